@@ -27,9 +27,17 @@
 #include "Combat/CombatAll.h"
 #include "TownHall/TownHall.h"
 #include "AudioManager/AudioManager.h"
+#include "EventBus/EventBus.h"
+#include "TimerService/TimerService.h"
+#include "JobSystem/JobSystem.h"
 #include "MapManager/MapManager.h"
 #include "UIManager/UIManager.h"
 #include "BattleScene.h"
+#include "StressScene.h"
+#include "Simulation/SimulationTools.h"
+#include "Profiler/GameProfiler.h"
+#include "Profiler/SceneTelemetry.h"
+#include "Profiler/StructuredLog.h"
 
 
 // #define USE_AUDIO_ENGINE 1
@@ -53,6 +61,7 @@ AppDelegate::AppDelegate()
 
 AppDelegate::~AppDelegate() 
 {
+    JobSystem::destroyInstance();
 #if USE_AUDIO_ENGINE
     AudioEngine::end();
 #endif
@@ -92,6 +101,19 @@ bool AppDelegate::applicationDidFinishLaunching() {
 
     // turn on display FPS
     director->setDisplayStats(true);
+    // 子系统耗时分析：F3 显示浮层，F4 导出 Chrome trace / CSV 到可写目录
+    GameProfiler::getInstance()->install();
+    // 场景遥测：每次切换场景后记录节点 / Action / 纹理 / 堆快照并输出差异，F5 导出
+    SceneTelemetry::getInstance()->install();
+    // 战斗热路径日志：TJ_LOG_CATEGORIES 选择类别，每帧由主线程统一格式化输出
+    StructuredLog::getInstance()->configureFromEnvironment();
+    StructuredLog::getInstance()->install();
+    // 事件总线：每帧统一派发战斗 / UI 事件
+    EventBus::getInstance()->install();
+    // 全局计时服务：建筑升级、训练与升级进度条
+    TimerService::getInstance()->install();
+    // 战斗并行任务线程池：TJ_JOB_THREADS 指定线程数（0 为全部串行），未设置时按 CPU 核数选择
+    JobSystem::getInstance()->start(JobSystem::workerCountFromEnvironment());
 
     // set FPS. the default value is 1.0/60 if you don't call this
     director->setAnimationInterval(1.0f / 60);
@@ -117,6 +139,55 @@ bool AppDelegate::applicationDidFinishLaunching() {
 
     register_all_packages();
 
+    // 音效在启动时统一解码缓存，避免战斗中首次播放时卡顿
+    AudioManager::getInstance()->preloadEffects();
+
+    // 状态校验跟踪：TJ_CHECKSUM_TRACE=文件名，战斗结束时写出每个检查点的实体记录（回放加 .replay 后缀）
+    if (const char* trace = std::getenv("TJ_CHECKSUM_TRACE")) {
+        CombatManager::SetChecksumTraceFile(trace);
+    }
+    // 分歧比对：TJ_DESYNC_DIFF=a.trace,b.trace，输出第一个分歧的 tick 与实体后退出
+    if (const char* diff = std::getenv("TJ_DESYNC_DIFF")) {
+        std::string files(diff);
+        auto comma = files.find(',');
+        auto fileUtils = FileUtils::getInstance();
+        if (comma == std::string::npos) {
+            log("TJ_DESYNC_DIFF expects two trace files separated by ','");
+        } else {
+            auto report = CombatChecksum::DiffTraces(fileUtils->getStringFromFile(files.substr(0, comma)),
+                                                     fileUtils->getStringFromFile(files.substr(comma + 1)));
+            log("desync diff: %s", report.ToString().c_str());
+        }
+        director->end();
+        return true;
+    }
+
+    // 离线进攻规划：TJ_PLAN_ATTACK=battle_field1.json，写出 attack_plans.json 后退出
+    if (SimulationTools::runAttackPlannerFromEnvironment()) {
+        director->end();
+        return true;
+    }
+
+    // 离线布局优化：TJ_OPTIMIZE_LAYOUT=battle_field1.json，进攻集合由 TJ_RECORD_ATTACKS 录制，
+    // 写出 optimized_layouts.json 后退出
+    if (SimulationTools::runLayoutOptimizerFromEnvironment()) {
+        director->end();
+        return true;
+    }
+
+    // 离线数值平衡扫描：TJ_BALANCE_SWEEP=balance_grid.json，写出 balance_sweep.csv 后退出
+    if (SimulationTools::runBalanceSweepFromEnvironment()) {
+        director->end();
+        return true;
+    }
+
+    // 压力测试模式：设置环境变量 TJ_STRESS_TROOPS=N 启动，跑完写出报告后退出
+    StressConfig stressConfig;
+    if (StressConfig::fromEnvironment(stressConfig)) {
+        director->runWithScene(StressScene::createScene(stressConfig));
+        return true;
+    }
+
     auto scene = MainScene::createScene();
     director->runWithScene(scene);
 
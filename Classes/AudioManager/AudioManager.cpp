@@ -1,8 +1,36 @@
 #include "AudioManager/AudioManager.h"
 #include "Soldier/Soldier.h"
+#include "EventBus/EventBus.h"
+#include <algorithm>
+#include <cmath>
 
 USING_NS_CC;
 
+namespace {
+// 单个音效的声部上限与优先级（数值越大越重要）
+struct EffectConfig {
+    int maxVoices;
+    int priority;
+};
+
+EffectConfig getEffectConfig(AudioID id) {
+    switch (id) {
+        case AudioID::SFX_Archer:
+        case AudioID::SFX_Barbarian:
+        case AudioID::SFX_Giant:
+        case AudioID::SFX_Bomber:           return {3, 0};
+        case AudioID::SFX_Cannon:           return {2, 1};
+        case AudioID::SFX_Die:              return {2, 1};
+        case AudioID::SFX_Building_Destroy: return {2, 2};
+        case AudioID::SFX_Collect_Resource: return {2, 2};
+        case AudioID::SFX_Intro:
+        case AudioID::SFX_Win:
+        case AudioID::SFX_Lost:             return {1, 3};
+        default:                            return {1, 0};
+    }
+}
+}
+
 AudioManager* AudioManager::_instance = nullptr;
 
 AudioManager* AudioManager::getInstance() {
@@ -13,7 +41,46 @@ AudioManager* AudioManager::getInstance() {
 AudioManager::AudioManager() 
     : _currentMusicID(AudioEngine::INVALID_AUDIO_ID)
     , _musicVolume(0.5f)
-    , _sfxVolume(0.8f) {}
+    , _sfxVolume(0.8f) {
+    for (int i = 0; i < kEffectCount; ++i) {
+        _paths[i] = getPath(static_cast<AudioID>(i));
+    }
+    _voices.reserve(kMaxVoices);
+    // 音效声部 + 背景音乐
+    AudioEngine::setMaxAudioInstance(kMaxVoices + 1);
+    Director::getInstance()->getScheduler()->schedule(
+        [this](float dt) { flushEffects(dt); }, this, 0.0f, false, "AudioManagerFlush");
+    subscribeCombatEvents();
+}
+
+// 战斗音效由战斗核心发布的事件驱动
+void AudioManager::subscribeCombatEvents() {
+    auto bus = EventBus::getInstance();
+    bus->subscribe(GameEventType::SoldierAttack, this, [this](const GameEvent& e) {
+        playSoldierAttack(static_cast<SoldierType>(e.soldier.soldierType));
+    });
+    bus->subscribe(GameEventType::SoldierDied, this, [this](const GameEvent&) {
+        playDie();
+    });
+    bus->subscribe(GameEventType::BuildingDestroyed, this, [this](const GameEvent&) {
+        playBuildingDestroy();
+    });
+    bus->subscribe(GameEventType::BuildingAttack, this, [this](const GameEvent& e) {
+        switch (e.building.kind) {
+            case BuildingAttackKind::ArcherTower: playArcher(); break;
+            case BuildingAttackKind::Cannon:      playCannon(); break;
+            default: break;
+        }
+    });
+}
+
+void AudioManager::preloadEffects() {
+    for (int i = 0; i < kEffectCount; ++i) {
+        auto id = static_cast<AudioID>(i);
+        if (id == AudioID::BGM_Village || id == AudioID::BGM_Battle || _paths[i].empty()) continue;
+        AudioEngine::preload(_paths[i]);
+    }
+}
 
 std::string AudioManager::getPath(AudioID id) const {
     switch (id) {
@@ -36,7 +103,7 @@ std::string AudioManager::getPath(AudioID id) const {
 
 void AudioManager::playMusic(bool isBattle) {
     stopMusic();
-    std::string path = getPath(isBattle ? AudioID::BGM_Battle : AudioID::BGM_Village);
+    const std::string& path = _paths[static_cast<int>(isBattle ? AudioID::BGM_Battle : AudioID::BGM_Village)];
     if (!path.empty()) {
         _currentMusicID = AudioEngine::play2d(path, true, _musicVolume);
     }
@@ -49,10 +116,82 @@ void AudioManager::stopMusic() {
     }
 }
 
+void AudioManager::stopAll() {
+    AudioEngine::stopAll();
+    _currentMusicID = AudioEngine::INVALID_AUDIO_ID;
+    _voices.clear();
+    std::fill(std::begin(_pendingCount), std::end(_pendingCount), 0);
+    _hasPending = false;
+}
+
 void AudioManager::playEffect(AudioID id) {
-    std::string path = getPath(id);
-    if (!path.empty()) {
-        AudioEngine::play2d(path, false, _sfxVolume);
+    int index = static_cast<int>(id);
+    if (index < 0 || index >= kEffectCount || _paths[index].empty()) return;
+    _pendingCount[index]++;
+    _hasPending = true;
+}
+
+void AudioManager::pruneVoices() {
+    _voices.erase(std::remove_if(_voices.begin(), _voices.end(), [](const Voice& v) {
+        auto state = AudioEngine::getState(v.audioID);
+        return state != AudioEngine::AudioState::PLAYING && state != AudioEngine::AudioState::INITIALIZING;
+    }), _voices.end());
+}
+
+bool AudioManager::stealVoice(int priority) {
+    // 选择优先级低于新音效的声部中优先级最低、开始最早的一个
+    auto victim = _voices.end();
+    for (auto it = _voices.begin(); it != _voices.end(); ++it) {
+        if (it->priority >= priority) continue;
+        if (victim == _voices.end() || it->priority < victim->priority ||
+            (it->priority == victim->priority && it->startFrame < victim->startFrame)) {
+            victim = it;
+        }
+    }
+    if (victim == _voices.end()) return false;
+    AudioEngine::stop(victim->audioID);
+    _voices.erase(victim);
+    return true;
+}
+
+void AudioManager::flushEffects(float dt) {
+    CC_UNUSED_PARAM(dt);
+    _frame++;
+    if (!_hasPending) return;
+    _hasPending = false;
+    pruneVoices();
+
+    // 先处理优先级高的音效，保证抢占顺序稳定
+    for (int priority = 3; priority >= 0; --priority) {
+        for (int i = 0; i < kEffectCount; ++i) {
+            int count = _pendingCount[i];
+            auto id = static_cast<AudioID>(i);
+            auto config = getEffectConfig(id);
+            if (count == 0 || config.priority != priority) continue;
+            _pendingCount[i] = 0;
+
+            // 单音效声部已满：重新触发其中最早的一个
+            int active = 0;
+            auto oldest = _voices.end();
+            for (auto it = _voices.begin(); it != _voices.end(); ++it) {
+                if (it->id != id) continue;
+                active++;
+                if (oldest == _voices.end() || it->startFrame < oldest->startFrame) oldest = it;
+            }
+            if (active >= config.maxVoices && oldest != _voices.end()) {
+                AudioEngine::stop(oldest->audioID);
+                _voices.erase(oldest);
+            } else if (static_cast<int>(_voices.size()) >= kMaxVoices && !stealVoice(config.priority)) {
+                continue;   // 全局声部已满且没有可抢占的声部，丢弃
+            }
+
+            // 同帧 N 次合并为一次，音量随数量对数增长
+            float volume = std::min(1.0f, _sfxVolume * (1.0f + 0.15f * std::log2(static_cast<float>(count))));
+            int audioID = AudioEngine::play2d(_paths[i], false, volume);
+            if (audioID != AudioEngine::INVALID_AUDIO_ID) {
+                _voices.push_back({audioID, id, config.priority, _frame});
+            }
+        }
     }
 }
 
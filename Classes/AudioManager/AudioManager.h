@@ -5,6 +5,7 @@
 #include "cocos2d.h"
 #include "audio/include/AudioEngine.h"
 #include <string>
+#include <vector>
 #include "Soldier/Soldier.h"
 
 enum class AudioID {
@@ -28,6 +29,8 @@ enum class AudioID {
     SFX_Intro,            // 开场
     SFX_Win,              // 胜利
     SFX_Lost,             // 失败
+
+    Count                 // 数量（不是音效）
 };
 
 class AudioManager {
@@ -62,17 +65,44 @@ public:
 
     // ========== 全局控制 ==========
     void stopMusic();
-    void stopAll() { cocos2d::AudioEngine::stopAll(); }
+    void stopAll();
+
+    // 预加载全部音效（解码后的缓冲由 AudioEngine 缓存），启动时调用一次
+    void preloadEffects();
 
 private:
     AudioManager();
+    // 只登记请求，实际播放在每帧一次的 flushEffects 中进行
     void playEffect(AudioID id);
     std::string getPath(AudioID id) const;
+    void subscribeCombatEvents();
+
+    // 每帧一次：同帧同一音效合并为一次播放（按数量略微提高音量），
+    // 再按单音效声部上限与全局声部上限分配，满时抢占优先级更低的最早声部
+    void flushEffects(float dt);
+    void pruneVoices();
+    bool stealVoice(int priority);
+
+    static const int kEffectCount = static_cast<int>(AudioID::Count);
+    static const int kMaxVoices = 16;       // 音效总声部数（不含背景音乐）
+
+    struct Voice {
+        int audioID;
+        AudioID id;
+        int priority;
+        unsigned int startFrame;
+    };
 
     static AudioManager* _instance;
     int _currentMusicID;
     float _musicVolume;
     float _sfxVolume;
+
+    std::string _paths[kEffectCount];         // 启动时解析一次的路径
+    int _pendingCount[kEffectCount] = {};     // 本帧请求次数
+    bool _hasPending = false;
+    std::vector<Voice> _voices;               // 正在播放的音效声部
+    unsigned int _frame = 0;
 };
 
 #endif __AUDIO_MANAGER_H__
\ No newline at end of file
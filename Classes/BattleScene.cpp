@@ -3,15 +3,19 @@
 #include "MapManager/MapManager.h"
 #include "UIManager/UIManager.h"
 #include "Combat/Combat.h"
+#include "Combat/CombatEntityPool.h"
 #include "AudioManager/AudioManager.h"
 #include "ReplayScene.h"
+#include "Profiler/GameProfiler.h"
 
 using namespace cocos2d;
 
 BattleScene* BattleScene::createScene(int levelId) {
+    PROFILE_SCOPE(ProfileZone::SceneBuild);
     CCLOG("BattleScene::createScene() started");
     auto scene = BattleScene::create();
     if (!scene) return nullptr;
+    scene->setName("BattleScene");
 
     auto map = MapManager::create(30, 30, -1, TerrainType::Battle);
     if (map) {
@@ -29,24 +33,29 @@ BattleScene* BattleScene::createScene(int levelId) {
     if (ui->init(scene)) {
         ui->setCurrentLevelId(levelId); 
         ui->enterBattleMode(map);
+        // 按本场军队配置预热士兵对象池，部署时不再新建节点
+        for (const auto& tmpl : TownHall::GetInstance()->GetSoldierCategory()) {
+            CombatEntityPool::GetInstance()->PrewarmSoldiers(tmpl, ui->getBattleTroopCount(tmpl.name_));
+        }
         AudioManager::getInstance()->playMusic(true);
         combatMgr->StartCombat();
-        ui->setUICallback("OnRequestEndBattle", [combatMgr]() {
+        ui->setUICallback(GameEventType::RequestEndBattle, [combatMgr](const GameEvent&) {
             AudioManager::getInstance()->playMusic(false);
             UIManager::getInstance()->exitBattleMode();
             combatMgr->EndCombat();
             auto homeScene = MainScene::createScene();
             Director::getInstance()->replaceScene(TransitionFade::create(0.5f, homeScene));
         });
-        ui->setUICallback("OnRequestReplay", []() {
+        ui->setUICallback(GameEventType::RequestReplay, [](const GameEvent&) {
             auto ui = UIManager::getInstance();
             int levelId = ui->getCurrentLevelId();
             auto steps = ui->getRecordedSteps();
+            auto checksums = ui->getRecordedChecksums();
             
             // 销毁当前战斗实例，准备重播
             CombatManager::DestroyInstance();
             
-            auto replayScene = ReplayScene::createScene(levelId, steps);
+            auto replayScene = ReplayScene::createScene(levelId, steps, checksums);
             Director::getInstance()->replaceScene(TransitionFade::create(0.5f, replayScene));
         });
     }
@@ -5,6 +5,7 @@
 #include <iostream>
 #include "Building/Building.h"
 #include "TownHall/TownHall.h"
+#include "TownHall/WallSegmentStore.h"
 
 // ==================== Building 基类函数的实现 ====================
 
@@ -16,12 +17,20 @@ Building::Building(std::string name, int level, int health, int defense,
     int buildtime, int build_cost, int width, int length, cocos2d::Vec2 position)
     : name_(std::move(name)), level_(level), health_(health), defense_(defense),
     build_time_(buildtime), build_cost_(build_cost), width_(width), length_(length),
-    is_upgrading_(false), upgrade_remaining_time_(0.0f),
+    is_upgrading_(false), upgrade_timer_(TimerService::kInvalidTimer),
     position_(position) {
     //napper:按照默认初始化为（0，0）这一指令不合适，且未做任何地图位置与屏幕位置之间的转换
     //this->setPosition(position_);
 }
 
+/**
+ * @brief 析构函数
+ * 取消本建筑持有的全部计时器（升级、训练等）。
+ */
+Building::~Building() {
+    TimerService::getInstance()->cancelAll(this);
+}
+
 /**
  * @brief 建筑升级
  * 提升建筑等级，同时调整建造时间、建造成本、防御并将生命值回满。
@@ -49,27 +58,31 @@ void Building::StartUpgrade(float upgrade_time) {
     }
 
     is_upgrading_ = true;
-    upgrade_remaining_time_ = upgrade_time;
 
     cocos2d::log("建筑 %s 开始升级，需要 %.1f 秒", name_.c_str(), upgrade_time);
 
-    // 启动升级计时器
-    this->schedule([this](float dt) {
-        upgrade_remaining_time_ -= dt;
-        if (upgrade_remaining_time_ <= 0.0f) {
-            upgrade_remaining_time_ = 0.0f;
-            is_upgrading_ = false;
+    // 截止时间交给全局计时服务，到期时回调
+    upgrade_timer_ = TimerService::getInstance()->start(upgrade_time, [this]() {
+        upgrade_timer_ = TimerService::kInvalidTimer;
+        is_upgrading_ = false;
 
-            // 升级完成，执行真正的升级逻辑
-            this->Upgrade();
+        // 升级完成，执行真正的升级逻辑
+        this->Upgrade();
+        this->OnUpgradeStateChanged();
 
-            // 停止计时器
-            this->unschedule("upgrade_timer");
+        cocos2d::log("建筑 %s 升级完成！当前等级：%d",
+            this->GetName().c_str(), this->GetLevel());
+        }, this);
+    OnUpgradeStateChanged();
+}
 
-            cocos2d::log("建筑 %s 升级完成！当前等级：%d",
-                this->GetName().c_str(), this->GetLevel());
-        }
-        }, "upgrade_timer");
+/**
+ * @brief 获取升级剩余时间
+ * @return 升级剩余时间（秒），未在升级时为 0
+ */
+float Building::GetUpgradeRemainingTime() const {
+    if (!is_upgrading_) return 0.0f;
+    return TimerService::getInstance()->getRemaining(upgrade_timer_);
 }
 
 /**
@@ -366,6 +379,45 @@ void WallBuilding::WallBuilding::Upgrade() {
         level_, health_, GetMaxHealth(), defense_);
 }
 
+/**
+ * @brief 墙体析构
+ * 从所属城墙段存储中移除，避免存储保留悬空指针
+ */
+WallBuilding::~WallBuilding() {
+    if (segment_store_) {
+        segment_store_->Remove(this);
+    }
+}
+
+/**
+ * @brief 升级状态变化时回写城墙段存储
+ */
+void WallBuilding::OnUpgradeStateChanged() {
+    if (segment_store_) {
+        segment_store_->Sync(segment_index_);
+    }
+}
+
+/**
+ * @brief 墙体受到伤害，同步城墙段存储
+ */
+void WallBuilding::TakeDamage(int damage) {
+    Building::TakeDamage(damage);
+    if (segment_store_) {
+        segment_store_->Sync(segment_index_);
+    }
+}
+
+/**
+ * @brief 修复墙体，同步城墙段存储
+ */
+void WallBuilding::Repair() {
+    Building::Repair();
+    if (segment_store_) {
+        segment_store_->Sync(segment_index_);
+    }
+}
+
 /**
  * @brief 显示墙体信息
  */
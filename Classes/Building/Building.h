@@ -9,6 +9,10 @@
 #include <string>
 #include "cocos2d.h"
 #include "Soldier/Soldier.h"
+#include "TimerService/TimerService.h"
+
+class WallSegmentStore;
+
 /**
  * @brief Building类
  * 基类，所有建筑物都会继承自该类。
@@ -24,9 +28,15 @@ protected:
     int width_;                       // 建造宽度
     int length_;                      // 建造长度
     bool is_upgrading_;               // 是否正在升级中
-    float upgrade_remaining_time_;    // 升级剩余时间（秒）
+    TimerService::TimerId upgrade_timer_;  // 升级计时器（剩余时间由 TimerService 计算）
     cocos2d::Vec2 position_;    // 建筑的位置信息 (x, y)
 
+    /**
+     * @brief 升级状态变化回调
+     * 开始升级与升级完成后调用，派生类可据此同步外部数据
+     */
+    virtual void OnUpgradeStateChanged() {}
+
 
 public:
     //napper:临时添加，用于绑定建筑对应的图片
@@ -69,13 +79,13 @@ public:
      * 根据传入伤害值减少当前生命值。
      * @param damage 外部传入的伤害值。
      */
-    void TakeDamage(int damage);
+    virtual void TakeDamage(int damage);
 
     /**
      * @brief 修复建筑
      * 将当前生命值恢复至最大生命值。
      */
-    void Repair();
+    virtual void Repair();
 
     /**
      * @brief 检查建筑是否被摧毁
@@ -100,7 +110,7 @@ public:
      * @brief 虚析构函数
      * 确保通过基类指针删除派生类对象时能够正确析构。
      */
-    virtual ~Building() = default;
+    virtual ~Building();
 
     /**
      * @brief 获取建筑名称
@@ -216,10 +226,11 @@ public:
      * @brief 获取升级剩余时间
      * @return 升级剩余时间（秒）
      */
-    float GetUpgradeRemainingTime() const { return upgrade_remaining_time_; }
+    float GetUpgradeRemainingTime() const;
 
     //napper:提供方法以从外部修改建筑的地图位置
     void SetMapPosition(const cocos2d::Vec2 pos){position_ = pos;};
+    const cocos2d::Vec2& GetMapPosition() const { return position_; }
 };
 
 /**
@@ -373,6 +384,37 @@ public:
      * 在基类显示信息基础上，附加墙体特有属性
      */
     virtual void ShowInfo() const override;
+
+    /**
+     * @brief 受伤后回写城墙段存储中的血量
+     */
+    void TakeDamage(int damage) override;
+
+    /**
+     * @brief 修复后回写城墙段存储中的血量
+     */
+    void Repair() override;
+
+    /**
+     * @brief 析构时从城墙段存储中移除
+     */
+    ~WallBuilding() override;
+
+    /**
+     * @brief 绑定到城墙段存储（由 WallSegmentStore 调用）
+     * @param store 所属存储，nullptr 表示解除绑定
+     * @param index 在存储中的下标
+     */
+    void BindSegment(WallSegmentStore* store, int index) { segment_store_ = store; segment_index_ = index; }
+    WallSegmentStore* GetSegmentStore() const { return segment_store_; }
+    int GetSegmentIndex() const { return segment_index_; }
+
+protected:
+    void OnUpgradeStateChanged() override;
+
+private:
+    WallSegmentStore* segment_store_ = nullptr;
+    int segment_index_ = -1;
 };
 
 /**
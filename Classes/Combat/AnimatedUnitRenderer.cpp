@@ -0,0 +1,373 @@
+// AnimatedUnitRenderer.cpp
+// 士兵批量渲染器实现
+
+#include "AnimatedUnitRenderer.h"
+#include "SoldierAnimationTable.h"
+#include "renderer/backend/Device.h"
+#include "Profiler/GameProfiler.h"
+
+USING_NS_CC;
+
+namespace {
+
+// 顶点布局：起点(2) 速度(2) 移动区间(2) 动画(4) 角点(4)
+constexpr int kFloatsPerVertex = 14;
+constexpr int kVerticesPerUnit = 4;
+constexpr int kIndicesPerUnit = 6;
+
+// 兵种在帧表中占用的连续帧区间
+constexpr int FirstFrameOfType(int type) {
+    return soldier_anim_table::kClips[type][0][0].first_frame;
+}
+constexpr int FrameCountOfType(int type) {
+    return (type + 1 < soldier_anim_table::kSoldierCount ? FirstFrameOfType(type + 1)
+                                                          : static_cast<int>(sizeof(soldier_anim_table::kFrames) /
+                                                                             sizeof(soldier_anim_table::kFrames[0])))
+           - FirstFrameOfType(type);
+}
+constexpr bool AllTypesFit(int limit) {
+    for (int t = 0; t < soldier_anim_table::kSoldierCount; ++t) {
+        if (FrameCountOfType(t) > limit) return false;
+    }
+    return true;
+}
+
+const char* kUnitVert = R"(
+#ifdef GL_ES
+precision highp float;
+#endif
+attribute vec2 a_position;
+attribute vec2 a_velocity;
+attribute vec2 a_motion;
+attribute vec4 a_anim;
+attribute vec4 a_corner;
+
+uniform mat4 u_MVPMatrix;
+uniform float u_time;
+uniform float u_frameDelay;
+uniform vec2 u_textureSize;
+uniform vec4 u_frames[96];
+
+varying vec2 v_texCoord;
+
+void main()
+{
+    // 直线移动：在 [start, start + duration] 内匀速插值
+    float moved = clamp(u_time - a_motion.x, 0.0, a_motion.y);
+    vec2 center = a_position + a_velocity * moved;
+
+    // 帧选择：循环动画取模，单次动画停在最后一帧
+    float index = floor(max(u_time - a_anim.z, 0.0) / u_frameDelay);
+    index = a_anim.w > 0.5 ? mod(index, a_anim.y) : min(index, a_anim.y - 1.0);
+    vec4 frame = u_frames[int(a_anim.x + index)];
+
+    vec2 size = frame.zw * a_corner.w;
+    gl_Position = u_MVPMatrix * vec4(center + a_corner.xy * size, 0.0, 1.0);
+
+    vec2 uv = vec2(frame.x + frame.z * (0.5 + a_corner.x * a_corner.z),
+                   frame.y + frame.w * (0.5 - a_corner.y));
+    v_texCoord = uv / u_textureSize;
+}
+)";
+
+const char* kUnitFrag = R"(
+#ifdef GL_ES
+precision lowp float;
+#endif
+varying vec2 v_texCoord;
+uniform sampler2D u_texture;
+
+void main()
+{
+    gl_FragColor = texture2D(u_texture, v_texCoord);
+}
+)";
+
+} // namespace
+
+AnimatedUnitRenderer* AnimatedUnitRenderer::Create() {
+    auto renderer = new (std::nothrow) AnimatedUnitRenderer();
+    if (renderer && renderer->Init()) {
+        renderer->autorelease();
+        return renderer;
+    }
+    CC_SAFE_DELETE(renderer);
+    return nullptr;
+}
+
+bool AnimatedUnitRenderer::Init() {
+    if (!Node::init()) {
+        CCLOG("AnimatedUnitRenderer init failed: Node init error");
+        return false;
+    }
+    // kMaxFramesPerType 须与 kUnitVert 中 u_frames 的长度一致
+    static_assert(AllTypesFit(kMaxFramesPerType), "SoldierAnimationTable.h has too many frames for u_frames");
+    this->scheduleUpdate();
+    return true;
+}
+
+AnimatedUnitRenderer::~AnimatedUnitRenderer() {
+    for (auto& batch : batches_) {
+        CC_SAFE_RELEASE_NULL(batch.program_state);
+        CC_SAFE_RELEASE_NULL(batch.texture);
+    }
+}
+
+bool AnimatedUnitRenderer::InitBatch(const Soldier* soldier_template) {
+    int type = static_cast<int>(soldier_template->GetSoldierType());
+    auto& batch = batches_[type];
+    if (batch.program_state) return true;
+    PROFILE_SCOPE(ProfileZone::AssetLoad);
+
+    auto texture = Director::getInstance()->getTextureCache()->addImage(soldier_anim_table::kTexturePaths[type]);
+    if (!texture) {
+        CCLOG("AnimatedUnitRenderer: load texture failure : %s", soldier_anim_table::kTexturePaths[type]);
+        return false;
+    }
+    batch.texture = texture;
+    batch.texture->retain();
+
+    // 帧表：与 SoldierAnimationDatabase 一样受兵种模板的帧数限制
+    const int first = FirstFrameOfType(type);
+    const int frame_limits[kActionCount] = {soldier_template->walk_frame_num, soldier_template->attack_frame_num};
+    for (int i = 0; i < FrameCountOfType(type); ++i) {
+        const auto& r = soldier_anim_table::kFrames[first + i];
+        batch.frames[i] = Vec4(r.x, r.y, r.width, r.height);
+    }
+    for (int action = 0; action < kActionCount; ++action) {
+        for (int dir = 0; dir < kDirectionCount; ++dir) {
+            const auto& clip = soldier_anim_table::kClips[type][action][dir];
+            batch.clip_first[action][dir] = clip.first_frame - first;
+            batch.clip_count[action][dir] = std::min(clip.frame_count, frame_limits[action]);
+        }
+    }
+
+    auto program = backend::Device::getInstance()->newProgram(kUnitVert, kUnitFrag);
+    batch.program_state = new (std::nothrow) backend::ProgramState(program);
+    CC_SAFE_RELEASE(program);
+
+    auto& descriptor = batch.command.getPipelineDescriptor();
+    descriptor.programState = batch.program_state;
+
+    auto layout = batch.program_state->getVertexLayout();
+    const struct { const char* name; backend::VertexFormat format; int offset; } attributes[] = {
+            {"a_position", backend::VertexFormat::FLOAT2, 0},
+            {"a_velocity", backend::VertexFormat::FLOAT2, 2},
+            {"a_motion", backend::VertexFormat::FLOAT2, 4},
+            {"a_anim", backend::VertexFormat::FLOAT4, 6},
+            {"a_corner", backend::VertexFormat::FLOAT4, 10},
+    };
+    for (const auto& attr : attributes) {
+        layout->setAttribute(attr.name, batch.program_state->getAttributeLocation(attr.name), attr.format,
+                             attr.offset * sizeof(float), false);
+    }
+    layout->setLayout(kFloatsPerVertex * sizeof(float));
+
+    // 纹理为 premultiplied alpha 时与 Sprite 默认混合方式一致
+    auto& blend = descriptor.blendDescriptor;
+    blend.blendEnabled = true;
+    blend.sourceRGBBlendFactor = blend.sourceAlphaBlendFactor =
+            texture->hasPremultipliedAlpha() ? backend::BlendFactor::ONE : backend::BlendFactor::SRC_ALPHA;
+    blend.destinationRGBBlendFactor = blend.destinationAlphaBlendFactor = backend::BlendFactor::ONE_MINUS_SRC_ALPHA;
+
+    // 帧表与纹理只需设置一次
+    auto state = batch.program_state;
+    float frame_delay = soldier_anim_table::kFrameDelay;
+    Vec2 texture_size = texture->getContentSize();
+    state->setUniform(state->getUniformLocation("u_frameDelay"), &frame_delay, sizeof(frame_delay));
+    state->setUniform(state->getUniformLocation("u_textureSize"), &texture_size, sizeof(texture_size));
+    state->setUniform(state->getUniformLocation("u_frames"), batch.frames, sizeof(batch.frames));
+    state->setTexture(state->getUniformLocation("u_texture"), 0, texture->getBackendTexture());
+
+    batch.command.setDrawType(CustomCommand::DrawType::ELEMENT);
+    batch.command.setPrimitiveType(CustomCommand::PrimitiveType::TRIANGLE);
+    return true;
+}
+
+void AnimatedUnitRenderer::EnsureCapacity(Batch& batch, int units) {
+    if (units <= batch.capacity) return;
+    int capacity = std::max(64, batch.capacity);
+    while (capacity < units) capacity *= 2;
+    capacity = std::min(capacity, kMaxUnitsPerBatch);
+
+    batch.command.createVertexBuffer(kFloatsPerVertex * sizeof(float), capacity * kVerticesPerUnit,
+                                     CustomCommand::BufferUsage::DYNAMIC);
+    batch.command.createIndexBuffer(CustomCommand::IndexFormat::U_SHORT, capacity * kIndicesPerUnit,
+                                    CustomCommand::BufferUsage::STATIC);
+    // 索引固定为每单位两个三角形，只在扩容时生成
+    std::vector<uint16_t> indices(capacity * kIndicesPerUnit);
+    for (int i = 0; i < capacity; ++i) {
+        auto base = static_cast<uint16_t>(i * kVerticesPerUnit);
+        uint16_t* quad = &indices[i * kIndicesPerUnit];
+        quad[0] = base; quad[1] = base + 1; quad[2] = base + 2;
+        quad[3] = base + 2; quad[4] = base + 1; quad[5] = base + 3;
+    }
+    batch.command.updateIndexBuffer(indices.data(), indices.size() * sizeof(uint16_t));
+    batch.capacity = capacity;
+    // 新建的顶点缓冲没有内容，已有单位全部重传
+    MarkSlots(batch, 0, static_cast<int>(batch.units.size()));
+}
+
+int AnimatedUnitRenderer::AddUnit(const Soldier* soldier_template, const Vec2& pos, float scale) {
+    if (!soldier_template) return -1;
+    int type = static_cast<int>(soldier_template->GetSoldierType());
+    if (type < 0 || type >= kTypeCount || !InitBatch(soldier_template)) return -1;
+
+    auto& batch = batches_[type];
+    if (static_cast<int>(batch.units.size()) >= kMaxUnitsPerBatch) {
+        CCLOG("AnimatedUnitRenderer: too many units of %s", soldier_template->GetName().c_str());
+        return -1;
+    }
+
+    int handle;
+    if (!free_handles_.empty()) {
+        handle = free_handles_.back();
+        free_handles_.pop_back();
+    } else {
+        handle = static_cast<int>(units_.size());
+        units_.emplace_back();
+    }
+
+    auto& unit = units_[handle];
+    unit = UnitInstance();
+    unit.origin = pos;
+    unit.scale = scale;
+    unit.type = type;
+    unit.slot = static_cast<int>(batch.units.size());
+    unit.first_frame = static_cast<float>(batch.clip_first[0][static_cast<int>(Direction::DOWN)]);
+    unit.frame_count = static_cast<float>(std::max(1, batch.clip_count[0][static_cast<int>(Direction::DOWN)]));
+    unit.anim_start = time_;
+    batch.units.push_back(handle);
+    EnsureCapacity(batch, static_cast<int>(batch.units.size()));
+    MarkSlots(batch, unit.slot, unit.slot + 1);
+    num_of_units_++;
+    return handle;
+}
+
+void AnimatedUnitRenderer::RemoveUnit(int handle) {
+    if (!IsValidHandle(handle)) return;
+    auto& unit = units_[handle];
+    auto& batch = batches_[unit.type];
+
+    // 与末尾交换后弹出，保持批次连续：只需重传被换入的槽位，末尾由绘制数量截掉
+    int last = batch.units.back();
+    batch.units[unit.slot] = last;
+    units_[last].slot = unit.slot;
+    batch.units.pop_back();
+    if (unit.slot < static_cast<int>(batch.units.size())) MarkSlots(batch, unit.slot, unit.slot + 1);
+    batch.dirty = true;
+
+    unit.type = -1;
+    unit.slot = -1;
+    free_handles_.push_back(handle);
+    num_of_units_--;
+}
+
+void AnimatedUnitRenderer::SetMotion(int handle, const Vec2& from, const Vec2& to, float duration) {
+    if (!IsValidHandle(handle)) return;
+    auto& unit = units_[handle];
+    unit.origin = from;
+    unit.velocity = duration > 0.0f ? (to - from) / duration : Vec2::ZERO;
+    unit.motion_start = time_;
+    unit.motion_duration = std::max(duration, 0.0f);
+    MarkDirty(handle);
+}
+
+void AnimatedUnitRenderer::SetPosition(int handle, const Vec2& pos) {
+    SetMotion(handle, pos, pos, 0.0f);
+}
+
+void AnimatedUnitRenderer::SetAnimation(int handle, SoldierAction action, Direction dir, bool flipped, bool loop) {
+    if (!IsValidHandle(handle)) return;
+    auto& unit = units_[handle];
+    const auto& batch = batches_[unit.type];
+    int a = static_cast<int>(action), d = static_cast<int>(dir);
+    unit.flipped = flipped;
+    if (batch.clip_count[a][d] > 0) {
+        unit.first_frame = static_cast<float>(batch.clip_first[a][d]);
+        unit.frame_count = static_cast<float>(batch.clip_count[a][d]);
+        unit.anim_start = time_;
+        unit.loop = loop;
+    }
+    MarkDirty(handle);
+}
+
+bool AnimatedUnitRenderer::IsValidHandle(int handle) const {
+    return handle >= 0 && handle < static_cast<int>(units_.size()) && units_[handle].type >= 0;
+}
+
+void AnimatedUnitRenderer::MarkDirty(int handle) {
+    const auto& unit = units_[handle];
+    MarkSlots(batches_[unit.type], unit.slot, unit.slot + 1);
+}
+
+void AnimatedUnitRenderer::MarkSlots(Batch& batch, int begin, int end) {
+    batch.dirty = true;
+    if (begin >= end) return;
+    if (batch.dirty_begin >= batch.dirty_end) {
+        batch.dirty_begin = begin;
+        batch.dirty_end = end;
+    } else {
+        batch.dirty_begin = std::min(batch.dirty_begin, begin);
+        batch.dirty_end = std::max(batch.dirty_end, end);
+    }
+}
+
+void AnimatedUnitRenderer::RebuildVertices(Batch& batch) {
+    static const float kCorners[kVerticesPerUnit][2] = {{-0.5f, 0.5f}, {-0.5f, -0.5f}, {0.5f, 0.5f}, {0.5f, -0.5f}};
+    constexpr int kFloatsPerUnit = kVerticesPerUnit * kFloatsPerVertex;
+    const int count = static_cast<int>(batch.units.size());
+    batch.vertices.resize(count * kFloatsPerUnit);
+    // 只重写并上传变化的槽位区间，开销与本帧变化的单位数成正比，与批次大小无关
+    const int begin = std::min(batch.dirty_begin, count);
+    const int end = std::min(batch.dirty_end, count);
+    float* out = batch.vertices.data() + begin * kFloatsPerUnit;
+    for (int slot = begin; slot < end; ++slot) {
+        const auto& unit = units_[batch.units[slot]];
+        for (const auto& corner : kCorners) {
+            *out++ = unit.origin.x;
+            *out++ = unit.origin.y;
+            *out++ = unit.velocity.x;
+            *out++ = unit.velocity.y;
+            *out++ = unit.motion_start;
+            *out++ = unit.motion_duration;
+            *out++ = unit.first_frame;
+            *out++ = unit.frame_count;
+            *out++ = unit.anim_start;
+            *out++ = unit.loop ? 1.0f : 0.0f;
+            *out++ = corner[0];
+            *out++ = corner[1];
+            *out++ = unit.flipped ? -1.0f : 1.0f;
+            *out++ = unit.scale;
+        }
+    }
+    if (begin < end) {
+        batch.command.updateVertexBuffer(batch.vertices.data() + begin * kFloatsPerUnit,
+                                         begin * kFloatsPerUnit * sizeof(float),
+                                         (end - begin) * kFloatsPerUnit * sizeof(float));
+    }
+    batch.command.setIndexDrawInfo(0, count * kIndicesPerUnit);
+    batch.dirty_begin = batch.dirty_end = 0;
+    batch.dirty = false;
+}
+
+void AnimatedUnitRenderer::update(float dt) {
+    time_ += dt;
+}
+
+void AnimatedUnitRenderer::draw(Renderer* renderer, const Mat4& transform, uint32_t flags) {
+    const auto& projection = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    Mat4 mvp = projection * transform;
+    for (auto& batch : batches_) {
+        if (!batch.program_state) continue;
+        if (batch.dirty) RebuildVertices(batch);
+        if (batch.units.empty()) continue;
+
+        // 每帧只更新时间与矩阵两个 uniform
+        auto state = batch.program_state;
+        state->setUniform(state->getUniformLocation("u_MVPMatrix"), mvp.m, sizeof(mvp.m));
+        state->setUniform(state->getUniformLocation("u_time"), &time_, sizeof(time_));
+        batch.command.init(_globalZOrder, transform, flags);
+        renderer->addCommand(&batch.command);
+    }
+}
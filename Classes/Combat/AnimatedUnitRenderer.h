@@ -0,0 +1,89 @@
+// AnimatedUnitRenderer.h
+// 士兵批量渲染器：每个士兵只是一条实例记录（起点、速度、动画区间、起始时间、翻转），
+// 帧选择与直线移动插值都在顶点着色器中完成，CPU 仅在记录变化时重新上传变化的那一段顶点
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_ANIMATEDUNITRENDERER_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_ANIMATEDUNITRENDERER_H
+
+#include <vector>
+#include "cocos2d.h"
+#include "renderer/CCCustomCommand.h"
+#include "Soldier/Soldier.h"
+#include "SoldierAnimation.h"
+
+class AnimatedUnitRenderer : public cocos2d::Node {
+public:
+    static AnimatedUnitRenderer* Create();
+    bool Init();
+
+    // 添加一个单位，返回句柄（失败返回 -1），坐标与士兵节点同处于地图世界节点下
+    int AddUnit(const Soldier* soldier_template, const cocos2d::Vec2& pos, float scale);
+    void RemoveUnit(int handle);
+
+    // 从 from 匀速移动到 to，耗时 duration 秒（由着色器插值）
+    void SetMotion(int handle, const cocos2d::Vec2& from, const cocos2d::Vec2& to, float duration);
+    void SetPosition(int handle, const cocos2d::Vec2& pos);
+    // 从当前时刻开始播放指定动作；该动作无帧时保持原动画
+    void SetAnimation(int handle, SoldierAction action, Direction dir, bool flipped, bool loop);
+
+    float GetTime() const { return time_; }
+    int GetUnitCount() const { return num_of_units_; }
+
+    void update(float dt) override;
+    void draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
+
+protected:
+    AnimatedUnitRenderer() = default;
+    ~AnimatedUnitRenderer() override;
+
+private:
+    static constexpr int kTypeCount = static_cast<int>(SoldierType::kSoldierTypes);
+    static constexpr int kActionCount = static_cast<int>(SoldierAction::kSoldierActions);
+    // 单个兵种的帧数上限（着色器 uniform 数组大小）
+    static constexpr int kMaxFramesPerType = 96;
+    // 16 位索引下单批最多的单位数
+    static constexpr int kMaxUnitsPerBatch = 65535 / 4;
+
+    struct UnitInstance {
+        cocos2d::Vec2 origin;
+        cocos2d::Vec2 velocity;
+        float motion_start = 0.0f, motion_duration = 0.0f;
+        float first_frame = 0.0f, frame_count = 1.0f, anim_start = 0.0f;
+        bool loop = true, flipped = false;
+        float scale = 1.0f;
+        int type = -1;
+        int slot = -1; // 在所属批次 units 中的下标
+    };
+
+    struct Batch {
+        cocos2d::Texture2D* texture = nullptr;
+        cocos2d::backend::ProgramState* program_state = nullptr;
+        cocos2d::CustomCommand command;
+        std::vector<int> units;           // 该兵种的单位句柄
+        std::vector<float> vertices;      // 展开后的顶点数据（与 GPU 顶点缓冲一致）
+        cocos2d::Vec4 frames[kMaxFramesPerType];
+        // [动作][方向] -> 在本兵种帧数组中的首帧与帧数
+        int clip_first[kActionCount][kDirectionCount] = {};
+        int clip_count[kActionCount][kDirectionCount] = {};
+        int capacity = 0;
+        // 需要重新上传的槽位区间 [dirty_begin, dirty_end)，为空时只可能是单位数变化
+        int dirty_begin = 0;
+        int dirty_end = 0;
+        bool dirty = false;
+    };
+
+    bool InitBatch(const Soldier* soldier_template);
+    void EnsureCapacity(Batch& batch, int units);
+    void RebuildVertices(Batch& batch);
+    bool IsValidHandle(int handle) const;
+    void MarkDirty(int handle);
+    static void MarkSlots(Batch& batch, int begin, int end);
+
+    Batch batches_[kTypeCount];
+    std::vector<UnitInstance> units_;
+    std::vector<int> free_handles_;
+    int num_of_units_ = 0;
+    float time_ = 0.0f;
+};
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_ANIMATEDUNITRENDERER_H
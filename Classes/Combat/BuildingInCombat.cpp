@@ -2,9 +2,18 @@
 // Created by duby0 on 2025/12/7.
 //
 #include "BuildingInCombat.h"
+#include "CombatEntityPool.h"
+#include "CombatSnapshot.h"
+#include "Profiler/GameProfiler.h"
+#include "Profiler/StructuredLog.h"
+#include "EventBus/EventBus.h"
 
 // -------------------------- 工厂方法实现 --------------------------
-BuildingInCombat* BuildingInCombat::Create(Building* soldier_template,MapManager* map) {
+BuildingInCombat* BuildingInCombat::Create(const Building* soldier_template,MapManager* map) {
+    auto pooled = CombatEntityPool::GetInstance()->AcquireBuilding();
+    if (pooled) {
+        return pooled->Spawn(soldier_template, map) ? pooled : nullptr;
+    }
     auto soldier = new (std::nothrow) BuildingInCombat();
     if (soldier && soldier->Init(soldier_template,map)) {
         soldier->autorelease();  // Cocos2d-x自动内存管理
@@ -19,11 +28,21 @@ BuildingInCombat::~BuildingInCombat() {
 }
 
 bool BuildingInCombat::Init(const Building* building_template,MapManager* map) {
+    return InitNode() && Spawn(building_template, map);
+}
+
+bool BuildingInCombat::InitNode() {
 // 1. 调用父类Sprite::init()确保渲染节点初始化
     if (!cocos2d::Sprite::init()) {
         CCLOG("BuildingInCombat Init Failed: Sprite Init Error");
         return false;
     }
+    // 血条随节点一起被对象池复用，上场时按建筑高度重新定位
+    hp_bar_ = HpBarComponents::createHpBar(this,0.0f);
+    return true;
+}
+
+bool BuildingInCombat::Spawn(const Building* building_template,MapManager* map) {
     // 2. 验证兵种模板的有效性
     if (!building_template) {
         CCLOG("BuildingInCombat init failed: Invalid building template!");
@@ -32,11 +51,15 @@ bool BuildingInCombat::Init(const Building* building_template,MapManager* map) {
 
     this->building_template_ = building_template;
     current_health_ = building_template->GetHealth();
+    subscribers.clear();
 
-    if(!this->initWithTexture(building_template->getTexture())){
+    auto texture = building_template->getTexture();
+    if(!texture){
         CCLOG("BuildingInCombat init failed: init texture failure!");
         return false;
     }
+    this->setTexture(texture);
+    this->setTextureRect(cocos2d::Rect(cocos2d::Vec2::ZERO, texture->getContentSize()));
 
     map_ = map;
     // 只有在map_不为nullptr时才调用addToWorld
@@ -54,8 +77,7 @@ bool BuildingInCombat::Init(const Building* building_template,MapManager* map) {
     this->setAnchorPoint(this->building_template_->getAnchorPoint());
 
 
-    auto building_size = this->getContentSize();
-    hp_bar_ = HpBarComponents::createHpBar(this,building_size.height);
+    hp_bar_.reset(this->getContentSize().height);
 
     CCLOG("Building init success");
     return true;
@@ -68,6 +90,9 @@ bool BuildingInCombat::TakeDamage(int damage) {
         current_health_ = 0;
     }
     hp_bar_.updateHp(current_health_,this->building_template_->GetHealth());
+    if (auto manager = CombatManager::GetInstance()) {
+        manager->UpdateBuildingChecksum(this);
+    }
     if(current_health_==0) {
         Die();
         return false;
@@ -75,7 +100,29 @@ bool BuildingInCombat::TakeDamage(int damage) {
     return true;
 }
 
+void BuildingInCombat::SaveState(BuildingState& state) const {
+    state.template_ = building_template_;
+    state.handle_ = handle_;
+    state.health_ = current_health_;
+}
+
+void BuildingInCombat::RestoreState(const BuildingState& state) {
+    current_health_ = state.health_;
+    hp_bar_.updateHp(current_health_, building_template_->GetHealth());
+}
+
+void BuildingInCombat::Recycle() {
+    this->stopAllActions();
+    subscribers.clear();
+    map_ = nullptr;
+    this->removeFromParent();
+}
+
 AttackBuildingInCombat* AttackBuildingInCombat::Create(const Building* building_template, MapManager* map) {
+    auto pooled = CombatEntityPool::GetInstance()->AcquireAttackBuilding();
+    if (pooled) {
+        return pooled->Spawn(building_template, map) ? pooled : nullptr;
+    }
     auto soldier = new (std::nothrow) AttackBuildingInCombat();
     if (soldier && soldier->Init(building_template, map)) {
         soldier->autorelease();  // Cocos2d-x自动内存管理
@@ -86,10 +133,20 @@ AttackBuildingInCombat* AttackBuildingInCombat::Create(const Building* building_
 }
 
 bool AttackBuildingInCombat::Init(const Building *building_template, MapManager *map) {
-    if(!BuildingInCombat::Init(building_template,map)){
+    return InitNode() && Spawn(building_template, map);
+}
+
+bool AttackBuildingInCombat::Spawn(const Building *building_template, MapManager *map) {
+    if(!BuildingInCombat::Spawn(building_template,map)){
         CCLOG("attack building father init failure");
         return false;
     }
+    target_ = CombatHandle();
+    attack_timer_ = 0.0f;
+    // 攻击音效种类只在上场时解析一次，攻击时只发布枚举
+    const auto& name = building_template->GetName();
+    attack_kind_ = name == "Archer Tower" ? BuildingAttackKind::ArcherTower
+                 : name == "Cannon" ? BuildingAttackKind::Cannon : BuildingAttackKind::Other;
 
     auto attack_building_template = dynamic_cast<const AttackBuilding*>(building_template);
     if(!attack_building_template){
@@ -105,50 +162,63 @@ bool AttackBuildingInCombat::Init(const Building *building_template, MapManager
     return true;
 }
 
+SoldierInCombat* AttackBuildingInCombat::GetCurrentTarget() const {
+    auto manager = CombatManager::GetInstance();
+    return manager ? manager->GetSoldier(target_) : nullptr;
+}
+
 void AttackBuildingInCombat::DealDamageToTarget() const {
-    if(current_target_) {
-        current_target_->TakeDamage(attack_damage_);  // 调用建筑的受伤害方法
-        CCLOG("current soldier health:%d", current_target_->GetCurrentHealth());
+    if(auto target = GetCurrentTarget()) {
+        target->TakeDamage(attack_damage_);  // 调用建筑的受伤害方法
+        TJ_LOG_DEBUG(LogCategory::Damage, "current soldier health:%d", target->GetCurrentHealth());
     }
 }
 
-void AttackBuildingInCombat::StartAttack() {
-    auto single_attack = cocos2d::CallFunc::create([this]() {
-        this->ChooseTarget();
-        if(current_target_) {
-            this->DealDamageToTarget();
-            AudioManager::getInstance()->playBuildingAttack(this->building_template_->GetName());
+bool AttackBuildingInCombat::AdvanceAttackTimer(float dt) {
+    attack_timer_ += dt;
+    if (attack_timer_ < attack_interval_) return false;
+    attack_timer_ -= attack_interval_;
+    return true;
+}
+
+CombatHandle AttackBuildingInCombat::SelectTarget(const SoldierSnapshot* soldiers, int count) const {
+    if(GetCurrentTarget()) return target_;
+    if(count <= 0) return CombatHandle();
+    // 与 std::min_element 相同：距离相等时取快照中靠前的士兵
+    int nearest = 0;
+    float nearest_distance = this->position_.distance(soldiers[0].position_);
+    for (int i = 1; i < count; ++i) {
+        float distance = this->position_.distance(soldiers[i].position_);
+        if (distance < nearest_distance) {
+            nearest = i;
+            nearest_distance = distance;
         }
-    });
-    // 单轮检测：延迟0.1秒 → 执行检测
-    auto single_check_loop = cocos2d::Sequence::create(
-            cocos2d::DelayTime::create(attack_interval_),
-            single_attack,
-            nullptr
-    );
-    auto repeat_attack = cocos2d::RepeatForever::create(single_check_loop);
-    this->runAction(repeat_attack);
-}
-
-void AttackBuildingInCombat::ChooseTarget(){
-    if(current_target_) return;
-    auto soldiers = CombatManager::GetInstance()->live_soldiers_;
-    if(soldiers.empty()) {
-        current_target_ = nullptr;
-        return;
     }
-    auto it = std::min_element(soldiers.begin(),soldiers.end(),
-                                                 [&](SoldierInCombat* a,SoldierInCombat* b){
-                                                     return this->position_.distance(a->position_)<this->position_.distance(b->position_);
-                                                 });
-    if (it != soldiers.end() && this->position_.distance((*it)->position_) <= attack_range_) {
-        current_target_ = *it;
-    }
-    else{
-        current_target_ = nullptr;
+    return nearest_distance <= attack_range_ ? soldiers[nearest].handle_ : CombatHandle();
+}
+
+void AttackBuildingInCombat::FireAt(CombatHandle target) {
+    target_ = target;
+    if(GetCurrentTarget()) {
+        this->DealDamageToTarget();
+        auto event = GameEvent::make(GameEventType::BuildingAttack);
+        event.building.kind = attack_kind_;
+        EventBus::getInstance()->publish(event);
     }
 }
 
+void AttackBuildingInCombat::SaveState(BuildingState& state) const {
+    BuildingInCombat::SaveState(state);
+    state.attack_timer_ = attack_timer_;
+    state.target_ = target_;
+}
+
+void AttackBuildingInCombat::RestoreState(const BuildingState& state) {
+    BuildingInCombat::RestoreState(state);
+    attack_timer_ = state.attack_timer_;
+    target_ = state.target_;
+}
+
 void BuildingInCombat::Die() {
     for(auto s:subscribers){
         s->stopAllActions();  // 目标死亡，停止当前攻击动作
@@ -164,31 +234,29 @@ void BuildingInCombat::Die() {
     if(former<50 && manager->destroy_degree_>=50) manager->stars_++;
     if(former<100 && manager->destroy_degree_==100) manager->stars_++;
     if(typeid(*building_template_)==typeid(TownHallTemplate)) manager->stars_++;
-    UIManager::getInstance()->updateDestructionPercent(manager->stars_, manager->destroy_degree_);   // 这里接口参数是星级和摧毁率，我这边先补一个1上去
+    auto destruction = GameEvent::make(GameEventType::DestructionChanged);
+    destruction.destruction = { manager->stars_, manager->destroy_degree_ };
+    EventBus::getInstance()->publish(destruction);
+    EventBus::getInstance()->publish(GameEventType::BuildingDestroyed);
 
-    CCLOG("live buildings:%d",manager->num_of_live_buildings_);
+    TJ_LOG_DEBUG(LogCategory::Combat, "%s destroyed, live buildings:%d", building_template_->GetName(),
+                 manager->num_of_live_buildings_);
     if(manager->IsCombatEnd()){
-        CCLOG("call EndCombat() from building");
+        TJ_LOG_INFO(LogCategory::Combat, "call EndCombat() from building");
         manager->EndCombat();
         return;
     }
 
-    auto it = find(manager->live_buildings_.begin(),manager->live_buildings_.end(),this);
-    if(it!=manager->live_buildings_.end()){
-        manager->live_buildings_.erase(it);
-    }
-    else{
-        CCLOG("dead building not found");
-    }
-
+    manager->GetPathCostField().OnBuildingRemoved(this);
+    manager->RemoveLiveBuilding(this);
     map_->updateEmptyBuildingGrids(this->building_template_);
 
+    // 订阅者在本 tick 交付寻路结果后统一重新选目标（CombatManager::RetargetSoldiers）
     for(auto s:subscribers){
-        s->DoAllMyActions();
+        manager->QueueRetarget(s);
     }
 
-    this->removeFromParent();
-    AudioManager::getInstance()->playBuildingDestroy();
+    CombatEntityPool::GetInstance()->ReleaseBuilding(this);
 }
 
 bool BuildingInCombat::IsBuildingShouldCount(const Building* b) {
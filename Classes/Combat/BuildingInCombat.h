@@ -9,50 +9,87 @@
 #include "Building/Building.h"
 #include "MapManager/MapManager.h"
 #include "UIManager/UIManager.h"
+#include "EventBus/GameEvent.h"
 #include "TownHall/TownHall.h"
 #include "TownHallTemplate/TownHallTemplate.h"
 #include "Combat.h"
+#include "CombatHandle.h"
+
+struct BuildingState;
 
 class BuildingInCombat : public cocos2d::Sprite{
 public:
     cocos2d::Vec2 position_;
     std::vector<SoldierInCombat*> subscribers;
     const Building* building_template_;
-    // 构造函数
-    static BuildingInCombat* Create(Building* building_template,MapManager* map);
+    CombatHandle handle_;        // 在 CombatManager 句柄表中的句柄，未上场时为空
+    int live_index_ = -1;        // 在 live_buildings_ 中的下标，用于 swap-and-pop 移除
+    // 构造函数（优先复用 CombatEntityPool 中的空闲节点）
+    static BuildingInCombat* Create(const Building* building_template,MapManager* map);
     // 析构函数
     ~BuildingInCombat() override;
 
     // 初始化函数
     virtual bool Init(const Building* building_template,MapManager* map);
+    // 上场：绑定模板、重置状态并加入地图，新建与复用共用
+    virtual bool Spawn(const Building* building_template,MapManager* map);
+    // 被对象池回收：停止动作并离开地图
+    void Recycle();
 
     // 被攻击函数
     virtual bool TakeDamage(int damage);
 
     void Die();
 
+    // 战斗快照：血量及防御建筑的攻击计时与目标（订阅者由 CombatManager 按句柄恢复）
+    virtual void SaveState(BuildingState& state) const;
+    virtual void RestoreState(const BuildingState& state);
+
     //判断建筑是否应该包括用于计算破坏度
     static bool IsBuildingShouldCount(const Building* b);
 
     int GetCurrentHealth() const{return current_health_;};
+protected:
+    bool InitNode();
 private:
     int current_health_;
     MapManager* map_;
     HpBarComponents hp_bar_;
 };
 
+// 防御建筑选目标时读取的士兵快照（每帧由 CombatManager 按 live_soldiers_ 顺序生成）
+struct SoldierSnapshot {
+    cocos2d::Vec2 position_;
+    CombatHandle handle_;
+};
+
 class AttackBuildingInCombat : public BuildingInCombat{
 public:
-    SoldierInCombat* current_target_;
+    int defense_index_ = -1;     // 在 CombatManager::live_defenses_ 中的下标
+    // 当前目标；目标士兵死亡后句柄自动失效，返回 nullptr
+    SoldierInCombat* GetCurrentTarget() const;
     static AttackBuildingInCombat* Create(const Building* building_template, MapManager* map);
     bool Init(const Building* building_template,MapManager* map) override;
-    void StartAttack();
+    bool Spawn(const Building* building_template,MapManager* map) override;
+
+    // 以下三步由 CombatManager::update 驱动，拆分后选目标可以并行执行
+    // 推进攻击计时，本帧应开火时返回 true（主线程）
+    bool AdvanceAttackTimer(float dt);
+    // 只读：沿用当前目标，否则在快照中取射程内最近的士兵（可在工作线程调用）
+    CombatHandle SelectTarget(const SoldierSnapshot* soldiers, int count) const;
+    // 锁定目标并结算伤害、发布攻击事件（主线程，按稳定顺序调用）
+    void FireAt(CombatHandle target);
+
+    void SaveState(BuildingState& state) const override;
+    void RestoreState(const BuildingState& state) override;
 private:
     int attack_damage_;
     float attack_range_,attack_interval_;
+    float attack_timer_ = 0.0f;
+    BuildingAttackKind attack_kind_ = BuildingAttackKind::Other;
+    CombatHandle target_;
 
     void DealDamageToTarget() const;
-    void ChooseTarget();
 };
 
 #endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_BUILDINGINCOMBAT_H
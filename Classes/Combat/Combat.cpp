@@ -2,8 +2,22 @@
 // Created by duby0 on 2025/12/7.
 //
 #include "Combat.h"
+#include "CombatEntityPool.h"
+#include "Profiler/GameProfiler.h"
+#include "JobSystem/JobSystem.h"
+#include "Simulation/SimulationTools.h"
+#include "EventBus/EventBus.h"
+#include <algorithm>
 
 CombatManager* CombatManager::instance_ = nullptr;
+bool CombatManager::use_unit_renderer_ = false;
+std::string CombatManager::checksum_trace_file_;
+// 高于 MapManager::updateYOrder 给建筑与士兵分配的 ZOrder
+static const int kUnitRendererZOrder = 4000;
+// 每个选目标任务处理的防御建筑数，少于该数量时不派发到工作线程
+static const int kDefenseJobGrain = 8;
+// 每个重新选目标任务处理的士兵数
+static const int kRetargetJobGrain = 8;
 // Combat类的实现
 CombatManager* CombatManager::InitializeInstance(MapManager* map) {
     // 若已创建，直接返回现有实例（避免重复初始化）
@@ -39,10 +53,17 @@ CombatManager* CombatManager::GetInstance() {
 
 CombatManager::~CombatManager(){
     DestroyInstance();
+    CC_SAFE_RELEASE_NULL(tick_actions_);
 }
 
 void CombatManager::DestroyInstance(){
     if (instance_) {
+        // 未经 EndCombat 直接销毁（如切换到回放）时，把仍在场上的实体交还对象池
+        instance_->WriteChecksumTrace();
+        instance_->RecycleEntities();
+        // 先等在途寻路结束，工作线程不再访问 battle arena 后才能归还
+        instance_->path_requests_.Cancel();
+        instance_->ReleaseArenas();
         instance_->map_ = nullptr;
         instance_ = nullptr;
         CCLOG("Combat singleton destroyed!");
@@ -56,6 +77,8 @@ bool CombatManager::Init(MapManager* map){
         CCLOG("manager init failure : map is null");
         return false;
     }
+    tick_actions_ = new (std::nothrow) cocos2d::ActionManager();
+    if (!tick_actions_) return false;
 
     if(map->getAllBuildings().empty()){
         CCLOG("no building available");
@@ -63,18 +86,26 @@ bool CombatManager::Init(MapManager* map){
     for(auto building:map_->getAllBuildings()){
         if(typeid(*building)==typeid(AttackBuilding)){
             auto attack_b = AttackBuildingInCombat::Create(building,map_);
-            attack_b->StartAttack();
-            live_buildings_.push_back(attack_b);
+            AddLiveDefense(attack_b);
         }
         else {
             auto b = BuildingInCombat::Create(building, map_);
-            live_buildings_.push_back(b);
+            AddLiveBuilding(b);
         }
         if(BuildingInCombat::IsBuildingShouldCount(building)){
             buildings_should_count_++;
         }
         num_of_live_buildings_++;
     }
+    if (use_unit_renderer_) {
+        unit_renderer_ = AnimatedUnitRenderer::Create();
+        if (unit_renderer_) {
+            // 置于所有建筑与士兵节点之上
+            map_->addToWorld(unit_renderer_, kUnitRendererZOrder);
+        }
+    }
+    path_cost_field_.Build(map_, live_buildings_);
+    checksum_log_.interval_ = CombatChecksum::kDefaultInterval;
     destroy_degree_ = 0;
     state_ = CombatState::kReady;
     return true;
@@ -89,7 +120,10 @@ void CombatManager::StartCombat() {
 
     state_ = CombatState::kFighting;
     combat_time_ = 0.0f;
+    tick_accumulator_ = 0.0f;
     this->scheduleUpdate();
+    timeline_.clear();
+    SaveSnapshot(start_snapshot_);
     CCLOG("CombatManager started!");
 }
 
@@ -123,13 +157,26 @@ void CombatManager::EndCombat() {
     state_ = CombatState::kEnded;
     this->unscheduleUpdate(); // 停止帧检测
 
-    for(auto it:live_soldiers_){
-        it->stopAllActions();
-        it->removeFromParent();
+    // 终局检查点：记录结束时的状态，随录像交给 UIManager
+    RecordChecksum();
+    UIManager::getInstance()->recordChecksums(checksum_log_);
+    if (!UIManager::getInstance()->isInReplayMode()) {
+        SimulationTools::recordAttack(UIManager::getInstance()->getRecordedSteps(), stars_, destroy_degree_);
     }
-    for(auto it:live_buildings_){
-        it->stopAllActions();
-        it->removeFromParent();
+
+    if (keep_after_end_) {
+        // 建筑留在场上，恢复快照时直接复用；士兵的动作仍在运行，先交还对象池
+        RecycleSoldiers();
+        path_requests_.Discard();
+        UIManager::getInstance()->endBattle(stars_, destroy_degree_);
+        CCLOG("CombatManager EndCombat() finished, kept for restart");
+        return;
+    }
+
+    RecycleEntities();
+    if (unit_renderer_) {
+        unit_renderer_->removeFromParent();
+        unit_renderer_ = nullptr;
     }
     this->removeFromParent();
     UIManager::getInstance()->endBattle(stars_, destroy_degree_);
@@ -137,20 +184,37 @@ void CombatManager::EndCombat() {
     CCLOG("CombatManager EndCombat() finished");
 }
 
-// 每帧更新：核心检测逻辑（Cocos 帧循环驱动）
+// 每帧更新：把帧间隔折算成固定步长的 tick（Cocos 帧循环驱动）
 void CombatManager::update(float dt) {
+    PROFILE_SCOPE(ProfileZone::CombatUpdate);
     if (state_ != CombatState::kFighting){
         CCLOG("Update() when not fighting");
         return;
     }
 
-    combat_time_ += dt;
-    
+    const float step = one_tick_per_frame_ ? kFixedTickDt : dt;
+    tick_accumulator_ = std::min(tick_accumulator_ + step, kFixedTickDt * kMaxTicksPerFrame);
+    while (tick_accumulator_ >= kFixedTickDt && state_ == CombatState::kFighting) {
+        tick_accumulator_ -= kFixedTickDt;
+        Tick();
+    }
+
     // 更新UI
-    UIManager::getInstance()->update(dt);
+    if (state_ == CombatState::kFighting) UIManager::getInstance()->update(dt);
+}
 
-    // 驱动回放逻辑（如果是回放模式）
-    UIManager::getInstance()->updateReplay();
+// 一个固定步长：先推进士兵动作（与 Director 先执行 ActionManager 再执行节点 update 的顺序一致），再结算战斗逻辑
+void CombatManager::Tick() {
+    tick_actions_->update(kFixedTickDt);
+    // 动作回调里可能已经结束战斗
+    if (state_ != CombatState::kFighting) return;
+
+    combat_time_ += kFixedTickDt;
+    combat_tick_++;
+    tick_scratch_.Reset();
+    path_requests_.ApplyResults();
+    RetargetSoldiers();
+    TickDefenses(kFixedTickDt);
 
     if (combat_time_ >= kMaxCombatTime) {
         EndCombat();
@@ -162,6 +226,358 @@ void CombatManager::update(float dt) {
         EndCombat();
         return; // 已结束，无需后续逻辑
     }
+
+    // 本帧新提交的寻路在渲染期间由工作线程搜索，下一帧开始时交付
+    path_requests_.Dispatch(path_cost_field_, battle_arena_);
+
+    if (combat_tick_ % checksum_log_.interval_ == 0) {
+        RecordChecksum();
+    }
+
+    // 驱动回放逻辑（如果是回放模式）：放在 tick 末尾，与实战中玩家在两次 update 之间部署的时机一致
+    UIManager::getInstance()->updateReplay();
+
+    if (snapshot_interval_ > 0 && combat_tick_ % snapshot_interval_ == 0) {
+        timeline_.emplace_back();
+        SaveSnapshot(timeline_.back());
+    }
+}
+
+void CombatManager::onExit() {
+    cocos2d::Node::onExit();
+    // 保留到战斗结束之后的管理器随场景一起退出，此时再销毁单例
+    if (keep_after_end_ && instance_ == this) {
+        DestroyInstance();
+    }
+}
+
+void CombatManager::SaveSnapshot(CombatSnapshot& snapshot) {
+    snapshot.tick_ = combat_tick_;
+    snapshot.time_ = combat_time_;
+    snapshot.stars_ = stars_;
+    snapshot.destroy_degree_ = destroy_degree_;
+    snapshot.buildings_should_count_destroyed_ = buildings_should_count_destroyed_;
+    snapshot.num_of_live_soldiers_ = num_of_live_soldiers_;
+    snapshot.num_of_live_buildings_ = num_of_live_buildings_;
+
+    snapshot.path_points_.clear();
+    snapshot.soldiers_.resize(live_soldiers_.size());
+    for (size_t i = 0; i < live_soldiers_.size(); ++i) {
+        live_soldiers_[i]->SaveState(snapshot.soldiers_[i], snapshot.path_points_);
+    }
+    snapshot.subscribers_.clear();
+    snapshot.buildings_.resize(live_buildings_.size());
+    for (size_t i = 0; i < live_buildings_.size(); ++i) {
+        auto& state = snapshot.buildings_[i];
+        live_buildings_[i]->SaveState(state);
+        state.subscribers_begin_ = static_cast<uint32_t>(snapshot.subscribers_.size());
+        for (auto soldier : live_buildings_[i]->subscribers) {
+            if (!soldier->handle_.IsNull()) snapshot.subscribers_.push_back(soldier->handle_);
+        }
+        state.subscribers_count_ = static_cast<uint32_t>(snapshot.subscribers_.size()) - state.subscribers_begin_;
+    }
+    snapshot.defenses_.clear();
+    for (auto defense : live_defenses_) {
+        snapshot.defenses_.push_back(defense->handle_);
+    }
+    soldier_handles_.SaveState(snapshot.soldier_handles_);
+    building_handles_.SaveState(snapshot.building_handles_);
+    path_requests_.SaveState(snapshot.path_requests_);
+
+    snapshot.checksum_ = checksum_;
+    snapshot.checksum_log_ = checksum_log_;
+    snapshot.next_expected_checkpoint_ = next_expected_checkpoint_;
+    snapshot.desync_tick_ = desync_tick_;
+    snapshot.checksum_trace_length_ = checksum_trace_.size();
+    snapshot.deploy_ = UIManager::getInstance()->captureDeployState();
+}
+
+bool CombatManager::RestoreSnapshot(const CombatSnapshot& snapshot) {
+    if (state_ == CombatState::kWrongInit || !snapshot.IsValid() || !map_) {
+        CCLOG("CombatManager: cannot restore snapshot");
+        return false;
+    }
+
+    // 1. 先等在途寻路结束，再回收全部士兵（按快照重新上场）
+    path_requests_.Discard();
+    RecycleSoldiers();
+
+    // 2. 建筑：快照中存活的沿用现有节点或从对象池重新上场，快照中已摧毁的离场
+    std::unordered_map<const Building*, BuildingInCombat*> on_field;
+    for (auto building : live_buildings_) {
+        on_field[building->building_template_] = building;
+    }
+    std::unordered_map<const Building*, bool> alive_in_snapshot;
+    for (const auto& state : snapshot.buildings_) {
+        alive_in_snapshot[state.template_] = true;
+    }
+    auto pool = CombatEntityPool::GetInstance();
+    for (auto building : live_buildings_) {
+        if (alive_in_snapshot.count(building->building_template_)) continue;
+        on_field.erase(building->building_template_);
+        map_->updateEmptyBuildingGrids(building->building_template_);
+        building->handle_ = CombatHandle();
+        building->live_index_ = -1;
+        pool->ReleaseBuilding(building);
+    }
+    for (auto defense : live_defenses_) {
+        defense->defense_index_ = -1;
+    }
+    live_buildings_.clear();
+    live_defenses_.clear();
+    template_handles_.clear();
+
+    building_handles_.RestoreState(snapshot.building_handles_);
+    soldier_handles_.RestoreState(snapshot.soldier_handles_);
+    for (const auto& state : snapshot.buildings_) {
+        BuildingInCombat* building = nullptr;
+        auto it = on_field.find(state.template_);
+        if (it != on_field.end()) {
+            building = it->second;
+        } else {
+            if (typeid(*state.template_) == typeid(AttackBuilding)) {
+                building = AttackBuildingInCombat::Create(state.template_, map_);
+            } else {
+                building = BuildingInCombat::Create(state.template_, map_);
+            }
+            if (!building) {
+                CCLOG("CombatManager: failed to restore building %s", state.template_->GetName().c_str());
+                continue;
+            }
+            map_->restoreBuildingGrids(state.template_);
+        }
+        building->handle_ = state.handle_;
+        building->live_index_ = static_cast<int>(live_buildings_.size());
+        building->subscribers.clear();
+        building->RestoreState(state);
+        live_buildings_.push_back(building);
+        building_handles_.Place(state.handle_, building);
+        template_handles_[state.template_] = state.handle_;
+    }
+    for (auto handle : snapshot.defenses_) {
+        auto building = building_handles_.Get(handle);
+        if (!building || typeid(*building) != typeid(AttackBuildingInCombat)) continue;
+        auto defense = static_cast<AttackBuildingInCombat*>(building);
+        defense->defense_index_ = static_cast<int>(live_defenses_.size());
+        live_defenses_.push_back(defense);
+    }
+
+    // 3. 士兵：按 live_soldiers_ 的顺序上场，再恢复目标与订阅顺序
+    for (const auto& state : snapshot.soldiers_) {
+        auto soldier = SoldierInCombat::Restore(state, map_);
+        if (!soldier) {
+            CCLOG("CombatManager: failed to restore soldier");
+            continue;
+        }
+        soldier->handle_ = state.handle_;
+        soldier->live_index_ = static_cast<int>(live_soldiers_.size());
+        soldier->current_target_ = building_handles_.Get(state.target_);
+        live_soldiers_.push_back(soldier);
+        soldier_handles_.Place(state.handle_, soldier);
+    }
+    for (const auto& state : snapshot.buildings_) {
+        auto building = building_handles_.Get(state.handle_);
+        if (!building) continue;
+        for (uint32_t i = 0; i < state.subscribers_count_; ++i) {
+            if (auto soldier = soldier_handles_.Get(snapshot.subscribers_[state.subscribers_begin_ + i])) {
+                building->subscribers.push_back(soldier);
+            }
+        }
+    }
+
+    // 4. 计数、计时与校验
+    combat_tick_ = snapshot.tick_;
+    combat_time_ = snapshot.time_;
+    tick_accumulator_ = 0.0f;
+    stars_ = snapshot.stars_;
+    destroy_degree_ = snapshot.destroy_degree_;
+    buildings_should_count_destroyed_ = snapshot.buildings_should_count_destroyed_;
+    num_of_live_soldiers_ = snapshot.num_of_live_soldiers_;
+    num_of_live_buildings_ = snapshot.num_of_live_buildings_;
+    checksum_ = snapshot.checksum_;
+    checksum_log_ = snapshot.checksum_log_;
+    next_expected_checkpoint_ = snapshot.next_expected_checkpoint_;
+    desync_tick_ = snapshot.desync_tick_;
+    if (checksum_trace_.size() > snapshot.checksum_trace_length_) {
+        checksum_trace_.resize(snapshot.checksum_trace_length_);
+    }
+
+    // 5. 代价场按恢复后的建筑与地图占位重新构建（版本递增，寻路快照整体刷新），
+    //    寻路队列的在途批次按它立即重新派发
+    path_cost_field_.Build(map_, live_buildings_);
+    tick_scratch_.Reset();
+    path_requests_.RestoreState(snapshot.path_requests_, soldier_handles_, path_cost_field_, battle_arena_);
+
+    // 6. 按原先在 ActionManager 中的先后重建士兵动作
+    std::vector<const SoldierState*> by_order;
+    by_order.reserve(snapshot.soldiers_.size());
+    for (const auto& state : snapshot.soldiers_) {
+        by_order.push_back(&state);
+    }
+    std::stable_sort(by_order.begin(), by_order.end(), [](const SoldierState* a, const SoldierState* b) {
+        return a->action_order_ < b->action_order_;
+    });
+    for (auto state : by_order) {
+        if (auto soldier = soldier_handles_.Get(state->handle_)) {
+            soldier->ResumeState(*state, snapshot.path_points_.data());
+        }
+    }
+
+    // 7. UI 与帧循环
+    UIManager::getInstance()->restoreDeployState(snapshot.deploy_);
+    auto destruction = GameEvent::make(GameEventType::DestructionChanged);
+    destruction.destruction = { stars_, destroy_degree_ };
+    EventBus::getInstance()->publish(destruction);
+    while (!timeline_.empty() && timeline_.back().tick_ > snapshot.tick_) {
+        timeline_.pop_back();
+    }
+    if (state_ != CombatState::kFighting) {
+        state_ = CombatState::kFighting;
+        this->scheduleUpdate();
+    }
+    CCLOG("CombatManager: restored snapshot of tick %d (%d soldiers, %d buildings)", snapshot.tick_,
+          static_cast<int>(live_soldiers_.size()), static_cast<int>(live_buildings_.size()));
+    return true;
+}
+
+bool CombatManager::RewindTo(int tick) {
+    const CombatSnapshot* target = &start_snapshot_;
+    for (auto it = timeline_.rbegin(); it != timeline_.rend(); ++it) {
+        if (it->tick_ <= tick) {
+            target = &*it;
+            break;
+        }
+    }
+    return RestoreSnapshot(*target);
+}
+
+uint64_t CombatManager::GetStateHash() {
+    // 士兵位置每帧都在变，取哈希时统一刷新；未变化的记录不会改动总和
+    for (auto soldier : live_soldiers_) {
+        CombatEntityRecord record;
+        record.kind_ = CombatEntityKind::kSoldier;
+        record.index_ = soldier->handle_.index_;
+        record.generation_ = soldier->handle_.generation_;
+        record.type_ = static_cast<int>(soldier->soldier_template_->GetSoldierType());
+        record.hp_ = soldier->GetCurrentHealth();
+        const auto pos = map_->worldToVec(soldier->getPosition());
+        record.qx_ = CombatChecksum::QuantizePosition(pos.x);
+        record.qy_ = CombatChecksum::QuantizePosition(pos.y);
+        auto target = soldier->current_target_;
+        record.target_ = (target && !target->handle_.IsNull()) ? target->handle_.index_ + 1 : 0;
+        checksum_.SetEntity(record);
+    }
+    return checksum_.MakeCheckpointHash(combat_tick_, stars_, destroy_degree_);
+}
+
+void CombatManager::UpdateBuildingChecksum(BuildingInCombat* building) {
+    if (building->handle_.IsNull()) return;
+    CombatEntityRecord record;
+    record.kind_ = CombatEntityKind::kBuilding;
+    record.index_ = building->handle_.index_;
+    record.generation_ = building->handle_.generation_;
+    record.hp_ = building->GetCurrentHealth();
+    record.qx_ = CombatChecksum::QuantizePosition(building->position_.x);
+    record.qy_ = CombatChecksum::QuantizePosition(building->position_.y);
+    checksum_.SetEntity(record);
+}
+
+void CombatManager::RecordChecksum() {
+    auto& checkpoints = checksum_log_.checkpoints_;
+    if (!checkpoints.empty() && checkpoints.back().tick_ == combat_tick_) return;
+    const uint64_t hash = GetStateHash();
+    checkpoints.push_back({ combat_tick_, hash });
+    if (!checksum_trace_file_.empty()) {
+        checksum_.AppendTrace(checksum_trace_, combat_tick_, hash);
+    }
+
+    // 回放比对：期望检查点按 tick 升序，只报告第一个不一致的 tick
+    const auto& expected = expected_checksums_.checkpoints_;
+    while (next_expected_checkpoint_ < expected.size() && expected[next_expected_checkpoint_].tick_ < combat_tick_) {
+        ++next_expected_checkpoint_;
+    }
+    if (next_expected_checkpoint_ < expected.size() && expected[next_expected_checkpoint_].tick_ == combat_tick_) {
+        if (expected[next_expected_checkpoint_].hash_ != hash && desync_tick_ < 0) {
+            desync_tick_ = combat_tick_;
+            CCLOG("CombatManager: replay diverged from the recorded battle at tick %d", combat_tick_);
+        }
+        ++next_expected_checkpoint_;
+    }
+}
+
+void CombatManager::WriteChecksumTrace() {
+    if (checksum_trace_file_.empty() || checksum_trace_.empty()) return;
+    auto file_utils = cocos2d::FileUtils::getInstance();
+    std::string path = checksum_trace_file_ + (expected_checksums_.Empty() ? "" : ".replay");
+    if (!file_utils->isAbsolutePath(path)) path = file_utils->getWritablePath() + path;
+    if (file_utils->writeStringToFile(checksum_trace_, path)) {
+        CCLOG("CombatManager: checksum trace written to %s", path.c_str());
+    } else {
+        CCLOG("CombatManager: failed to write checksum trace %s", path.c_str());
+    }
+    checksum_trace_.clear();
+}
+
+void CombatManager::TickDefenses(float dt) {
+    const int defense_count = static_cast<int>(live_defenses_.size());
+    if (defense_count == 0) return;
+
+    // 推进攻击计时，收集本帧开火的防御建筑
+    int* firing = tick_scratch_.NewArray<int>(defense_count);
+    int firing_count = 0;
+    for (int i = 0; i < defense_count; ++i) {
+        if (live_defenses_[i]->AdvanceAttackTimer(dt)) firing[firing_count++] = i;
+    }
+    if (firing_count == 0) return;
+
+    PROFILE_SCOPE(ProfileZone::Targeting);
+    // 士兵死亡在动作回调中生效，结算阶段不会改变 live_soldiers_，快照在整个 tick 内有效
+    const int soldier_count = static_cast<int>(live_soldiers_.size());
+    auto soldiers = tick_scratch_.NewArray<SoldierSnapshot>(std::max(1, soldier_count));
+    for (int i = 0; i < soldier_count; ++i) {
+        soldiers[i].position_ = live_soldiers_[i]->position_;
+        soldiers[i].handle_ = live_soldiers_[i]->handle_;
+    }
+
+    // 并行阶段：只读快照与句柄表，每个分块只写自己的 targets 槽位
+    auto targets = tick_scratch_.NewArray<CombatHandle>(firing_count);
+    auto select = [&](int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            targets[k] = live_defenses_[firing[k]]->SelectTarget(soldiers, soldier_count);
+        }
+    };
+    JobSystem::getInstance()->parallelFor(firing_count, kDefenseJobGrain, select);
+
+    // 结算阶段：按 live_defenses_ 顺序扣血、发事件，与线程数无关
+    for (int k = 0; k < firing_count; ++k) {
+        live_defenses_[firing[k]]->FireAt(targets[k]);
+    }
+}
+
+void CombatManager::RetargetSoldiers() {
+    const int count = static_cast<int>(retarget_queue_.size());
+    if (count == 0) return;
+    PROFILE_SCOPE(ProfileZone::Targeting);
+    // 排队之后离场的士兵句柄已失效，跳过
+    auto soldiers = tick_scratch_.NewArray<SoldierInCombat*>(count);
+    auto targets = tick_scratch_.NewArray<BuildingInCombat*>(count);
+    for (int i = 0; i < count; ++i) {
+        soldiers[i] = soldier_handles_.Get(retarget_queue_[i]);
+    }
+    retarget_queue_.clear();
+
+    // 并行阶段：各士兵只读 live_buildings_ 与自身位置，选目标与其他士兵的选择无关，结果与串行一致
+    auto select = [&](int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            targets[k] = soldiers[k] ? soldiers[k]->SelectTarget(live_buildings_) : nullptr;
+        }
+    };
+    JobSystem::getInstance()->parallelFor(count, kRetargetJobGrain, select);
+
+    // 订阅与提交寻路按队列顺序进行，订阅者列表与寻路票号的先后与线程数无关
+    for (int k = 0; k < count; ++k) {
+        if (soldiers[k] && targets[k]) soldiers[k]->AttackTarget(targets[k]);
+    }
 }
 
 //在接收到交互指令后，将士兵加入到战斗中；
@@ -177,10 +593,110 @@ void CombatManager::SendSoldier(const Soldier* soldier_template, cocos2d::Vec2 s
         return;
     }
 
-    live_soldiers_.push_back(soldier);
+    AddLiveSoldier(soldier);
     num_of_live_soldiers_++;
 }
 
+void CombatManager::AddLiveSoldier(SoldierInCombat* soldier) {
+    soldier->handle_ = soldier_handles_.Add(soldier);
+    soldier->live_index_ = static_cast<int>(live_soldiers_.size());
+    live_soldiers_.push_back(soldier);
+}
+
+void CombatManager::RemoveLiveSoldier(SoldierInCombat* soldier) {
+    const int index = soldier->live_index_;
+    if (index < 0 || index >= static_cast<int>(live_soldiers_.size()) || live_soldiers_[index] != soldier) {
+        CCLOG("dead soldier not found");
+        return;
+    }
+    live_soldiers_[index] = live_soldiers_.back();
+    live_soldiers_[index]->live_index_ = index;
+    live_soldiers_.pop_back();
+    checksum_.RemoveEntity(CombatEntityKind::kSoldier, soldier->handle_.index_);
+    soldier_handles_.Remove(soldier->handle_);
+    soldier->handle_ = CombatHandle();
+    soldier->live_index_ = -1;
+}
+
+void CombatManager::AddLiveBuilding(BuildingInCombat* building) {
+    building->handle_ = building_handles_.Add(building);
+    building->live_index_ = static_cast<int>(live_buildings_.size());
+    live_buildings_.push_back(building);
+    template_handles_[building->building_template_] = building->handle_;
+    UpdateBuildingChecksum(building);
+}
+
+void CombatManager::AddLiveDefense(AttackBuildingInCombat* defense) {
+    defense->defense_index_ = static_cast<int>(live_defenses_.size());
+    live_defenses_.push_back(defense);
+    AddLiveBuilding(defense);
+}
+
+void CombatManager::RemoveLiveBuilding(BuildingInCombat* building) {
+    if (typeid(*building) == typeid(AttackBuildingInCombat)) {
+        auto defense = static_cast<AttackBuildingInCombat*>(building);
+        const int slot = defense->defense_index_;
+        if (slot >= 0 && slot < static_cast<int>(live_defenses_.size()) && live_defenses_[slot] == defense) {
+            live_defenses_[slot] = live_defenses_.back();
+            live_defenses_[slot]->defense_index_ = slot;
+            live_defenses_.pop_back();
+        }
+        defense->defense_index_ = -1;
+    }
+    const int index = building->live_index_;
+    if (index < 0 || index >= static_cast<int>(live_buildings_.size()) || live_buildings_[index] != building) {
+        CCLOG("dead building not found");
+        return;
+    }
+    live_buildings_[index] = live_buildings_.back();
+    live_buildings_[index]->live_index_ = index;
+    live_buildings_.pop_back();
+    template_handles_.erase(building->building_template_);
+    checksum_.RemoveEntity(CombatEntityKind::kBuilding, building->handle_.index_);
+    building_handles_.Remove(building->handle_);
+    building->handle_ = CombatHandle();
+    building->live_index_ = -1;
+}
+
+BuildingInCombat* CombatManager::FindBuilding(const Building* building_template) const {
+    auto it = template_handles_.find(building_template);
+    return it != template_handles_.end() ? building_handles_.Get(it->second) : nullptr;
+}
+
+void CombatManager::RecycleSoldiers() {
+    auto pool = CombatEntityPool::GetInstance();
+    for(auto it:live_soldiers_){
+        it->handle_ = CombatHandle();
+        it->live_index_ = -1;
+        pool->ReleaseSoldier(it);
+    }
+    live_soldiers_.clear();
+    soldier_handles_.Clear();
+    retarget_queue_.clear();
+}
+
+void CombatManager::RecycleEntities() {
+    RecycleSoldiers();
+    auto pool = CombatEntityPool::GetInstance();
+    for(auto it:live_buildings_){
+        it->handle_ = CombatHandle();
+        it->live_index_ = -1;
+        pool->ReleaseBuilding(it);
+    }
+    for(auto it:live_defenses_){
+        it->defense_index_ = -1;
+    }
+    live_buildings_.clear();
+    live_defenses_.clear();
+    building_handles_.Clear();
+    template_handles_.clear();
+}
+
+void CombatManager::ReleaseArenas() {
+    tick_scratch_.Release();
+    battle_arena_.Release();
+}
+
 bool CombatManager::IsCombatEnd() {
     if((num_of_live_soldiers_==0 && UIManager::getInstance()->areAllTroopsDeployed())|| destroy_degree_==100) {
         return true;
@@ -11,8 +11,19 @@
 #include "Building/Building.h"
 #include "Soldier/Soldier.h"
 #include "MapManager/MapManager.h"
+#include "TownHall/BattleStats.h"
 #include "SoldierInCombat.h"
 #include "BuildingInCombat.h"
+#include "AnimatedUnitRenderer.h"
+#include "PathCostField.h"
+#include "CombatHandle.h"
+#include "CombatArena.h"
+#include "PathRequestQueue.h"
+#include "CombatChecksum.h"
+#include "CombatSnapshot.h"
+#include <unordered_map>
+
+class AttackBuildingInCombat;
 
 enum class CombatState {
     kWrongInit,//初始化失败
@@ -27,7 +38,22 @@ class CombatManager :public cocos2d::Node {
 public:
     std::vector<BuildingInCombat*> live_buildings_;
     std::vector<SoldierInCombat*> live_soldiers_;
+    std::vector<AttackBuildingInCombat*> live_defenses_;  // live_buildings_ 中的防御建筑，每帧驱动攻击
     int num_of_live_soldiers_ = 0,num_of_live_buildings_ = 0;
+
+    // 实体登记：加入 live_* 并分配句柄；移除为 swap-and-pop，同时使句柄失效
+    void AddLiveSoldier(SoldierInCombat* soldier);
+    void RemoveLiveSoldier(SoldierInCombat* soldier);
+    void AddLiveBuilding(BuildingInCombat* building);
+    void AddLiveDefense(AttackBuildingInCombat* defense);   // 同时登记到 live_buildings_
+    void RemoveLiveBuilding(BuildingInCombat* building);
+    // 目标被摧毁的士兵：留到本 tick 交付寻路结果之后，与其他士兵一起并行选目标
+    void QueueRetarget(SoldierInCombat* soldier) { retarget_queue_.push_back(soldier->handle_); }
+    // 按句柄取实体，句柄失效时返回 nullptr
+    SoldierInCombat* GetSoldier(CombatHandle handle) const { return soldier_handles_.Get(handle); }
+    BuildingInCombat* GetBuilding(CombatHandle handle) const { return building_handles_.Get(handle); }
+    // MapManager 中的建筑模板 → 对应的战斗建筑（已摧毁返回 nullptr）
+    BuildingInCombat* FindBuilding(const Building* building_template) const;
     int stars_ = 0,destroy_degree_ = 0,buildings_should_count_=0,buildings_should_count_destroyed_=0;
 
     static CombatManager* InitializeInstance(MapManager* map); // 初始化单例（仅第一次调用有效）
@@ -45,6 +71,57 @@ public:
     // 获取当前战斗已持续的时间
     float getCombatTime() const { return combat_time_; }
     float getRemainingTime() const { return std::max(0.0f, kMaxCombatTime - combat_time_); }
+    // 已执行的固定步长 tick 数，回放按它对齐部署时机，校验按它对齐检查点
+    int getCombatTick() const { return combat_tick_; }
+    // 每个 tick 推进的战斗时间：帧间隔累积到一个步长才推进一次，与帧率无关，回放与快照恢复才能逐 tick 一致
+    static constexpr float kFixedTickDt = battle_stats::kFixedTickDt;
+    // 士兵动作不走 Director 的 ActionManager，由战斗在每个 tick 开始时按 kFixedTickDt 推进
+    cocos2d::ActionManager* GetTickActionManager() const { return tick_actions_; }
+    // 每帧恰好推进一个 tick，不再按真实帧间隔累积：压力测试用它让同一脚本每次跑出相同的战斗，
+    // 帧率只影响墙钟耗时，不影响战斗进程
+    void SetOneTickPerFrame(bool enable) { one_tick_per_frame_ = enable; }
+
+    // 当前 tick 的状态哈希（刷新士兵记录后计算，建筑记录随受伤/摧毁增量维护）
+    uint64_t GetStateHash();
+    // 建筑血量变化时更新其校验记录
+    void UpdateBuildingChecksum(BuildingInCombat* building);
+    // 本场战斗每 CombatChecksum::kDefaultInterval 个 tick 记录的检查点
+    const CombatChecksumLog& GetChecksumLog() const { return checksum_log_; }
+    // 回放时设置原战斗的检查点，逐点比对；第一个不一致的 tick 记入 GetDesyncTick（一致为 -1）
+    void SetExpectedChecksums(const CombatChecksumLog& log) { expected_checksums_ = log; }
+    int GetDesyncTick() const { return desync_tick_; }
+    // 非空时在战斗结束时把每个检查点的全部实体记录写入可写目录下的该文件（回放加 .replay 后缀）
+    static void SetChecksumTraceFile(const std::string& file_name) { checksum_trace_file_ = file_name; }
+
+    // 是否用 AnimatedUnitRenderer 批量绘制士兵（需在 InitializeInstance 前设置）。
+    // 批量绘制的士兵统一画在建筑之上，不再参与 Y 轴遮挡排序，适合大规模压力战斗
+    static void SetUseUnitRenderer(bool enable) { use_unit_renderer_ = enable; }
+    // 未启用批量绘制时返回 nullptr
+    AnimatedUnitRenderer* GetUnitRenderer() const { return unit_renderer_; }
+    // 本场战斗的寻路代价场（Init 时构建，建筑被摧毁时增量更新）
+    PathCostField& GetPathCostField() { return path_cost_field_; }
+    // 整场战斗存活的竞技场（EndCombat/DestroyInstance 时整体归还）
+    CombatArena& GetBattleArena() { return battle_arena_; }
+    // 帧内临时竞技场：每次 update 开始时复位，分配结果不得跨帧保存
+    CombatArena& GetTickScratch() { return tick_scratch_; }
+    // 异步寻路请求队列：update 开始时交付上一批结果，末尾派发新一批
+    PathRequestQueue& GetPathRequests() { return path_requests_; }
+    MapManager* GetMap() const { return map_; }
+    bool IsFighting() const { return state_ == CombatState::kFighting; }
+
+    // 战斗快照：只能在两次 update 之间调用（不能在士兵、建筑的回调里）。
+    // 恢复时复用场上的建筑节点与对象池中的士兵节点，不重新加载布局；已结束的战斗恢复后重新开始帧循环
+    void SaveSnapshot(CombatSnapshot& snapshot);
+    bool RestoreSnapshot(const CombatSnapshot& snapshot);
+    // StartCombat 时保存的开战快照，用于原地重来
+    const CombatSnapshot& GetStartSnapshot() const { return start_snapshot_; }
+    // 每 ticks 个 tick 在 update 末尾保存一份快照（0 关闭），供 RewindTo 回退
+    void SetSnapshotInterval(int ticks) { snapshot_interval_ = std::max(0, ticks); }
+    // 回到不晚于 tick 的最近一份快照（没有时回到开战），更晚的快照丢弃，重新推进时再保存
+    bool RewindTo(int tick);
+    // 战斗结束后保留管理器与场上建筑，不销毁单例，可以恢复开战快照原地重来；
+    // 管理器随场景退出时再销毁
+    void SetKeepAfterEnd(bool keep) { keep_after_end_ = keep; }
 
 
 protected:
@@ -53,15 +130,60 @@ protected:
     ~CombatManager() override;
     //初始化战场中的建筑，返回初始化结果
     bool Init(MapManager* map);
+    void onExit() override;
 
 private:
+    // 测试单独驱动 tick 中的各个阶段
+    friend class CombatTickTest;
+
     static CombatManager* instance_;
+    static bool use_unit_renderer_;
+    static std::string checksum_trace_file_;
     MapManager* map_ = nullptr;
+    AnimatedUnitRenderer* unit_renderer_ = nullptr;
+    PathCostField path_cost_field_;
+    CombatHandleTable<SoldierInCombat> soldier_handles_;
+    CombatHandleTable<BuildingInCombat> building_handles_;
+    std::unordered_map<const Building*, CombatHandle> template_handles_;
+    CombatArena battle_arena_;
+    CombatArena tick_scratch_;
+    PathRequestQueue path_requests_;
+    cocos2d::ActionManager* tick_actions_ = nullptr;
+    float tick_accumulator_ = 0.0f;
+    bool one_tick_per_frame_ = false;
     CombatState state_ = CombatState::kWrongInit;
     float combat_time_ = 0.0f;
+    int combat_tick_ = 0;
+    CombatChecksum checksum_;
+    CombatChecksumLog checksum_log_;
+    CombatChecksumLog expected_checksums_;
+    size_t next_expected_checkpoint_ = 0;
+    int desync_tick_ = -1;
+    std::string checksum_trace_;
+    std::vector<CombatHandle> retarget_queue_;   // 按建筑摧毁与订阅的先后
+    CombatSnapshot start_snapshot_;
+    std::vector<CombatSnapshot> timeline_;   // 按 tick 升序
+    int snapshot_interval_ = 0;
+    bool keep_after_end_ = false;
     const float kMaxCombatTime = 300.0f;
+    // 一帧最多追赶的 tick 数，卡顿更久时丢弃多出的时间（战斗变慢而不是越积越多）
+    static const int kMaxTicksPerFrame = 8;
 
+    // 按帧间隔累积，逐个执行固定步长的 Tick
     virtual void update(float dt) override;
+    void Tick();
+    // 防御建筑攻击：快照士兵位置 → 并行选目标 → 按 live_defenses_ 顺序串行结算
+    void TickDefenses(float dt);
+    // 士兵重新选目标：并行选出 retarget_queue_ 中每个士兵的目标 → 按队列顺序串行订阅并提交寻路
+    void RetargetSoldiers();
+    // 将场上剩余的士兵与建筑交还 CombatEntityPool
+    void RecycleEntities();
+    void RecycleSoldiers();
+    // 归还两个竞技场的全部内存
+    void ReleaseArenas();
+    // 到达检查点时记录哈希、与回放期望值比对并追加跟踪文本
+    void RecordChecksum();
+    void WriteChecksumTrace();
 };
 
 
@@ -8,5 +8,14 @@
 #include "SoldierInCombat.h"
 #include "BuildingInCombat.h"
 #include "HpBarUtils.h"
+#include "SoldierAnimation.h"
+#include "AnimatedUnitRenderer.h"
+#include "CombatEntityPool.h"
+#include "PathCostField.h"
+#include "CombatHandle.h"
+#include "CombatArena.h"
+#include "PathRequestQueue.h"
+#include "CombatChecksum.h"
+#include "CombatSnapshot.h"
 
 #endif // COMBAT_ALL_H
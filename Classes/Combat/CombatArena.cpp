@@ -0,0 +1,58 @@
+// CombatArena.cpp
+// 战斗内存竞技场实现
+
+#include "CombatArena.h"
+#include <algorithm>
+#include <cstdlib>
+
+void* CombatArena::Allocate(size_t size, size_t align) {
+    if (size == 0) size = 1;
+    while (true) {
+        if (current_ < blocks_.size()) {
+            Block& block = blocks_[current_];
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.data_);
+            const uintptr_t aligned = (base + offset_ + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+            const size_t end = static_cast<size_t>(aligned - base) + size;
+            if (end <= block.size_) {
+                offset_ = end;
+                return reinterpret_cast<void*>(aligned);
+            }
+            // 当前块放不下：复用下一个已有块
+            if (current_ + 1 < blocks_.size() && blocks_[current_ + 1].size_ >= size + align) {
+                ++current_;
+                offset_ = 0;
+                continue;
+            }
+        }
+
+        // 没有可复用的块：新块插在当前块之后，超大请求单独成块
+        const size_t block_size = std::max(block_size_, size + align);
+        char* data = static_cast<char*>(std::malloc(block_size));
+        if (!data) throw std::bad_alloc();
+        ++block_allocations_;
+        const size_t insert_at = blocks_.empty() ? 0 : current_ + 1;
+        blocks_.insert(blocks_.begin() + static_cast<std::ptrdiff_t>(insert_at), Block{ data, block_size });
+        current_ = insert_at;
+        offset_ = 0;
+    }
+}
+
+void CombatArena::Rewind(Marker marker) {
+    if (marker.block_ > current_ || (marker.block_ == current_ && marker.offset_ > offset_)) return;
+    current_ = marker.block_;
+    offset_ = marker.offset_;
+}
+
+void CombatArena::Release() {
+    for (auto& block : blocks_) std::free(block.data_);
+    blocks_.clear();
+    blocks_.shrink_to_fit();
+    current_ = 0;
+    offset_ = 0;
+}
+
+size_t CombatArena::GetBytesReserved() const {
+    size_t total = 0;
+    for (const auto& block : blocks_) total += block.size_;
+    return total;
+}
@@ -0,0 +1,111 @@
+// CombatArena.h
+// 战斗内存竞技场：单调递增的分块分配器，只整体回收（Reset/Release），不逐个释放。
+// CombatManager 持有两个实例：整场战斗存活的 battle arena 与每帧复位的 tick scratch，
+// 块在 Reset 后保留复用，稳态战斗帧内不再触发通用堆分配
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATARENA_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class CombatArena {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    // 回退点：Rewind 后其后分配的内存全部作废
+    struct Marker {
+        size_t block_ = 0;
+        size_t offset_ = 0;
+    };
+
+    explicit CombatArena(size_t block_size = kDefaultBlockSize) : block_size_(block_size) {}
+    ~CombatArena() { Release(); }
+    CombatArena(const CombatArena&) = delete;
+    CombatArena& operator=(const CombatArena&) = delete;
+
+    void* Allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    // 只允许平凡析构的类型：竞技场不会调用析构函数
+    template <typename T, typename... Args>
+    T* New(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "CombatArena never runs destructors");
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    T* NewArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "CombatArena never runs destructors");
+        T* data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; ++i) new (data + i) T();
+        return data;
+    }
+
+    Marker GetMarker() const { return { current_, offset_ }; }
+    void Rewind(Marker marker);
+
+    // 回到起点但保留所有块（每帧复位）
+    void Reset() { Rewind(Marker()); }
+    // 归还全部块（战斗结束）
+    void Release();
+
+    size_t GetBytesReserved() const;
+    size_t GetBlockCount() const { return blocks_.size(); }
+    // 从通用堆申请块的累计次数，稳态下应不再增长
+    uint64_t GetBlockAllocations() const { return block_allocations_; }
+
+private:
+    struct Block {
+        char* data_;
+        size_t size_;
+    };
+
+    size_t block_size_;
+    std::vector<Block> blocks_;
+    size_t current_ = 0;     // 当前块下标
+    size_t offset_ = 0;      // 当前块内已用字节
+    uint64_t block_allocations_ = 0;
+};
+
+// 标准容器适配器：deallocate 为空操作，内存随竞技场整体回收
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(CombatArena* arena) : arena_(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(arena_->Allocate(sizeof(T) * count, alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena_ == other.arena_; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena_ != other.arena_; }
+
+    CombatArena* arena_;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// 作用域回退：离开作用域时把竞技场回退到进入时的位置
+class ArenaScope {
+public:
+    explicit ArenaScope(CombatArena& arena) : arena_(arena), marker_(arena.GetMarker()) {}
+    ~ArenaScope() { arena_.Rewind(marker_); }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    CombatArena& arena_;
+    CombatArena::Marker marker_;
+};
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATARENA_H
@@ -0,0 +1,208 @@
+// CombatChecksum.cpp
+// 战斗状态校验实现
+
+#include "CombatChecksum.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace {
+const uint64_t kFnvOffset = 1469598103934665603ull;
+const uint64_t kFnvPrime = 1099511628211ull;
+
+// 按字节喂入 FNV-1a，字节序与平台无关
+void HashWord(uint64_t& hash, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= kFnvPrime;
+    }
+}
+
+// 求和前打散，避免相近记录的哈希相加后互相抵消
+uint64_t Mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+char KindTag(CombatEntityKind kind) {
+    return kind == CombatEntityKind::kSoldier ? 'S' : 'B';
+}
+
+struct TraceBlock {
+    int tick_ = -1;
+    std::string hash_;
+    std::map<std::pair<char, long>, std::string> entities_;
+};
+
+std::vector<TraceBlock> ParseTrace(const std::string& text) {
+    std::vector<TraceBlock> blocks;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.size() < 2) continue;
+        std::istringstream fields(line.substr(2));
+        if (line[0] == 'T') {
+            blocks.emplace_back();
+            fields >> blocks.back().tick_ >> blocks.back().hash_;
+        } else if (!blocks.empty() && (line[0] == 'S' || line[0] == 'B')) {
+            long index = -1;
+            fields >> index;
+            blocks.back().entities_[{ line[0], index }] = line;
+        }
+    }
+    return blocks;
+}
+}
+
+bool CombatEntityRecord::operator==(const CombatEntityRecord& other) const {
+    return kind_ == other.kind_ && index_ == other.index_ && generation_ == other.generation_ &&
+           type_ == other.type_ && hp_ == other.hp_ && qx_ == other.qx_ && qy_ == other.qy_ &&
+           target_ == other.target_;
+}
+
+uint64_t CombatEntityRecord::Hash() const {
+    uint64_t hash = kFnvOffset;
+    HashWord(hash, static_cast<uint32_t>(kind_));
+    HashWord(hash, index_);
+    HashWord(hash, generation_);
+    HashWord(hash, static_cast<uint32_t>(type_));
+    HashWord(hash, static_cast<uint32_t>(hp_));
+    HashWord(hash, static_cast<uint32_t>(qx_));
+    HashWord(hash, static_cast<uint32_t>(qy_));
+    HashWord(hash, target_);
+    return Mix(hash);
+}
+
+std::string CombatEntityRecord::ToString() const {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "%c %u %u %d %d %d %d %u", KindTag(kind_),
+             index_, generation_, type_, hp_, qx_, qy_, target_);
+    return buffer;
+}
+
+int CombatChecksumLog::FindFirstMismatch(const CombatChecksumLog& other) const {
+    const size_t count = std::min(checkpoints_.size(), other.checkpoints_.size());
+    for (size_t i = 0; i < count; ++i) {
+        if (checkpoints_[i].tick_ != other.checkpoints_[i].tick_ ||
+            checkpoints_[i].hash_ != other.checkpoints_[i].hash_) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::string DesyncReport::ToString() const {
+    if (!diverged_) return "no divergence";
+    return "first divergence at tick " + std::to_string(tick_) + ": " + entity_;
+}
+
+void CombatChecksum::Reset() {
+    soldiers_.clear();
+    buildings_.clear();
+    sum_ = 0;
+    entity_count_ = 0;
+}
+
+int CombatChecksum::QuantizePosition(float value) {
+    return static_cast<int>(std::lround(value * kPositionScale));
+}
+
+void CombatChecksum::SetEntity(const CombatEntityRecord& record) {
+    auto& slots = SlotsOf(record.kind_);
+    if (record.index_ >= slots.size()) slots.resize(record.index_ + 1);
+    auto& slot = slots[record.index_];
+    if (slot.used_) {
+        if (slot.record_ == record) return;
+        sum_ -= slot.hash_;
+    } else {
+        slot.used_ = true;
+        ++entity_count_;
+    }
+    slot.record_ = record;
+    slot.hash_ = record.Hash();
+    sum_ += slot.hash_;
+}
+
+void CombatChecksum::RemoveEntity(CombatEntityKind kind, uint32_t index) {
+    auto& slots = SlotsOf(kind);
+    if (index >= slots.size() || !slots[index].used_) return;
+    sum_ -= slots[index].hash_;
+    slots[index].used_ = false;
+    --entity_count_;
+}
+
+uint64_t CombatChecksum::MakeCheckpointHash(int tick, int stars, int destroy_degree) const {
+    uint64_t hash = kFnvOffset;
+    HashWord(hash, static_cast<uint32_t>(tick));
+    HashWord(hash, static_cast<uint32_t>(stars));
+    HashWord(hash, static_cast<uint32_t>(destroy_degree));
+    HashWord(hash, static_cast<uint32_t>(entity_count_));
+    return Mix(hash) ^ sum_;
+}
+
+void CombatChecksum::AppendTrace(std::string& out, int tick, uint64_t hash) const {
+    char header[64];
+    snprintf(header, sizeof(header), "T %d %016llx\n", tick, static_cast<unsigned long long>(hash));
+    out += header;
+    for (const auto* slots : { &soldiers_, &buildings_ }) {
+        for (const auto& slot : *slots) {
+            if (!slot.used_) continue;
+            out += slot.record_.ToString();
+            out += '\n';
+        }
+    }
+}
+
+DesyncReport CombatChecksum::DiffTraces(const std::string& a, const std::string& b) {
+    DesyncReport report;
+    const auto blocks_a = ParseTrace(a);
+    const auto blocks_b = ParseTrace(b);
+    const size_t count = std::min(blocks_a.size(), blocks_b.size());
+    for (size_t i = 0; i < count; ++i) {
+        const auto& block_a = blocks_a[i];
+        const auto& block_b = blocks_b[i];
+        if (block_a.tick_ == block_b.tick_ && block_a.hash_ == block_b.hash_) continue;
+
+        report.diverged_ = true;
+        report.tick_ = std::min(block_a.tick_, block_b.tick_);
+        if (block_a.tick_ != block_b.tick_) {
+            report.entity_ = "checkpoint ticks differ (" + std::to_string(block_a.tick_) + " vs " +
+                             std::to_string(block_b.tick_) + ")";
+            return report;
+        }
+        // 按 (种类, 槽位) 归并，取第一个记录不同或只在一侧存在的实体
+        auto it_a = block_a.entities_.begin();
+        auto it_b = block_b.entities_.begin();
+        while (it_a != block_a.entities_.end() || it_b != block_b.entities_.end()) {
+            if (it_b == block_b.entities_.end() || (it_a != block_a.entities_.end() && it_a->first < it_b->first)) {
+                report.entity_ = it_a->second + " vs <none>";
+                return report;
+            }
+            if (it_a == block_a.entities_.end() || it_b->first < it_a->first) {
+                report.entity_ = "<none> vs " + it_b->second;
+                return report;
+            }
+            if (it_a->second != it_b->second) {
+                report.entity_ = it_a->second + " vs " + it_b->second;
+                return report;
+            }
+            ++it_a;
+            ++it_b;
+        }
+        report.entity_ = "entity records match, battle result differs";
+        return report;
+    }
+    if (blocks_a.size() != blocks_b.size()) {
+        const auto& longer = blocks_a.size() > blocks_b.size() ? blocks_a : blocks_b;
+        report.diverged_ = true;
+        report.tick_ = longer[count].tick_;
+        report.entity_ = "one trace ends before this checkpoint";
+    }
+    return report;
+}
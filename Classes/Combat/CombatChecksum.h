@@ -0,0 +1,95 @@
+// CombatChecksum.h
+// 战斗状态校验：每个实体（按句柄槽位）维护一条规范化记录（量化位置、血量、目标）及其哈希，
+// 整体哈希为各实体哈希之和，与遍历顺序无关，实体变化时只替换它自己的那一项；
+// CombatManager 按固定 tick 间隔把检查点记入 CombatChecksumLog，随回放保存并在回放时逐点比对；
+// 开启跟踪时每个检查点还写出全部实体记录，DiffTraces 据此给出第一个分歧的 tick 与实体
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATCHECKSUM_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATCHECKSUM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class CombatEntityKind : uint8_t {
+    kSoldier = 1,
+    kBuilding = 2
+};
+
+// 参与校验的实体状态，所有字段都是整数，跨平台可比
+struct CombatEntityRecord {
+    CombatEntityKind kind_ = CombatEntityKind::kSoldier;
+    uint32_t index_ = 0;         // 句柄槽位
+    uint32_t generation_ = 0;    // 句柄代数
+    int type_ = 0;               // 兵种（建筑为 0）
+    int hp_ = 0;
+    int qx_ = 0;                 // 位置，单位 1/kPositionScale 格
+    int qy_ = 0;
+    uint32_t target_ = 0;        // 目标句柄槽位 + 1，0 表示没有目标
+
+    bool operator==(const CombatEntityRecord& other) const;
+    bool operator!=(const CombatEntityRecord& other) const { return !(*this == other); }
+    uint64_t Hash() const;
+    std::string ToString() const;
+};
+
+struct ChecksumCheckpoint {
+    int tick_ = 0;
+    uint64_t hash_ = 0;
+};
+
+struct CombatChecksumLog {
+    int interval_ = 0;           // 检查点间隔（tick），0 表示没有记录
+    std::vector<ChecksumCheckpoint> checkpoints_;
+
+    bool Empty() const { return checkpoints_.empty(); }
+    // 第一个 tick 或哈希不一致的检查点下标（只比较双方都有的部分），全部一致返回 -1
+    int FindFirstMismatch(const CombatChecksumLog& other) const;
+};
+
+// 两份跟踪文件的比对结果
+struct DesyncReport {
+    bool diverged_ = false;
+    int tick_ = -1;              // 第一个分歧的检查点 tick
+    std::string entity_;         // 第一个分歧的实体：双方的记录，缺失一侧记为 <none>
+    std::string ToString() const;
+};
+
+class CombatChecksum {
+public:
+    static constexpr int kDefaultInterval = 30;
+    static constexpr float kPositionScale = 16.0f;
+
+    void Reset();
+    // 新增或替换实体记录
+    void SetEntity(const CombatEntityRecord& record);
+    void RemoveEntity(CombatEntityKind kind, uint32_t index);
+    int GetEntityCount() const { return entity_count_; }
+
+    // 检查点哈希：实体哈希之和再混入 tick 与战斗结果
+    uint64_t MakeCheckpointHash(int tick, int stars, int destroy_degree) const;
+
+    // 以文本追加一个检查点及全部实体记录（先士兵后建筑，按槽位升序）
+    void AppendTrace(std::string& out, int tick, uint64_t hash) const;
+    // 比对两份 AppendTrace 生成的文本
+    static DesyncReport DiffTraces(const std::string& a, const std::string& b);
+
+    static int QuantizePosition(float value);
+
+private:
+    struct Slot {
+        bool used_ = false;
+        CombatEntityRecord record_;
+        uint64_t hash_ = 0;
+    };
+    std::vector<Slot>& SlotsOf(CombatEntityKind kind) {
+        return kind == CombatEntityKind::kSoldier ? soldiers_ : buildings_;
+    }
+
+    std::vector<Slot> soldiers_;
+    std::vector<Slot> buildings_;
+    uint64_t sum_ = 0;
+    int entity_count_ = 0;
+};
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATCHECKSUM_H
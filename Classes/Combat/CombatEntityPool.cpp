@@ -0,0 +1,104 @@
+// CombatEntityPool.cpp
+// 战斗实体对象池实现
+
+#include "CombatEntityPool.h"
+#include "SoldierInCombat.h"
+#include "BuildingInCombat.h"
+#include "Profiler/GameProfiler.h"
+
+CombatEntityPool* CombatEntityPool::instance_ = nullptr;
+
+CombatEntityPool* CombatEntityPool::GetInstance() {
+    if (!instance_) {
+        instance_ = new (std::nothrow) CombatEntityPool();
+    }
+    return instance_;
+}
+
+void CombatEntityPool::DestroyInstance() {
+    CC_SAFE_DELETE(instance_);
+}
+
+CombatEntityPool::~CombatEntityPool() {
+    Clear();
+}
+
+void CombatEntityPool::PrewarmSoldiers(const SoldierTemplate& soldier_template, int count) {
+    int type = static_cast<int>(soldier_template.type_);
+    if (type < 0 || type >= kTypeCount || !soldier_template.createFunc) return;
+    auto& idle = idle_soldiers_[type];
+    if (static_cast<int>(idle.size()) >= count) return;
+    PROFILE_SCOPE(ProfileZone::AssetLoad);
+
+    // 模板只在构建节点时使用，节点真正上场时由 Spawn 重新绑定
+    Soldier* prototype = soldier_template.createFunc();
+    idle.reserve(count);
+    while (static_cast<int>(idle.size()) < count) {
+        auto soldier = SoldierInCombat::CreateIdle(prototype);
+        if (!soldier) break;
+        idle.pushBack(soldier);
+    }
+    CC_SAFE_RELEASE(prototype);
+    CCLOG("CombatEntityPool: %d idle %s prewarmed", static_cast<int>(idle.size()), soldier_template.name_.c_str());
+}
+
+SoldierInCombat* CombatEntityPool::AcquireSoldier(SoldierType type) {
+    int index = static_cast<int>(type);
+    if (index < 0 || index >= kTypeCount || idle_soldiers_[index].empty()) return nullptr;
+    auto& idle = idle_soldiers_[index];
+    auto soldier = idle.back();
+    soldier->retain();
+    idle.popBack();
+    soldier->autorelease();
+    return soldier;
+}
+
+BuildingInCombat* CombatEntityPool::AcquireBuilding() {
+    if (idle_buildings_.empty()) return nullptr;
+    auto building = idle_buildings_.back();
+    building->retain();
+    idle_buildings_.popBack();
+    building->autorelease();
+    return building;
+}
+
+AttackBuildingInCombat* CombatEntityPool::AcquireAttackBuilding() {
+    if (idle_attack_buildings_.empty()) return nullptr;
+    auto building = idle_attack_buildings_.back();
+    building->retain();
+    idle_attack_buildings_.popBack();
+    building->autorelease();
+    return building;
+}
+
+void CombatEntityPool::ReleaseSoldier(SoldierInCombat* soldier) {
+    if (!soldier) return;
+    int index = static_cast<int>(soldier->soldier_template_->GetSoldierType());
+    // 先入池持有引用，再从父节点移除，避免节点在回调中被释放
+    idle_soldiers_[index].pushBack(soldier);
+    soldier->Recycle();
+}
+
+void CombatEntityPool::ReleaseBuilding(BuildingInCombat* building) {
+    if (!building) return;
+    if (typeid(*building) == typeid(AttackBuildingInCombat)) {
+        idle_attack_buildings_.pushBack(static_cast<AttackBuildingInCombat*>(building));
+    } else {
+        idle_buildings_.pushBack(building);
+    }
+    building->Recycle();
+}
+
+int CombatEntityPool::GetIdleSoldierCount(SoldierType type) const {
+    int index = static_cast<int>(type);
+    if (index < 0 || index >= kTypeCount) return 0;
+    return static_cast<int>(idle_soldiers_[index].size());
+}
+
+void CombatEntityPool::Clear() {
+    for (auto& idle : idle_soldiers_) {
+        idle.clear();
+    }
+    idle_buildings_.clear();
+    idle_attack_buildings_.clear();
+}
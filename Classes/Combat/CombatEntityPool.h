@@ -0,0 +1,48 @@
+// CombatEntityPool.h
+// 战斗实体对象池：回收死亡/战斗结束后的士兵与建筑节点（连同血条子节点），
+// 在下一次部署、下一场战斗或回放中直接复用，避免连续部署时反复构建 Sprite
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATENTITYPOOL_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATENTITYPOOL_H
+
+#include "cocos2d.h"
+#include "Soldier/Soldier.h"
+
+class SoldierInCombat;
+class BuildingInCombat;
+class AttackBuildingInCombat;
+
+class CombatEntityPool {
+public:
+    static CombatEntityPool* GetInstance();
+    static void DestroyInstance();
+
+    // 预热：保证指定兵种至少有 count 个空闲节点（在场景加载阶段调用）
+    void PrewarmSoldiers(const SoldierTemplate& soldier_template, int count);
+
+    // 取出空闲节点（已 autorelease），池中没有时返回 nullptr
+    SoldierInCombat* AcquireSoldier(SoldierType type);
+    BuildingInCombat* AcquireBuilding();
+    AttackBuildingInCombat* AcquireAttackBuilding();
+
+    // 回收：停止动作、从父节点移除并放回池中（调用方需保证同一节点只回收一次）
+    void ReleaseSoldier(SoldierInCombat* soldier);
+    void ReleaseBuilding(BuildingInCombat* building);
+
+    int GetIdleSoldierCount(SoldierType type) const;
+    void Clear();
+
+private:
+    CombatEntityPool() = default;
+    ~CombatEntityPool();
+
+    static CombatEntityPool* instance_;
+
+    static constexpr int kTypeCount = static_cast<int>(SoldierType::kSoldierTypes);
+
+    cocos2d::Vector<SoldierInCombat*> idle_soldiers_[kTypeCount];
+    cocos2d::Vector<BuildingInCombat*> idle_buildings_;
+    cocos2d::Vector<AttackBuildingInCombat*> idle_attack_buildings_;
+};
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATENTITYPOOL_H
@@ -0,0 +1,118 @@
+// CombatHandle.h
+// 战斗实体句柄：槽位下标 + 代数。实体被移除后槽位代数递增，
+// 旧句柄自动失效，持有方无需在实体死亡时被逐个通知清空
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATHANDLE_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATHANDLE_H
+
+#include <cstdint>
+#include <vector>
+
+struct CombatHandle {
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index_ = kInvalidIndex;
+    uint32_t generation_ = 0;
+
+    bool IsNull() const { return index_ == kInvalidIndex; }
+    bool operator==(const CombatHandle& other) const {
+        return index_ == other.index_ && generation_ == other.generation_;
+    }
+    bool operator!=(const CombatHandle& other) const { return !(*this == other); }
+};
+
+// 句柄表的槽位代数与空闲链表，不含实体指针（战斗快照用）
+struct CombatHandleTableState {
+    std::vector<uint32_t> generations_;
+    std::vector<uint32_t> free_;
+};
+
+// 句柄表：Add/Remove/Get 均为 O(1)，空闲槽位用空闲链表复用
+template <typename T>
+class CombatHandleTable {
+public:
+    CombatHandle Add(T* entity) {
+        uint32_t index;
+        if (!free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        slots_[index].entity_ = entity;
+        return { index, slots_[index].generation_ };
+    }
+
+    // 句柄已失效时返回 false
+    bool Remove(CombatHandle handle) {
+        if (!Get(handle)) return false;
+        Slot& slot = slots_[handle.index_];
+        slot.entity_ = nullptr;
+        ++slot.generation_;
+        free_.push_back(handle.index_);
+        return true;
+    }
+
+    // 句柄失效（实体已移除或槽位已被复用）时返回 nullptr
+    T* Get(CombatHandle handle) const {
+        if (handle.index_ >= slots_.size()) return nullptr;
+        const Slot& slot = slots_[handle.index_];
+        return slot.generation_ == handle.generation_ ? slot.entity_ : nullptr;
+    }
+
+    // 当前占用该槽位的实体（不校验代数）
+    T* GetAt(uint32_t index) const {
+        return index < slots_.size() ? slots_[index].entity_ : nullptr;
+    }
+
+    uint32_t GetCapacity() const { return static_cast<uint32_t>(slots_.size()); }
+
+    void SaveState(CombatHandleTableState& state) const {
+        state.generations_.resize(slots_.size());
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            state.generations_[i] = slots_[i].generation_;
+        }
+        state.free_ = free_;
+    }
+
+    // 恢复代数与空闲链表，所有槽位先置空，再由调用方用 Place 放回快照中的实体；
+    // 之后的 Add 分配到的槽位与代数和保存快照时一致
+    void RestoreState(const CombatHandleTableState& state) {
+        slots_.resize(state.generations_.size());
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            slots_[i].entity_ = nullptr;
+            slots_[i].generation_ = state.generations_[i];
+        }
+        free_ = state.free_;
+    }
+
+    // 把实体放回句柄所指的槽位（句柄须来自 RestoreState 所用的同一份快照）
+    void Place(CombatHandle handle, T* entity) {
+        if (handle.index_ < slots_.size() && slots_[handle.index_].generation_ == handle.generation_) {
+            slots_[handle.index_].entity_ = entity;
+        }
+    }
+
+    // 清空时保留代数，之前发出的句柄在新战斗中依旧无效
+    void Clear() {
+        free_.clear();
+        for (uint32_t i = static_cast<uint32_t>(slots_.size()); i-- > 0;) {
+            if (slots_[i].entity_) {
+                slots_[i].entity_ = nullptr;
+                ++slots_[i].generation_;
+            }
+            free_.push_back(i);
+        }
+    }
+
+private:
+    struct Slot {
+        T* entity_ = nullptr;
+        uint32_t generation_ = 1;
+    };
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_;
+};
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATHANDLE_H
@@ -0,0 +1,88 @@
+// CombatSnapshot.h
+// 战斗状态快照：两次 update 之间整场战斗的完整状态（实体、计时、目标、订阅、寻路队列、校验），
+// 全部为值类型，只通过句柄与模板指针引用实体，不持有节点；
+// CombatManager::RestoreSnapshot 复用场上的建筑节点与对象池中的士兵节点原地恢复，不重新加载布局。
+// 士兵的移动与攻击由 cocos Action 驱动，快照记录动作的起点与已经过的时间，
+// 恢复时重建同样的动作并快进到该进度；战斗逻辑不使用随机数，没有随机数状态需要保存。
+// 寻路代价场不进快照：它完全由存活建筑与地图占位决定，恢复建筑后重新构建，每份快照因此只有实体大小
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATSNAPSHOT_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATSNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "cocos2d.h"
+#include "CombatHandle.h"
+#include "CombatChecksum.h"
+#include "PathRequestQueue.h"
+#include "UIManager/UIManager.h"
+
+class Soldier;
+class Building;
+
+// 士兵当前运行的动作
+enum class SoldierPhase : uint8_t {
+    kIdle,        // 没有动作：没有目标，或在等待寻路结果
+    kMoving,      // 沿路径移动，到达后开始攻击
+    kAttacking,   // 攻击循环（炸弹人为自爆）
+    kDying        // 已阵亡，下一帧离场
+};
+
+struct SoldierState {
+    const Soldier* template_ = nullptr;
+    CombatHandle handle_;
+    CombatHandle target_;            // 目标建筑
+    int health_ = 0;
+    cocos2d::Vec2 position_;         // 逻辑位置（地图坐标）
+    cocos2d::Vec2 node_position_;    // 节点位置（世界坐标）
+    bool flipped_ = false;
+    SoldierPhase phase_ = SoldierPhase::kIdle;
+    float elapsed_ = -1.0f;          // 动作已经过的时间（攻击为本轮），尚未执行第一帧为 -1
+    uint64_t action_order_ = 0;      // 在 ActionManager 中的先后，同一帧内按它依次推进
+    cocos2d::Vec2 move_origin_;      // 移动：开始沿路径移动时的节点位置（世界坐标）
+    uint32_t path_begin_ = 0;        // 移动：路径在 CombatSnapshot::path_points_ 中的范围
+    uint32_t path_count_ = 0;
+    cocos2d::Vec2 attack_pos_;       // 攻击：站位（地图坐标）
+};
+
+struct BuildingState {
+    const Building* template_ = nullptr;
+    CombatHandle handle_;
+    int health_ = 0;
+    float attack_timer_ = 0.0f;      // 防御建筑
+    CombatHandle target_;            // 防御建筑当前的目标士兵
+    uint32_t subscribers_begin_ = 0; // 以它为目标的士兵在 CombatSnapshot::subscribers_ 中的范围（按订阅顺序）
+    uint32_t subscribers_count_ = 0;
+};
+
+struct CombatSnapshot {
+    int tick_ = -1;                  // -1 表示空快照
+    float time_ = 0.0f;
+    int stars_ = 0;
+    int destroy_degree_ = 0;
+    int buildings_should_count_destroyed_ = 0;
+    int num_of_live_soldiers_ = 0;
+    int num_of_live_buildings_ = 0;
+
+    std::vector<SoldierState> soldiers_;      // live_soldiers_ 顺序
+    std::vector<BuildingState> buildings_;    // live_buildings_ 顺序
+    std::vector<CombatHandle> defenses_;      // live_defenses_ 顺序
+    std::vector<cocos2d::Vec2> path_points_;
+    std::vector<CombatHandle> subscribers_;
+    CombatHandleTableState soldier_handles_;
+    CombatHandleTableState building_handles_;
+    PathQueueState path_requests_;
+
+    CombatChecksum checksum_;
+    CombatChecksumLog checksum_log_;
+    size_t next_expected_checkpoint_ = 0;
+    int desync_tick_ = -1;
+    size_t checksum_trace_length_ = 0;
+
+    BattleDeployState deploy_;
+
+    bool IsValid() const { return tick_ >= 0; }
+    void Clear() { *this = CombatSnapshot(); }
+};
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_COMBATSNAPSHOT_H
@@ -8,6 +8,12 @@
 #include "Building/Building.h"
 #include "BuildingInCombat.h"
 #include "MainScene.h"
+#include "CombatArena.h"
+#include "PathRequestQueue.h"
+#include "Profiler/GameProfiler.h"
+#include "Profiler/StructuredLog.h"
+#include "Simulation/BalanceSweep.h"
+#include "Simulation/HeadlessBattle.h"
 
 //// 前向声明
 //class MockSoldier;
@@ -189,3 +195,288 @@ TEST_F(SoldierInCombatTest, CreateStraightMoveActionTest) {
 //    }
 //}
 
+// 战斗 tick 稳态测试：预热之后，防御建筑索敌、寻路请求的提交/派发/交付与溅射范围查询
+// 只使用复位重用的竞技场与已有容量，不再触发任何通用堆分配
+class CombatTickTest : public ::testing::Test {
+protected:
+    static void TickDefenses(CombatManager* manager, float dt) { manager->TickDefenses(dt); }
+    // 推进一个完整的固定步长 tick，不经过帧间隔累积
+    static void Tick(CombatManager* manager) { manager->Tick(); }
+    static void RunTo(CombatManager* manager, int tick) {
+        while (manager->getCombatTick() < tick && manager->IsFighting()) Tick(manager);
+    }
+};
+
+TEST_F(CombatTickTest, SteadyStateTicksDoNotAllocate) {
+    // operator new 计数只在开启 TJ_PROFILE_ALLOCATIONS 时编译进来，否则计数恒为 0，什么也检查不了
+    if (!TJ_PROFILE_ALLOCATIONS) GTEST_SKIP() << "allocation counter compiled out (TJ_PROFILE_ALLOCATIONS=0)";
+
+    auto map = MapManager::create(30, 30, -1, TerrainType::Battle);
+    ASSERT_NE(map, nullptr);
+    rapidjson::Document layout;
+    layout.Parse(R"({"buildings":[{"type":"TownHall","x":13,"y":13,"level":1},
+                                  {"type":"Cannon","x":9,"y":9,"level":1},
+                                  {"type":"Wall","x":8,"y":12,"level":1}]})");
+    ASSERT_TRUE(map->loadFromJSONObject(layout));
+    auto manager = CombatManager::InitializeInstance(map);
+    ASSERT_NE(manager, nullptr);
+    ASSERT_FALSE(manager->live_defenses_.empty());
+
+    // 射程外的士兵：加农炮每次开火都要对它索敌，但不会命中（命中会触发血条动作，不属于核心逻辑）
+    Soldier barbarian(SoldierType::kBarbarian, 100, 100, 1, 1, 0.1);
+    auto soldier = SoldierInCombat::CreateIdle(&barbarian);
+    ASSERT_NE(soldier, nullptr);
+    soldier->retain();
+    soldier->current_target_ = nullptr;
+    soldier->position_ = cocos2d::Vec2(28.5f, 28.5f);
+    manager->AddLiveSoldier(soldier);
+
+    PathRequest request;
+    request.start_ = soldier->position_;
+    request.target_ = cocos2d::Vec2(13, 13);
+    request.target_width_ = request.target_length_ = 4;
+    request.range_ = 1.0f;
+    request.profile_ = PathCostProfile::FromSoldier(&barbarian);
+
+    CombatArena& scratch = manager->GetTickScratch();
+    PathRequestQueue& queue = manager->GetPathRequests();
+    const float dt = CombatManager::kFixedTickDt;
+    int splash_hits = 0;
+    auto run_tick = [&]() {
+        scratch.Reset();
+        // 上一 tick 派发的搜索在这里交付（士兵没有目标，只清掉票号）
+        queue.ApplyResults();
+        TickDefenses(manager, dt);
+        {
+            ArenaScope scope(scratch);
+            ArenaVector<BuildingInCombat*> targets{ArenaAllocator<BuildingInCombat*>(&scratch)};
+            targets.reserve(9);
+            manager->GetPathCostField().QueryBuildingsInArea(cocos2d::Vec2(9.5f, 11.5f), 1.0f,
+                                                             AreaShape::kSquare, targets);
+            splash_hits = static_cast<int>(targets.size());
+        }
+        soldier->path_ticket_ = queue.Submit(soldier, request);
+        queue.Dispatch(manager->GetPathCostField(), manager->GetBattleArena());
+    };
+    // 预热：竞技场申请块、队列与搜索槽位扩容；加农炮间隔内至少开火一次
+    for (int tick = 0; tick < 120; ++tick) run_tick();
+    const uint64_t blocks = scratch.GetBlockAllocations();
+    const uint64_t searches = queue.GetSearchCount();
+    const uint64_t before = GameProfiler::getAllocationCount();
+    for (int tick = 0; tick < 300; ++tick) run_tick();
+    const uint64_t after = GameProfiler::getAllocationCount();
+
+    EXPECT_EQ(after, before);
+    EXPECT_EQ(scratch.GetBlockAllocations(), blocks);
+    // 确认三条路径确实走过：每 tick 一次搜索，溅射查询命中加农炮与城墙
+    EXPECT_EQ(queue.GetSearchCount() - searches, 300u);
+    EXPECT_EQ(splash_hits, 2);
+    EXPECT_FALSE(manager->live_defenses_.front()->GetCurrentTarget());
+
+    queue.ApplyResults();
+    manager->RemoveLiveSoldier(soldier);
+    soldier->release();
+    CombatManager::DestroyInstance();
+}
+
+// 快照恢复后重新推进：从 tick N 恢复再跑到 M，状态哈希与第一次跑到 M 时一致。
+// N 到 M 之间加农炮被摧毁，恢复时代价场按快照里的建筑重新构建
+TEST_F(CombatTickTest, RestoreAndResimulateGivesSameHash) {
+    const int kSaveTick = 60;
+    const int kCompareTick = 600;
+
+    auto map = MapManager::create(30, 30, -1, TerrainType::Battle);
+    ASSERT_NE(map, nullptr);
+    rapidjson::Document layout;
+    layout.Parse(R"({"buildings":[{"type":"TownHall","x":13,"y":13,"level":1},
+                                  {"type":"Cannon","x":9,"y":9,"level":1},
+                                  {"type":"Wall","x":8,"y":12,"level":1},
+                                  {"type":"Wall","x":9,"y":12,"level":1}]})");
+    ASSERT_TRUE(map->loadFromJSONObject(layout));
+    auto manager = CombatManager::InitializeInstance(map);
+    ASSERT_NE(manager, nullptr);
+    manager->SetKeepAfterEnd(true);
+    manager->StartCombat();
+
+    Soldier barbarian(SoldierType::kBarbarian, 50, 12, 1, 1, 1.0);
+    for (int i = 0; i < 6; ++i) {
+        manager->SendSoldier(&barbarian, cocos2d::Vec2(8.5f + i * 0.5f, 5.5f));
+    }
+
+    RunTo(manager, kSaveTick);
+    ASSERT_EQ(manager->getCombatTick(), kSaveTick);
+    CombatSnapshot snapshot;
+    manager->SaveSnapshot(snapshot);
+    const int buildings_at_save = manager->num_of_live_buildings_;
+
+    RunTo(manager, kCompareTick);
+    ASSERT_EQ(manager->getCombatTick(), kCompareTick);
+    ASSERT_LT(manager->num_of_live_buildings_, buildings_at_save);
+    const uint64_t first = manager->GetStateHash();
+
+    ASSERT_TRUE(manager->RestoreSnapshot(snapshot));
+    EXPECT_EQ(manager->getCombatTick(), kSaveTick);
+    EXPECT_EQ(manager->num_of_live_buildings_, buildings_at_save);
+    RunTo(manager, kCompareTick);
+    ASSERT_EQ(manager->getCombatTick(), kCompareTick);
+    EXPECT_EQ(manager->GetStateHash(), first);
+
+    CombatManager::DestroyInstance();
+}
+
+TEST(PathRequestQueueTest, SnapshotSearchWalksAroundObstacles) {
+    // 5x5 空地，x=2 的 y=0..3 为障碍物，只能从 y=4 绕过去
+    PathGridSnapshot grid;
+    grid.width_ = grid.length_ = 5;
+    grid.owners_.assign(25, -1);
+    grid.compartments_.assign(25, 0);
+    for (int y = 0; y < 4; ++y) {
+        grid.owners_[y * 5 + 2] = -2;
+        grid.compartments_[y * 5 + 2] = -1;
+    }
+
+    std::vector<float> g_cost(25);
+    std::vector<int> parent(25);
+    std::vector<uint32_t> visited(25, 0), closed(25, 0);
+    PathSearchWorkspace workspace;
+    workspace.size_ = 25;
+    workspace.g_cost_ = g_cost.data();
+    workspace.parent_ = parent.data();
+    workspace.visited_ = visited.data();
+    workspace.closed_ = closed.data();
+
+    PathRequest request;
+    request.start_ = cocos2d::Vec2(0.5f, 0.5f);
+    request.target_ = cocos2d::Vec2(4.0f, 0.0f);
+    request.profile_.damage_per_second_ = 10.0f;
+    request.profile_.move_speed_ = 1.0f;
+
+    std::vector<AStarNode> open_list;
+    std::vector<cocos2d::Vec2> path;
+    PathRequestQueue::FindPath(grid, request, workspace, open_list, path);
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(path.front(), cocos2d::Vec2(0, 0));
+    EXPECT_EQ(path.back(), cocos2d::Vec2(4, 0));
+    for (const auto& tile : path) {
+        EXPECT_FALSE(tile.x == 2 && tile.y < 4);
+    }
+
+    // 起点格相同的请求合并为一次搜索
+    PathRequest same = request;
+    same.start_ = cocos2d::Vec2(0.9f, 0.1f);
+    EXPECT_TRUE(request.SameSearch(same));
+    same.range_ = 1.0f;
+    EXPECT_FALSE(request.SameSearch(same));
+}
+
+TEST(HeadlessBattleTest, SameDeploymentsGiveSameResult) {
+    SimRules rules = SimRules::defaults();
+    std::vector<LayoutPiece> pieces = { {"TownHall", 13, 13, 1}, {"Cannon", 9, 9, 1} };
+    SimField field;
+    ASSERT_TRUE(field.build(rules, 30, 30, pieces));
+    // 建筑外一圈禁止部署
+    EXPECT_FALSE(field.isDeployAllowed(12, 12));
+    EXPECT_TRUE(field.isDeployAllowed(2, 2));
+
+    std::vector<SimDeployment> deployments;
+    for (int i = 0; i < 10; ++i) deployments.push_back({ 0, 2.5f, 2.5f, 0.1f * i });
+    deployments.push_back({ 0, 12.5f, 12.5f, 0.0f });
+
+    HeadlessBattle battle(rules);
+    SimResult first = battle.run(field, deployments);
+    SimResult second = battle.run(field, deployments);
+    EXPECT_EQ(first.stars, 3);
+    EXPECT_EQ(first.destruction, 100);
+    EXPECT_TRUE(first.townHallDestroyed);
+    EXPECT_EQ(first.rejected, 1);
+    EXPECT_EQ(first.deployed, 10);
+    // 工作数组复用不影响结果
+    EXPECT_EQ(second.stars, first.stars);
+    EXPECT_EQ(second.unitsLost, first.unitsLost);
+    EXPECT_FLOAT_EQ(second.duration, first.duration);
+}
+
+TEST(HeadlessBattleTest, InfluenceSkipsUntouchedBuildings) {
+    SimRules rules = SimRules::defaults();
+    std::vector<LayoutPiece> pieces = { {"TownHall", 13, 13, 1}, {"Cannon", 9, 9, 1}, {"Gold Mine", 24, 24, 1} };
+    SimField field;
+    ASSERT_TRUE(field.build(rules, 30, 30, pieces));
+    std::vector<SimDeployment> deployments = { { 0, 2.5f, 2.5f, 0.0f } };
+
+    HeadlessBattle battle(rules);
+    SimInfluence influence;
+    SimResult before = battle.run(field, deployments, SimRunOptions(), &influence);
+
+    // 远处的金矿挪一格：战斗没有碰到它，结果可以沿用
+    std::vector<LayoutPiece> movedMine = pieces;
+    movedMine[2].x = 25;
+    SimField mineField;
+    ASSERT_TRUE(mineField.build(rules, 30, 30, movedMine));
+    EXPECT_FALSE(influence.affectedBy(2, field.buildings()[2], mineField.buildings()[2],
+                                      rules.buildings[field.buildings()[2].stats]));
+    SimResult after = battle.run(mineField, deployments);
+    EXPECT_EQ(after.destruction, before.destruction);
+    EXPECT_EQ(after.unitsLost, before.unitsLost);
+    EXPECT_FLOAT_EQ(after.duration, before.duration);
+
+    // 士兵的目标加农炮挪动则必须重新模拟
+    std::vector<LayoutPiece> movedCannon = pieces;
+    movedCannon[1].x = 8;
+    SimField cannonField;
+    ASSERT_TRUE(cannonField.build(rules, 30, 30, movedCannon));
+    EXPECT_TRUE(influence.affectedBy(1, field.buildings()[1], cannonField.buildings()[1],
+                                     rules.buildings[field.buildings()[1].stats]));
+}
+
+TEST(BalanceSweepTest, AppliesKnownParametersOnly) {
+    SimRules rules = SimRules::defaults();
+    EXPECT_TRUE(BalanceSweep::applyParameter(rules, "Barbarian", "health", 80.0f));
+    EXPECT_EQ(rules.units[rules.findUnit("Barbarian")].health, 80);
+    EXPECT_TRUE(BalanceSweep::applyParameter(rules, "Cannon", "attack_interval", 0.5f));
+    EXPECT_FLOAT_EQ(rules.buildings[rules.findBuilding("Cannon")].attackInterval, 0.5f);
+    // 非防御建筑没有攻击参数，未知数值名直接拒绝
+    EXPECT_FALSE(BalanceSweep::applyParameter(rules, "Gold Mine", "attack_damage", 5.0f));
+    EXPECT_FALSE(BalanceSweep::applyParameter(rules, "Barbarian", "armor", 1.0f));
+}
+
+TEST(StructuredLogTest, FormatsOnDrainAndHonoursCategoryMask) {
+    auto log = StructuredLog::getInstance();
+    std::vector<std::string> lines;
+    log->drain();
+    log->setSink([&lines](const char* line) { lines.push_back(line); });
+    log->setMask(~0u);
+
+    std::string name = "Cannon";
+    log->write(LogCategory::Damage, LogLevel::Warning, "%s health:%d (%.1f)", name, 42, 1.25);
+    log->setCategoryEnabled(LogCategory::Path, false);
+    EXPECT_FALSE(log->isEnabled(LogCategory::Path));
+    TJ_LOG_ERROR(LogCategory::Path, "masked %d", 1);
+
+    // 写入时只拷贝参数，drain 时才格式化
+    EXPECT_TRUE(lines.empty());
+    EXPECT_EQ(log->drain(), 1u);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("Cannon health:42 (1.2"), std::string::npos);
+
+    log->setMask(~0u);
+    log->setSink(nullptr);
+}
+
+TEST(StructuredLogTest, TruncatesLongTextArguments) {
+    auto log = StructuredLog::getInstance();
+    std::vector<std::string> lines;
+    log->drain();
+    log->setSink([&lines](const char* line) { lines.push_back(line); });
+    log->setMask(~0u);
+
+    // 第一个字符串占满缓冲后，后面的字符串参数输出为空串，不越界读取
+    const std::string first(60, 'a');
+    const std::string second(30, 'b');
+    log->write(LogCategory::Combat, LogLevel::Error, "%s|%s|%d", first, second, 7);
+    EXPECT_EQ(log->drain(), 1u);
+    ASSERT_EQ(lines.size(), 1u);
+    const std::string expected = std::string(LogRecord::kTextBytes - 1, 'a') + "||7";
+    EXPECT_NE(lines[0].find(expected), std::string::npos);
+
+    log->setSink(nullptr);
+}
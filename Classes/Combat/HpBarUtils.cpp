@@ -48,3 +48,16 @@ void HpBarComponents::updateHp(int currentHp, int maxHp) {
 
     hpBar->runAction(cocos2d::ScaleTo::create(0.2f, hpPercent, 1.0f));
 }
+
+void HpBarComponents::reset(float hostHeight, float hpOffsetRatio, float hpWidth) {
+    if (!hpBg || !hpBar) return;
+    auto hpY = static_cast<float>(hostHeight * hpOffsetRatio);
+
+    hpBg->setPosition(cocos2d::Vec2(3*hpWidth/4, hpY));
+    hpBg->setVisible(false);
+
+    hpBar->stopAllActions();
+    hpBar->setScale(1.0f);
+    hpBar->setPosition(cocos2d::Vec2(hpWidth / 4, hpY));
+    hpBar->setVisible(false);
+}
@@ -21,6 +21,8 @@ public:
             const std::string& progressPath = "UI/slider_progress.png" // 血条进度条路径
     );
     void updateHp(int currentHp, int maxHp);
+    // 宿主被对象池回收复用时：停止缩放动作、恢复满血并按新的宿主高度重新定位
+    void reset(float hostHeight, float hpOffsetRatio = 1.2f, float hpWidth = 20.0f);
 };
 
 #endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_HPBARUTILS_H
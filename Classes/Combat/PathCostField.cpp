@@ -0,0 +1,272 @@
+// PathCostField.cpp
+// 战斗寻路代价场实现
+
+#include "PathCostField.h"
+#include "BuildingInCombat.h"
+#include "MapManager/MapManager.h"
+#include "Soldier/Soldier.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+constexpr int kFree = -1;
+constexpr int kObstacle = -2;
+const int kDirX[] = {1, 0, -1, 0};
+const int kDirY[] = {0, 1, 0, -1};
+}
+
+void PathCostField::Clear() {
+    width_ = length_ = 0;
+    buildings_.clear();
+    owners_.clear();
+    wall_segments_.clear();
+    segment_borders_.clear();
+    parent_.clear();
+    query_stamps_.clear();
+    query_serial_ = 0;
+}
+
+void PathCostField::Build(MapManager* map, const std::vector<BuildingInCombat*>& buildings) {
+    Clear();
+    if (!map) return;
+    auto size = map->getMapSize();
+    width_ = size.first;
+    length_ = size.second;
+    owners_.assign(width_, length_, kFree);
+
+    // 1. 占位：地图格子上的 Building 模板 → 战斗建筑句柄槽位
+    std::unordered_map<const Building*, int> index_of;
+    for (auto building : buildings) {
+        if (building->handle_.IsNull()) continue;
+        const int index = static_cast<int>(building->handle_.index_);
+        if (index >= static_cast<int>(buildings_.size())) buildings_.resize(index + 1, nullptr);
+        buildings_[index] = building;
+        index_of[building->building_template_] = index;
+    }
+    query_stamps_.assign(buildings_.size(), 0);
+    for (int y = 0; y < length_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            if (map->IsGridAvailable(x, y)) continue;
+            auto it = index_of.find(map->getBuildingAt(x, y));
+            owners_.at(x, y) = (it != index_of.end()) ? it->second : kObstacle;
+        }
+    }
+
+    // 2. 隔间：空地按 4 邻接合并
+    parent_.resize(static_cast<size_t>(width_) * length_);
+    for (int i = 0; i < static_cast<int>(parent_.size()); ++i) parent_[i] = i;
+    for (int y = 0; y < length_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            if (owners_.at(x, y) != kFree) continue;
+            if (x + 1 < width_ && owners_.at(x + 1, y) == kFree) Union(Index(x, y), Index(x + 1, y));
+            if (y + 1 < length_ && owners_.at(x, y + 1) == kFree) Union(Index(x, y), Index(x, y + 1));
+        }
+    }
+
+    // 3. 城墙段连通图
+    BuildWallSegments();
+    ++version_;
+    CCLOG("PathCostField built: %d buildings, %d wall segments", static_cast<int>(buildings_.size()), GetWallSegmentCount());
+}
+
+void PathCostField::BuildWallSegments() {
+    wall_segments_.assign(width_, length_, -1);
+    segment_borders_.clear();
+    auto is_wall = [this](int x, int y) {
+        int owner = owners_.at(x, y);
+        return owner >= 0 && typeid(*buildings_[owner]->building_template_) == typeid(WallBuilding);
+    };
+
+    std::vector<int> stack;
+    for (int y = 0; y < length_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            if (wall_segments_.at(x, y) >= 0 || !is_wall(x, y)) continue;
+            const int segment = static_cast<int>(segment_borders_.size());
+            segment_borders_.emplace_back();
+            auto& borders = segment_borders_.back();
+
+            wall_segments_.at(x, y) = segment;
+            stack.push_back(Index(x, y));
+            while (!stack.empty()) {
+                const int tile = stack.back();
+                stack.pop_back();
+                const int cx = tile % width_, cy = tile / width_;
+                for (int d = 0; d < 4; ++d) {
+                    const int nx = cx + kDirX[d], ny = cy + kDirY[d];
+                    if (!InBounds(nx, ny)) continue;
+                    if (owners_.at(nx, ny) == kFree) {
+                        borders.push_back(Index(nx, ny));
+                    } else if (wall_segments_.at(nx, ny) < 0 && is_wall(nx, ny)) {
+                        wall_segments_.at(nx, ny) = segment;
+                        stack.push_back(Index(nx, ny));
+                    }
+                }
+            }
+            // 相邻空地只需每个隔间保留一个代表格
+            std::sort(borders.begin(), borders.end(), [this](int a, int b) { return Find(a) < Find(b); });
+            borders.erase(std::unique(borders.begin(), borders.end(),
+                                      [this](int a, int b) { return Find(a) == Find(b); }), borders.end());
+        }
+    }
+}
+
+void PathCostField::OnBuildingRemoved(const BuildingInCombat* building) {
+    if (!IsBuilt() || !building) return;
+    if (building->handle_.IsNull()) return;
+    const int owner = static_cast<int>(building->handle_.index_);
+    if (owner >= static_cast<int>(buildings_.size()) || buildings_[owner] != building) return;
+
+    const int gx = static_cast<int>(std::floor(building->position_.x));
+    const int gy = static_cast<int>(std::floor(building->position_.y));
+    const int w = building->building_template_->GetWidth();
+    const int l = building->building_template_->GetLength();
+    for (int y = gy; y < gy + l; ++y) {
+        for (int x = gx; x < gx + w; ++x) {
+            if (!InBounds(x, y) || owners_.at(x, y) != owner) continue;
+            owners_.at(x, y) = kFree;
+            wall_segments_.at(x, y) = -1;
+        }
+    }
+    for (int y = gy; y < gy + l; ++y) {
+        for (int x = gx; x < gx + w; ++x) {
+            if (InBounds(x, y) && owners_.at(x, y) == kFree) JoinFreeNeighbors(x, y);
+        }
+    }
+    // 下标保持稳定，只清空指针（对象会回到 CombatEntityPool 被复用）
+    buildings_[owner] = nullptr;
+    ++version_;
+}
+
+void PathCostField::JoinFreeNeighbors(int x, int y) {
+    for (int d = 0; d < 4; ++d) {
+        const int nx = x + kDirX[d], ny = y + kDirY[d];
+        if (InBounds(nx, ny) && owners_.at(nx, ny) == kFree) Union(Index(x, y), Index(nx, ny));
+    }
+}
+
+BuildingInCombat* PathCostField::GetBuildingAt(int x, int y) const {
+    if (!InBounds(x, y)) return nullptr;
+    const int owner = owners_.at(x, y);
+    return owner >= 0 ? buildings_[owner] : nullptr;
+}
+
+float PathCostField::GetBreakCost(int x, int y, const Soldier* soldier) const {
+    if (!InBounds(x, y)) return kImpassable;
+    const int owner = owners_.at(x, y);
+    if (owner == kFree) return 0.0f;
+    if (owner == kObstacle || !buildings_[owner]) return kImpassable;
+
+    return PathCostProfile::FromSoldier(soldier).BreakCost(buildings_[owner]->GetCurrentHealth());
+}
+
+PathCostProfile PathCostProfile::FromSoldier(const Soldier* soldier) {
+    PathCostProfile profile;
+    profile.damage_per_second_ = soldier->GetAttackDelay() > 0.0f
+        ? soldier->GetDamage() / soldier->GetAttackDelay()
+        : static_cast<float>(soldier->GetDamage());
+    profile.move_speed_ = soldier->GetMoveSpeed();
+    return profile;
+}
+
+float PathCostProfile::BreakCost(int hp) const {
+    // 摧毁耗时（秒）换算成同等时间内可走的格数
+    if (damage_per_second_ <= 0.0f) return PathCostField::kImpassable;
+    const float seconds = hp / damage_per_second_;
+    return seconds * move_speed_;
+}
+
+void PathCostField::CaptureSnapshot(PathGridSnapshot& snapshot) const {
+    if (snapshot.version_ != version_ || snapshot.width_ != width_ || snapshot.length_ != length_) {
+        snapshot.version_ = version_;
+        snapshot.width_ = width_;
+        snapshot.length_ = length_;
+        const size_t tiles = static_cast<size_t>(width_) * length_;
+        snapshot.owners_.resize(tiles);
+        snapshot.compartments_.resize(tiles);
+        for (int y = 0; y < length_; ++y) {
+            for (int x = 0; x < width_; ++x) {
+                snapshot.owners_[Index(x, y)] = owners_.at(x, y);
+                snapshot.compartments_[Index(x, y)] = GetCompartment(x, y);
+            }
+        }
+    }
+    // 血量每次都刷新：拆除代价随建筑受损变化
+    snapshot.building_hp_.resize(buildings_.size());
+    for (size_t i = 0; i < buildings_.size(); ++i) {
+        snapshot.building_hp_[i] = buildings_[i] ? buildings_[i]->GetCurrentHealth() : 0;
+    }
+}
+
+float PathGridSnapshot::GetBreakCost(int x, int y, const PathCostProfile& profile) const {
+    if (!InBounds(x, y)) return PathCostField::kImpassable;
+    const int owner = owners_[y * width_ + x];
+    if (owner == kFree) return 0.0f;
+    if (owner == kObstacle) return PathCostField::kImpassable;
+    return profile.BreakCost(building_hp_[owner]);
+}
+
+bool PathGridSnapshot::CanReachWithoutBreaking(int from_x, int from_y, int goal_x, int goal_y, float range) const {
+    if (!InBounds(from_x, from_y)) return false;
+    const int start = compartments_[from_y * width_ + from_x];
+    if (start < 0) return false;
+    const int reach = static_cast<int>(std::ceil(range));
+    for (int y = goal_y - reach; y <= goal_y + reach; ++y) {
+        for (int x = goal_x - reach; x <= goal_x + reach; ++x) {
+            if (!InBounds(x, y) || compartments_[y * width_ + x] != start) continue;
+            const float dx = static_cast<float>(x - goal_x), dy = static_cast<float>(y - goal_y);
+            if (dx * dx + dy * dy <= range * range) return true;
+        }
+    }
+    return false;
+}
+
+int PathCostField::GetCompartment(int x, int y) const {
+    if (!InBounds(x, y) || owners_.at(x, y) != kFree) return -1;
+    return Find(Index(x, y));
+}
+
+bool PathCostField::CanReachWithoutBreaking(int from_x, int from_y, int goal_x, int goal_y, float range) const {
+    const int start = GetCompartment(from_x, from_y);
+    if (start < 0) return false;
+    const int reach = static_cast<int>(std::ceil(range));
+    for (int y = goal_y - reach; y <= goal_y + reach; ++y) {
+        for (int x = goal_x - reach; x <= goal_x + reach; ++x) {
+            if (GetCompartment(x, y) != start) continue;
+            const float dx = static_cast<float>(x - goal_x), dy = static_cast<float>(y - goal_y);
+            if (dx * dx + dy * dy <= range * range) return true;
+        }
+    }
+    return false;
+}
+
+int PathCostField::GetWallSegmentAt(int x, int y) const {
+    return InBounds(x, y) ? wall_segments_.at(x, y) : -1;
+}
+
+std::vector<int> PathCostField::GetSegmentCompartments(int segment) const {
+    std::vector<int> result;
+    if (segment < 0 || segment >= GetWallSegmentCount()) return result;
+    for (int tile : segment_borders_[segment]) {
+        result.push_back(Find(tile));
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+int PathCostField::Find(int tile) const {
+    int root = tile;
+    while (parent_[root] != root) root = parent_[root];
+    while (parent_[tile] != root) {
+        const int next = parent_[tile];
+        parent_[tile] = root;
+        tile = next;
+    }
+    return root;
+}
+
+void PathCostField::Union(int a, int b) {
+    const int ra = Find(a), rb = Find(b);
+    if (ra != rb) parent_[std::max(ra, rb)] = std::min(ra, rb);
+}
@@ -0,0 +1,183 @@
+// PathCostField.h
+// 战斗寻路代价场：每场战斗构建一次，记录每格被哪个战斗建筑占用，
+// 通行代价按该建筑当前血量与士兵 DPS 推算（以"走一格"为单位）；
+// 同时维护城墙段连通图和空地隔间（并查集），建筑被摧毁时增量合并隔间；
+// 格子→战斗建筑索引也用于溅射等范围伤害查询
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_PATHCOSTFIELD_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_PATHCOSTFIELD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "cocos2d.h"
+#include "MapManager/MapGrid.h"
+#include "CombatHandle.h"
+
+class MapManager;
+class BuildingInCombat;
+class Soldier;
+
+// 范围查询形状
+enum class AreaShape {
+    kSquare,   // 以中心所在格为中心、切比雪夫距离 ≤ radius 的格子
+    kCircle    // 与以中心为圆心、radius 为半径的圆相交的格子
+};
+
+// A* 节点数组：按格子下标平铺，每场战斗从 battle arena 分配一次，各次搜索复用；
+// 用搜索序号标记访问/关闭状态，开始新搜索无需清零整个数组
+struct PathSearchWorkspace {
+    int size_ = 0;
+    float* g_cost_ = nullptr;
+    int* parent_ = nullptr;
+    uint32_t* visited_ = nullptr;
+    uint32_t* closed_ = nullptr;
+    uint32_t serial_ = 0;
+
+    void Begin() {
+        if (++serial_ == 0) {
+            // 序号回绕时清空标记
+            std::fill(visited_, visited_ + size_, 0u);
+            std::fill(closed_, closed_ + size_, 0u);
+            serial_ = 1;
+        }
+    }
+    bool IsVisited(int tile) const { return visited_[tile] == serial_; }
+    bool IsClosed(int tile) const { return closed_[tile] == serial_; }
+    void Visit(int tile, float g_cost, int parent) {
+        visited_[tile] = serial_;
+        g_cost_[tile] = g_cost;
+        parent_[tile] = parent;
+    }
+    void Close(int tile) { closed_[tile] = serial_; }
+};
+
+// 士兵的拆除代价参数：由主线程从 Soldier 模板取出，寻路线程不再访问模板
+struct PathCostProfile {
+    float damage_per_second_ = 0.0f;
+    float move_speed_ = 0.0f;
+
+    static PathCostProfile FromSoldier(const Soldier* soldier);
+    // 拆掉剩余血量为 hp 的建筑折算成的格数，无法造成伤害时为 PathCostField::kImpassable
+    float BreakCost(int hp) const;
+    bool operator==(const PathCostProfile& other) const {
+        return damage_per_second_ == other.damage_per_second_ && move_speed_ == other.move_speed_;
+    }
+};
+
+// PathCostField 的只读拷贝，供工作线程寻路：主线程在派发前刷新，搜索期间不再修改
+struct PathGridSnapshot {
+    uint32_t version_ = 0;              // 拷贝时代价场的版本，版本未变时只刷新建筑血量
+    int width_ = 0;
+    int length_ = 0;
+    std::vector<int> owners_;           // 同 PathCostField：-1 空地，-2 障碍物，其余为建筑下标
+    std::vector<int> compartments_;     // 空地所在隔间，被占用为 -1
+    std::vector<int> building_hp_;      // 建筑下标 → 当前血量
+
+    bool IsBuilt() const { return width_ > 0; }
+    bool InBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width_ && y < length_; }
+    bool IsFree(int x, int y) const { return InBounds(x, y) && owners_[y * width_ + x] == -1; }
+    float GetBreakCost(int x, int y, const PathCostProfile& profile) const;
+    bool CanReachWithoutBreaking(int from_x, int from_y, int goal_x, int goal_y, float range) const;
+};
+
+class PathCostField {
+public:
+    // 不可通行（障碍物）的代价
+    static constexpr float kImpassable = -1.0f;
+
+    // 按当前战斗建筑构建占位、城墙段与隔间（CombatManager::Init 末尾与恢复快照时调用，建筑须已登记句柄）；
+    // 版本在原有基础上递增
+    void Build(MapManager* map, const std::vector<BuildingInCombat*>& buildings);
+    void Clear();
+    bool IsBuilt() const { return width_ > 0; }
+    // 占位或隔间发生变化时递增（Build/OnBuildingRemoved），建筑掉血不改变版本
+    uint32_t GetVersion() const { return version_; }
+    // 拷贝到寻路快照（主线程）
+    void CaptureSnapshot(PathGridSnapshot& snapshot) const;
+
+    // 建筑被摧毁：清除其占位，并把它隔开的隔间合并
+    void OnBuildingRemoved(const BuildingInCombat* building);
+
+    // 占用该格的战斗建筑，空地/障碍物/越界返回 nullptr
+    BuildingInCombat* GetBuildingAt(int x, int y) const;
+
+    // 穿过该格的额外代价：空地为 0，建筑为 摧毁耗时 × 移动速度，障碍物为 kImpassable
+    float GetBreakCost(int x, int y, const Soldier* soldier) const;
+
+    // 空地所在隔间编号（并查集根），被占用或越界返回 -1
+    int GetCompartment(int x, int y) const;
+
+    // 不破坏任何建筑即可从 (from_x, from_y) 走到距 goal 不超过 range 的空地
+    bool CanReachWithoutBreaking(int from_x, int from_y, int goal_x, int goal_y, float range) const;
+
+    // 范围查询：把范围内被占用的战斗建筑追加到 out（同一建筑只出现一次，按首次覆盖的格子顺序），
+    // 返回追加的数量；耗时只与范围内格子数有关。out 可为任意分配器的 vector
+    template <typename Container>
+    int QueryBuildingsInArea(const cocos2d::Vec2& center, float radius, AreaShape shape,
+                             Container& out) const;
+
+    // 城墙段：4 邻接的城墙格组成一段，每段记录相邻隔间的代表格
+    int GetWallSegmentCount() const { return static_cast<int>(segment_borders_.size()); }
+    int GetWallSegmentAt(int x, int y) const;
+    // 该城墙段当前分隔的隔间（去重后的并查集根）
+    std::vector<int> GetSegmentCompartments(int segment) const;
+
+private:
+    int Index(int x, int y) const { return y * width_ + x; }
+    bool InBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width_ && y < length_; }
+    int Find(int tile) const;
+    void Union(int a, int b);
+    void JoinFreeNeighbors(int x, int y);
+    void BuildWallSegments();
+
+    int width_ = 0;
+    int length_ = 0;
+    uint32_t version_ = 0;
+    std::vector<BuildingInCombat*> buildings_;   // 下标为建筑句柄槽位，即 owners_ 中的编号
+    FlatGrid<int> owners_;                       // -1 空地，-2 障碍物，其余为 buildings_ 下标
+    FlatGrid<int> wall_segments_;                // -1 非城墙
+    std::vector<std::vector<int>> segment_borders_;
+    mutable std::vector<int> parent_;            // 并查集（按格子下标），Find 时路径压缩
+    mutable std::vector<uint32_t> query_stamps_; // 范围查询去重：建筑下标 → 最近一次命中的查询序号
+    mutable uint32_t query_serial_ = 0;
+};
+
+template <typename Container>
+int PathCostField::QueryBuildingsInArea(const cocos2d::Vec2& center, float radius, AreaShape shape,
+                                        Container& out) const {
+    if (!IsBuilt() || radius < 0.0f) return 0;
+    if (++query_serial_ == 0) {
+        // 序号回绕时清空标记，避免与旧查询混淆
+        std::fill(query_stamps_.begin(), query_stamps_.end(), 0);
+        query_serial_ = 1;
+    }
+
+    const int cx = static_cast<int>(std::floor(center.x));
+    const int cy = static_cast<int>(std::floor(center.y));
+    const int reach = shape == AreaShape::kSquare ? static_cast<int>(radius) : static_cast<int>(std::ceil(radius));
+    const int x_min = std::max(0, cx - reach), x_max = std::min(width_ - 1, cx + reach);
+    const int y_min = std::max(0, cy - reach), y_max = std::min(length_ - 1, cy + reach);
+    const float radius_sq = radius * radius;
+
+    int added = 0;
+    for (int y = y_min; y <= y_max; ++y) {
+        for (int x = x_min; x <= x_max; ++x) {
+            const int owner = owners_.at(x, y);
+            if (owner < 0 || !buildings_[owner] || query_stamps_[owner] == query_serial_) continue;
+            if (shape == AreaShape::kCircle) {
+                // 圆心到格子 [x, x+1]×[y, y+1] 的最近距离
+                const float dx = center.x - std::max(static_cast<float>(x), std::min(center.x, x + 1.0f));
+                const float dy = center.y - std::max(static_cast<float>(y), std::min(center.y, y + 1.0f));
+                if (dx * dx + dy * dy > radius_sq) continue;
+            }
+            query_stamps_[owner] = query_serial_;
+            out.push_back(buildings_[owner]);
+            ++added;
+        }
+    }
+    return added;
+}
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_PATHCOSTFIELD_H
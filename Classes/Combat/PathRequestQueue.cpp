@@ -0,0 +1,290 @@
+// PathRequestQueue.cpp
+// 异步寻路请求队列实现
+
+#include "PathRequestQueue.h"
+#include "SoldierInCombat.h"
+#include "CombatArena.h"
+#include "JobSystem/JobSystem.h"
+#include "Profiler/GameProfiler.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace {
+const int kNeighborDirs[][2] = {
+        {1, 0}, {0, 1}, {-1, 0}, {0, -1}  // 4方向
+};
+
+float ManhattanDistance(const cocos2d::Vec2& a, const cocos2d::Vec2& b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+
+bool SameTile(const cocos2d::Vec2& a, const cocos2d::Vec2& b) {
+    return std::floor(a.x) == std::floor(b.x) && std::floor(a.y) == std::floor(b.y);
+}
+}
+
+bool PathRequest::SameSearch(const PathRequest& other) const {
+    return SameTile(start_, other.start_) && SameTile(target_, other.target_) &&
+           target_width_ == other.target_width_ && target_length_ == other.target_length_ &&
+           range_ == other.range_ && profile_ == other.profile_;
+}
+
+PathRequestQueue::~PathRequestQueue() {
+    Cancel();
+}
+
+uint32_t PathRequestQueue::Submit(SoldierInCombat* soldier, const PathRequest& request) {
+    const uint32_t ticket = next_ticket_++;
+    if (next_ticket_ == 0) next_ticket_ = 1;
+
+    // 先与在途批次合并（结果同样在下一帧交付），再与待派发请求合并；交付过程中不再并入在途批次
+    for (int i = 0; running_ && i < static_cast<int>(in_flight_.size()); ++i) {
+        if (in_flight_[i].request_.SameSearch(request)) {
+            in_flight_waiters_.push_back({ soldier, ticket, i });
+            ++merged_count_;
+            return ticket;
+        }
+    }
+    for (int i = 0; i < static_cast<int>(pending_.size()); ++i) {
+        if (pending_[i].request_.SameSearch(request)) {
+            pending_waiters_.push_back({ soldier, ticket, i });
+            ++merged_count_;
+            return ticket;
+        }
+    }
+    pending_waiters_.push_back({ soldier, ticket, static_cast<int>(pending_.size()) });
+    pending_.push_back({ request });
+    return ticket;
+}
+
+void PathRequestQueue::ApplyResults() {
+    if (!running_) return;
+    PROFILE_SCOPE(ProfileZone::PathFinding);
+    JobSystem::getInstance()->wait();
+    running_ = false;
+
+    // 按提交顺序交付，结果与工作线程数无关
+    for (const auto& waiter : in_flight_waiters_) {
+        auto soldier = waiter.soldier_;
+        if (soldier->path_ticket_ != waiter.ticket_ || soldier->live_index_ < 0) continue;
+        soldier->OnPathReady(slots_[waiter.search_].path_);
+    }
+    in_flight_.clear();
+    in_flight_waiters_.clear();
+}
+
+void PathRequestQueue::Dispatch(const PathCostField& field, CombatArena& arena) {
+    if (running_ || pending_.empty() || !field.IsBuilt()) return;
+    PROFILE_SCOPE(ProfileZone::PathFinding);
+
+    // 前 count 个搜索进入在途批次，其余等待者的搜索下标前移
+    const int count = std::min(budget_, static_cast<int>(pending_.size()));
+    in_flight_.assign(pending_.begin(), pending_.begin() + count);
+    pending_.erase(pending_.begin(), pending_.begin() + count);
+    size_t kept = 0;
+    for (auto& waiter : pending_waiters_) {
+        if (waiter.search_ < count) {
+            in_flight_waiters_.push_back(waiter);
+        } else {
+            waiter.search_ -= count;
+            pending_waiters_[kept++] = waiter;
+        }
+    }
+    pending_waiters_.resize(kept);
+
+    search_count_ += count;
+    Launch(field, arena);
+}
+
+void PathRequestQueue::Launch(const PathCostField& field, CombatArena& arena) {
+    field.CaptureSnapshot(snapshot_);
+
+    const int count = static_cast<int>(in_flight_.size());
+    const int tiles = snapshot_.width_ * snapshot_.length_;
+    while (static_cast<int>(slots_.size()) < count) {
+        slots_.emplace_back();
+    }
+    for (int i = 0; i < count; ++i) {
+        auto& workspace = slots_[i].workspace_;
+        if (workspace.size_ == tiles) continue;
+        workspace.size_ = tiles;
+        workspace.g_cost_ = arena.NewArray<float>(tiles);
+        workspace.parent_ = arena.NewArray<int>(tiles);
+        workspace.visited_ = arena.NewArray<uint32_t>(tiles);
+        workspace.closed_ = arena.NewArray<uint32_t>(tiles);
+        workspace.serial_ = 0;
+        slots_[i].open_list_.reserve(static_cast<size_t>(tiles) * 2);
+    }
+
+    running_ = true;
+    JobSystem::getInstance()->beginParallelFor(count, 1, job_);
+}
+
+void PathRequestQueue::Discard() {
+    if (running_) {
+        JobSystem::getInstance()->wait();
+        running_ = false;
+    }
+    pending_.clear();
+    pending_waiters_.clear();
+    in_flight_.clear();
+    in_flight_waiters_.clear();
+}
+
+void PathRequestQueue::Cancel() {
+    Discard();
+    // 节点数组来自 battle arena，随 arena 一起归还
+    slots_.clear();
+    snapshot_ = PathGridSnapshot();
+}
+
+void PathRequestQueue::SaveState(PathQueueState& state) const {
+    state.pending_.clear();
+    state.in_flight_.clear();
+    state.waiters_.clear();
+    auto save_waiters = [&state](const std::vector<Waiter>& waiters, bool in_flight) {
+        for (const auto& waiter : waiters) {
+            auto soldier = waiter.soldier_;
+            if (soldier->path_ticket_ != waiter.ticket_ || soldier->live_index_ < 0) continue;
+            state.waiters_.push_back({ soldier->handle_, waiter.search_, in_flight });
+        }
+    };
+    // 作废等待者的搜索仍占用预算，原样保留，派发时机才与原战斗一致
+    for (const auto& search : in_flight_) state.in_flight_.push_back(search.request_);
+    save_waiters(in_flight_waiters_, true);
+    for (const auto& search : pending_) state.pending_.push_back(search.request_);
+    save_waiters(pending_waiters_, false);
+}
+
+void PathRequestQueue::RestoreState(const PathQueueState& state, const CombatHandleTable<SoldierInCombat>& soldiers,
+                                    const PathCostField& field, CombatArena& arena) {
+    Discard();
+    for (const auto& request : state.in_flight_) in_flight_.push_back({ request });
+    for (const auto& request : state.pending_) pending_.push_back({ request });
+    for (const auto& saved : state.waiters_) {
+        auto soldier = soldiers.Get(saved.soldier_);
+        if (!soldier) continue;
+        const uint32_t ticket = next_ticket_++;
+        if (next_ticket_ == 0) next_ticket_ = 1;
+        soldier->path_ticket_ = ticket;
+        auto& waiters = saved.in_flight_ ? in_flight_waiters_ : pending_waiters_;
+        waiters.push_back({ soldier, ticket, saved.search_ });
+    }
+    if (!in_flight_.empty() && field.IsBuilt()) {
+        Launch(field, arena);
+    }
+}
+
+void PathRequestQueue::SearchJob::operator()(int begin, int end) const {
+    for (int i = begin; i < end; ++i) {
+        auto& slot = queue_->slots_[i];
+        FindPath(queue_->snapshot_, queue_->in_flight_[i].request_, slot.workspace_, slot.open_list_, slot.path_);
+    }
+}
+
+// -------------------------- A*寻路 --------------------------
+void PathRequestQueue::FindPath(const PathGridSnapshot& grid, const PathRequest& request,
+                                PathSearchWorkspace& workspace, std::vector<AStarNode>& open_list,
+                                std::vector<cocos2d::Vec2>& path) {
+    path.clear();
+    if (!grid.IsBuilt()) return;
+    const int width = grid.width_;
+    const float soldier_range = request.range_;
+    cocos2d::Vec2 start_tile(std::floor(request.start_.x), std::floor(request.start_.y));
+    cocos2d::Vec2 end_tile(std::floor(request.target_.x), std::floor(request.target_.y));
+    if (!grid.InBounds(static_cast<int>(start_tile.x), static_cast<int>(start_tile.y))) {
+        return;
+    }
+
+    if(request.target_width_!=1 || request.target_length_!=1){
+        // 按 下边→上边→右边→左边 的顺序取离起点最近的建筑边缘格
+        int x_min = static_cast<int>(end_tile.x),y_min = static_cast<int>(end_tile.y),
+            x_max = x_min+request.target_width_-1,y_max = y_min+request.target_length_-1;
+        cocos2d::Vec2 best = end_tile;
+        float best_distance = -1.0f;
+        auto consider = [&](int x, int y) {
+            cocos2d::Vec2 candidate(x, y);
+            float distance = start_tile.distance(candidate);
+            if (best_distance < 0.0f || distance < best_distance) {
+                best = candidate;
+                best_distance = distance;
+            }
+        };
+        for (int x = x_min; x <= x_max; x += 1) consider(x, y_min);
+        for (int x = x_min; x <= x_max; x += 1) consider(x, y_max);
+        for (int y = y_min + 1; y < y_max; y += 1) consider(x_max, y);
+        for (int y = y_min + 1; y < y_max; y += 1) consider(x_min, y);
+        end_tile = best;
+    }
+
+    // 存在不破坏任何建筑的路线时只在空地上搜索，避免无谓地拆墙
+    const bool avoid_buildings = grid.CanReachWithoutBreaking(
+        static_cast<int>(start_tile.x), static_cast<int>(start_tile.y),
+        static_cast<int>(end_tile.x), static_cast<int>(end_tile.y), soldier_range);
+
+    // 1. 节点数组按格子下标平铺，OpenList 为小根堆，二者容量都由槽位复用
+    workspace.Begin();
+    open_list.clear();
+    auto push_open = [&open_list](const AStarNode& node) {
+        open_list.push_back(node);
+        std::push_heap(open_list.begin(), open_list.end(), std::greater<>());
+    };
+
+    // 2. 起点入队
+    const int start_index = static_cast<int>(start_tile.y) * width + static_cast<int>(start_tile.x);
+    workspace.Visit(start_index, 0.0f, -1);
+    push_open({0.0f, ManhattanDistance(start_tile, end_tile), start_index});
+
+    // 3. 核心寻路循环
+    while (!open_list.empty()) {
+        // 3.1 取出OpenList中F值最小的节点
+        std::pop_heap(open_list.begin(), open_list.end(), std::greater<>());
+        AStarNode current = open_list.back();
+        open_list.pop_back();
+        const int cx = current.tile % width, cy = current.tile / width;
+        const cocos2d::Vec2 current_pos(cx, cy);
+
+        // 3.2 若到达终点，回溯路径
+        if (current_pos.distance(end_tile)<=soldier_range) {
+            // 回溯父节点直到起点
+            for (int tile = current.tile; tile != start_index; tile = workspace.parent_[tile]) {
+                path.emplace_back(tile % width, tile / width);
+            }
+            path.push_back(start_tile);
+            std::reverse(path.begin(), path.end());  // 反转路径为起点→终点
+            return;
+        }
+
+        // 3.3 标记当前节点为已考察
+        if(workspace.IsClosed(current.tile)) continue;
+        workspace.Close(current.tile);
+
+        // 3.4 遍历所有邻居节点
+        for (const auto& dir : kNeighborDirs) {
+            const int nx = cx + dir[0], ny = cy + dir[1];
+            const int neighbor = ny * width + nx;
+
+            // 邻居不可通行或已在ClosedList，跳过
+            if (!grid.InBounds(nx, ny) || workspace.IsClosed(neighbor)) {
+                continue;
+            }
+            // 3.5 计算邻居的G/H/F代价
+            float new_g = current.g_cost + 1;
+            float new_h = ManhattanDistance(cocos2d::Vec2(nx, ny),end_tile);  // 启发代价为曼哈顿距离
+            if(!grid.IsFree(nx, ny)){
+                // 代价来自占用建筑在快照时的血量与本兵种 DPS
+                float break_cost = grid.GetBreakCost(nx, ny, request.profile_);
+                if (avoid_buildings || break_cost == PathCostField::kImpassable) continue;
+                new_g += break_cost;
+            }
+
+            // 若邻居尚未访问，或新路径代价更低 → 更新并加入OpenList
+            if (!workspace.IsVisited(neighbor) || new_g < workspace.g_cost_[neighbor]) {
+                workspace.Visit(neighbor, new_g, current.tile);
+                push_open({new_g, new_h, neighbor});
+            }
+        }
+    }
+    // 4. 寻路失败，path 为空
+}
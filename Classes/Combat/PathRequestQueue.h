@@ -0,0 +1,127 @@
+// PathRequestQueue.h
+// 异步寻路请求队列：士兵提交请求（起点、目标占地、射程、拆除代价参数），
+// 每帧按预算取出一批，在 PathGridSnapshot 上由 JobSystem 工作线程搜索，
+// 结果在下一次 CombatManager::update 开始时按提交顺序交回士兵；
+// 起点格、目标与参数完全相同的请求合并为一次搜索
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_PATHREQUESTQUEUE_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_PATHREQUESTQUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include "cocos2d.h"
+#include "PathCostField.h"
+#include "CombatHandle.h"
+
+class SoldierInCombat;
+class CombatArena;
+
+struct PathRequest {
+    cocos2d::Vec2 start_;            // 起点（地图坐标，搜索时取整到格子）
+    cocos2d::Vec2 target_;           // 目标建筑左下角格子
+    int target_width_ = 1;
+    int target_length_ = 1;
+    float range_ = 0.0f;             // 攻击射程：到达距目标 range_ 以内即停止
+    PathCostProfile profile_;
+
+    // 两个请求的搜索结果必然相同
+    bool SameSearch(const PathRequest& other) const;
+};
+
+// 队列中的请求与仍然有效的等待者（战斗快照用）；等待者以士兵句柄记录，恢复时重新发放票号
+struct PathQueueState {
+    struct Waiter {
+        CombatHandle soldier_;
+        int search_ = 0;
+        bool in_flight_ = false;
+    };
+    std::vector<PathRequest> pending_;
+    std::vector<PathRequest> in_flight_;
+    std::vector<Waiter> waiters_;      // 先在途批次后待派发，各自保持交付顺序
+};
+
+struct AStarNode {
+    float g_cost;                // 起点到当前的实际代价
+    float h_cost;                // 当前到终点的启发代价
+    int tile;                    // 格子下标（y * width + x）
+    float f_cost() const { return g_cost + h_cost; }  // 总代价
+    // 比较函数（用于小根堆的排序：F值小的在前）
+    bool operator>(const AStarNode& other) const { return f_cost() > other.f_cost(); }
+};
+
+class PathRequestQueue {
+public:
+    static constexpr int kDefaultBudget = 8;
+
+    ~PathRequestQueue();
+
+    // 提交请求，返回非 0 票号；士兵只接受与自己 path_ticket_ 相同的结果，重新提交即作废旧请求
+    uint32_t Submit(SoldierInCombat* soldier, const PathRequest& request);
+    // 等待上一批搜索结束，把结果交给仍在等待的士兵（主线程，update 开始时调用）
+    void ApplyResults();
+    // 按预算取出待处理请求、刷新快照并派发（主线程，update 末尾调用）；节点数组从 arena 分配
+    void Dispatch(const PathCostField& field, CombatArena& arena);
+    // 等待在途搜索并丢弃所有请求，保留搜索槽位
+    void Discard();
+    // Discard 并释放搜索槽位（战斗结束时调用，之后才能归还 arena）
+    void Cancel();
+
+    // 保存请求与等待者；已作废（票号不符或士兵已离场）的等待者不保存，它们本来也不会收到结果
+    void SaveState(PathQueueState& state) const;
+    // 丢弃当前请求，换成 state 中的请求；在途批次按保存时的快照立即重新派发，
+    // 结果与保存时的那一批一样在下一次 ApplyResults 交付。士兵须已按句柄登记到 soldiers
+    void RestoreState(const PathQueueState& state, const CombatHandleTable<SoldierInCombat>& soldiers,
+                      const PathCostField& field, CombatArena& arena);
+
+    // 每帧最多派发的搜索数
+    void SetBudget(int budget) { budget_ = std::max(1, budget); }
+    int GetPendingCount() const { return static_cast<int>(pending_.size()); }
+    // 累计执行的搜索数与被合并掉的请求数
+    uint64_t GetSearchCount() const { return search_count_; }
+    uint64_t GetMergedCount() const { return merged_count_; }
+
+    // 在快照上做一次 A* 搜索，把格子路径写入 path（失败时为空），可在任意线程调用
+    static void FindPath(const PathGridSnapshot& grid, const PathRequest& request,
+                         PathSearchWorkspace& workspace, std::vector<AStarNode>& open_list,
+                         std::vector<cocos2d::Vec2>& path);
+
+private:
+    struct Search {
+        PathRequest request_;
+    };
+    struct Waiter {
+        SoldierInCombat* soldier_;
+        uint32_t ticket_;
+        int search_;                 // 所在批次中的搜索下标
+    };
+    // 每个搜索槽位独占节点数组与 OpenList，容量在整场战斗中复用
+    struct SearchSlot {
+        PathSearchWorkspace workspace_;
+        std::vector<AStarNode> open_list_;
+        std::vector<cocos2d::Vec2> path_;
+    };
+    // 传给 JobSystem 的任务对象，需在搜索期间保持有效
+    struct SearchJob {
+        PathRequestQueue* queue_;
+        void operator()(int begin, int end) const;
+    };
+
+    // 为 in_flight_ 准备搜索槽位、刷新快照并交给工作线程
+    void Launch(const PathCostField& field, CombatArena& arena);
+
+    int budget_ = kDefaultBudget;
+    uint32_t next_ticket_ = 1;
+    std::vector<Search> pending_;
+    std::vector<Waiter> pending_waiters_;
+    // 在途批次：派发后到 ApplyResults 之前工作线程只读 in_flight_、snapshot_，只写各自的 slots_
+    std::vector<Search> in_flight_;
+    std::vector<Waiter> in_flight_waiters_;
+    std::vector<SearchSlot> slots_;
+    PathGridSnapshot snapshot_;
+    SearchJob job_{ this };
+    bool running_ = false;
+    uint64_t search_count_ = 0;
+    uint64_t merged_count_ = 0;
+};
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_PATHREQUESTQUEUE_H
@@ -0,0 +1,93 @@
+// SoldierAnimation.cpp
+// 士兵动画数据库实现
+
+#include "SoldierAnimation.h"
+#include "SoldierAnimationTable.h"
+#include "Profiler/GameProfiler.h"
+
+static_assert(soldier_anim_table::kSoldierCount == static_cast<int>(SoldierType::kSoldierTypes),
+              "SoldierAnimationTable.h is out of date, rerun tools/gen_soldier_anim_table.py");
+static_assert(soldier_anim_table::kActionCount == static_cast<int>(SoldierAction::kSoldierActions),
+              "SoldierAnimationTable.h is out of date, rerun tools/gen_soldier_anim_table.py");
+static_assert(soldier_anim_table::kDirectionCount == kDirectionCount,
+              "SoldierAnimationTable.h is out of date, rerun tools/gen_soldier_anim_table.py");
+
+SoldierAnimationDatabase* SoldierAnimationDatabase::instance_ = nullptr;
+
+SoldierAnimationDatabase* SoldierAnimationDatabase::GetInstance() {
+    if (!instance_) {
+        instance_ = new (std::nothrow) SoldierAnimationDatabase();
+    }
+    return instance_;
+}
+
+void SoldierAnimationDatabase::DestroyInstance() {
+    CC_SAFE_DELETE(instance_);
+}
+
+SoldierAnimationDatabase::~SoldierAnimationDatabase() {
+    for (auto& per_type : animations_) {
+        for (auto& per_action : per_type) {
+            for (auto& anim : per_action) {
+                CC_SAFE_RELEASE_NULL(anim);
+            }
+        }
+    }
+}
+
+void SoldierAnimationDatabase::Load(const Soldier* soldier_template) {
+    if (!soldier_template) return;
+    int type = static_cast<int>(soldier_template->GetSoldierType());
+    if (type < 0 || type >= kTypeCount || is_loaded_[type]) return;
+    PROFILE_SCOPE(ProfileZone::AssetLoad);
+
+    auto texture = cocos2d::Director::getInstance()->getTextureCache()->addImage(
+            soldier_anim_table::kTexturePaths[type]);
+    if (!texture) {
+        CCLOG("SoldierAnimationDatabase: load texture failure : %s", soldier_anim_table::kTexturePaths[type]);
+        return;
+    }
+
+    // 帧数上限与原先按模板逐帧查找的行为保持一致
+    const int frame_limits[kActionCount] = {soldier_template->walk_frame_num, soldier_template->attack_frame_num};
+    for (int action = 0; action < kActionCount; ++action) {
+        for (int dir = 0; dir < kDirectionCount; ++dir) {
+            const auto& clip = soldier_anim_table::kClips[type][action][dir];
+            int frame_count = std::min(clip.frame_count, frame_limits[action]);
+            if (frame_count <= 0) continue;
+
+            cocos2d::Vector<cocos2d::SpriteFrame*> frames(frame_count);
+            for (int i = 0; i < frame_count; ++i) {
+                const auto& r = soldier_anim_table::kFrames[clip.first_frame + i];
+                cocos2d::Rect rect(r.x, r.y, r.width, r.height);
+                frames.pushBack(cocos2d::SpriteFrame::createWithTexture(texture, rect, false,
+                                                                        cocos2d::Vec2::ZERO, rect.size));
+            }
+            auto anim = cocos2d::Animation::createWithSpriteFrames(frames, soldier_anim_table::kFrameDelay);
+            anim->retain();
+            animations_[type][action][dir] = anim;
+        }
+    }
+
+    is_loaded_[type] = true;
+    CCLOG("SoldierAnimationDatabase: animations of %s loaded", soldier_template->GetName().c_str());
+}
+
+bool SoldierAnimationDatabase::IsLoaded(SoldierType type) const {
+    int index = static_cast<int>(type);
+    return index >= 0 && index < kTypeCount && is_loaded_[index];
+}
+
+cocos2d::Animation* SoldierAnimationDatabase::GetAnimation(SoldierType type, SoldierAction action, Direction dir) const {
+    int t = static_cast<int>(type), a = static_cast<int>(action), d = static_cast<int>(dir);
+    if (t < 0 || t >= kTypeCount || a < 0 || a >= kActionCount || d < 0 || d >= kDirectionCount) {
+        return nullptr;
+    }
+    return animations_[t][a][d];
+}
+
+cocos2d::SpriteFrame* SoldierAnimationDatabase::GetFirstFrame(SoldierType type, SoldierAction action, Direction dir) const {
+    auto anim = GetAnimation(type, action, dir);
+    if (!anim || anim->getFrames().empty()) return nullptr;
+    return anim->getFrames().at(0)->getSpriteFrame();
+}
@@ -0,0 +1,53 @@
+// SoldierAnimation.h
+// 士兵动画数据库：启动时按离线生成的帧表（SoldierAnimationTable.h）一次性构建所有动画，
+// 运行时按 兵种 x 动作 x 方向 的枚举下标直接取用，不再拼接帧名或查询 AnimationCache
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATION_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATION_H
+
+#include "cocos2d.h"
+#include "Soldier/Soldier.h"
+
+enum class SoldierAction : int {
+    kWalk = 0,
+    kAttack = 1,
+    kSoldierActions
+};
+
+// 4方向（与帧表中的方向顺序一致）
+enum class Direction : int {
+    UP = 0,
+    DOWN = 1,
+    LEFT = 2,
+    RIGHT = 3
+};
+constexpr int kDirectionCount = 4;
+
+class SoldierAnimationDatabase {
+public:
+    static SoldierAnimationDatabase* GetInstance();
+    static void DestroyInstance();
+
+    // 加载指定兵种的全部动画（每个兵种仅首次调用生效），帧数受兵种模板的帧数限制
+    void Load(const Soldier* soldier_template);
+    bool IsLoaded(SoldierType type) const;
+
+    // 未加载或该动作无帧时返回 nullptr
+    cocos2d::Animation* GetAnimation(SoldierType type, SoldierAction action, Direction dir) const;
+    cocos2d::SpriteFrame* GetFirstFrame(SoldierType type, SoldierAction action, Direction dir) const;
+
+private:
+    SoldierAnimationDatabase() = default;
+    ~SoldierAnimationDatabase();
+
+    static SoldierAnimationDatabase* instance_;
+
+    static constexpr int kTypeCount = static_cast<int>(SoldierType::kSoldierTypes);
+    static constexpr int kActionCount = static_cast<int>(SoldierAction::kSoldierActions);
+
+    // 扁平动画表：[兵种][动作][方向]，持有引用直到数据库销毁
+    cocos2d::Animation* animations_[kTypeCount][kActionCount][kDirectionCount] = {};
+    bool is_loaded_[kTypeCount] = {};
+};
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATION_H
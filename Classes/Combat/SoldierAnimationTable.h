@@ -0,0 +1,270 @@
+// SoldierAnimationTable.h
+// 由 tools/gen_soldier_anim_table.py 根据 Resources/Soldiers/*/anims.plist 生成，请勿手动修改
+
+#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATIONTABLE_H
+#define PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATIONTABLE_H
+
+namespace soldier_anim_table {
+
+struct FrameRect { float x, y, width, height; };
+struct Clip { int first_frame; int frame_count; };
+
+constexpr int kSoldierCount = 4;
+constexpr int kActionCount = 2;
+constexpr int kDirectionCount = 4;
+constexpr float kFrameDelay = 0.10f;
+
+// 兵种图集路径（下标与 SoldierType 一致）
+constexpr const char* kTexturePaths[kSoldierCount] = {
+        "Soldiers/Barbarian/anims.png",
+        "Soldiers/Archer/anims.png",
+        "Soldiers/Bomber/anims.png",
+        "Soldiers/Giant/anims.png",
+};
+
+// [兵种][动作][方向] -> 帧区间（方向顺序：up, down, left, right）
+constexpr Clip kClips[kSoldierCount][kActionCount][kDirectionCount] = {
+        { // Barbarian
+                {{0, 8}, {8, 8}, {16, 8}, {24, 8}}, // walk
+                {{32, 8}, {40, 8}, {48, 8}, {56, 8}}, // attack
+        },
+        { // Archer
+                {{64, 8}, {72, 8}, {80, 8}, {88, 8}}, // walk
+                {{96, 4}, {100, 4}, {104, 4}, {108, 4}}, // attack
+        },
+        { // Bomber
+                {{112, 6}, {118, 6}, {124, 6}, {130, 6}}, // walk
+                {{136, 0}, {136, 0}, {136, 0}, {136, 0}}, // attack
+        },
+        { // Giant
+                {{136, 12}, {148, 12}, {160, 12}, {172, 12}}, // walk
+                {{184, 8}, {192, 9}, {201, 9}, {210, 9}}, // attack
+        },
+};
+
+// 图集内的帧矩形（像素，左上角为原点）
+constexpr FrameRect kFrames[] = {
+        {383, 639, 66, 94},
+        {425, 384, 73, 81},
+        {75, 304, 66, 78},
+        {376, 74, 75, 75},
+        {426, 0, 83, 74},
+        {0, 149, 81, 75},
+        {378, 149, 71, 77},
+        {67, 550, 69, 85},
+        {313, 226, 67, 78},
+        {141, 304, 57, 79},
+        {198, 304, 68, 79},
+        {380, 226, 74, 78},
+        {0, 304, 75, 78},
+        {351, 384, 74, 81},
+        {0, 465, 67, 82},
+        {81, 149, 56, 76},
+        {0, 0, 101, 70},
+        {206, 149, 86, 77},
+        {266, 304, 71, 80},
+        {337, 304, 71, 80},
+        {408, 304, 69, 80},
+        {67, 465, 68, 83},
+        {135, 465, 73, 83},
+        {194, 74, 91, 75},
+        {101, 0, 101, 70},
+        {292, 149, 86, 77},
+        {0, 384, 71, 80},
+        {71, 384, 71, 80},
+        {142, 384, 69, 80},
+        {208, 465, 68, 83},
+        {276, 465, 73, 83},
+        {285, 74, 91, 75},
+        {341, 0, 85, 74},
+        {220, 733, 61, 108},
+        {137, 149, 69, 77},
+        {125, 74, 69, 75},
+        {349, 465, 70, 84},
+        {0, 733, 94, 98},
+        {196, 226, 117, 78},
+        {254, 550, 116, 87},
+        {320, 639, 63, 94},
+        {202, 0, 56, 72},
+        {0, 639, 62, 91},
+        {419, 465, 62, 85},
+        {258, 0, 83, 73},
+        {0, 550, 67, 85},
+        {136, 550, 118, 86},
+        {0, 74, 125, 75},
+        {370, 550, 66, 89},
+        {62, 639, 66, 91},
+        {194, 639, 63, 92},
+        {211, 384, 70, 81},
+        {94, 733, 63, 100},
+        {0, 226, 98, 78},
+        {281, 733, 43, 118},
+        {367, 733, 50, 119},
+        {436, 550, 66, 89},
+        {128, 639, 66, 91},
+        {257, 639, 63, 92},
+        {281, 384, 70, 81},
+        {157, 733, 63, 100},
+        {98, 226, 98, 78},
+        {324, 733, 43, 118},
+        {417, 733, 50, 119},
+        {93, 240, 39, 69},
+        {283, 240, 41, 70},
+        {132, 240, 39, 69},
+        {324, 240, 41, 70},
+        {171, 240, 39, 69},
+        {365, 240, 41, 70},
+        {210, 240, 39, 69},
+        {406, 240, 41, 70},
+        {202, 174, 57, 62},
+        {259, 174, 55, 62},
+        {452, 55, 53, 58},
+        {290, 55, 52, 57},
+        {233, 113, 51, 60},
+        {183, 113, 50, 59},
+        {0, 55, 50, 56},
+        {0, 113, 53, 58},
+        {50, 55, 64, 56},
+        {53, 113, 65, 58},
+        {284, 113, 54, 60},
+        {392, 113, 50, 61},
+        {342, 55, 55, 57},
+        {368, 0, 56, 55},
+        {442, 113, 52, 61},
+        {0, 174, 50, 61},
+        {114, 55, 64, 56},
+        {118, 113, 65, 58},
+        {338, 113, 54, 60},
+        {50, 174, 50, 61},
+        {397, 55, 55, 57},
+        {424, 0, 56, 55},
+        {100, 174, 52, 61},
+        {152, 174, 50, 61},
+        {447, 240, 41, 75},
+        {249, 240, 34, 70},
+        {0, 240, 42, 67},
+        {42, 240, 51, 68},
+        {314, 174, 58, 63},
+        {462, 174, 43, 66},
+        {419, 174, 43, 64},
+        {372, 174, 47, 63},
+        {0, 0, 70, 55},
+        {178, 55, 56, 57},
+        {70, 0, 56, 55},
+        {126, 0, 58, 55},
+        {184, 0, 70, 55},
+        {234, 55, 56, 57},
+        {254, 0, 56, 55},
+        {310, 0, 58, 55},
+        {0, 1302, 64, 69},
+        {0, 1371, 64, 69},
+        {0, 1440, 64, 69},
+        {0, 1509, 64, 69},
+        {0, 1578, 64, 69},
+        {0, 1647, 64, 69},
+        {0, 0, 64, 66},
+        {0, 66, 64, 66},
+        {0, 132, 64, 66},
+        {0, 198, 64, 66},
+        {0, 264, 64, 66},
+        {0, 330, 64, 66},
+        {0, 396, 64, 74},
+        {0, 470, 64, 74},
+        {0, 544, 64, 74},
+        {0, 618, 64, 74},
+        {0, 692, 64, 74},
+        {0, 766, 64, 74},
+        {0, 840, 64, 77},
+        {0, 917, 64, 77},
+        {0, 994, 64, 77},
+        {0, 1071, 64, 77},
+        {0, 1148, 64, 77},
+        {0, 1225, 64, 77},
+        {852, 749, 85, 141},
+        {0, 890, 95, 141},
+        {425, 612, 110, 132},
+        {97, 232, 125, 119},
+        {264, 354, 137, 123},
+        {0, 481, 143, 127},
+        {143, 481, 147, 127},
+        {639, 232, 144, 121},
+        {874, 0, 134, 114},
+        {486, 114, 119, 117},
+        {546, 481, 102, 130},
+        {460, 749, 91, 138},
+        {472, 0, 147, 113},
+        {347, 114, 139, 116},
+        {783, 232, 124, 122},
+        {102, 612, 109, 132},
+        {193, 749, 97, 137},
+        {551, 749, 92, 139},
+        {643, 749, 89, 139},
+        {290, 481, 92, 130},
+        {0, 232, 97, 118},
+        {619, 0, 113, 113},
+        {235, 0, 131, 111},
+        {732, 0, 142, 113},
+        {648, 481, 122, 131},
+        {203, 890, 89, 143},
+        {525, 890, 63, 145},
+        {292, 890, 72, 143},
+        {290, 749, 85, 138},
+        {211, 612, 107, 132},
+        {677, 354, 117, 127},
+        {907, 232, 108, 122},
+        {0, 354, 78, 122},
+        {401, 354, 78, 125},
+        {382, 481, 82, 130},
+        {770, 481, 102, 131},
+        {872, 481, 122, 131},
+        {364, 890, 89, 143},
+        {588, 890, 63, 145},
+        {453, 890, 72, 143},
+        {375, 749, 85, 138},
+        {318, 612, 107, 132},
+        {794, 354, 117, 127},
+        {78, 354, 108, 122},
+        {186, 354, 78, 122},
+        {479, 354, 78, 125},
+        {464, 481, 82, 130},
+        {0, 612, 102, 131},
+        {557, 354, 120, 127},
+        {95, 890, 108, 143},
+        {732, 749, 120, 140},
+        {822, 612, 121, 136},
+        {98, 1046, 106, 163},
+        {241, 114, 106, 116},
+        {825, 114, 105, 118},
+        {529, 232, 110, 121},
+        {0, 114, 121, 116},
+        {535, 612, 133, 134},
+        {626, 1046, 97, 170},
+        {723, 1046, 94, 173},
+        {222, 232, 121, 120},
+        {366, 0, 106, 112},
+        {0, 0, 114, 97},
+        {114, 0, 121, 107},
+        {121, 114, 120, 116},
+        {943, 612, 63, 137},
+        {875, 890, 98, 156},
+        {418, 1046, 104, 169},
+        {204, 1046, 107, 166},
+        {651, 890, 112, 150},
+        {605, 114, 110, 118},
+        {343, 232, 93, 121},
+        {668, 612, 77, 135},
+        {0, 749, 65, 137},
+        {65, 749, 63, 137},
+        {0, 1046, 98, 156},
+        {522, 1046, 104, 169},
+        {311, 1046, 107, 166},
+        {763, 890, 112, 150},
+        {715, 114, 110, 118},
+        {436, 232, 93, 121},
+        {745, 612, 77, 135},
+        {128, 749, 65, 137},
+};
+
+} // namespace soldier_anim_table
+
+#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATIONTABLE_H
@@ -4,15 +4,25 @@
 #include "SoldierInCombat.h"
 #include "BuildingInCombat.h"
 #include "Combat.h"
-#include <unordered_set>
+#include "AnimatedUnitRenderer.h"
+#include "CombatEntityPool.h"
+#include "CombatSnapshot.h"
+#include "Profiler/GameProfiler.h"
+#include "Profiler/StructuredLog.h"
+#include "EventBus/EventBus.h"
+#include <algorithm>
 #include <string>
 
+uint64_t SoldierInCombat::next_action_order_ = 0;
 
-bool SoldierInCombat::is_animation_loaded_[];
-
-const std::string SoldierInCombat::direction_names[4] = {"up", "down", "left", "right"};
 // -------------------------- 工厂方法实现 --------------------------
 SoldierInCombat* SoldierInCombat::Create(const Soldier* soldier_template, const cocos2d::Vec2& spawn_pos,MapManager* map) {
+    if (soldier_template) {
+        auto pooled = CombatEntityPool::GetInstance()->AcquireSoldier(soldier_template->GetSoldierType());
+        if (pooled) {
+            return pooled->Spawn(soldier_template, spawn_pos, map) ? pooled : nullptr;
+        }
+    }
     auto soldier = new (std::nothrow) SoldierInCombat();
     if (soldier && soldier->Init(soldier_template, spawn_pos,map)) {
         soldier->autorelease();  // Cocos2d-x自动内存管理
@@ -22,6 +32,16 @@ SoldierInCombat* SoldierInCombat::Create(const Soldier* soldier_template, const
     return nullptr;
 }
 
+SoldierInCombat* SoldierInCombat::CreateIdle(const Soldier* soldier_template) {
+    auto soldier = new (std::nothrow) SoldierInCombat();
+    if (soldier && soldier->InitNode(soldier_template)) {
+        soldier->autorelease();
+        return soldier;
+    }
+    CC_SAFE_DELETE(soldier);
+    return nullptr;
+}
+
 SoldierInCombat::~SoldierInCombat() {
     current_target_ = nullptr;  // 清空目标指针，避免悬空
 }
@@ -29,6 +49,10 @@ SoldierInCombat::~SoldierInCombat() {
 // -------------------------- 初始化实现 --------------------------
 
 bool SoldierInCombat::Init(const Soldier* soldier_template, const cocos2d::Vec2& spawn_pos,MapManager* map) {
+    return InitNode(soldier_template) && Spawn(soldier_template, spawn_pos, map);
+}
+
+bool SoldierInCombat::InitNode(const Soldier* soldier_template) {
     // 1. 调用父类Sprite::init()确保渲染节点初始化
     if (!cocos2d::Sprite::init()) {
         CCLOG("SoldierInCombat Init Failed: Sprite Init Error");
@@ -40,18 +64,48 @@ bool SoldierInCombat::Init(const Soldier* soldier_template, const cocos2d::Vec2&
         return false;
     }
 
+    auto anim_db = SoldierAnimationDatabase::GetInstance();
+    anim_db->Load(soldier_template);
+    auto firstFrame = anim_db->GetFirstFrame(soldier_template->GetSoldierType(),SoldierAction::kWalk,Direction::DOWN);
+    if (!firstFrame) {
+        CCLOG("SoldierInCombat init failed: walk animation missing!");
+        return false;
+    }
+    this->setSpriteFrame(firstFrame);
+
+    // 血条随节点一起被对象池复用，同兵种帧尺寸相同
+    auto soldier_size = this->getContentSize();
+    hp_bar_ = HpBarComponents::createHpBar(this, soldier_size.height);
+    return true;
+}
+
+bool SoldierInCombat::Spawn(const Soldier* soldier_template, const cocos2d::Vec2& spawn_pos,MapManager* map) {
+    if (!AttachToMap(soldier_template, spawn_pos, map)) return false;
+    this->DoAllMyActions();
+    return true;
+}
+
+bool SoldierInCombat::AttachToMap(const Soldier* soldier_template, const cocos2d::Vec2& spawn_pos,MapManager* map) {
+    if (!soldier_template) {
+        CCLOG("SoldierInCombat init failed: Invalid soldier template!");
+        return false;
+    }
+
     // 3.设置兵种属性
     soldier_template_ = soldier_template;
     position_ = spawn_pos;
     current_health_ = soldier_template->GetHealth();
     current_target_ = nullptr;
+    // 动作交给战斗的固定步长 ActionManager 推进；切换时清掉原 ActionManager 上的动作
+    auto manager = CombatManager::GetInstance();
+    if (manager) this->setActionManager(manager->GetTickActionManager());
+    // 回收时可能还留有在离场后才排入的动作（如自爆回调里的 Die），上场前清掉
+    this->stopAllActions();
 
-    if (!is_animation_loaded_[static_cast<int>(this->soldier_template_->GetSoldierType())]) {
-        LoadSoldierAnimations();
-    }
-    auto soldierAnim = cocos2d::AnimationCache::getInstance()->getAnimation(this->soldier_template_->GetName()+"walkdown");
-    auto firstFrame = soldierAnim->getFrames().at(0)->getSpriteFrame();
-    this->setSpriteFrame(firstFrame);
+    auto firstFrame = SoldierAnimationDatabase::GetInstance()->GetFirstFrame(
+            soldier_template_->GetSoldierType(),SoldierAction::kWalk,Direction::DOWN);
+    if (firstFrame) this->setSpriteFrame(firstFrame);
+    this->setFlippedX(false);
 
     // 4. 设置初始状态
     map_ = map;
@@ -68,14 +122,57 @@ bool SoldierInCombat::Init(const Soldier* soldier_template, const cocos2d::Vec2&
     map_->addToWorld(this);
     map_->updateYOrder(this);
 
-    auto soldier_size = this->getContentSize();
-    hp_bar_ = HpBarComponents::createHpBar(this, soldier_size.height);
-
-    this->DoAllMyActions();
+    auto unit_renderer = manager ? manager->GetUnitRenderer() : nullptr;
+    if (unit_renderer) {
+        unit_handle_ = unit_renderer->AddUnit(soldier_template_, this->getPosition(), this->getScale());
+    }
 
+    hp_bar_.reset(this->getContentSize().height);
     return true;
 }
 
+SoldierInCombat* SoldierInCombat::Restore(const SoldierState& state, MapManager* map) {
+    if (!state.template_) return nullptr;
+    auto soldier = CombatEntityPool::GetInstance()->AcquireSoldier(state.template_->GetSoldierType());
+    if (!soldier) soldier = CreateIdle(state.template_);
+    if (!soldier || !soldier->AttachToMap(state.template_, state.position_, map)) return nullptr;
+
+    soldier->setPosition(state.node_position_);
+    soldier->setFlippedX(state.flipped_);
+    map->updateYOrder(soldier);
+    if (auto unit_renderer = soldier->GetUnitRenderer()) {
+        unit_renderer->SetPosition(soldier->unit_handle_, state.node_position_);
+    }
+    soldier->current_health_ = state.health_;
+    soldier->hp_bar_.updateHp(state.health_, state.template_->GetHealth());
+    return soldier;
+}
+
+void SoldierInCombat::Recycle() {
+    this->stopAllActions();
+    // 交还 Director 的 ActionManager，对象池中的节点不再持有已结束战斗的 ActionManager
+    this->setActionManager(cocos2d::Director::getInstance()->getActionManager());
+    if (auto unit_renderer = GetUnitRenderer()) {
+        unit_renderer->RemoveUnit(unit_handle_);
+    }
+    unit_handle_ = -1;
+    current_target_ = nullptr;
+    path_ticket_ = 0;
+    map_ = nullptr;
+    this->removeFromParent();
+}
+
+void SoldierInCombat::draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) {
+    if (unit_handle_ >= 0) return;
+    cocos2d::Sprite::draw(renderer, transform, flags);
+}
+
+AnimatedUnitRenderer* SoldierInCombat::GetUnitRenderer() const {
+    if (unit_handle_ < 0) return nullptr;
+    auto manager = CombatManager::GetInstance();
+    return manager ? manager->GetUnitRenderer() : nullptr;
+}
+
 void SoldierInCombat::TakeDamage(int damage) {
     current_health_ -= damage;
     if (current_health_ < 0){
@@ -86,58 +183,7 @@ void SoldierInCombat::TakeDamage(int damage) {
 }
 
 
-void SoldierInCombat::LoadSoldierAnimations() const {
-    auto name = this->soldier_template_->GetName();
-    auto frame_cache = cocos2d::SpriteFrameCache::getInstance();
-    // 1. 加载动画资源plist（需将所有士兵动画帧打包为soldier_anim.plist+png，放在Resources目录）
-    std::string plist_name = "Soldiers/"+name+"/anims.plist";
-    std::string png_name = "Soldiers/"+name+"/anims.png";
-    frame_cache->addSpriteFramesWithFile(plist_name, png_name);
-    CCLOG("call load soldier animations of %s",name.c_str());
-
-    // 2. 4方向移动动画（每方向8帧）
-    for (const auto& dir_name : direction_names) {
-        cocos2d::Vector<cocos2d::SpriteFrame*> move_frames;
-        std::string anim_name = name+"walk" ;
-        anim_name += dir_name;
-        for (int i = 1; i <= this->soldier_template_->walk_frame_num; ++i) {
-            std::string frame_name =  anim_name + std::to_string(i) + ".png";
-            auto frame = frame_cache->getSpriteFrameByName(frame_name);
-            if (frame) move_frames.pushBack(frame);
-        }
-        if(!move_frames.empty()) {
-            auto move_anim = cocos2d::Animation::createWithSpriteFrames(move_frames, 0.1f); // 0.1秒/帧
-            cocos2d::AnimationCache::getInstance()->addAnimation(move_anim, anim_name);
-        }
-    }
-
-    // 3. 攻击动画（8帧）
-    for (const auto& dir_name : direction_names) {
-        cocos2d::Vector<cocos2d::SpriteFrame*> attack_frames;
-        std::string anim_name = name+"attack" ;
-        anim_name += dir_name;
-        for (int i = 1; i <= this->soldier_template_->attack_frame_num; ++i) {
-            std::string frame_name = anim_name + std::to_string(i) + ".png";
-            auto frame = frame_cache->getSpriteFrameByName(frame_name);
-            if (frame) attack_frames.pushBack(frame);
-        }
-        if(!attack_frames.empty()) {
-            auto attack_anim = cocos2d::Animation::createWithSpriteFrames(attack_frames, 0.1f);
-            cocos2d::AnimationCache::getInstance()->addAnimation(attack_anim, anim_name);
-        }
-    }
-
-    is_animation_loaded_[static_cast<int>(this->soldier_template_->GetSoldierType())] = true;
-}
-
 // -------------------------- 4方向判断（核心：根据移动向量） --------------------------
-enum class Direction : int{
-    UP = 0,
-    DOWN = 1,
-    LEFT = 2,
-    RIGHT = 3
-};
-
 void SetDirection(SoldierInCombat* s,const cocos2d::Vec2& delta){
     float abs_x = abs(delta.x),abs_y = abs(delta.y);
     if (abs_x > abs_y) {
@@ -177,20 +223,30 @@ cocos2d::Spawn* SoldierInCombat::CreateStraightMoveAction(const cocos2d::Vec2& s
 
     // 3. 获取对应方向的动画
     Direction dir = GetDirection(move_delta);
-    auto set_dir =cocos2d::CallFunc::create([this,dir,move_delta]() {
+    auto set_dir =cocos2d::CallFunc::create([this,dir,move_delta,target_screen_pos,move_time]() {
+        action_started_ = true;
+        move_target_ = target_screen_pos;
         SetDirection(this,move_delta);
+        // 批量渲染时只提交一次移动与动画记录，逐帧插值与换帧由着色器完成
+        if (auto unit_renderer = GetUnitRenderer()) {
+            unit_renderer->SetMotion(unit_handle_, this->getPosition(), target_screen_pos, move_time);
+            unit_renderer->SetAnimation(unit_handle_, SoldierAction::kWalk, dir, this->isFlippedX(), true);
+        }
     });
-    std::string dir_name = direction_names[static_cast<int>(dir)],soldier_name = this->soldier_template_->GetName();
-    auto move_anim = cocos2d::AnimationCache::getInstance()->getAnimation( soldier_name +"walk" + dir_name);
-
-    float anim_duration = move_anim ? move_anim->getDuration() : 0.1f; // 兜底值
-    // 计算动画需要循环的次数（移动总时长 / 单段动画时长）
-    int anim_repeat_count = static_cast<int>(move_time / anim_duration);
-    anim_repeat_count = std::max(anim_repeat_count, 1); // 至少循环1次
-
-    // 用Repeat替代RepeatForever，确保动画和移动同步结束
-    auto animate = cocos2d::Repeat::create(cocos2d::Animate::create(move_anim), anim_repeat_count);
-    auto whole_animate = cocos2d::Sequence::create(set_dir,animate, nullptr);
+    cocos2d::FiniteTimeAction* whole_animate = set_dir;
+    if (unit_handle_ < 0) {
+        auto move_anim = SoldierAnimationDatabase::GetInstance()->GetAnimation(
+                soldier_template_->GetSoldierType(),SoldierAction::kWalk,dir);
+
+        float anim_duration = move_anim ? move_anim->getDuration() : 0.1f; // 兜底值
+        // 计算动画需要循环的次数（移动总时长 / 单段动画时长）
+        int anim_repeat_count = static_cast<int>(move_time / anim_duration);
+        anim_repeat_count = std::max(anim_repeat_count, 1); // 至少循环1次
+
+        // 用Repeat替代RepeatForever，确保动画和移动同步结束
+        auto animate = cocos2d::Repeat::create(cocos2d::Animate::create(move_anim), anim_repeat_count);
+        whole_animate = cocos2d::Sequence::create(set_dir,animate, nullptr);
+    }
 
     // 4. 构建“延迟+检测”的循环动作（每0.1秒检测一次）
     auto update_position = cocos2d::CallFunc::create([this]() {
@@ -213,10 +269,12 @@ cocos2d::Spawn* SoldierInCombat::CreateStraightMoveAction(const cocos2d::Vec2& s
 
 void SoldierInCombat::DoAllMyActions(){
     BuildingInCombat* next_target = GetNextTarget();  // 寻找下一个目标
-    if (next_target) {
-        SubscribeTarget(next_target);
-        MoveToTargetAndStartAttack();  // 移动到新目标继续攻击
-    }
+    if (next_target) AttackTarget(next_target);
+}
+
+void SoldierInCombat::AttackTarget(BuildingInCombat* target) {
+    SubscribeTarget(target);
+    MoveToTargetAndStartAttack();  // 移动到新目标继续攻击
 }
 
 // -------------------------- 死亡实现 --------------------------
@@ -224,40 +282,42 @@ void SoldierInCombat::NotifyManagerDie(){
     auto manager = CombatManager::GetInstance();
     if (manager) {
         manager->num_of_live_soldiers_--;
-        for(auto it = manager->live_soldiers_.begin(); it != manager->live_soldiers_.end(); ++it){
-            if(*it == this){
-                manager->live_soldiers_.erase(it);
-                break;
-            }
-        }
-
-        for(auto it:manager->live_buildings_){
-            if(typeid(*it)== typeid(AttackBuildingInCombat)){
-                auto b = dynamic_cast<AttackBuildingInCombat*>(it);
-                if(b->current_target_==this){
-                    b->current_target_ = nullptr;
-                }
-            }
-        }
+        // 句柄失效后，以本士兵为目标的防御建筑下次取目标时自然得到 nullptr
+        manager->RemoveLiveSoldier(this);
 
         if(manager->IsCombatEnd()){
-            CCLOG("call EndCombat() from soldier");
+            TJ_LOG_INFO(LogCategory::Combat, "call EndCombat() from soldier");
             manager->EndCombat();
         }
     }
 }
 
 void SoldierInCombat::Die() {
-    CCLOG("soldier die started");
+    TJ_LOG_DEBUG(LogCategory::Combat, "%s die started", soldier_template_->GetName());
     this->stopAllActions();  // 停止所有当前动作
 
     auto remove_self = cocos2d::CallFunc::create([this]() {
         UnsubscribeTarget(current_target_);
         NotifyManagerDie();
-        AudioManager::getInstance()->playDie();
-        this->removeFromParent();
+        PublishSoldierEvent(GameEventType::SoldierDied);
+        CombatEntityPool::GetInstance()->ReleaseSoldier(this);
     });
-    this->runAction(remove_self);
+    RunTracked(remove_self, kDieActionTag);
+}
+
+void SoldierInCombat::RunTracked(cocos2d::Action* action, int tag) {
+    // 节点没有动作时 ActionManager 为它新建条目并排在末尾，同一帧内各士兵按条目先后推进；
+    // 记下这个先后，恢复快照时按同样的顺序重建动作
+    if (this->getNumberOfRunningActions() == 0) action_order_ = ++next_action_order_;
+    action_started_ = false;
+    action->setTag(tag);
+    this->runAction(action);
+}
+
+void SoldierInCombat::PublishSoldierEvent(GameEventType type) const {
+    auto event = GameEvent::make(type);
+    event.soldier.soldierType = static_cast<int>(soldier_template_->GetSoldierType());
+    EventBus::getInstance()->publish(event);
 }
 
 void SoldierInCombat::StartAttack(const cocos2d::Vec2& pos) {
@@ -267,16 +327,27 @@ void SoldierInCombat::StartAttack(const cocos2d::Vec2& pos) {
     }
     auto delta = current_target_->position_-pos;
     Direction dir = GetDirection(delta);
-    auto set_dir =cocos2d::CallFunc::create([this,delta]() {
+    auto set_dir =cocos2d::CallFunc::create([this,delta,dir]() {
+        action_started_ = true;
         SetDirection(this,delta);
+        if (auto unit_renderer = GetUnitRenderer()) {
+            unit_renderer->SetPosition(unit_handle_, this->getPosition());
+            unit_renderer->SetAnimation(unit_handle_, SoldierAction::kAttack, dir, this->isFlippedX(), false);
+        }
     });
-    std::string dir_name = direction_names[static_cast<int>(dir)],soldier_name = this->soldier_template_->GetName();
-    auto attack_anim = cocos2d::AnimationCache::getInstance()->getAnimation( soldier_name+"attack"+dir_name);
-
-    auto animate = cocos2d::Animate::create(attack_anim);
+    auto attack_anim = SoldierAnimationDatabase::GetInstance()->GetAnimation(
+            soldier_template_->GetSoldierType(),SoldierAction::kAttack,dir);
+
+    // 批量渲染时攻击动画由着色器播放，这里只保留等长的等待；缺少动画时同样只等待
+    float anim_duration = attack_anim ? attack_anim->getDuration() : 0.1f; // 兜底值
+    cocos2d::FiniteTimeAction* animate = nullptr;
+    if (unit_handle_ < 0 && attack_anim) animate = cocos2d::Animate::create(attack_anim);
+    else animate = cocos2d::DelayTime::create(anim_duration);
     auto single_attack = cocos2d::CallFunc::create([this]() {
+        // 快进经过的攻击在原战斗中已经结算过
+        if (fast_forwarding_) return;
         this->DealDamageToBuilding(current_target_);
-        AudioManager::getInstance()->playSoldierAttack(this->soldier_template_->GetSoldierType());
+        PublishSoldierEvent(GameEventType::SoldierAttack);
     });
     auto anim_and_delay = cocos2d::Sequence::create(
             set_dir,
@@ -286,7 +357,8 @@ void SoldierInCombat::StartAttack(const cocos2d::Vec2& pos) {
             nullptr
     );
     auto repeat_attack = cocos2d::RepeatForever::create(anim_and_delay);
-    this->runAction(repeat_attack);
+    attack_pos_ = pos;
+    RunTracked(repeat_attack, kAttackActionTag);
 }
 
 void SoldierInCombat::BomberAttack(const cocos2d::Vec2& pos) {
@@ -294,10 +366,11 @@ void SoldierInCombat::BomberAttack(const cocos2d::Vec2& pos) {
     auto animate = cocos2d::CallFunc::create([this, delta,pos]() {
         cocos2d::DelayTime::create(this->soldier_template_->GetAttackDelay());
         DealSplashDamage(pos);
-        AudioManager::getInstance()->playSoldierAttack(this->soldier_template_->GetSoldierType());
+        PublishSoldierEvent(GameEventType::SoldierAttack);
         Die();
     });
-    this->runAction(animate);
+    attack_pos_ = pos;
+    RunTracked(animate, kAttackActionTag);
 }
 void SoldierInCombat::DealDamageToBuilding(BuildingInCombat* target) const {
     bool ret=false;
@@ -311,24 +384,23 @@ void SoldierInCombat::DealDamageToBuilding(BuildingInCombat* target) const {
         }
     }
     if(ret){
-        auto name = target->building_template_->GetName();
-        CCLOG("%s health:%d",name.c_str(),target->GetCurrentHealth());
+        TJ_LOG_DEBUG(LogCategory::Damage, "%s health:%d", target->building_template_->GetName(), target->GetCurrentHealth());
     }
 }
 
 void SoldierInCombat::DealSplashDamage(const cocos2d::Vec2& pos){
-    auto surroundings = map_->GetSurroundings(pos);
-    std::unordered_set<Building*> visited;
-    auto buildings_in_combat = CombatManager::GetInstance()->live_buildings_;
-    for(auto it:surroundings){
-        auto building = map_->getBuildingAt(static_cast<int>(it.x),static_cast<int>(it.y));
-        if(building && (visited.find(building)==visited.end())){
-            CCLOG("splash");
-            auto building_in_combat = find_if(buildings_in_combat.begin(),buildings_in_combat.end(),[building](BuildingInCombat* a){
-                return a->building_template_ == building;
-            });
-            if(building_in_combat!=buildings_in_combat.end()) DealDamageToBuilding(*building_in_combat);
-        }
+    // 周围一圈（3x3）内的建筑各受一次伤害，多格建筑不会被重复命中
+    auto manager = CombatManager::GetInstance();
+    CombatArena& scratch = manager->GetTickScratch();
+    ArenaScope scratch_scope(scratch);
+    ArenaVector<BuildingInCombat*> targets{ArenaAllocator<BuildingInCombat*>(&scratch)};
+    targets.reserve(9);
+    manager->GetPathCostField().QueryBuildingsInArea(pos, 1.0f, AreaShape::kSquare, targets);
+    for(auto target:targets){
+        TJ_LOG_TRACE(LogCategory::Damage, "splash");
+        DealDamageToBuilding(target);
+        // 摧毁最后一座建筑会结束战斗并把剩余目标交还对象池
+        if(target->GetCurrentHealth() == 0 && manager->IsCombatEnd()) break;
     }
 }
 
@@ -337,147 +409,9 @@ void SoldierInCombat::UpdatePosition() {
     map_->updateYOrder(this);
 }
 
-struct AStarNode {
-    cocos2d::Vec2 tile_pos;   // 格子坐标
-    float g_cost{};              // 起点到当前的实际代价
-    float h_cost{};              // 当前到终点的启发代价
-    float f_cost() const { return g_cost + h_cost; }  // 总代价
-    cocos2d::Vec2 parent_pos;         // 父节点（用于回溯路径）
-
-    AStarNode() = default;
-    // 构造函数
-    explicit AStarNode(const cocos2d::Vec2& pos) : tile_pos(pos), g_cost(0), h_cost(0), parent_pos({-1,-1}) {}
-    // 比较函数（用于优先队列的排序：F值小的在前）
-    bool operator>(const AStarNode& other) const { return f_cost() > other.f_cost(); }
-};
-
-struct Vec2Hash {
-    size_t operator()(const cocos2d::Vec2& v) const {
-        return std::hash<float>()(v.x) ^ (std::hash<float>()(v.y) << 1);
-    }
-};
-
-class PathFinder {
-public:
-    explicit PathFinder(MapManager* map):map_(map){};
-    // A*寻路入口：返回从start到end的格子路径（若失败则返回空）
-    std::vector<cocos2d::Vec2> FindPath(cocos2d::Vec2 start_tile,cocos2d::Vec2 end_tile,
-                                        float soldier_range_,int building_width,int building_length);
-
-private:
-    // 生成8个方向的邻居格子
-    constexpr static const float kDestroyCost = 10.0;
-    static float ManhattanDistance(const cocos2d::Vec2& a, const::cocos2d::Vec2& b);
-    MapManager* map_;
-};
-
-static const cocos2d::Vec2 kNeighborDirs[] = {
-        cocos2d::Vec2(1, 0), cocos2d::Vec2(0, 1), cocos2d::Vec2(-1, 0), cocos2d::Vec2(0, -1)  // 4方向
-};
-
-float PathFinder::ManhattanDistance(const cocos2d::Vec2& a, const::cocos2d::Vec2& b){
-    return abs(a.x-b.x) + abs(a.y-b.y);
-}
-
-// -------------------------- A*寻路入口 --------------------------
-std::vector<cocos2d::Vec2> PathFinder::FindPath(cocos2d::Vec2 start_tile,cocos2d::Vec2 end_tile, float soldier_range,
-                                                int building_width,int building_length) {
-    // 1. 初始化OpenList（小根堆，按F值排序）、ClosedList（哈希表，避免重复）
-    std::priority_queue<AStarNode, std::vector<AStarNode>, std::greater<>> open_list;
-    std::unordered_set<cocos2d::Vec2, Vec2Hash> closed_list;
-    // node_map：存储所有节点的详细信息（坐标→节点，避免指针拷贝）
-    std::unordered_map<cocos2d::Vec2, AStarNode, Vec2Hash> node_map;
-    start_tile.x = floor(start_tile.x);
-    start_tile.y = floor(start_tile.y);
-    end_tile.x = floor(end_tile.x);
-    end_tile.y = floor(end_tile.y);
-
-
-    if(building_width!=1 || building_length!=1){
-        std::vector<cocos2d::Vec2> candidates;
-        int x_min = floor(end_tile.x),y_min = floor(end_tile.y),
-            x_max = x_min+building_width-1,y_max = y_min+building_length-1;
-        // 1. 下边
-        for (int x = x_min; x <= x_max; x += 1) candidates.emplace_back(x, y_min);
-        // 2. 上边
-        for (int x = x_min; x <= x_max; x += 1) candidates.emplace_back(x, y_max);
-        // 3. 右边
-        for (int y = y_min + 1; y < y_max; y += 1) candidates.emplace_back(x_max, y);
-        // 4. 左边
-        for (int y = y_min + 1; y < y_max; y += 1) candidates.emplace_back(x_min, y);
-        end_tile = *std::min_element(candidates.begin(),candidates.end(),[start_tile](auto a,auto b){
-            return start_tile.distance(a)<start_tile.distance(b);
-        });
-    }
-
-    // 2. 起点入队
-    AStarNode start_node(start_tile);
-    start_node.h_cost = ManhattanDistance(start_tile, end_tile);
-    open_list.push(start_node);
-    node_map[start_tile] = start_node;
-
-    // 3. 核心寻路循环
-    while (!open_list.empty()) {
-        // 3.1 取出OpenList中F值最小的节点
-        AStarNode current = open_list.top();
-        open_list.pop();
-
-        // 3.2 若到达终点，回溯路径
-        if (current.tile_pos.distance(end_tile)<=soldier_range) {
-            CCLOG("end tile:(%f,%f),soldier_range:%f",end_tile.x,end_tile.y,soldier_range);
-            std::vector<cocos2d::Vec2> path;
-            cocos2d::Vec2 temp_pos = current.tile_pos;
-            // 回溯父节点直到起点
-            while (temp_pos != start_tile) {
-                path.push_back(temp_pos);
-                temp_pos = node_map[temp_pos].parent_pos;
-            }
-            path.push_back(start_tile);
-            std::reverse(path.begin(), path.end());  // 反转路径为起点→终点
-            return path;
-        }
-
-        // 3.3 标记当前节点为已考察
-        if(closed_list.count(current.tile_pos)) continue;
-        closed_list.insert(current.tile_pos);
-
-        // 3.4 遍历所有邻居节点
-        for (const auto& dir : kNeighborDirs) {
-            cocos2d::Vec2 neighbor_tile = current.tile_pos + dir;
-
-            // 邻居不可通行或已在ClosedList，跳过
-            if (!map_->isValidGrid(neighbor_tile) || closed_list.count(neighbor_tile)) {
-                continue;
-            }
-            // 3.5 计算邻居的G/H/F代价
-            float new_g = current.g_cost + 1;
-            float new_h = ManhattanDistance(neighbor_tile,end_tile);  // 启发代价为对角线距离
-            if(!map_->IsGridAvailable(neighbor_tile)){
-                new_g += kDestroyCost;
-            }
-
-            bool is_neighbor_in_open = (node_map.count(neighbor_tile) > 0);
-            // 若邻居不在OpenList，或新路径代价更低 → 更新
-            if (!is_neighbor_in_open || new_g < node_map[neighbor_tile].g_cost) {
-                AStarNode neighbor_node(neighbor_tile);
-                neighbor_node.g_cost = new_g;
-                neighbor_node.h_cost = new_h;
-                neighbor_node.parent_pos = current.tile_pos; // 关联父节点坐标（核心）
-                // 更新node_map并加入OpenList
-                node_map[neighbor_tile] = neighbor_node;
-                open_list.push(neighbor_node);
-            }
-        }
-    }
-
-    CCLOG("no path");
-    // 4. 寻路失败，返回空
-    return {};
-}
-
 void SoldierInCombat::RedirectPath(std::vector<cocos2d::Vec2>& path){
     if(path.empty()){
-        CCLOG("empty path");
+        TJ_LOG_WARNING(LogCategory::Path, "empty path");
     }
     LogPath(path, "RedirectPath");
     for(auto ptr = path.begin();ptr != path.end();ptr++){
@@ -496,16 +430,15 @@ void SoldierInCombat::RedirectPath(std::vector<cocos2d::Vec2>& path){
             if (start_erase != path.end()) {
                 path.erase(start_erase, path.end());
             }
-            auto buildings = CombatManager::GetInstance()->live_buildings_;
-            auto it =  find_if(buildings.begin(),buildings.end(),[&](BuildingInCombat* b){
-                return b->building_template_ == map_->getBuildingAt(floor(new_target.x),floor(new_target.y));
-            });
-            if(it!=buildings.end()){
+            // 代价场按格子直接给出占用的战斗建筑，无需遍历 live_buildings_
+            auto blocker = CombatManager::GetInstance()->GetPathCostField().GetBuildingAt(
+                static_cast<int>(floor(new_target.x)), static_cast<int>(floor(new_target.y)));
+            if(blocker){
                 UnsubscribeTarget(current_target_);
-                SubscribeTarget(*it);
+                SubscribeTarget(blocker);
             }
             else{
-                CCLOG("warning : SoldierInCombat fail to change target when RedirectPath");
+                TJ_LOG_WARNING(LogCategory::Targeting, "SoldierInCombat fail to change target when RedirectPath");
             }
             break;
         }
@@ -514,58 +447,44 @@ void SoldierInCombat::RedirectPath(std::vector<cocos2d::Vec2>& path){
 
 void SoldierInCombat::SimplifyPath(std::vector<cocos2d::Vec2>& path){
     if(path.size()<2){
-        if(path.empty()){
-            CCLOG("empty path");
+        for(const auto& it:path){
+            TJ_LOG_TRACE(LogCategory::Path, "(%f,%f)", it.x, it.y);
         }
-        for(auto it:path){
-            CCLOG("(%f,%f)",it.x,it.y);
-        }
-        CCLOG("invalid path found when simplified");
+        TJ_LOG_WARNING(LogCategory::Path, "invalid path of %d points found when simplified", static_cast<int>(path.size()));
         return;
     }
-    cocos2d::Vec2 former_dir = path[1]-path[0];
-    std::vector<int> erased;
-    //去除同方向直线上的中间点
-    for(int i=2;i<path.size();i++){
-        if(path[i]-path[i-1]==former_dir){
-            erased.push_back(i-1);
-        }
-        else{
-            former_dir = path[i]-path[i-1];
+    //去除同方向直线上的中间点：原地压缩，不分配额外内存
+    size_t kept = 1;
+    for(size_t i=1;i+1<path.size();i++){
+        if(path[i+1]-path[i] != path[i]-path[i-1]){
+            path[kept++] = path[i];
         }
     }
-    //从后向前不影响顺序的情况下完成删除
-    for(auto it = erased.rbegin(); it != erased.rend(); ++it){
-        path.erase(path.begin() + *it);
-    }
+    path[kept++] = path.back();
+    path.resize(kept);
 }
 
-void LogVec2(const cocos2d::Vec2& pos,std::string& s){
-    s +="(";
-    s += std::to_string(pos.x);
-    s += ",";
-    s += std::to_string(pos.y);
-    s +=")";
-}
-void SoldierInCombat::LogPath(const std::vector<cocos2d::Vec2> &path, const std::string &prompt) const{
-    std::string s = prompt + " " + soldier_template_->GetName() + " find path:";
-    for(auto i : path){
-        LogVec2(i,s);
+void SoldierInCombat::LogPath(const std::vector<cocos2d::Vec2> &path, const char* prompt) const{
+    // 摘要一条，逐点明细在 Trace 级别；两者都只拷贝数值，格式化推迟到主线程 drain
+    if (path.empty() || !current_target_) return;
+    const auto& target = current_target_->position_;
+    TJ_LOG_DEBUG(LogCategory::Path, "%s %s find path: %d points (%.0f,%.0f)->(%.0f,%.0f)",
+                 prompt, soldier_template_->GetName(), static_cast<int>(path.size()),
+                 path.front().x, path.front().y, path.back().x, path.back().y);
+    TJ_LOG_DEBUG(LogCategory::Path, "%s target:(%.0f,%.0f)-(%.0f,%.0f)", prompt, target.x, target.y,
+                 target.x + current_target_->building_template_->GetWidth() - 1,
+                 target.y + current_target_->building_template_->GetLength() - 1);
+    for (const auto& point : path) {
+        TJ_LOG_TRACE(LogCategory::Path, "(%.0f,%.0f)", point.x, point.y);
     }
-    s+=" target:";
-    auto target = current_target_->position_;
-    LogVec2(target,s);
-    auto up_right = target+cocos2d::Vec2(current_target_->building_template_->GetWidth()-1,current_target_->building_template_->GetLength()-1);
-    LogVec2(up_right,s);
-    CCLOG("%s",s.c_str());
 }
 BuildingInCombat* SoldierInCombat::GetNextTarget() const {
-    auto buildings = CombatManager::GetInstance()->live_buildings_;
+    PROFILE_SCOPE(ProfileZone::Targeting);
+    return SelectTarget(CombatManager::GetInstance()->live_buildings_);
+}
+
+BuildingInCombat* SoldierInCombat::SelectTarget(const std::vector<BuildingInCombat*>& buildings) const {
     if(buildings.empty()) return nullptr;
-    else{
-        auto b = buildings.front();
-        CCLOG("building name:%s",b->getResourceName().c_str());
-    }
 
     BuildingInCombat* target = *std::min_element(buildings.begin(),buildings.end(),
                                                  [&](BuildingInCombat* a,BuildingInCombat* b){
@@ -586,6 +505,8 @@ BuildingInCombat* SoldierInCombat::GetNextTarget() const {
         //最后按距离排序
         return this->position_.distance(a->position_) < this->position_.distance(b->position_);
     });
+    TJ_LOG_DEBUG(LogCategory::Targeting, "%s targets %s at (%.0f,%.0f)", soldier_template_->GetName(),
+                 target->building_template_->GetName(), target->position_.x, target->position_.y);
     return target;
 }
 
@@ -605,22 +526,117 @@ void SoldierInCombat::UnsubscribeTarget(BuildingInCombat *b){
 }
 
 void SoldierInCombat::MoveToTargetAndStartAttack() {
-    PathFinder pf(map_);
-    auto width = current_target_->building_template_->GetWidth(),length = current_target_->building_template_->GetLength();
-    auto path = pf.FindPath(this->position_, current_target_->position_,
-                            this->soldier_template_->GetAttackRange(),width,length);
-    RedirectPath(path);
-    SimplifyPath(path);
-    LogPath(path, "Simplified Path");
+    // 寻路交给 PathRequestQueue，结果最早在下一帧由 OnPathReady 交回
+    PathRequest request;
+    request.start_ = this->position_;
+    request.target_ = current_target_->position_;
+    request.target_width_ = current_target_->building_template_->GetWidth();
+    request.target_length_ = current_target_->building_template_->GetLength();
+    request.range_ = this->soldier_template_->GetAttackRange();
+    request.profile_ = PathCostProfile::FromSoldier(soldier_template_);
+    path_ticket_ = CombatManager::GetInstance()->GetPathRequests().Submit(this, request);
+}
+
+void SoldierInCombat::OnPathReady(const std::vector<cocos2d::Vec2>& result) {
+    path_ticket_ = 0;
+    if (!current_target_) return;
+    path_.assign(result.begin(), result.end());
+    RedirectPath(path_);
+    SimplifyPath(path_);
+    LogPath(path_, "Simplified Path");
+    RunPath();
+}
+
+cocos2d::Sequence* SoldierInCombat::RunPath() {
+    const auto& path = path_;
+    move_origin_ = this->getPosition();
     cocos2d::Vector<cocos2d::FiniteTimeAction*> moves;
     for(int i=1;i<path.size();i++){
         moves.pushBack(CreateStraightMoveAction(path[i-1],path[i]));
     }
-    auto start_attack = cocos2d::CallFunc::create([this,path]() {
-        if (path.empty()) this->StartAttack(this->position_);
-        else this->StartAttack(path.back());
+    // 只捕获终点，避免把整条路径复制进回调
+    const bool has_path = !path.empty();
+    const cocos2d::Vec2 attack_pos = has_path ? path.back() : cocos2d::Vec2::ZERO;
+    auto start_attack = cocos2d::CallFunc::create([this,has_path,attack_pos]() {
+        if (!has_path) this->StartAttack(this->position_);
+        else this->StartAttack(attack_pos);
     });
     moves.pushBack(start_attack);
     cocos2d::Sequence* seq = cocos2d::Sequence::create(moves);
-    if(seq) this->runAction(seq);
+    if(seq) RunTracked(seq, kMoveActionTag);
+    return seq;
+}
+
+void SoldierInCombat::SaveState(SoldierState& state, std::vector<cocos2d::Vec2>& path_points) {
+    state = SoldierState();
+    state.template_ = soldier_template_;
+    state.handle_ = handle_;
+    if (current_target_) state.target_ = current_target_->handle_;
+    state.health_ = current_health_;
+    state.position_ = position_;
+    state.node_position_ = this->getPosition();
+    state.flipped_ = this->isFlippedX();
+    state.action_order_ = action_order_;
+
+    if (auto move = this->getActionByTag(kMoveActionTag)) {
+        state.phase_ = SoldierPhase::kMoving;
+        if (action_started_) state.elapsed_ = static_cast<cocos2d::ActionInterval*>(move)->getElapsed();
+        state.move_origin_ = move_origin_;
+        state.path_begin_ = static_cast<uint32_t>(path_points.size());
+        state.path_count_ = static_cast<uint32_t>(path_.size());
+        path_points.insert(path_points.end(), path_.begin(), path_.end());
+    } else if (auto attack = this->getActionByTag(kAttackActionTag)) {
+        state.phase_ = SoldierPhase::kAttacking;
+        state.attack_pos_ = attack_pos_;
+        // 攻击循环每轮重启内层序列，进度取内层本轮已经过的时间（炸弹人的自爆是瞬时动作，没有进度）
+        auto repeat = dynamic_cast<cocos2d::RepeatForever*>(attack);
+        if (repeat && action_started_) state.elapsed_ = repeat->getInnerAction()->getElapsed();
+    } else if (this->getActionByTag(kDieActionTag)) {
+        state.phase_ = SoldierPhase::kDying;
+    }
+}
+
+void SoldierInCombat::ResumeState(const SoldierState& state, const cocos2d::Vec2* path_points) {
+    cocos2d::ActionInterval* action = nullptr;
+    switch (state.phase_) {
+        case SoldierPhase::kMoving:
+            if (!current_target_) break;
+            path_.assign(path_points + state.path_begin_, path_points + state.path_begin_ + state.path_count_);
+            this->setPosition(state.move_origin_);
+            action = RunPath();
+            break;
+        case SoldierPhase::kAttacking:
+            if (!current_target_) break;
+            StartAttack(state.attack_pos_);
+            action = dynamic_cast<cocos2d::ActionInterval*>(this->getActionByTag(kAttackActionTag));
+            break;
+        case SoldierPhase::kDying:
+            Die();
+            break;
+        default:
+            break;
+    }
+
+    if (action && state.elapsed_ >= 0.0f) {
+        // step(0) 相当于原动作的第一帧，再一步推进到已经过的时间：Sequence/Repeat 按同样的进度
+        // 结束前面的分段，节点位置与动画帧和原动作一致
+        fast_forwarding_ = true;
+        action->step(0.0f);
+        action->step(state.elapsed_);
+        fast_forwarding_ = false;
+        if (state.phase_ == SoldierPhase::kMoving) {
+            if (auto unit_renderer = GetUnitRenderer()) {
+                // 快进时提交的是整段移动，改为从当前位置走完剩余部分
+                float remaining = map_->worldToVec(state.node_position_).distance(map_->worldToVec(move_target_)) /
+                                  soldier_template_->GetMoveSpeed();
+                unit_renderer->SetMotion(unit_handle_, state.node_position_, move_target_, remaining);
+            }
+        }
+    }
+
+    // 快进途中的 UpdatePosition 以快进时的节点位置为准，最后统一回到快照时的状态
+    position_ = state.position_;
+    this->setPosition(state.node_position_);
+    this->setFlippedX(state.flipped_);
+    map_->updateYOrder(this);
 }
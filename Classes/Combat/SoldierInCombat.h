@@ -12,8 +12,13 @@
 #include "MapManager/MapManager.h"
 #include "HpBarUtils.h"
 #include "AudioManager/AudioManager.h"
+#include "SoldierAnimation.h"
+#include "EventBus/GameEvent.h"
+#include "CombatHandle.h"
 
 class BuildingInCombat;
+class AnimatedUnitRenderer;
+struct SoldierState;
 
 class SoldierInCombat : public cocos2d::Sprite{
 public:
@@ -21,24 +26,71 @@ public:
     const Soldier* soldier_template_;
     MapManager* map_;
 
+    // 优先从 CombatEntityPool 取出同兵种的空闲节点，没有时再新建
     static SoldierInCombat* Create(const Soldier* soldier_template, const cocos2d::Vec2& spawn_pos,MapManager* map);
+    // 只构建节点（精灵与血条），不上场，供对象池预热
+    static SoldierInCombat* CreateIdle(const Soldier* soldier_template);
     // 初始化函数
     bool Init(const Soldier* soldier_template, const cocos2d::Vec2& spawn_pos,MapManager* map);
+    // 上场：绑定模板、重置状态并加入地图，新建与复用共用
+    bool Spawn(const Soldier* soldier_template, const cocos2d::Vec2& spawn_pos,MapManager* map);
+    // 按快照上场（不开始行动）：取出对象池节点，恢复位置、朝向与血量；目标与动作由 ResumeState 恢复
+    static SoldierInCombat* Restore(const SoldierState& state, MapManager* map);
+    // 被对象池回收：停止动作并离开地图
+    void Recycle();
     // 被攻击函数
     void TakeDamage(int damage);
 
     void DoAllMyActions();
+    // 按目标偏好、城墙与距离在 buildings 中选下一个目标；只读，可在工作线程调用
+    BuildingInCombat* SelectTarget(const std::vector<BuildingInCombat*>& buildings) const;
+    // 订阅 target 并寻路前往攻击
+    void AttackTarget(BuildingInCombat* target);
+    // PathRequestQueue 交付寻路结果：沿路径移动到目标并开始攻击
+    void OnPathReady(const std::vector<cocos2d::Vec2>& path);
+
+    // 战斗快照：记录当前动作及其进度，移动路径追加到 path_points
+    void SaveState(SoldierState& state, std::vector<cocos2d::Vec2>& path_points);
+    // 重建快照时的动作并快进到保存时的进度（current_target_ 须已恢复）；
+    // 多个士兵须按 SoldierState::action_order_ 依次调用
+    void ResumeState(const SoldierState& state, const cocos2d::Vec2* path_points);
 
     BuildingInCombat* current_target_;
+    CombatHandle handle_;        // 在 CombatManager 句柄表中的句柄，未上场时为空
+    int live_index_ = -1;        // 在 live_soldiers_ 中的下标，用于 swap-and-pop 移除
+    uint32_t path_ticket_ = 0;   // 正在等待的寻路请求票号，0 表示没有
     void Die();
 
     int GetCurrentHealth() const{return current_health_;};
+
+    // 由 AnimatedUnitRenderer 批量绘制时跳过自身的精灵绘制（血条等子节点照常绘制）
+    void draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
 protected:
+    // 三类动作的 tag，保存快照时据此判断士兵所处阶段
+    static constexpr int kMoveActionTag = 1;
+    static constexpr int kAttackActionTag = 2;
+    static constexpr int kDieActionTag = 3;
+
     int current_health_;
-    static const std::string direction_names[4];
     HpBarComponents hp_bar_;
+    int unit_handle_ = -1;  // 在 AnimatedUnitRenderer 中的句柄，-1 表示使用自身 Animate 动画
+    std::vector<cocos2d::Vec2> path_;  // 寻路结果缓冲，随节点在对象池中复用，容量不回收
+    cocos2d::Vec2 move_origin_;        // 开始沿 path_ 移动时的节点位置
+    cocos2d::Vec2 move_target_;        // 当前这段移动的终点（世界坐标）
+    cocos2d::Vec2 attack_pos_;         // 当前攻击的站位
+    bool action_started_ = false;      // 当前动作是否已执行第一帧
+    bool fast_forwarding_ = false;     // 恢复快照时快进动作，期间不结算伤害
+    uint64_t action_order_ = 0;        // 最近一次在 ActionManager 中新建条目的先后
+    static uint64_t next_action_order_;
 
     ~SoldierInCombat() override;
+    bool InitNode(const Soldier* soldier_template);
+    // Spawn 中除开始行动外的部分
+    bool AttachToMap(const Soldier* soldier_template, const cocos2d::Vec2& spawn_pos,MapManager* map);
+    // 带 tag 运行动作，并记录 action_order_
+    void RunTracked(cocos2d::Action* action, int tag);
+    // 沿 path_ 移动到终点后开始攻击
+    cocos2d::Sequence* RunPath();
     void MoveToTargetAndStartAttack();
     void StartAttack(const cocos2d::Vec2& pos);
     void BomberAttack(const cocos2d::Vec2& pos);
@@ -49,16 +101,14 @@ protected:
     void SubscribeTarget(BuildingInCombat *b);
     void UnsubscribeTarget(BuildingInCombat *b);
     void NotifyManagerDie();
+    void PublishSoldierEvent(GameEventType type) const;
+    AnimatedUnitRenderer* GetUnitRenderer() const;
 
     cocos2d::Spawn* CreateStraightMoveAction(const cocos2d::Vec2& start_map_pos,const cocos2d::Vec2& target_map_pos);
     void RedirectPath(std::vector<cocos2d::Vec2>& path);
     static void SimplifyPath(std::vector<cocos2d::Vec2>& path);
-    void LogPath(const std::vector<cocos2d::Vec2> &path, const std::string &prompt) const;
-
+    void LogPath(const std::vector<cocos2d::Vec2> &path, const char* prompt) const;
 
-    // -------------------------- 动画资源（静态共享） --------------------------
-    void LoadSoldierAnimations() const;
-    static bool is_animation_loaded_[static_cast<int>(SoldierType::kSoldierTypes)]; // 标记动画资源是否已加载（避免重复加载）
 };
 
 #endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERINCOMBAT_H
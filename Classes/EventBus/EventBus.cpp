@@ -0,0 +1,123 @@
+#include "EventBus/EventBus.h"
+#include "cocos2d.h"
+#include <algorithm>
+
+USING_NS_CC;
+
+EventBus* EventBus::_instance = nullptr;
+
+EventBus* EventBus::getInstance() {
+    if (!_instance) {
+        _instance = new (std::nothrow) EventBus();
+    }
+    return _instance;
+}
+
+EventBus::EventBus() {
+    std::fill(std::begin(_pendingSlot), std::end(_pendingSlot), -1);
+    setCoalesced(GameEventType::DestructionChanged, true);
+}
+
+void EventBus::install() {
+    // 自定义定时器在所有 scheduleUpdate 之后执行，本帧战斗中发布的事件本帧即可派发
+    Director::getInstance()->getScheduler()->schedule(
+        [this](float) { dispatch(); }, this, 0.0f, false, "EventBusDispatch");
+}
+
+void EventBus::subscribe(GameEventType type, const void* owner, const Handler& handler) {
+    auto& list = _subscribers[static_cast<int>(type)];
+    auto shared = std::make_shared<const Handler>(handler);
+    for (auto& subscriber : list) {
+        if (subscriber.owner == owner) {
+            subscriber.handler = std::move(shared);
+            return;
+        }
+    }
+    list.push_back({ owner, std::move(shared) });
+}
+
+void EventBus::unsubscribe(GameEventType type, const void* owner) {
+    auto& list = _subscribers[static_cast<int>(type)];
+    if (_dispatchDepth > 0) {
+        // 派发中不移动元素，否则按下标遍历会跳过后面的订阅者
+        for (auto& subscriber : list) {
+            if (subscriber.owner == owner && subscriber.handler) {
+                subscriber.handler.reset();
+                _hasUnsubscribed = true;
+            }
+        }
+        return;
+    }
+    list.erase(std::remove_if(list.begin(), list.end(), [owner](const Subscriber& s) {
+        return s.owner == owner;
+    }), list.end());
+}
+
+void EventBus::removeUnsubscribed() {
+    for (auto& list : _subscribers) {
+        list.erase(std::remove_if(list.begin(), list.end(), [](const Subscriber& s) {
+            return !s.handler;
+        }), list.end());
+    }
+    _hasUnsubscribed = false;
+}
+
+void EventBus::unsubscribeAll(const void* owner) {
+    for (int i = 0; i < kTypeCount; ++i) {
+        unsubscribe(static_cast<GameEventType>(i), owner);
+    }
+}
+
+void EventBus::setCoalesced(GameEventType type, bool coalesced) {
+    _coalesced[static_cast<int>(type)] = coalesced;
+}
+
+bool EventBus::publish(const GameEvent& event) {
+    int type = static_cast<int>(event.type);
+    if (type < 0 || type >= kTypeCount) return false;
+
+    // 可合并事件：覆盖本帧尚未派发的那一条
+    if (_coalesced[type] && _pendingSlot[type] >= 0) {
+        _queue[_pendingSlot[type]] = event;
+        return true;
+    }
+
+    if (_count >= kCapacity) {
+        if (_dropped++ == 0) {
+            CCLOG("EventBus: queue full, dropping events");
+        }
+        return false;
+    }
+
+    int slot = (_head + _count) % kCapacity;
+    _queue[slot] = event;
+    _count++;
+    if (_coalesced[type]) {
+        _pendingSlot[type] = slot;
+    }
+    return true;
+}
+
+void EventBus::dispatch() {
+    ++_dispatchDepth;
+    int count = _count;
+    for (int i = 0; i < count; ++i) {
+        GameEvent event = _queue[_head];
+        _head = (_head + 1) % kCapacity;
+        _count--;
+
+        int type = static_cast<int>(event.type);
+        _pendingSlot[type] = -1;
+
+        // 处理函数中可能订阅/退订（例如切换场景）：按下标遍历，退订只留下空位，
+        // 持有 shared_ptr 的副本保证处理函数在执行期间不被替换析构；复制指针不分配内存
+        auto& list = _subscribers[type];
+        for (size_t s = 0; s < list.size(); ++s) {
+            std::shared_ptr<const Handler> handler = list[s].handler;
+            if (handler && *handler) (*handler)(event);
+        }
+    }
+    if (--_dispatchDepth == 0 && _hasUnsubscribed) {
+        removeUnsubscribed();
+    }
+}
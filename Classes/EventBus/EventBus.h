@@ -0,0 +1,69 @@
+#pragma once
+#ifndef __EVENT_BUS_H__
+#define __EVENT_BUS_H__
+
+#include "EventBus/GameEvent.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+// 类型化事件总线：
+// - publish 只把事件按值写入固定容量的环形队列，不分配内存、不调用任何订阅者
+// - 每帧由 Scheduler 统一派发一次（dispatch），战斗核心因此不直接依赖 UI / 音频
+// - 标记为可合并的事件类型在同一帧内只保留最新一次（例如摧毁率）
+class EventBus {
+public:
+    using Handler = std::function<void(const GameEvent&)>;
+
+    static EventBus* getInstance();
+
+    // 注册每帧派发，在 AppDelegate 创建 Director 之后调用一次
+    void install();
+
+    // 同一 owner 对同一事件类型只保留一个处理函数，重复订阅即替换
+    void subscribe(GameEventType type, const void* owner, const Handler& handler);
+    void unsubscribe(GameEventType type, const void* owner);
+    void unsubscribeAll(const void* owner);
+
+    // 队列满时丢弃并返回 false
+    bool publish(const GameEvent& event);
+    bool publish(GameEventType type) { return publish(GameEvent::make(type)); }
+
+    // 派发队列中的全部事件（派发过程中新发布的事件留到下一帧）
+    void dispatch();
+
+    // 同帧多次发布只派发最后一次
+    void setCoalesced(GameEventType type, bool coalesced);
+
+    int getPendingCount() const { return _count; }
+    int getDroppedCount() const { return _dropped; }
+
+private:
+    EventBus();
+
+    static const int kCapacity = 1024;
+    static const int kTypeCount = static_cast<int>(GameEventType::Count);
+
+    // 处理函数放在 shared_ptr 里：派发时只复制指针（不分配），处理函数中重复订阅替换掉自己也不会析构正在执行的函数
+    struct Subscriber {
+        const void* owner;
+        std::shared_ptr<const Handler> handler;   // 为空表示派发期间已退订，派发结束后移除
+    };
+
+    void removeUnsubscribed();
+
+    static EventBus* _instance;
+
+    GameEvent _queue[kCapacity];
+    int _head = 0;
+    int _count = 0;
+    int _dropped = 0;
+
+    bool _coalesced[kTypeCount] = {};
+    int _pendingSlot[kTypeCount];           // 可合并事件在队列中的位置，-1 表示没有
+    std::vector<Subscriber> _subscribers[kTypeCount];
+    int _dispatchDepth = 0;
+    bool _hasUnsubscribed = false;
+};
+
+#endif // __EVENT_BUS_H__
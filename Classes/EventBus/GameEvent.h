@@ -0,0 +1,74 @@
+#pragma once
+#ifndef __GAME_EVENT_H__
+#define __GAME_EVENT_H__
+
+#include <cstdint>
+#include <type_traits>
+
+// 游戏事件类型（取代原 setUICallback 的字符串事件名）
+enum class GameEventType : uint8_t {
+    // ---- UI 请求 ----
+    EnterPlacementMode,     // 商店购买后进入建筑放置
+    BattleStart,            // 选择地图开始战斗，payload: level
+    UpgradeStarted,
+    UpgradeComplete,
+    ArmyConfigSaved,
+    RequestEndBattle,
+    RequestReplay,
+    RequestExitReplay,
+
+    // ---- 战斗事件（由战斗核心发布，UI / 音频消费）----
+    DestructionChanged,     // payload: destruction（同帧只保留最新一次）
+    BuildingDestroyed,
+    BuildingAttack,         // payload: building
+    SoldierAttack,          // payload: soldier
+    SoldierDied,            // payload: soldier
+
+    Count
+};
+
+// 防御建筑攻击音效种类（发布时不再携带建筑名字符串）
+enum class BuildingAttackKind : uint8_t {
+    Other,
+    ArcherTower,
+    Cannon
+};
+
+struct LevelPayload {
+    int levelId;
+};
+
+struct DestructionPayload {
+    int stars;
+    int percent;
+};
+
+struct SoldierPayload {
+    int soldierType;        // SoldierType
+};
+
+struct BuildingPayload {
+    BuildingAttackKind kind;
+};
+
+// 事件本体：类型 + POD 负载，可直接按值拷贝进环形队列
+struct GameEvent {
+    GameEventType type;
+    union {
+        LevelPayload level;
+        DestructionPayload destruction;
+        SoldierPayload soldier;
+        BuildingPayload building;
+    };
+
+    static GameEvent make(GameEventType type) {
+        GameEvent e;
+        e.type = type;
+        e.destruction = { 0, 0 };
+        return e;
+    }
+};
+
+static_assert(std::is_trivially_copyable<GameEvent>::value, "GameEvent must stay POD");
+
+#endif // __GAME_EVENT_H__
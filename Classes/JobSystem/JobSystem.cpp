@@ -0,0 +1,119 @@
+#include "JobSystem/JobSystem.h"
+#include "cocos2d.h"
+#include <algorithm>
+#include <cstdlib>
+
+JobSystem* JobSystem::_instance = nullptr;
+
+namespace {
+// 自动选择时的上限：战斗每帧任务量有限，线程过多只会增加唤醒开销
+const int kMaxAutoWorkers = 3;
+}
+
+JobSystem* JobSystem::getInstance() {
+    if (!_instance) {
+        _instance = new (std::nothrow) JobSystem();
+    }
+    return _instance;
+}
+
+void JobSystem::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+int JobSystem::workerCountFromEnvironment() {
+    const char* threads = std::getenv("TJ_JOB_THREADS");
+    if (!threads) return -1;
+    return std::max(0, std::atoi(threads));
+}
+
+void JobSystem::start(int workerCount) {
+    stop();
+    if (workerCount < 0) {
+        // 主线程也参与执行，因此保留一个硬件线程给它
+        int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = std::min(kMaxAutoWorkers, std::max(0, hardware - 1));
+    }
+    _stopping = false;
+    _workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        _workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+    CCLOG("JobSystem: %d worker threads", workerCount);
+}
+
+void JobSystem::stop() {
+    wait();
+    if (_workers.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+void JobSystem::begin(int count, int grain, RangeFunc func, void* context) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _func = func;
+        _context = context;
+        _count = count;
+        _grain = grain;
+        _chunkCount = (count + grain - 1) / grain;
+        _nextChunk.store(0);
+        _pendingWorkers = static_cast<int>(_workers.size());
+        _dispatching = true;
+        ++_generation;
+    }
+    _wake.notify_all();
+}
+
+void JobSystem::finish() {
+    runChunks();
+
+    // 等所有工作线程确认过本代任务，保证返回后不会再有线程访问 context
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] { return _pendingWorkers == 0; });
+    _dispatching = false;
+}
+
+void JobSystem::wait() {
+    if (!_async) return;
+    _async = false;
+    finish();
+}
+
+void JobSystem::runChunks() {
+    for (;;) {
+        const int chunk = _nextChunk.fetch_add(1);
+        if (chunk >= _chunkCount) return;
+        const int first = chunk * _grain;
+        const int last = std::min(_count, first + _grain);
+        _func(_context, first, last);
+    }
+}
+
+void JobSystem::workerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this, seen] { return _stopping || _generation != seen; });
+            if (_stopping) return;
+            seen = _generation;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pendingWorkers == 0) _done.notify_one();
+        }
+    }
+}
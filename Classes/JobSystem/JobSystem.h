@@ -0,0 +1,99 @@
+#pragma once
+#ifndef __JOB_SYSTEM_H__
+#define __JOB_SYSTEM_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定大小的工作线程池，只提供阻塞式 parallelFor：
+// - 调用线程同样领取分块执行，返回时全部分块已完成
+// - 任务以函数指针 + 上下文传入，派发时不产生堆分配
+// - 工作线程数为 0、任务量不足一个分块或已有任务在途时直接在调用线程串行执行
+// - beginParallelFor/wait 为非阻塞版本，同一时刻只允许一个在途任务
+// 调用方需保证各分块只读共享数据、只写各自的输出槽位，结果才与串行执行一致
+class JobSystem {
+public:
+    static JobSystem* getInstance();
+    static void destroyInstance();
+
+    // 启动 workerCount 个工作线程（已启动时先停止）；workerCount < 0 时按硬件线程数选择
+    void start(int workerCount);
+    void stop();
+
+    // 环境变量 TJ_JOB_THREADS 指定的线程数，未设置时返回 -1
+    static int workerCountFromEnvironment();
+
+    int getWorkerCount() const { return static_cast<int>(_workers.size()); }
+
+    // 把 [0, count) 按 grain 切块，fn(begin, end) 在任意线程上执行各分块
+    template <typename F>
+    void parallelFor(int count, int grain, F& fn) {
+        if (count <= 0) return;
+        if (grain < 1) grain = 1;
+        if (_workers.empty() || count <= grain || _dispatching) {
+            fn(0, count);
+            return;
+        }
+        begin(count, grain, &invokeRange<F>, &fn);
+        finish();
+    }
+
+    // 派发后立即返回，由 wait() 收尾；调用 wait() 之前 fn 及其引用的数据必须保持有效且不被修改。
+    // 没有工作线程或已有任务在途时在返回前执行完毕
+    template <typename F>
+    void beginParallelFor(int count, int grain, F& fn) {
+        if (count <= 0) return;
+        if (grain < 1) grain = 1;
+        if (_workers.empty() || _dispatching) {
+            fn(0, count);
+            return;
+        }
+        begin(count, grain, &invokeRange<F>, &fn);
+        _async = true;
+    }
+
+    // 等待 beginParallelFor 派发的任务完成（调用线程同样领取剩余分块），没有在途任务时立即返回
+    void wait();
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+    using RangeFunc = void (*)(void* context, int begin, int end);
+
+    template <typename F>
+    static void invokeRange(void* context, int begin, int end) {
+        (*static_cast<F*>(context))(begin, end);
+    }
+
+    void begin(int count, int grain, RangeFunc func, void* context);
+    void finish();
+    void workerLoop();
+    void runChunks();
+
+    static JobSystem* _instance;
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    bool _stopping = false;
+    bool _dispatching = false;
+    bool _async = false;
+
+    // 当前任务：在 _mutex 保护下写入，_generation 递增后由工作线程读取
+    RangeFunc _func = nullptr;
+    void* _context = nullptr;
+    int _count = 0;
+    int _grain = 1;
+    int _chunkCount = 0;
+    uint64_t _generation = 0;
+    int _pendingWorkers = 0;             // 尚未处理完本代任务的工作线程数
+    std::atomic<int> _nextChunk{ 0 };
+};
+
+#endif // __JOB_SYSTEM_H__
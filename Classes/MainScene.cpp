@@ -3,12 +3,15 @@
 #include "MapManager/MapManager.h"
 #include "UIManager/UIManager.h"
 #include "AudioManager/AudioManager.h"
+#include "Profiler/GameProfiler.h"
 
 using namespace cocos2d;
 
 MainScene* MainScene::createScene() {
+    PROFILE_SCOPE(ProfileZone::SceneBuild);
     auto scene = MainScene::create();
     if (!scene) return nullptr;
+    scene->setName("MainScene");
 
     auto map = MapManager::create(30, 30, -1, TerrainType::Home);
     if (map) {
@@ -25,7 +28,7 @@ MainScene* MainScene::createScene() {
         ui->showPanel(UIPanelType::GameHUD, UILayer::HUD);
         AudioManager::getInstance()->playMusic(false);
 
-        ui->setUICallback("OnEnterPlacementMode", [map]() {
+        ui->setUICallback(GameEventType::EnterPlacementMode, [map](const GameEvent&) {
             auto building = UIManager::getInstance()->getPendingPlacementBuilding();
             auto cost = UIManager::getInstance()->getPendingPlacementCost();
             if (building && map) {
@@ -33,13 +36,8 @@ MainScene* MainScene::createScene() {
             }
         });
 
-        ui->setUICallback("OnBattleStart_Map1", []() {
-            auto scene = BattleScene::createScene(1);
-            Director::getInstance()->replaceScene(TransitionFade::create(0.5, scene));
-        });
-
-        ui->setUICallback("OnBattleStart_Map2", []() {
-            auto scene = BattleScene::createScene(2);
+        ui->setUICallback(GameEventType::BattleStart, [](const GameEvent& e) {
+            auto scene = BattleScene::createScene(e.level.levelId);
             Director::getInstance()->replaceScene(TransitionFade::create(0.5, scene));
         });
     }
@@ -0,0 +1,181 @@
+#include "LayoutValidator.h"
+#include "TownHall/TownHall.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+struct PieceSize {
+    int width;
+    int length;
+};
+
+// 模板尺寸表：每次校验只构建一次，避免每个摆放项都线性扫描模板列表
+std::unordered_map<std::string, PieceSize> buildSizeTable() {
+    std::unordered_map<std::string, PieceSize> sizes;
+    for (const auto& t : TownHall::GetAllBuildingTemplates()) {
+        sizes[t.name_] = { t.width_, t.length_ };
+    }
+    sizes["Obstacle"] = { 1, 1 };
+    return sizes;
+}
+
+} // namespace
+
+LayoutValidator::LayoutValidator(int width, int length)
+    : _width(width), _length(length) {
+}
+
+bool LayoutValidator::parseLayout(const rapidjson::Value& mapLayout, std::vector<LayoutPiece>& pieces) {
+    if (!mapLayout.IsObject()) return false;
+    pieces.clear();
+
+    if (mapLayout.HasMember("buildings") && mapLayout["buildings"].IsArray()) {
+        const auto& buildingsJson = mapLayout["buildings"];
+        pieces.reserve(buildingsJson.Size());
+        for (rapidjson::SizeType i = 0; i < buildingsJson.Size(); i++) {
+            const auto& bJson = buildingsJson[i];
+            if (!bJson.IsObject() || !bJson.HasMember("type") || !bJson.HasMember("x") || !bJson.HasMember("y")) continue;
+            if (!bJson["type"].IsString() || !bJson["x"].IsInt() || !bJson["y"].IsInt()) continue;
+            LayoutPiece piece;
+            piece.type = bJson["type"].GetString();
+            piece.x = bJson["x"].GetInt();
+            piece.y = bJson["y"].GetInt();
+            piece.level = (bJson.HasMember("level") && bJson["level"].IsInt()) ? bJson["level"].GetInt() : 1;
+            pieces.push_back(std::move(piece));
+        }
+    }
+
+    if (mapLayout.HasMember("obstacles") && mapLayout["obstacles"].IsArray()) {
+        const auto& obstaclesJson = mapLayout["obstacles"];
+        for (rapidjson::SizeType i = 0; i < obstaclesJson.Size(); i++) {
+            const auto& oJson = obstaclesJson[i];
+            if (!oJson.IsObject() || !oJson.HasMember("x") || !oJson.HasMember("y")) continue;
+            if (!oJson["x"].IsInt() || !oJson["y"].IsInt()) continue;
+            LayoutPiece piece;
+            piece.type = "Obstacle";
+            piece.x = oJson["x"].GetInt();
+            piece.y = oJson["y"].GetInt();
+            pieces.push_back(std::move(piece));
+        }
+    }
+    return true;
+}
+
+LayoutValidationResult LayoutValidator::validate(const std::vector<LayoutPiece>& pieces,
+                                                 const LayoutValidationOptions& options) const {
+    LayoutValidationResult result;
+    const auto sizes = buildSizeTable();
+
+    auto addConflict = [&](LayoutConflictType type, int index, int other) {
+        LayoutConflict conflict;
+        conflict.type = type;
+        conflict.pieceIndex = index;
+        conflict.otherIndex = other;
+        if (index >= 0) {
+            conflict.buildingType = pieces[index].type;
+            conflict.x = pieces[index].x;
+            conflict.y = pieces[index].y;
+        }
+        result.conflicts.push_back(std::move(conflict));
+    };
+
+    // 1. 大本营等级：优先使用调用方指定的值，否则取布局中的大本营
+    result.townHallLevel = options.townHallLevel;
+    if (result.townHallLevel <= 0) {
+        for (const auto& piece : pieces) {
+            if (piece.type == "TownHall") {
+                result.townHallLevel = piece.level;
+                break;
+            }
+        }
+    }
+    if (options.checkCapacity && result.townHallLevel <= 0) {
+        addConflict(LayoutConflictType::MissingTownHall, -1, -1);
+    }
+
+    // 2. 单次遍历：尺寸 / 边界 / 禁区缓冲 / 重叠 / 数量
+    GridBitset occupied;
+    occupied.assign(_width, _length);
+    FlatGrid<int> owners;
+    owners.assign(_width, _length, -1);
+    GridBitset noDeploy;
+    if (options.checkDeployMargin) noDeploy.assign(_width, _length);
+    std::unordered_map<std::string, int> counts;
+
+    for (int i = 0; i < static_cast<int>(pieces.size()); ++i) {
+        const LayoutPiece& piece = pieces[i];
+        auto sizeIt = sizes.find(piece.type);
+        if (sizeIt == sizes.end()) {
+            addConflict(LayoutConflictType::UnknownType, i, -1);
+            continue;
+        }
+        const int w = sizeIt->second.width;
+        const int l = sizeIt->second.length;
+
+        if (piece.x < 0 || piece.y < 0 || piece.x + w > _width || piece.y + l > _length) {
+            addConflict(LayoutConflictType::OutOfBounds, i, -1);
+            continue;
+        }
+
+        if (options.checkCapacity && result.townHallLevel > 0) {
+            const int cap = TownHall::GetBuildingCapacityForLevel(piece.type, result.townHallLevel);
+            if (cap >= 0 && ++counts[piece.type] > cap) {
+                addConflict(LayoutConflictType::CapacityExceeded, i, -1);
+            }
+        }
+
+        const bool isBuilding = piece.type != "Obstacle";
+        if (options.checkDeployMargin && isBuilding) {
+            // 与 updateBuildingGrids 一致：建筑外一圈为禁区
+            const int mx = std::max(0, piece.x - 1);
+            const int my = std::max(0, piece.y - 1);
+            noDeploy.setRect(mx, my, std::min(_width, piece.x + w + 1) - mx, std::min(_length, piece.y + l + 1) - my, true);
+        }
+
+        // 位图整块测试通过时直接占位；只有真正重叠时才逐格查找占用者
+        if (occupied.anyInRect(piece.x, piece.y, w, l)) {
+            int lastOther = -1;
+            for (int y = piece.y; y < piece.y + l; ++y) {
+                for (int x = piece.x; x < piece.x + w; ++x) {
+                    const int other = owners.at(x, y);
+                    if (other >= 0 && other != lastOther) {
+                        addConflict(LayoutConflictType::Overlap, i, other);
+                        lastOther = other;
+                    }
+                }
+            }
+            continue;
+        }
+        occupied.setRect(piece.x, piece.y, w, l, true);
+        for (int y = piece.y; y < piece.y + l; ++y) {
+            for (int x = piece.x; x < piece.x + w; ++x) {
+                owners.at(x, y) = i;
+            }
+        }
+    }
+
+    if (options.checkDeployMargin) {
+        for (int y = 0; y < _length; ++y) {
+            for (int x = 0; x < _width; ++x) {
+                if (!noDeploy.test(x, y) && !occupied.test(x, y)) ++result.deployableCells;
+            }
+        }
+        if (result.deployableCells == 0) {
+            addConflict(LayoutConflictType::NoDeployableArea, -1, -1);
+        }
+    }
+    return result;
+}
+
+const char* LayoutValidator::conflictTypeName(LayoutConflictType type) {
+    switch (type) {
+        case LayoutConflictType::UnknownType:      return "UnknownType";
+        case LayoutConflictType::OutOfBounds:      return "OutOfBounds";
+        case LayoutConflictType::Overlap:          return "Overlap";
+        case LayoutConflictType::NoDeployableArea: return "NoDeployableArea";
+        case LayoutConflictType::CapacityExceeded: return "CapacityExceeded";
+        case LayoutConflictType::MissingTownHall:  return "MissingTownHall";
+    }
+    return "Unknown";
+}
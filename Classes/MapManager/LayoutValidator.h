@@ -0,0 +1,71 @@
+#pragma once
+#ifndef __LAYOUT_VALIDATOR_H__
+#define __LAYOUT_VALIDATOR_H__
+
+#include "json/document.h"
+#include "MapGrid.h"
+#include <string>
+#include <vector>
+
+// 布局中的一个摆放项（建筑或障碍物），坐标为左下角格子
+struct LayoutPiece {
+    std::string type;          // 建筑类型名；障碍物为 "Obstacle"
+    int x = 0;
+    int y = 0;
+    int level = 1;
+};
+
+// 冲突类型
+enum class LayoutConflictType {
+    UnknownType,       // 没有对应的建筑模板
+    OutOfBounds,       // 占位超出地图
+    Overlap,           // 与其他摆放项重叠（otherIndex 为先占位的一项）
+    NoDeployableArea,  // 建筑及其禁区缓冲圈覆盖了整张地图，没有可部署士兵的格子
+    CapacityExceeded,  // 超出大本营等级允许的数量
+    MissingTownHall,   // 布局中没有大本营且未指定大本营等级
+};
+
+struct LayoutConflict {
+    LayoutConflictType type;
+    int pieceIndex = -1;       // 出问题的摆放项下标（全局冲突为 -1）
+    int otherIndex = -1;       // Overlap 时另一项的下标
+    std::string buildingType;
+    int x = 0;
+    int y = 0;
+};
+
+struct LayoutValidationOptions {
+    int townHallLevel = 0;         // 0 表示取布局中大本营的等级
+    bool checkCapacity = true;     // 主村庄检查数量上限；战斗地图关卡不受玩家上限约束
+    bool checkDeployMargin = false;// 战斗地图：按建筑外一圈禁区统计可部署格子
+};
+
+struct LayoutValidationResult {
+    std::vector<LayoutConflict> conflicts;
+    int townHallLevel = 0;
+    int deployableCells = 0;       // 校验后仍可部署士兵的格子数（仅 checkDeployMargin 时统计）
+
+    bool ok() const { return conflicts.empty(); }
+};
+
+// 批量布局校验器：
+// 对整份布局只做一次遍历，用占用位图做矩形测试、用扁平下标网格定位重叠对象，
+// 一次性返回全部冲突，而不是像逐个 placeBuilding 那样遇到问题才失败
+class LayoutValidator {
+public:
+    LayoutValidator(int width, int length);
+
+    // 从 map_layout 格式的 JSON（buildings / obstacles 数组）读取摆放项
+    static bool parseLayout(const rapidjson::Value& mapLayout, std::vector<LayoutPiece>& pieces);
+
+    LayoutValidationResult validate(const std::vector<LayoutPiece>& pieces,
+                                    const LayoutValidationOptions& options) const;
+
+    static const char* conflictTypeName(LayoutConflictType type);
+
+private:
+    int _width;
+    int _length;
+};
+
+#endif // __LAYOUT_VALIDATOR_H__
@@ -0,0 +1,102 @@
+#pragma once
+#ifndef __MAP_GRID_H__
+#define __MAP_GRID_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// 行主序扁平网格：下标 = y * width + x，整张地图一块连续内存
+template <typename T>
+class FlatGrid {
+public:
+    void assign(int width, int length, const T& value) {
+        _width = width;
+        _length = length;
+        _cells.assign(static_cast<size_t>(width) * length, value);
+    }
+    void fill(const T& value) { std::fill(_cells.begin(), _cells.end(), value); }
+    void clear() { _width = _length = 0; _cells.clear(); }
+
+    // 调用方负责边界检查
+    T& at(int x, int y) { return _cells[static_cast<size_t>(y) * _width + x]; }
+    const T& at(int x, int y) const { return _cells[static_cast<size_t>(y) * _width + x]; }
+
+    int width() const { return _width; }
+    int length() const { return _length; }
+    bool empty() const { return _cells.empty(); }
+
+private:
+    int _width = 0;
+    int _length = 0;
+    std::vector<T> _cells;
+};
+
+// 按行打包的格子位图（每行若干个 64 位字）：
+// 单格读写为一次移位，矩形区域测试每行只需 1~2 次按字与运算（4x4 建筑占位即 4 行）
+class GridBitset {
+public:
+    void assign(int width, int length) {
+        _width = width;
+        _length = length;
+        _wordsPerRow = (width + 63) / 64;
+        _words.assign(static_cast<size_t>(_wordsPerRow) * length, 0);
+    }
+    void reset() { std::fill(_words.begin(), _words.end(), 0); }
+    void clear() { _width = _length = _wordsPerRow = 0; _words.clear(); }
+
+    // 以下接口调用方负责边界检查
+    bool test(int x, int y) const {
+        return (word(x, y) >> (x & 63)) & 1u;
+    }
+
+    void set(int x, int y, bool value) {
+        uint64_t bit = uint64_t(1) << (x & 63);
+        if (value) word(x, y) |= bit;
+        else word(x, y) &= ~bit;
+    }
+
+    // [x, x+w) × [y, y+h) 内是否有任意一位被置位
+    bool anyInRect(int x, int y, int w, int h) const {
+        for (int row = y; row < y + h; ++row) {
+            for (int cx = x, remaining = w; remaining > 0; ) {
+                int bit = cx & 63;
+                int count = std::min(64 - bit, remaining);
+                if (word(cx, row) & mask(bit, count)) return true;
+                cx += count;
+                remaining -= count;
+            }
+        }
+        return false;
+    }
+
+    void setRect(int x, int y, int w, int h, bool value) {
+        for (int row = y; row < y + h; ++row) {
+            for (int cx = x, remaining = w; remaining > 0; ) {
+                int bit = cx & 63;
+                int count = std::min(64 - bit, remaining);
+                if (value) word(cx, row) |= mask(bit, count);
+                else word(cx, row) &= ~mask(bit, count);
+                cx += count;
+                remaining -= count;
+            }
+        }
+    }
+
+    int width() const { return _width; }
+    int length() const { return _length; }
+
+private:
+    static uint64_t mask(int bit, int count) {
+        return (count >= 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1)) << bit;
+    }
+    uint64_t& word(int x, int y) { return _words[static_cast<size_t>(y) * _wordsPerRow + (x >> 6)]; }
+    const uint64_t& word(int x, int y) const { return _words[static_cast<size_t>(y) * _wordsPerRow + (x >> 6)]; }
+
+    int _width = 0;
+    int _length = 0;
+    int _wordsPerRow = 0;
+    std::vector<uint64_t> _words;
+};
+
+#endif // __MAP_GRID_H__
@@ -2,8 +2,10 @@
 #include "TownHall/TownHall.h"
 #include "UIManager/UIManager.h"
 #include "Combat/Combat.h"
+#include "Profiler/GameProfiler.h"
 #include <algorithm>
 #include <cmath>
+#include <unordered_map>
 
 MapManager::MapManager():_width(0),_length(0),_gridSize(0),_terrainType(TerrainType::Home){}
 
@@ -15,10 +17,9 @@ MapManager::~MapManager() {
         _inputListener = nullptr;
     }
 
-    for (int x = 0; x < _width; ++x) {
-        for (int y = 0; y < _length; ++y) {
-            cocos2d::Sprite* spr = (x < (int)_gridObstacles.size() && y < (int)_gridObstacles[x].size())
-                ? _gridObstacles[x][y] : nullptr;
+    for (int x = 0; x < _gridObstacles.width(); ++x) {
+        for (int y = 0; y < _gridObstacles.length(); ++y) {
+            cocos2d::Sprite* spr = _gridObstacles.at(x, y);
             if (spr) spr->removeFromParent();
         }
     }
@@ -27,6 +28,7 @@ MapManager::~MapManager() {
     _buildings.clear();
     _gridBuildings.clear();
     _gridStates.clear();
+    _blocked.clear();
 }
 
 MapManager* MapManager::create(int width, int length, int gridSize, TerrainType terrainType) {
@@ -99,10 +101,13 @@ bool MapManager::init(int width, int length, int gridSize, TerrainType terrainTy
 
 void MapManager::initGrids() {
     // 确保容器大小正确
-    if (_gridStates.size() != _width) _gridStates.assign(_width, std::vector<GridState>(_length, GridState::Empty));
-    if (_gridBuildings.size() != _width) _gridBuildings.assign(_width, std::vector<Building*>(_length, nullptr));
-    if (_gridObstacles.size() != _width) _gridObstacles.assign(_width, std::vector<cocos2d::Sprite*>(_length, nullptr));
-    if (_noDeploy.size() != _width) _noDeploy.assign(_width, std::vector<bool>(_length, false));
+    if (_gridStates.width() != _width || _gridStates.length() != _length) {
+        _gridStates.assign(_width, _length, GridState::Empty);
+        _gridBuildings.assign(_width, _length, nullptr);
+        _gridObstacles.assign(_width, _length, nullptr);
+        _noDeploy.assign(_width, _length);
+        _blocked.assign(_width, _length);
+    }
     _buildings.clear();
 
     // 创建禁区可视化节点 (仅在战斗地图使用)
@@ -154,12 +159,18 @@ GridState MapManager::getGridState(int gridX, int gridY) const {
     if (!isValidGrid(gridX, gridY)) {
         return GridState::Obstacle;
     }
-    return _gridStates[gridX][gridY];
+    return _gridStates.at(gridX, gridY);
 }
 
 void MapManager::setGridState(int gridX, int gridY, GridState state) {
     if (!isValidGrid(gridX, gridY)) return;
-    _gridStates[gridX][gridY] = state;
+    setCellState(gridX, gridY, state);
+}
+
+// 写入格子状态并同步占用位图（调用方负责边界检查）
+void MapManager::setCellState(int gridX, int gridY, GridState state) {
+    _gridStates.at(gridX, gridY) = state;
+    _blocked.set(gridX, gridY, state != GridState::Empty);
 }
 
 
@@ -168,20 +179,17 @@ bool MapManager::isRangeAvailable(int gridX, int gridY, int width, int length) c
     if (gridX < 0 || gridY < 0 || (gridX + width) > _width || (gridY + length) > _length) {
         return false;
     }
-    for (int x = gridX; x < gridX + width; ++x) {
-        for (int y = gridY; y < gridY + length; ++y) {
-            const GridState st = _gridStates[x][y];
-            if (st == GridState::HasBuilding || st == GridState::Obstacle) {
-                return false;
-            }
-        }
-    }
-    return true;
+    // 2. 占用位图按字测试整个矩形
+    return !_blocked.anyInRect(gridX, gridY, width, length);
 }
 
 //对于士兵类型的特别重载
 bool MapManager::IsGridAvailable(const cocos2d::Vec2& pos) const{
-    return isRangeAvailable(std::floor(pos.x),std::floor(pos.y),1,1);
+    return IsGridAvailable(static_cast<int>(std::floor(pos.x)), static_cast<int>(std::floor(pos.y)));
+}
+
+bool MapManager::IsGridAvailable(int gridX, int gridY) const {
+    return isValidGrid(gridX, gridY) && !_blocked.test(gridX, gridY);
 }
 
 bool MapManager::isPositionAvailable(int gridX, int gridY, const Building* building ) const {
@@ -201,12 +209,12 @@ void MapManager::updateBuildingGrids(Building* building, int gridX, int gridY, b
         for (int y = gridY; y < gridY + bh; ++y) {
             if (!isValidGrid(x, y)) continue;
             if (occupy) {
-                _gridStates[x][y] = GridState::HasBuilding;
-                _gridBuildings[x][y] = building;
+                setCellState(x, y, GridState::HasBuilding);
+                _gridBuildings.at(x, y) = building;
             }
             else {
-                _gridStates[x][y] = GridState::Empty;
-                _gridBuildings[x][y] = nullptr;
+                setCellState(x, y, GridState::Empty);
+                _gridBuildings.at(x, y) = nullptr;
             }
         }
     }
@@ -219,12 +227,12 @@ void MapManager::updateBuildingGrids(Building* building, int gridX, int gridY, b
                 if (!isValidGrid(x, y)) continue;
                 
                 if (occupy) {
-                    _noDeploy[x][y] = true;
+                    _noDeploy.set(x, y, true);
                 } else {
                     // 暂时简单处理：移除建筑时取消禁区
                     // 注意：如果多个建筑禁区重叠，这里可能会误删邻近建筑的禁区
                     // 但战斗地图建筑通常是静态加载的，不会在运行时移动
-                    _noDeploy[x][y] = false;
+                    _noDeploy.set(x, y, false);
                 }
             }
         }
@@ -242,8 +250,23 @@ void MapManager::updateEmptyBuildingGrids(const Building* building){
     for (int x = gridX; x < gridX + bw; ++x) {
         for (int y = gridY; y < gridY + bh; ++y) {
             if (!isValidGrid(x, y)) continue;
-            _gridStates[x][y] = GridState::Empty;
-            _gridBuildings[x][y] = nullptr;
+            setCellState(x, y, GridState::Empty);
+            _gridBuildings.at(x, y) = nullptr;
+        }
+    }
+}
+
+void MapManager::restoreBuildingGrids(const Building* building) {
+    if (!building) return;
+    const int gridX = floor(building->GetPosition().x);
+    const int gridY = floor(building->GetPosition().y);
+
+    for (int x = gridX; x < gridX + building->GetWidth(); ++x) {
+        for (int y = gridY; y < gridY + building->GetLength(); ++y) {
+            if (!isValidGrid(x, y)) continue;
+            setCellState(x, y, GridState::HasBuilding);
+            // 格子记录的是地图自己持有的建筑，战斗侧只拿到 const 指针
+            _gridBuildings.at(x, y) = const_cast<Building*>(building);
         }
     }
 }
@@ -348,7 +371,7 @@ void MapManager::updateYOrder(cocos2d::Node* node) {
 
 bool MapManager::removeBuilding(int gridX, int gridY) {
     if (!isValidGrid(gridX, gridY)) return false;
-    Building* b = _gridBuildings[gridX][gridY];
+    Building* b = _gridBuildings.at(gridX, gridY);
     if (!b) return false;
 
     updateBuildingGrids(b, gridX, gridY, false);
@@ -366,7 +389,7 @@ bool MapManager::removeBuilding(int gridX, int gridY) {
 
 bool MapManager::moveBuilding(int fromX, int fromY, int toX, int toY) {
     if (!isValidGrid(fromX, fromY) || !isValidGrid(toX, toY)) return false;
-    Building* b = _gridBuildings[fromX][fromY];
+    Building* b = _gridBuildings.at(fromX, fromY);
     if (!b) return false;
 
 	const int bw = b->GetWidth();
@@ -429,7 +452,7 @@ cocos2d::Vec2 MapManager::worldToVec(cocos2d::Vec2 worldPos) const{
 
 Building* MapManager::getBuildingAt(int gridX, int gridY) const {
     if (!isValidGrid(gridX, gridY)) return nullptr;
-    return _gridBuildings[gridX][gridY];
+    return _gridBuildings.at(gridX, gridY);
 }
 
 const std::vector<Building*>& MapManager::getAllBuildings() const {
@@ -438,19 +461,19 @@ const std::vector<Building*>& MapManager::getAllBuildings() const {
 
 void MapManager::placeObstacle(int gridX, int gridY) {
     if (!isValidGrid(gridX, gridY)) return;
-    const GridState st = _gridStates[gridX][gridY];
+    const GridState st = _gridStates.at(gridX, gridY);
     if (st == GridState::Empty) {
-        _gridStates[gridX][gridY] = GridState::Obstacle;
-        if (_gridObstacles[gridX][gridY]) {
-            _gridObstacles[gridX][gridY]->removeFromParent();
-            _gridObstacles[gridX][gridY] = nullptr;
+        setCellState(gridX, gridY, GridState::Obstacle);
+        if (_gridObstacles.at(gridX, gridY)) {
+            _gridObstacles.at(gridX, gridY)->removeFromParent();
+            _gridObstacles.at(gridX, gridY) = nullptr;
         }
         const std::string obstaclePath = "obstacles/rock.png";
         cocos2d::Sprite* sprite = nullptr;
         if (cocos2d::FileUtils::getInstance()->isFileExist(obstaclePath)) {
             sprite = cocos2d::Sprite::create(obstaclePath);
             setupNodeOnMap(sprite, gridX, gridY, 1, 1);
-            _gridObstacles[gridX][gridY] = sprite;
+            _gridObstacles.at(gridX, gridY) = sprite;
             _worldNode->addChild(sprite, 1);
         }		
     }
@@ -458,12 +481,12 @@ void MapManager::placeObstacle(int gridX, int gridY) {
 
 void MapManager::removeObstacle(int gridX, int gridY) {
     if (!isValidGrid(gridX, gridY)) return;
-    if (_gridStates[gridX][gridY] == GridState::Obstacle) {
-        _gridStates[gridX][gridY] = GridState::Empty;
-        cocos2d::Sprite* sprite = _gridObstacles[gridX][gridY];
+    if (_gridStates.at(gridX, gridY) == GridState::Obstacle) {
+        setCellState(gridX, gridY, GridState::Empty);
+        cocos2d::Sprite* sprite = _gridObstacles.at(gridX, gridY);
         if (sprite) {
             sprite->removeFromParent();
-            _gridObstacles[gridX][gridY] = nullptr;
+            _gridObstacles.at(gridX, gridY) = nullptr;
         }
         // 自动保存
         if (!_currentSavePath.empty() && _terrainType == TerrainType::Home) {
@@ -474,20 +497,17 @@ void MapManager::removeObstacle(int gridX, int gridY) {
 
 void MapManager::markNoDeploy(int gridX, int gridY) {
     if (!isValidGrid(gridX, gridY)) return;
-    _noDeploy[gridX][gridY] = true;
+    _noDeploy.set(gridX, gridY, true);
 }
 
 void MapManager::unmarkNoDeploy(int gridX, int gridY) {
     if (!isValidGrid(gridX, gridY)) return;
-    _noDeploy[gridX][gridY] = false;
+    _noDeploy.set(gridX, gridY, false);
 }
 
 bool MapManager::isDeployAllowedGrid(int gridX, int gridY) const {
     if (!isValidGrid(gridX, gridY)) return false;
-    if (_noDeploy[gridX][gridY]) return false;
-    const GridState st = _gridStates[gridX][gridY];
-    if (st == GridState::HasBuilding || st == GridState::Obstacle) return false;
-    return true;
+    return !_noDeploy.test(gridX, gridY) && !_blocked.test(gridX, gridY);
 }
 
 
@@ -911,14 +931,14 @@ void MapManager::clearMap() {
     // 移除所有建筑
     for (int x = 0; x < _width; ++x) {
         for (int y = 0; y < _length; ++y) {
-            Building* b = _gridBuildings[x][y];
+            Building* b = _gridBuildings.at(x, y);
             if (b) {
                 // 找到建筑的左下角起始点（因为一个建筑占用多个格子，只需处理一次）
                 // 这里简单处理：直接通过 gridBuildings 遍历并移除
                 b->removeFromParent();
-                _gridBuildings[x][y] = nullptr;
+                _gridBuildings.at(x, y) = nullptr;
             }
-            _gridStates[x][y] = GridState::Empty;
+            setCellState(x, y, GridState::Empty);
         }
     }
     _buildings.clear();
@@ -926,9 +946,9 @@ void MapManager::clearMap() {
     // 移除所有障碍物
     for (int x = 0; x < _width; ++x) {
         for (int y = 0; y < _length; ++y) {
-            if (_gridObstacles[x][y]) {
-                _gridObstacles[x][y]->removeFromParent();
-                _gridObstacles[x][y] = nullptr;
+            if (_gridObstacles.at(x, y)) {
+                _gridObstacles.at(x, y)->removeFromParent();
+                _gridObstacles.at(x, y) = nullptr;
             }
         }
     }
@@ -943,6 +963,8 @@ bool MapManager::loadFromJSONObject(const rapidjson::Value& mapData) {
     if (mapData.HasMember("buildings") && mapData["buildings"].IsArray()) {
         const auto& buildingsJson = mapData["buildings"];
         auto templates = TownHall::GetAllBuildingTemplates();
+        std::unordered_map<std::string, const TownHall::BuildingTemplate*> templateByName;
+        for (const auto& t : templates) templateByName[t.name_] = &t;
 
         for (rapidjson::SizeType i = 0; i < buildingsJson.Size(); i++) {
             const auto& bJson = buildingsJson[i];
@@ -955,30 +977,29 @@ bool MapManager::loadFromJSONObject(const rapidjson::Value& mapData) {
             CCLOG("load building '%s' : (%d,%d),level%d",type.c_str(),gx,gy,level);
 
             // Find matching template
-            for (const auto& t : templates) {
-                if (t.name_ == type) {
-                    CCLOG("template founded when loading : %s",type.c_str());
-                    Building* building = t.createFunc();
-                    if (building) {
-                        building->SetMapPosition({static_cast<float>(gx),static_cast<float>(gy)});
-                        // Set level (assuming UpgradeToLevel exists or calling Upgrade multiple times)
-                        for(int l = 1; l < level; ++l) building->Upgrade();
-                        
-                        // 关键改动：如果不是主场景（战斗模式），我们只记录建筑数据，不进行实际的渲染和网格占用
-                        // 战斗中的建筑渲染由 CombatManager 负责创建对应的 BuildingInCombat 节点
-                        if (_terrainType == TerrainType::Home) {
-                            placeBuilding(building, gx, gy);
-                        } else {
-                            // 战斗模式下，只需将建筑添加到列表供 CombatManager 读取
-                            _buildings.push_back(building);
-                            // 依然需要更新网格数据以便战斗逻辑查询
-                            updateBuildingGrids(building, gx, gy, true);
-                            // 建筑本身不需要显示，因为 Combat 会创建新的 Sprite
-                            building->setVisible(false);
-                            this->addChild(building);
-                        }
+            auto templateIt = templateByName.find(type);
+            if (templateIt != templateByName.end()) {
+                const auto& t = *templateIt->second;
+                CCLOG("template founded when loading : %s",type.c_str());
+                Building* building = t.createFunc();
+                if (building) {
+                    building->SetMapPosition({static_cast<float>(gx),static_cast<float>(gy)});
+                    // Set level (assuming UpgradeToLevel exists or calling Upgrade multiple times)
+                    for(int l = 1; l < level; ++l) building->Upgrade();
+                    
+                    // 关键改动：如果不是主场景（战斗模式），我们只记录建筑数据，不进行实际的渲染和网格占用
+                    // 战斗中的建筑渲染由 CombatManager 负责创建对应的 BuildingInCombat 节点
+                    if (_terrainType == TerrainType::Home) {
+                        placeBuilding(building, gx, gy);
+                    } else {
+                        // 战斗模式下，只需将建筑添加到列表供 CombatManager 读取
+                        _buildings.push_back(building);
+                        // 依然需要更新网格数据以便战斗逻辑查询
+                        updateBuildingGrids(building, gx, gy, true);
+                        // 建筑本身不需要显示，因为 Combat 会创建新的 Sprite
+                        building->setVisible(false);
+                        this->addChild(building);
                     }
-                    break;
                 }
             }
         }
@@ -1003,6 +1024,30 @@ bool MapManager::loadFromJSONObject(const rapidjson::Value& mapData) {
     return true;
 }
 
+LayoutValidationResult MapManager::validateLayout(const rapidjson::Value& mapData) const {
+    std::vector<LayoutPiece> pieces;
+    LayoutValidator::parseLayout(mapData, pieces);
+
+    LayoutValidationOptions options;
+    options.checkCapacity = (_terrainType == TerrainType::Home);
+    options.checkDeployMargin = (_terrainType == TerrainType::Battle);
+    return LayoutValidator(_width, _length).validate(pieces, options);
+}
+
+bool MapManager::importLayout(const rapidjson::Value& mapData, LayoutValidationResult* result) {
+    LayoutValidationResult validation = validateLayout(mapData);
+    for (const auto& conflict : validation.conflicts) {
+        (void)conflict;  // 发布构建中 CCLOG 为空
+        CCLOG("MapManager: layout conflict %s piece=%d other=%d '%s' (%d,%d)",
+              LayoutValidator::conflictTypeName(conflict.type), conflict.pieceIndex, conflict.otherIndex,
+              conflict.buildingType.c_str(), conflict.x, conflict.y);
+    }
+    const bool ok = validation.ok();
+    if (result) *result = std::move(validation);
+    if (!ok) return false;
+    return loadFromJSONObject(mapData);
+}
+
 void MapManager::updateNoDeployVisual() {
     if (!_noDeployVisual || _terrainType != TerrainType::Battle) return;
 
@@ -1014,7 +1059,7 @@ void MapManager::updateNoDeployVisual() {
     // 遍历所有格子，绘制禁区
     for (int x = 0; x < _width; ++x) {
         for (int y = 0; y < _length; ++y) {
-            if (_noDeploy[x][y]) {
+            if (_noDeploy.test(x, y)) {
                 cocos2d::Vec2 center = gridToWorld(x, y);
                 
                 // 绘制菱形的四个顶点
@@ -1033,6 +1078,7 @@ void MapManager::updateNoDeployVisual() {
 }
 
 bool MapManager::loadMapData(const std::string& filePath) {
+    PROFILE_SCOPE(ProfileZone::SaveIO);
     _currentSavePath = filePath; // 记录保存路径以便后续自动保存
     
     // 1. 构造可写目录下的绝对路径
@@ -1081,6 +1127,7 @@ bool MapManager::loadMapData(const std::string& filePath) {
 }
 
 bool MapManager::saveMapData(const std::string& filePath) const {
+    PROFILE_SCOPE(ProfileZone::SaveIO);
     rapidjson::Document doc;
     
     // 优先从可写目录读取现有存档以保留 player_stats
@@ -1143,7 +1190,7 @@ bool MapManager::saveMapData(const std::string& filePath) const {
     rapidjson::Value obstaclesArray(rapidjson::kArrayType);
     for (int x = 0; x < _width; ++x) {
         for (int y = 0; y < _length; ++y) {
-            if (_gridStates[x][y] == GridState::Obstacle) {
+            if (_gridStates.at(x, y) == GridState::Obstacle) {
                 rapidjson::Value oObj(rapidjson::kObjectType);
                 oObj.AddMember("x", x, allocator);
                 oObj.AddMember("y", y, allocator);
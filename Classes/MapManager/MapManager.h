@@ -11,6 +11,8 @@
 #include "json/document.h"
 #include "json/writer.h"
 #include "json/stringbuffer.h"
+#include "MapGrid.h"
+#include "LayoutValidator.h"
 
 // 地图格子状态枚举
 enum class GridState {
@@ -54,6 +56,19 @@ public:
 	// 检查建筑是否可以放置在指定范围（从gridX开始，到gridX+width；从gridY开始，到gridY+length）
     virtual bool isRangeAvailable(int gridX, int gridY, int width, int length) const;
     virtual bool IsGridAvailable(const cocos2d::Vec2& pos) const;
+    // 整数格子版本（寻路等热点路径使用，单次位测试）
+    bool IsGridAvailable(int gridX, int gridY) const;
+
+    // 占用位图（有建筑或障碍物的格子置位），供寻路等批量查询直接读取
+    const GridBitset& getBlockedBits() const { return _blocked; }
+
+    // ========== 批量布局校验 ==========
+    // 按当前地图尺寸与类型一次性校验整份布局（map_layout 格式），返回全部冲突
+    // 主村庄检查大本营等级数量上限，战斗地图检查是否仍有可部署区域
+    LayoutValidationResult validateLayout(const rapidjson::Value& mapData) const;
+
+    // 导入共享布局：先整体校验，全部通过才清空并加载；失败时地图保持不变
+    bool importLayout(const rapidjson::Value& mapData, LayoutValidationResult* result = nullptr);
 
     // ========== 建筑管理功能 ==========
     // 将建筑放置到指定格子位置  返回是否成功
@@ -150,6 +165,8 @@ public:
     void updateYOrder(cocos2d::Node* node);
 
     void updateEmptyBuildingGrids(const Building* building);
+    // updateEmptyBuildingGrids 的逆操作：战斗快照恢复时把已摧毁的建筑放回格子（不改动部署禁区）
+    void restoreBuildingGrids(const Building* building);
 
     // 获取地图奖励信息
     int getBaseGoldReward() const { return _baseGoldReward; }
@@ -165,6 +182,7 @@ protected:
 
     // 设置格子状态
     void setGridState(int gridX, int gridY, GridState state);
+    void setCellState(int gridX, int gridY, GridState state);
 
 
     // 获取格子状态
@@ -181,17 +199,20 @@ private:
     int _gridSize;            // 每个格子的像素大小
     TerrainType _terrainType; // 地形类型（主村庄/战斗地图）
 
-    // 地图格子状态（二维数组：[x][y]）
-    std::vector<std::vector<GridState>> _gridStates;
+    // 地图格子状态（行主序扁平数组，只能经 setCellState 写入）
+    FlatGrid<GridState> _gridStates;
+
+    // 地图上的建筑引用（行主序扁平数组），用于快速查找
+    FlatGrid<Building*> _gridBuildings;
 
-    // 地图上的建筑引用（二维数组：[x][y]），用于快速查找
-    std::vector<std::vector<Building*>> _gridBuildings;
+	// 地图上的障碍物引用（行主序扁平数组），用于显示和管理
+    FlatGrid<cocos2d::Sprite*> _gridObstacles;
 
-	// 地图上的障碍物引用（二维数组：[x][y]），用于显示和管理
-    std::vector<std::vector<cocos2d::Sprite*>> _gridObstacles;
+	// 士兵部署禁区标记位图，置位表示不可部署
+    GridBitset _noDeploy;
 
-	// 士兵部署禁区标记（二维数组：[x][y]），true表示不可部署
-    std::vector<std::vector<bool>> _noDeploy;
+    // 占用位图：与 _gridStates 同步，非 Empty 的格子置位
+    GridBitset _blocked;
 
     // 维护一个所有建筑的列表，方便遍历
     std::vector<Building*> _buildings;
@@ -0,0 +1,365 @@
+#include "GameProfiler.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+USING_NS_CC;
+
+// ==================== 分配计数 ====================
+thread_local ProfileZone GameProfiler::_heapZone = ProfileZone::Count;
+
+#if TJ_PROFILE_ALLOCATIONS
+static const int kHeapBuckets = static_cast<int>(ProfileZone::Count) + 1;
+static std::atomic<uint64_t> s_allocationCount{0};
+static std::atomic<int64_t> s_liveHeapBytes[kHeapBuckets];
+
+// 每块内存前面放一个头，记录大小与分配时所在的子系统，释放时从同一子系统扣除；
+// 头按 max_align_t 对齐，返回给调用者的地址与 malloc 的对齐保证相同
+struct alignas(alignof(std::max_align_t)) AllocationHeader {
+    std::size_t size;
+    int zone;
+};
+
+static void* allocateTracked(std::size_t size) noexcept {
+    auto header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+    if (!header) return nullptr;
+    header->size = size;
+    header->zone = static_cast<int>(GameProfiler::getHeapZone());
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_liveHeapBytes[header->zone].fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    return header + 1;
+}
+
+static void freeTracked(void* p) noexcept {
+    if (!p) return;
+    auto header = static_cast<AllocationHeader*>(p) - 1;
+    s_liveHeapBytes[header->zone].fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+    std::free(header);
+}
+
+// 带头的块只能由这里的 delete 释放，所以 nothrow 与数组形式也一并替换，不依赖标准库默认实现的转发方式
+void* operator new(std::size_t size) {
+    if (size == 0) size = 1;
+    while (true) {
+        if (void* p = allocateTracked(size)) return p;
+        auto handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    freeTracked(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    freeTracked(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    freeTracked(p);
+}
+
+void operator delete[](void* p) noexcept {
+    freeTracked(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    freeTracked(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    freeTracked(p);
+}
+#endif
+
+uint64_t GameProfiler::getAllocationCount() {
+#if TJ_PROFILE_ALLOCATIONS
+    return s_allocationCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+int64_t GameProfiler::getLiveHeapBytes(ProfileZone zone) {
+#if TJ_PROFILE_ALLOCATIONS
+    return s_liveHeapBytes[static_cast<int>(zone)].load(std::memory_order_relaxed);
+#else
+    (void)zone;
+    return 0;
+#endif
+}
+
+// ==================== GameProfiler ====================
+static const char* kZoneNames[] = {
+    "Scheduler", "CombatUpdate", "PathFinding", "Targeting",
+    "UIUpdate", "SaveIO", "Render", "AssetLoad", "SceneBuild"
+};
+static_assert(sizeof(kZoneNames) / sizeof(kZoneNames[0]) == static_cast<size_t>(ProfileZone::Count),
+              "kZoneNames must match ProfileZone");
+
+static const float kFrameBudgetMs = 1000.0f / 60.0f;
+static const float kOverlayRefreshInterval = 0.5f;
+
+GameProfiler* GameProfiler::_instance = nullptr;
+
+const char* GameProfiler::getZoneName(ProfileZone zone) {
+    return zone == ProfileZone::Count ? "Other" : kZoneNames[static_cast<int>(zone)];
+}
+
+GameProfiler* GameProfiler::getInstance() {
+    if (!_instance) {
+        _instance = new GameProfiler();
+    }
+    return _instance;
+}
+
+GameProfiler::GameProfiler()
+    : _startTime(Clock::now()), _lastFrameEnd(_startTime) {
+    _history.resize(kHistoryFrames);
+}
+
+void GameProfiler::install() {
+    if (_installed) return;
+    _installed = true;
+
+    auto director = Director::getInstance();
+    auto dispatcher = director->getEventDispatcher();
+
+    // Scheduler/Render 阶段的分配在没有更内层作用域时记到这两个子系统
+    dispatcher->addCustomEventListener(Director::EVENT_BEFORE_UPDATE, [this](EventCustom*) {
+        exchangeHeapZone(ProfileZone::Scheduler);
+        if (!_enabled) return;
+        _updateBegin = Clock::now();
+        _updateAllocations = getAllocationCount();
+    });
+    dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom*) {
+        exchangeHeapZone(ProfileZone::Count);
+        if (!_enabled) return;
+        record(ProfileZone::Scheduler, _updateBegin, Clock::now(), getAllocationCount() - _updateAllocations);
+    });
+    // Render 从 BEFORE_DRAW 开始：AFTER_VISIT 在场景遍历并 Renderer::render 之后才触发，从那里计时会漏掉场景绘制
+    dispatcher->addCustomEventListener(Director::EVENT_BEFORE_DRAW, [this](EventCustom*) {
+        exchangeHeapZone(ProfileZone::Render);
+        if (!_enabled) return;
+        _renderBegin = Clock::now();
+        _renderAllocations = getAllocationCount();
+    });
+    dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+        exchangeHeapZone(ProfileZone::Count);
+        if (!_enabled) return;
+        record(ProfileZone::Render, _renderBegin, Clock::now(), getAllocationCount() - _renderAllocations);
+        onFrameEnd();
+    });
+
+    // 快捷键：F3 浮层，F4 导出
+    auto keyListener = EventListenerKeyboard::create();
+    keyListener->onKeyReleased = [this](EventKeyboard::KeyCode code, Event*) {
+        if (code == EventKeyboard::KeyCode::KEY_F3) {
+            toggleOverlay();
+        } else if (code == EventKeyboard::KeyCode::KEY_F4) {
+            // 还没有记录过任何帧时先开始采集，再按一次 F4 才导出
+            if (!hasCapture()) {
+                setEnabled(true);
+                CCLOG("GameProfiler: nothing recorded yet, capture started; press F4 again to export");
+                return;
+            }
+            exportChromeTrace();
+            exportCsv();
+        }
+    };
+    dispatcher->addEventListenerWithFixedPriority(keyListener, 1);
+}
+
+void GameProfiler::setEnabled(bool enabled) {
+    if (_enabled == enabled) return;
+    _enabled = enabled;
+    if (enabled) {
+        // 重新开始计时，避免把关闭期间的时间算进第一帧
+        _lastFrameEnd = Clock::now();
+        _current = FrameSample();
+    }
+}
+
+void GameProfiler::setOverlayVisible(bool visible) {
+    _overlayVisible = visible;
+    if (visible) {
+        setEnabled(true);
+        if (!_overlay) {
+            auto director = Director::getInstance();
+            auto origin = director->getVisibleOrigin();
+            auto size = director->getVisibleSize();
+
+            // 挂在通知节点上，切换场景时不会被销毁
+            auto root = Node::create();
+            _overlay = Label::createWithTTF("", "fonts/arial.ttf", 10);
+            _overlay->setAnchorPoint(Vec2(0.0f, 1.0f));
+            _overlay->setPosition(Vec2(origin.x + 4, origin.y + size.height - 4));
+            _overlay->setColor(Color3B::YELLOW);
+            _overlay->enableOutline(Color4B::BLACK, 1);
+            root->addChild(_overlay);
+            director->setNotificationNode(root);
+        }
+        refreshOverlay();
+    }
+    if (_overlay) {
+        _overlay->setVisible(visible);
+    }
+}
+
+void GameProfiler::record(ProfileZone zone, Clock::time_point begin, Clock::time_point end, uint64_t allocations) {
+    int index = static_cast<int>(zone);
+    int64_t beginUs = toMicroseconds(begin);
+    int64_t durationUs = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+
+    _current.zoneMs[index] += durationUs / 1000.0f;
+    _current.zoneAllocations[index] += static_cast<uint32_t>(allocations);
+
+    TraceEvent event{zone, beginUs, durationUs};
+    if (_trace.size() < kMaxTraceEvents) {
+        _trace.push_back(event);
+    } else {
+        _trace[_traceHead] = event;
+        _traceHead = (_traceHead + 1) % kMaxTraceEvents;
+    }
+}
+
+void GameProfiler::onFrameEnd() {
+    auto now = Clock::now();
+    _current.frame = _frameIndex++;
+    _current.frameMs = std::chrono::duration_cast<std::chrono::microseconds>(now - _lastFrameEnd).count() / 1000.0f;
+    _lastFrameEnd = now;
+    if (_current.frameMs > kFrameBudgetMs) {
+        _overBudgetFrames++;
+    }
+
+    _history[_historyHead] = _current;
+    _historyHead = (_historyHead + 1) % _history.size();
+    _current = FrameSample();
+
+    if (_overlayVisible) {
+        _overlayTimer += Director::getInstance()->getDeltaTime();
+        if (_overlayTimer >= kOverlayRefreshInterval) {
+            _overlayTimer = 0.0f;
+            refreshOverlay();
+        }
+    }
+}
+
+float GameProfiler::getAverageZoneMs(ProfileZone zone) const {
+    int frames = std::min<int>(kAverageFrames, std::min<uint32_t>(_frameIndex, kHistoryFrames));
+    if (frames == 0) return 0.0f;
+    float total = 0.0f;
+    for (int i = 1; i <= frames; ++i) {
+        total += _history[(_historyHead + kHistoryFrames - i) % kHistoryFrames].zoneMs[static_cast<int>(zone)];
+    }
+    return total / frames;
+}
+
+float GameProfiler::getAverageFrameMs() const {
+    int frames = std::min<int>(kAverageFrames, std::min<uint32_t>(_frameIndex, kHistoryFrames));
+    if (frames == 0) return 0.0f;
+    float total = 0.0f;
+    for (int i = 1; i <= frames; ++i) {
+        total += _history[(_historyHead + kHistoryFrames - i) % kHistoryFrames].frameMs;
+    }
+    return total / frames;
+}
+
+void GameProfiler::refreshOverlay() {
+    if (!_overlay) return;
+    int frames = std::min<int>(kAverageFrames, std::min<uint32_t>(_frameIndex, kHistoryFrames));
+
+    std::string text = StringUtils::format("frame %.2f ms  over budget %d\n", getAverageFrameMs(), _overBudgetFrames);
+    for (int zone = 0; zone < kZoneCount; ++zone) {
+        uint64_t allocations = 0;
+        for (int i = 1; i <= frames; ++i) {
+            allocations += _history[(_historyHead + kHistoryFrames - i) % kHistoryFrames].zoneAllocations[zone];
+        }
+        text += StringUtils::format("%-13s %6.2f ms  %5d alloc\n", kZoneNames[zone],
+                                    getAverageZoneMs(static_cast<ProfileZone>(zone)),
+                                    frames ? static_cast<int>(allocations / frames) : 0);
+    }
+    _overlay->setString(text);
+}
+
+int64_t GameProfiler::toMicroseconds(Clock::time_point t) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(t - _startTime).count();
+}
+
+std::string GameProfiler::exportChromeTrace(const std::string& fileName) const {
+    if (_trace.empty()) {
+        CCLOG("GameProfiler: no trace events recorded, %s not written", fileName.c_str());
+        return "";
+    }
+
+    // Chrome trace event 格式：完整事件 ph=X，时间单位为微秒
+    std::ostringstream out;
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (size_t i = 0; i < _trace.size(); ++i) {
+        const auto& event = _trace[(_traceHead + i) % _trace.size()];
+        if (!first) out << ",";
+        first = false;
+        out << "{\"name\":\"" << kZoneNames[static_cast<int>(event.zone)]
+            << "\",\"cat\":\"game\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << event.beginUs
+            << ",\"dur\":" << event.durationUs << "}";
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}";
+
+    std::string fullPath = FileUtils::getInstance()->getWritablePath() + fileName;
+    if (!FileUtils::getInstance()->writeStringToFile(out.str(), fullPath)) {
+        CCLOG("GameProfiler: failed to write %s", fullPath.c_str());
+        return "";
+    }
+    CCLOG("GameProfiler: trace exported to %s (%d events)", fullPath.c_str(), static_cast<int>(_trace.size()));
+    return fullPath;
+}
+
+std::string GameProfiler::exportCsv(const std::string& fileName) const {
+    if (_frameIndex == 0) {
+        CCLOG("GameProfiler: no frames recorded, %s not written", fileName.c_str());
+        return "";
+    }
+
+    std::ostringstream out;
+    out << "frame,frame_ms";
+    for (auto name : kZoneNames) out << "," << name << "_ms";
+    for (auto name : kZoneNames) out << "," << name << "_alloc";
+    out << "\n";
+
+    int frames = static_cast<int>(std::min<uint32_t>(_frameIndex, kHistoryFrames));
+    for (int i = frames; i >= 1; --i) {
+        const auto& sample = _history[(_historyHead + kHistoryFrames - i) % kHistoryFrames];
+        out << sample.frame << "," << sample.frameMs;
+        for (float ms : sample.zoneMs) out << "," << ms;
+        for (uint32_t allocations : sample.zoneAllocations) out << "," << allocations;
+        out << "\n";
+    }
+
+    std::string fullPath = FileUtils::getInstance()->getWritablePath() + fileName;
+    if (!FileUtils::getInstance()->writeStringToFile(out.str(), fullPath)) {
+        CCLOG("GameProfiler: failed to write %s", fullPath.c_str());
+        return "";
+    }
+    CCLOG("GameProfiler: %d frames exported to %s", frames, fullPath.c_str());
+    return fullPath;
+}
@@ -0,0 +1,178 @@
+#pragma once
+#ifndef __GAME_PROFILER_H__
+#define __GAME_PROFILER_H__
+
+#include "cocos2d.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 默认只在调试构建中替换全局 operator new（分配计数与按子系统的堆字节统计），
+// 可在编译选项里显式定义 TJ_PROFILE_ALLOCATIONS=0/1
+#ifndef TJ_PROFILE_ALLOCATIONS
+#if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
+#define TJ_PROFILE_ALLOCATIONS 1
+#else
+#define TJ_PROFILE_ALLOCATIONS 0
+#endif
+#endif
+
+// 性能分析子系统（顺序即浮层与 CSV 中的列顺序）
+enum class ProfileZone {
+    Scheduler,      // Scheduler::update（全部 update 与 Action）
+    CombatUpdate,   // CombatManager::update
+    PathFinding,    // A* 寻路
+    Targeting,      // 士兵/防御建筑索敌
+    UIUpdate,       // UIManager::update
+    SaveIO,         // 存档读写
+    Render,         // 场景遍历与 Renderer::render（BEFORE_DRAW 到 AFTER_DRAW，含通知节点与统计信息）
+    AssetLoad,      // 动画/纹理等资源加载
+    SceneBuild,     // 各场景的 createScene（地图、UI、对象池预热）
+    Count
+};
+
+// 帧耗时与子系统分析器：
+// - PROFILE_SCOPE 记录作用域耗时与其间的内存分配次数（嵌套作用域的时间为包含关系）
+// - F3 切换浮层（显示各子系统最近 60 帧平均 ms 与分配次数），F4 导出 Chrome trace 与 CSV
+//   （尚未采集时 F4 先开始采集，再按一次才导出）
+// - 导出的 trace 可直接拖入 chrome://tracing 或 Perfetto 查看
+class GameProfiler {
+public:
+    static GameProfiler* getInstance();
+
+    // 注册 Director 事件与快捷键，在 AppDelegate 创建 Director 之后调用一次
+    void install();
+
+    // 关闭时 PROFILE_SCOPE 只有一次分支判断的开销
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    void setOverlayVisible(bool visible);
+    void toggleOverlay() { setOverlayVisible(!_overlayVisible); }
+
+    // 是否已记录过帧或 trace 事件
+    bool hasCapture() const { return _frameIndex > 0 || !_trace.empty(); }
+
+    // 导出到可写目录，返回完整路径（没有数据或写入失败返回空串）
+    std::string exportChromeTrace(const std::string& fileName = "profile_trace.json") const;
+    std::string exportCsv(const std::string& fileName = "profile_frames.csv") const;
+
+    // 最近 60 帧的平均值
+    float getAverageZoneMs(ProfileZone zone) const;
+    float getAverageFrameMs() const;
+    // 启动以来超过 16.6ms 预算的帧数
+    int getOverBudgetFrames() const { return _overBudgetFrames; }
+
+    // 进程内 operator new 调用总数（未开启 TJ_PROFILE_ALLOCATIONS 时恒为 0）
+    static uint64_t getAllocationCount();
+
+    // 按子系统统计的存活堆字节数：分配发生在哪个 PROFILE_SCOPE（或 Scheduler/Render 阶段）内就记在哪个子系统，
+    // 不在任何作用域内的记在 ProfileZone::Count（其他）。未开启 TJ_PROFILE_ALLOCATIONS 时恒为 0
+    static int64_t getLiveHeapBytes(ProfileZone zone);
+    // ProfileZone::Count 返回 "Other"
+    static const char* getZoneName(ProfileZone zone);
+
+    // 当前线程新分配的内存记到哪个子系统，返回之前的子系统
+    static ProfileZone exchangeHeapZone(ProfileZone zone) {
+        ProfileZone previous = _heapZone;
+        _heapZone = zone;
+        return previous;
+    }
+    static ProfileZone getHeapZone() { return _heapZone; }
+
+    // 供 ProfileScope 使用
+    using Clock = std::chrono::steady_clock;
+    void record(ProfileZone zone, Clock::time_point begin, Clock::time_point end, uint64_t allocations);
+
+private:
+    GameProfiler();
+
+    static constexpr int kZoneCount = static_cast<int>(ProfileZone::Count);
+    static constexpr int kHistoryFrames = 600;   // CSV 保留的帧数
+    static constexpr int kAverageFrames = 60;
+    static constexpr size_t kMaxTraceEvents = 1 << 16;
+
+    struct TraceEvent {
+        ProfileZone zone;
+        int64_t beginUs;
+        int64_t durationUs;
+    };
+
+    struct FrameSample {
+        uint32_t frame = 0;
+        float frameMs = 0.0f;
+        float zoneMs[kZoneCount] = {};
+        uint32_t zoneAllocations[kZoneCount] = {};
+    };
+
+    void onFrameEnd();
+    void refreshOverlay();
+    int64_t toMicroseconds(Clock::time_point t) const;
+
+    static GameProfiler* _instance;
+    static thread_local ProfileZone _heapZone;
+    bool _installed = false;
+    bool _enabled = false;
+    bool _overlayVisible = false;
+
+    Clock::time_point _startTime;
+    Clock::time_point _lastFrameEnd;
+    Clock::time_point _updateBegin;
+    Clock::time_point _renderBegin;
+    uint64_t _updateAllocations = 0;
+    uint64_t _renderAllocations = 0;
+
+    FrameSample _current;
+    std::vector<FrameSample> _history;   // 环形缓冲
+    size_t _historyHead = 0;
+    uint32_t _frameIndex = 0;
+    int _overBudgetFrames = 0;
+
+    std::vector<TraceEvent> _trace;      // 环形缓冲
+    size_t _traceHead = 0;
+
+    cocos2d::Label* _overlay = nullptr;
+    float _overlayTimer = 0.0f;
+};
+
+// RAII 计时器：构造时记录开始，析构时提交给 GameProfiler
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileZone zone)
+        : _zone(zone), _active(GameProfiler::getInstance()->isEnabled()) {
+#if TJ_PROFILE_ALLOCATIONS
+        _previousHeapZone = GameProfiler::exchangeHeapZone(zone);
+#endif
+        if (_active) {
+            _allocations = GameProfiler::getAllocationCount();
+            _begin = GameProfiler::Clock::now();
+        }
+    }
+    ~ProfileScope() {
+#if TJ_PROFILE_ALLOCATIONS
+        GameProfiler::exchangeHeapZone(_previousHeapZone);
+#endif
+        if (_active) {
+            GameProfiler::getInstance()->record(_zone, _begin, GameProfiler::Clock::now(),
+                                                GameProfiler::getAllocationCount() - _allocations);
+        }
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileZone _zone;
+    bool _active;
+    uint64_t _allocations = 0;
+    GameProfiler::Clock::time_point _begin;
+#if TJ_PROFILE_ALLOCATIONS
+    ProfileZone _previousHeapZone = ProfileZone::Count;
+#endif
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(zone) ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(zone)
+
+#endif // __GAME_PROFILER_H__
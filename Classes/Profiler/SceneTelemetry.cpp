@@ -0,0 +1,207 @@
+#include "SceneTelemetry.h"
+#include "GameProfiler.h"
+#include "ui/CocosGUI.h"
+#include <cstdio>
+#include <sstream>
+
+USING_NS_CC;
+
+namespace {
+// TextureCache 只通过 getCachedTextureInfo 公开缓存内容，每张纹理一行：
+// "<key>" rc=<引用数> id=<指针> <宽> x <高> @ <bpp> bpp => <KB> KB
+// 取出键与宽、高、bpp，字节数按同样的公式重新计算（KB 列已被截断）
+bool parseTextureInfoLine(const std::string& line, std::string& key, int64_t& bytes) {
+    if (line.size() < 2 || line[0] != '"') return false;
+    const size_t keyEnd = line.rfind("\" rc=");
+    if (keyEnd == std::string::npos || keyEnd == 0) return false;
+    long width = 0, height = 0, bpp = 0;
+    if (std::sscanf(line.c_str() + keyEnd, "\" rc=%*u id=%*s %ld x %ld @ %ld bpp", &width, &height, &bpp) != 3) {
+        return false;
+    }
+    key = line.substr(1, keyEnd - 1);
+    bytes = static_cast<int64_t>(width) * height * bpp / 8;
+    return true;
+}
+
+// 差异日志每次最多列出的项数
+const size_t kMaxLoggedDeltas = 24;
+}
+
+SceneTelemetry* SceneTelemetry::_instance = nullptr;
+
+SceneTelemetry* SceneTelemetry::getInstance() {
+    if (!_instance) {
+        _instance = new SceneTelemetry();
+    }
+    return _instance;
+}
+
+void SceneTelemetry::install() {
+    if (_installed) return;
+    _installed = true;
+
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->addCustomEventListener(Director::EVENT_AFTER_SET_NEXT_SCENE, [this](EventCustom*) {
+        onSceneChanged();
+    });
+
+    // 快捷键：F5 导出
+    auto keyListener = EventListenerKeyboard::create();
+    keyListener->onKeyReleased = [this](EventKeyboard::KeyCode code, Event*) {
+        if (code == EventKeyboard::KeyCode::KEY_F5) {
+            exportJson();
+        }
+    };
+    dispatcher->addEventListenerWithFixedPriority(keyListener, 1);
+}
+
+void SceneTelemetry::countNodes(Node* node, TelemetrySnapshot& snapshot) {
+    auto& values = snapshot.values;
+    values["nodes/Node"]++;
+    if (dynamic_cast<Sprite*>(node)) values["nodes/Sprite"]++;
+    if (dynamic_cast<ui::Scale9Sprite*>(node)) values["nodes/Scale9Sprite"]++;
+    if (dynamic_cast<Label*>(node)) values["nodes/Label"]++;
+    for (auto child : node->getChildren()) {
+        countNodes(child, snapshot);
+    }
+}
+
+TelemetrySnapshot SceneTelemetry::capture(const std::string& label) const {
+    TelemetrySnapshot snapshot;
+    snapshot.label = label;
+    snapshot.sequence = _sequence;
+    auto& values = snapshot.values;
+
+    auto director = Director::getInstance();
+    values["nodes/Node"] = 0;
+    values["nodes/Sprite"] = 0;
+    values["nodes/Scale9Sprite"] = 0;
+    values["nodes/Label"] = 0;
+    if (auto scene = director->getRunningScene()) {
+        countNodes(scene, snapshot);
+    }
+    values["actions/running"] = static_cast<int64_t>(director->getActionManager()->getNumberOfRunningActions());
+
+    int64_t textureBytes = 0;
+    int64_t textureCount = 0;
+    std::istringstream info(director->getTextureCache()->getCachedTextureInfo());
+    std::string line, key;
+    while (std::getline(info, line)) {
+        int64_t bytes = 0;
+        if (!parseTextureInfoLine(line, key, bytes)) continue;  // 末尾的汇总行
+        values["textures/" + key] = bytes;
+        textureBytes += bytes;
+        ++textureCount;
+    }
+    values["textures/count"] = textureCount;
+    values["textures/bytes"] = textureBytes;
+
+    int64_t heapBytes = 0;
+    for (int zone = 0; zone <= static_cast<int>(ProfileZone::Count); ++zone) {
+        int64_t bytes = GameProfiler::getLiveHeapBytes(static_cast<ProfileZone>(zone));
+        values[std::string("heap/") + GameProfiler::getZoneName(static_cast<ProfileZone>(zone))] = bytes;
+        heapBytes += bytes;
+    }
+    values["heap/total"] = heapBytes;
+    return snapshot;
+}
+
+std::vector<TelemetryDelta> SceneTelemetry::diff(const TelemetrySnapshot& before, const TelemetrySnapshot& after) {
+    // 两侧都按键排序，归并一遍即可
+    std::vector<TelemetryDelta> deltas;
+    auto a = before.values.begin();
+    auto b = after.values.begin();
+    while (a != before.values.end() || b != after.values.end()) {
+        TelemetryDelta delta;
+        if (b == after.values.end() || (a != before.values.end() && a->first < b->first)) {
+            delta.key = a->first;
+            delta.before = a->second;
+            ++a;
+        } else if (a == before.values.end() || b->first < a->first) {
+            delta.key = b->first;
+            delta.after = b->second;
+            ++b;
+        } else {
+            delta.key = a->first;
+            delta.before = a->second;
+            delta.after = b->second;
+            ++a;
+            ++b;
+        }
+        if (delta.before != delta.after) {
+            deltas.push_back(std::move(delta));
+        }
+    }
+    return deltas;
+}
+
+void SceneTelemetry::onSceneChanged() {
+    auto scene = Director::getInstance()->getRunningScene();
+    if (!scene || dynamic_cast<TransitionScene*>(scene)) return;
+
+    const std::string label = scene->getName().empty() ? "Scene" : scene->getName();
+    TelemetrySnapshot snapshot = capture(label);
+    ++_sequence;
+
+    const auto& values = snapshot.values;
+    (void)values;  // 发布构建中 CCLOG 为空
+    CCLOG("SceneTelemetry #%u %s: %lld nodes, %lld actions, %lld textures (%.2f MB), heap %.2f MB",
+          snapshot.sequence, label.c_str(),
+          static_cast<long long>(values.at("nodes/Node")), static_cast<long long>(values.at("actions/running")),
+          static_cast<long long>(values.at("textures/count")), values.at("textures/bytes") / (1024.0 * 1024.0),
+          values.at("heap/total") / (1024.0 * 1024.0));
+
+    // 与上一次进入同一场景时比较
+    for (auto it = _snapshots.rbegin(); it != _snapshots.rend(); ++it) {
+        if (it->label != label) continue;
+        auto deltas = diff(*it, snapshot);
+        CCLOG("SceneTelemetry %s vs #%u: %d changed", label.c_str(), it->sequence, static_cast<int>(deltas.size()));
+        for (size_t i = 0; i < deltas.size() && i < kMaxLoggedDeltas; ++i) {
+            CCLOG("  %s: %lld -> %lld (%+lld)", deltas[i].key.c_str(), static_cast<long long>(deltas[i].before),
+                  static_cast<long long>(deltas[i].after),
+                  static_cast<long long>(deltas[i].after - deltas[i].before));
+        }
+        break;
+    }
+
+    if (_snapshots.size() >= kMaxSnapshots) {
+        _snapshots.erase(_snapshots.begin());
+    }
+    _snapshots.push_back(std::move(snapshot));
+}
+
+std::string SceneTelemetry::exportJson(const std::string& fileName) const {
+    // 键来自纹理路径等，按 JSON 字符串转义
+    auto quote = [](const std::string& text) {
+        std::string quoted = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') quoted += '\\';
+            quoted += c;
+        }
+        return quoted + "\"";
+    };
+
+    std::ostringstream out;
+    out << "{\"snapshots\":[";
+    for (size_t i = 0; i < _snapshots.size(); ++i) {
+        const auto& snapshot = _snapshots[i];
+        if (i > 0) out << ",";
+        out << "{\"label\":" << quote(snapshot.label) << ",\"sequence\":" << snapshot.sequence << ",\"values\":{";
+        bool first = true;
+        for (const auto& entry : snapshot.values) {
+            if (!first) out << ",";
+            first = false;
+            out << quote(entry.first) << ":" << entry.second;
+        }
+        out << "}}";
+    }
+    out << "]}";
+
+    std::string fullPath = FileUtils::getInstance()->getWritablePath() + fileName;
+    if (!FileUtils::getInstance()->writeStringToFile(out.str(), fullPath)) {
+        CCLOG("SceneTelemetry: failed to write %s", fullPath.c_str());
+        return "";
+    }
+    CCLOG("SceneTelemetry: %d snapshots exported to %s", static_cast<int>(_snapshots.size()), fullPath.c_str());
+    return fullPath;
+}
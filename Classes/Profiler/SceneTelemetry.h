@@ -0,0 +1,63 @@
+#pragma once
+#ifndef __SCENE_TELEMETRY_H__
+#define __SCENE_TELEMETRY_H__
+
+#include "cocos2d.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 一次快照：一组 "分组/名称" → 数值，两次快照可以逐项相减
+//   nodes/<类名>      运行场景节点树中的节点数（Node 为总数，Sprite 含 Scale9Sprite 等子类）
+//   actions/running   ActionManager 中仍在运行的 Action（包括已脱离场景树的节点上的）
+//   textures/<key>    TextureCache 中每张纹理（图集）占用的字节数；textures/count、textures/bytes 为合计
+//   heap/<子系统>     GameProfiler 统计的存活堆字节数（需 TJ_PROFILE_ALLOCATIONS）；heap/total 为合计
+struct TelemetrySnapshot {
+    std::string label;                  // 场景名
+    uint32_t sequence = 0;              // 启动以来第几次快照
+    std::map<std::string, int64_t> values;
+};
+
+struct TelemetryDelta {
+    std::string key;
+    int64_t before = 0;
+    int64_t after = 0;
+};
+
+// 场景资源遥测：
+// - 每次切换到新场景（过渡场景除外）后记录一次快照，并输出与上一次同名场景快照的差异：
+//   同一场景来回切换后节点、Action、纹理或堆字节持续增长即说明有对象没有释放
+// - F5 导出全部快照到可写目录
+class SceneTelemetry {
+public:
+    static SceneTelemetry* getInstance();
+
+    // 注册 Director 事件与快捷键，在 AppDelegate 创建 Director 之后调用一次
+    void install();
+
+    // 统计当前运行的场景与全局缓存
+    TelemetrySnapshot capture(const std::string& label) const;
+    // 只列出数值不同的项，任一侧缺失的项按 0 计
+    static std::vector<TelemetryDelta> diff(const TelemetrySnapshot& before, const TelemetrySnapshot& after);
+
+    const std::vector<TelemetrySnapshot>& getSnapshots() const { return _snapshots; }
+
+    // 导出到可写目录，返回完整路径（失败返回空串）
+    std::string exportJson(const std::string& fileName = "scene_telemetry.json") const;
+
+private:
+    SceneTelemetry() = default;
+
+    static constexpr size_t kMaxSnapshots = 64;
+
+    void onSceneChanged();
+    static void countNodes(cocos2d::Node* node, TelemetrySnapshot& snapshot);
+
+    static SceneTelemetry* _instance;
+    bool _installed = false;
+    uint32_t _sequence = 0;
+    std::vector<TelemetrySnapshot> _snapshots;   // 最近 kMaxSnapshots 次
+};
+
+#endif // __SCENE_TELEMETRY_H__
@@ -0,0 +1,207 @@
+#include "StructuredLog.h"
+#include "cocos2d.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+USING_NS_CC;
+
+static const char* kCategoryNames[] = { "combat", "targeting", "path", "damage" };
+static_assert(sizeof(kCategoryNames) / sizeof(kCategoryNames[0]) == static_cast<size_t>(LogCategory::Count),
+              "kCategoryNames must match LogCategory");
+
+static const char* kLevelNames[] = { "T", "D", "I", "W", "E" };
+
+StructuredLog* StructuredLog::_instance = nullptr;
+
+StructuredLog* StructuredLog::getInstance() {
+    if (!_instance) {
+        _instance = new StructuredLog();
+    }
+    return _instance;
+}
+
+StructuredLog::StructuredLog()
+    : _mask((1u << static_cast<int>(LogCategory::Count)) - 1),
+      _slots(new Slot[kCapacity]) {
+    for (size_t i = 0; i < kCapacity; ++i) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _startUs = nowUs();
+}
+
+void StructuredLog::install() {
+    if (_installed) return;
+    _installed = true;
+    // 每帧 update 之后输出一次：工作线程写入的记录也在这里由主线程格式化
+    Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE,
+                                                                          [this](EventCustom*) { drain(); });
+}
+
+void StructuredLog::configureFromEnvironment() {
+    const char* categories = std::getenv("TJ_LOG_CATEGORIES");
+    if (!categories) return;
+    uint32_t mask = 0;
+    std::string list = categories;
+    size_t begin = 0;
+    while (begin <= list.size()) {
+        size_t end = list.find(',', begin);
+        if (end == std::string::npos) end = list.size();
+        const std::string name = list.substr(begin, end - begin);
+        if (name == "all") mask = (1u << static_cast<int>(LogCategory::Count)) - 1;
+        for (int c = 0; c < static_cast<int>(LogCategory::Count); ++c) {
+            if (name == kCategoryNames[c]) mask |= 1u << c;
+        }
+        begin = end + 1;
+    }
+    setMask(mask);
+}
+
+void StructuredLog::setCategoryEnabled(LogCategory category, bool enabled) {
+    const uint32_t bit = 1u << static_cast<int>(category);
+    if (enabled) _mask.fetch_or(bit, std::memory_order_relaxed);
+    else _mask.fetch_and(~bit, std::memory_order_relaxed);
+}
+
+const char* StructuredLog::categoryName(LogCategory category) {
+    const int index = static_cast<int>(category);
+    return index < static_cast<int>(LogCategory::Count) ? kCategoryNames[index] : "?";
+}
+
+const char* StructuredLog::levelName(LogLevel level) {
+    const int index = static_cast<int>(level);
+    return index <= static_cast<int>(LogLevel::Error) ? kLevelNames[index] : "?";
+}
+
+int64_t StructuredLog::nowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void StructuredLog::capture(LogRecord& record, const char* value) {
+    record.types[record.argCount] = LogRecord::ArgType::Text;
+    // 最后一个字节始终为 '\0'：缓冲已满时参数指向它，按空串输出
+    constexpr int kLast = LogRecord::kTextBytes - 1;
+    if (record.textUsed >= kLast) {
+        record.text[kLast] = '\0';
+        record.args[record.argCount++].textOffset = kLast;
+        return;
+    }
+    record.args[record.argCount++].textOffset = record.textUsed;
+    // 放不下时截断，结尾的 '\0' 最多落在最后一个字节上
+    const size_t room = kLast - record.textUsed;
+    const size_t length = value ? std::min(std::strlen(value), room) : 0;
+    if (length) std::memcpy(record.text + record.textUsed, value, length);
+    record.text[record.textUsed + length] = '\0';
+    record.textUsed = static_cast<uint8_t>(record.textUsed + length + 1);
+}
+
+void StructuredLog::push(LogRecord& record) {
+    record.timeUs = nowUs() - _startUs;
+    // 有界多生产者队列：每个槽位的序号表示它当前可写还是可读
+    size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &_slots[pos & (kCapacity - 1)];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->record = record;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+size_t StructuredLog::drain() {
+    size_t count = 0;
+    char prefix[48];
+    for (;;) {
+        Slot& slot = _slots[_dequeuePos & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != _dequeuePos + 1) break;
+        const LogRecord record = slot.record;
+        slot.sequence.store(_dequeuePos + kCapacity, std::memory_order_release);
+        ++_dequeuePos;
+
+        snprintf(prefix, sizeof(prefix), "[%s %s %.3f] ", levelName(record.level), categoryName(record.category),
+                 record.timeUs / 1000000.0);
+        const std::string line = prefix + format(record);
+        if (_sink) _sink(line.c_str());
+        else cocos2d::log("%s", line.c_str());
+        ++count;
+    }
+    return count;
+}
+
+std::string StructuredLog::format(const LogRecord& record) {
+    std::string out;
+    if (!record.format) return out;
+    char spec[16];
+    char buffer[64];
+    int arg = 0;
+    for (const char* p = record.format; *p; ++p) {
+        if (*p != '%') {
+            out += *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            out += '%';
+            ++p;
+            continue;
+        }
+        // 拷贝标志、宽度、精度，去掉长度修饰符，按实际参数类型重新补上
+        size_t length = 0;
+        spec[length++] = '%';
+        const char* q = p + 1;
+        while (*q && std::strchr("-+ #0123456789.", *q) && length < sizeof(spec) - 4) spec[length++] = *q++;
+        while (*q && std::strchr("hlLqjzt", *q)) ++q;
+        const char conversion = *q;
+        if (!conversion) break;
+        p = q;
+        if (arg >= record.argCount) {
+            out += "<?>";
+            continue;
+        }
+        const auto type = record.types[arg];
+        const auto value = record.args[arg++];
+        if (conversion == 's') {
+            spec[length++] = 's';
+            spec[length] = '\0';
+            if (type == LogRecord::ArgType::Text) {
+                snprintf(buffer, sizeof(buffer), spec, record.text + value.textOffset);
+            } else if (type == LogRecord::ArgType::Int) {
+                snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value.i));
+            } else {
+                snprintf(buffer, sizeof(buffer), "%g", value.d);
+            }
+        } else if (std::strchr("fFeEgGaA", conversion)) {
+            spec[length++] = conversion;
+            spec[length] = '\0';
+            const double d = type == LogRecord::ArgType::Double ? value.d
+                           : type == LogRecord::ArgType::Int ? static_cast<double>(value.i) : 0.0;
+            snprintf(buffer, sizeof(buffer), spec, d);
+        } else if (conversion == 'c') {
+            spec[length++] = 'c';
+            spec[length] = '\0';
+            snprintf(buffer, sizeof(buffer), spec, type == LogRecord::ArgType::Int ? static_cast<int>(value.i) : '?');
+        } else {
+            // d i u x X o 以及不认识的说明符：一律按 64 位整数输出
+            spec[length++] = 'l';
+            spec[length++] = 'l';
+            spec[length++] = std::strchr("diuxXo", conversion) ? conversion : 'd';
+            spec[length] = '\0';
+            const long long i = type == LogRecord::ArgType::Int ? static_cast<long long>(value.i)
+                              : type == LogRecord::ArgType::Double ? static_cast<long long>(value.d) : 0;
+            snprintf(buffer, sizeof(buffer), spec, i);
+        }
+        out += buffer;
+    }
+    return out;
+}
@@ -0,0 +1,161 @@
+#pragma once
+#ifndef __STRUCTURED_LOG_H__
+#define __STRUCTURED_LOG_H__
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+// 日志级别：低于编译期级别 TJ_LOG_LEVEL 的 TJ_LOG_* 调用连同参数求值一起被编译器删除
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+// 日志类别：每个类别一位，运行期按掩码开关
+enum class LogCategory : uint8_t {
+    Combat,     // 战斗流程（开始/结束、建筑摧毁、士兵阵亡）
+    Targeting,  // 士兵/防御建筑索敌
+    Path,       // 寻路结果与路径修正
+    Damage,     // 每次攻击的伤害结算
+    Count
+};
+
+// 默认：调试构建保留 Debug 及以上，发布构建只保留 Warning 及以上
+#ifndef TJ_LOG_LEVEL
+#if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
+#define TJ_LOG_LEVEL 1
+#else
+#define TJ_LOG_LEVEL 3
+#endif
+#endif
+
+// 一条二进制日志：只保存格式串指针与原始参数，格式化推迟到 drain 时在主线程进行
+struct LogRecord {
+    static constexpr int kMaxArgs = 8;
+    static constexpr int kTextBytes = 48;   // 字符串参数按 '\0' 分隔拷贝到这里，超出部分截断，最后一字节保留为 '\0'
+
+    enum class ArgType : uint8_t { Int, Double, Text };
+    union ArgValue {
+        int64_t i;
+        double d;
+        uint32_t textOffset;
+    };
+
+    int64_t timeUs = 0;                     // 进程启动以来的微秒数
+    const char* format = nullptr;           // 必须是字符串字面量
+    LogCategory category = LogCategory::Combat;
+    LogLevel level = LogLevel::Debug;
+    uint8_t argCount = 0;
+    uint8_t textUsed = 0;
+    ArgType types[kMaxArgs];
+    ArgValue args[kMaxArgs];
+    char text[kTextBytes];
+};
+
+// 结构化日志：
+// - 写入方（主线程或 JobSystem 工作线程）只把参数拷进无锁环形缓冲，不做字符串格式化，不分配内存
+// - 主线程每帧 drain 一次，按 printf 格式串格式化后交给输出函数（默认 cocos2d::log）
+// - 缓冲写满时丢弃新记录并计数，不阻塞写入方
+class StructuredLog {
+public:
+    static StructuredLog* getInstance();
+
+    // 注册每帧 drain，在 AppDelegate 创建 Director 之后、启动工作线程之前调用一次
+    void install();
+    // TJ_LOG_CATEGORIES=combat,path 只打开列出的类别（all 为全部，none 为全部关闭）
+    void configureFromEnvironment();
+
+    bool isEnabled(LogCategory category) const {
+        return (_mask.load(std::memory_order_relaxed) >> static_cast<int>(category)) & 1u;
+    }
+    void setCategoryEnabled(LogCategory category, bool enabled);
+    void setMask(uint32_t mask) { _mask.store(mask, std::memory_order_relaxed); }
+    uint32_t getMask() const { return _mask.load(std::memory_order_relaxed); }
+
+    template <typename... Args>
+    void write(LogCategory category, LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::kMaxArgs, "too many log arguments");
+        LogRecord record;
+        record.category = category;
+        record.level = level;
+        record.format = format;
+        int expand[] = { 0, (capture(record, args), 0)... };
+        (void)expand;
+        push(record);
+    }
+
+    // 格式化并输出积压的记录（只能在一个线程调用），返回输出条数
+    size_t drain();
+    // 替换输出函数；传空恢复默认
+    void setSink(std::function<void(const char* line)> sink) { _sink = std::move(sink); }
+    uint64_t getDroppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+
+    static const char* categoryName(LogCategory category);
+    static const char* levelName(LogLevel level);
+    // 按记录中的参数展开 printf 格式串（整数、浮点、字符串各自匹配 d/f/s 类说明符）
+    static std::string format(const LogRecord& record);
+
+private:
+    StructuredLog();
+
+    static constexpr size_t kCapacity = 4096;   // 2 的幂
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    capture(LogRecord& record, const T& value) {
+        record.types[record.argCount] = LogRecord::ArgType::Int;
+        record.args[record.argCount++].i = static_cast<int64_t>(value);
+    }
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    capture(LogRecord& record, const T& value) {
+        record.types[record.argCount] = LogRecord::ArgType::Double;
+        record.args[record.argCount++].d = static_cast<double>(value);
+    }
+    static void capture(LogRecord& record, const char* value);
+    static void capture(LogRecord& record, const std::string& value) { capture(record, value.c_str()); }
+    template <size_t N>
+    static void capture(LogRecord& record, const char (&value)[N]) { capture(record, static_cast<const char*>(value)); }
+
+    void push(LogRecord& record);
+    int64_t nowUs() const;
+
+    static StructuredLog* _instance;
+    bool _installed = false;
+    std::atomic<uint32_t> _mask;
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<size_t> _enqueuePos{0};
+    size_t _dequeuePos = 0;
+    std::unique_ptr<Slot[]> _slots;
+    std::function<void(const char* line)> _sink;
+    int64_t _startUs = 0;
+};
+
+// 编译期级别不够时整条语句（包括参数求值）被删除；运行期只多一次类别掩码判断
+#define TJ_LOG(category, level, format, ...)                                                  \
+    do {                                                                                      \
+        if (static_cast<int>(level) >= TJ_LOG_LEVEL &&                                        \
+            StructuredLog::getInstance()->isEnabled(category)) {                             \
+            StructuredLog::getInstance()->write(category, level, format, ##__VA_ARGS__);     \
+        }                                                                                     \
+    } while (0)
+
+#define TJ_LOG_TRACE(category, format, ...) TJ_LOG(category, LogLevel::Trace, format, ##__VA_ARGS__)
+#define TJ_LOG_DEBUG(category, format, ...) TJ_LOG(category, LogLevel::Debug, format, ##__VA_ARGS__)
+#define TJ_LOG_INFO(category, format, ...) TJ_LOG(category, LogLevel::Info, format, ##__VA_ARGS__)
+#define TJ_LOG_WARNING(category, format, ...) TJ_LOG(category, LogLevel::Warning, format, ##__VA_ARGS__)
+#define TJ_LOG_ERROR(category, format, ...) TJ_LOG(category, LogLevel::Error, format, ##__VA_ARGS__)
+
+#endif // __STRUCTURED_LOG_H__
@@ -3,13 +3,22 @@
 #include "MapManager/MapManager.h"
 #include "UIManager/UIManager.h"
 #include "Combat/Combat.h"
+#include "Combat/CombatEntityPool.h"
 #include "AudioManager/AudioManager.h"
+#include "Profiler/GameProfiler.h"
 
 using namespace cocos2d;
 
-ReplayScene* ReplayScene::createScene(int levelId, const std::vector<ReplayStep>& steps) {
+// 回放每隔这么多 tick 保存一份快照，左方向键回退约 kRewindTicks 个 tick（60 帧时约 5 秒）
+static const int kReplaySnapshotInterval = 150;
+static const int kRewindTicks = 300;
+
+ReplayScene* ReplayScene::createScene(int levelId, const std::vector<ReplayStep>& steps,
+                                      const CombatChecksumLog& checksums) {
+    PROFILE_SCOPE(ProfileZone::SceneBuild);
     auto scene = ReplayScene::create();
     if (!scene) return nullptr;
+    scene->setName("ReplayScene");
 
     // 1. 加载相同的战斗地图
     auto map = MapManager::create(30, 30, -1, TerrainType::Battle);
@@ -19,37 +28,69 @@ ReplayScene* ReplayScene::createScene(int levelId, const std::vector<ReplayStep>
         scene->addChild(map, 0);
     }
 
-    // 2. 初始化战斗管理器
+    // 2. 按回放步骤中各兵种的数量预热士兵对象池
+    for (const auto& tmpl : TownHall::GetInstance()->GetSoldierCategory()) {
+        int count = static_cast<int>(std::count_if(steps.begin(), steps.end(), [&tmpl](const ReplayStep& step) {
+            return step.troopName == tmpl.name_;
+        }));
+        CombatEntityPool::GetInstance()->PrewarmSoldiers(tmpl, count);
+    }
+
+    // 3. 初始化战斗管理器
     auto combatMgr = CombatManager::InitializeInstance(map);
+    combatMgr->SetExpectedChecksums(checksums);
+    // 结束后保留场上建筑与开战快照，"Replay" 原地重来
+    combatMgr->SetKeepAfterEnd(true);
+    combatMgr->SetSnapshotInterval(kReplaySnapshotInterval);
     scene->addChild(combatMgr);
 
-    // 3. 配置 UI 进入回放模式
+    // 4. 配置 UI 进入回放模式
     auto ui = UIManager::getInstance();
     if (ui->init(scene)) {
-        ui->enterReplayMode(map, steps);
+        ui->enterReplayMode(map, steps, checksums);
         AudioManager::getInstance()->playMusic(true);
         
-        // 4. 启动战斗逻辑
+        // 5. 启动战斗逻辑
         combatMgr->StartCombat();
         
-        // 5. 设置回调：处理回放中的交互
-        ui->setUICallback("OnRequestReplay", [levelId]() {
+        // 6. 设置回调：处理回放中的交互
+        ui->setUICallback(GameEventType::RequestReplay, [levelId](const GameEvent&) {
             auto ui = UIManager::getInstance();
             auto currentSteps = ui->getPlaybackSteps(); // 拿当前正在播的这份
+            auto currentChecksums = ui->getPlaybackChecksums();
             
             CCLOG("Re-requesting Replay. Steps count: %d", (int)currentSteps.size());
+
+            // 管理器仍在时恢复开战快照，不重新加载地图与建筑
+            auto combatMgr = CombatManager::GetInstance();
+            if (combatMgr && combatMgr->GetStartSnapshot().IsValid()) {
+                ui->hidePanel(UIPanelType::BattleResult, true);
+                ui->enterReplayMode(combatMgr->GetMap(), currentSteps, currentChecksums);
+                if (combatMgr->RestoreSnapshot(combatMgr->GetStartSnapshot())) return;
+            }
             
             CombatManager::DestroyInstance();
-            auto replayScene = ReplayScene::createScene(levelId, currentSteps);
+            auto replayScene = ReplayScene::createScene(levelId, currentSteps, currentChecksums);
             Director::getInstance()->replaceScene(TransitionFade::create(0.5f, replayScene));
         });
-        ui->setUICallback("OnRequestExitReplay", []() {
+        ui->setUICallback(GameEventType::RequestExitReplay, [](const GameEvent&) {
             AudioManager::getInstance()->playMusic(false);
             UIManager::getInstance()->exitReplayMode();
             CombatManager::DestroyInstance(); // 必须销毁回放中的战斗单例
             auto homeScene = MainScene::createScene();
             Director::getInstance()->replaceScene(TransitionFade::create(0.5f, homeScene));
         });
+
+        // 左方向键：回退到较早的快照
+        auto keyListener = EventListenerKeyboard::create();
+        keyListener->onKeyReleased = [](EventKeyboard::KeyCode code, Event*) {
+            if (code != EventKeyboard::KeyCode::KEY_LEFT_ARROW) return;
+            auto combat = CombatManager::GetInstance();
+            if (combat && combat->IsFighting()) {
+                combat->RewindTo(combat->getCombatTick() - kRewindTicks);
+            }
+        };
+        scene->getEventDispatcher()->addEventListenerWithSceneGraphPriority(keyListener, scene);
     }    
     return scene;
 }
@@ -6,8 +6,9 @@
 
 class ReplayScene : public cocos2d::Scene {
 public:
-    // 创建场景，传入地图ID和操作剧本
-    static ReplayScene* createScene(int levelId, const std::vector<ReplayStep>& steps);
+    // 创建场景，传入地图ID和操作剧本；checksums 非空时逐点校验回放是否与原战斗一致
+    static ReplayScene* createScene(int levelId, const std::vector<ReplayStep>& steps,
+                                    const CombatChecksumLog& checksums = CombatChecksumLog());
     
     virtual bool init() override;
     CREATE_FUNC(ReplayScene);
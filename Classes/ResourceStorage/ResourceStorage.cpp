@@ -765,10 +765,10 @@ bool Barracks::Init() {
     troopCapacity_["Barbarian"] = 20;
     troopCapacity_["Archer"] = 15;
 
-    // 启动训练更新定时器
-    schedule([this](float dt) {
-        OnTrainingUpdate(dt);
-        }, 1.0f, "training_timer");
+    // 启动训练更新定时器（由全局计时服务每秒触发，建筑析构时自动取消）
+    TimerService::getInstance()->start(1.0f, [this]() {
+        OnTrainingUpdate(1.0f);
+        }, this, 1.0f);
 
     return true;
 }
@@ -0,0 +1,160 @@
+#include "AttackPlanner.h"
+#include "JobSystem/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+// 每个分块连续模拟的场数：分块内复用同一个 HeadlessBattle 的工作数组
+const int kBattlesPerChunk = 4;
+}
+
+AttackPlanner::AttackPlanner(const SimRules& rules, const SimField& field)
+    : _rules(rules), _field(field) {
+}
+
+std::vector<AttackPlan> AttackPlanner::plan(const AttackPlanOptions& options) {
+    const auto begin = std::chrono::steady_clock::now();
+    _simulatedBattles = 0;
+
+    std::vector<AttackPlan> plans;
+    plans.reserve(options.candidates);
+    for (int id = 0; id < options.candidates; ++id) {
+        AttackPlan candidate = randomPlan(id, options);
+        if (!candidate.groups.empty()) plans.push_back(std::move(candidate));
+    }
+
+    int trials = std::max(1, options.initialTrials);
+    const int rounds = std::max(1, options.rounds);
+    for (int round = 0; round < rounds && !plans.empty(); ++round) {
+        evaluate(plans, trials, options);
+        std::stable_sort(plans.begin(), plans.end(), [](const AttackPlan& a, const AttackPlan& b) {
+            return a.score() > b.score();
+        });
+        if (round + 1 < rounds) {
+            // 淘汰后一半，保留的方案下一轮模拟次数翻倍
+            const size_t keep = std::max<size_t>(options.topCount, plans.size() / 2);
+            if (plans.size() > keep) plans.resize(keep);
+            trials *= 2;
+        }
+    }
+    if (plans.size() > static_cast<size_t>(options.topCount)) plans.resize(options.topCount);
+
+    _elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return plans;
+}
+
+AttackPlan AttackPlanner::randomPlan(int id, const AttackPlanOptions& options) const {
+    AttackPlan plan;
+    plan.id = id;
+    const auto& edge = _field.deployEdge();
+    const int unitTypes = static_cast<int>(_rules.units.size());
+    if (edge.empty() || unitTypes == 0) return plan;
+    SimRandom random(SimRandom::mix(options.seed, static_cast<uint64_t>(id)));
+
+    // 1. 兵种组合：先随机选出参与的兵种，再在其中逐个随机挑选放得下的士兵直到人口用完
+    std::vector<bool> allowed(unitTypes, false);
+    int allowedCount = 0;
+    for (int u = 0; u < unitTypes; ++u) {
+        if (random.nextInt(2) == 0) {
+            allowed[u] = true;
+            ++allowedCount;
+        }
+    }
+    if (allowedCount == 0) allowed[random.nextInt(unitTypes)] = true;
+
+    std::vector<int> counts(unitTypes, 0);
+    std::vector<int> fitting;
+    for (int remaining = options.armyCapacity;;) {
+        fitting.clear();
+        for (int u = 0; u < unitTypes; ++u) {
+            const int space = _rules.units[u].housingSpace;
+            if (allowed[u] && space > 0 && space <= remaining) fitting.push_back(u);
+        }
+        if (fitting.empty()) break;
+        const int pick = fitting[random.nextInt(static_cast<int>(fitting.size()))];
+        ++counts[pick];
+        remaining -= _rules.units[pick].housingSpace;
+    }
+
+    // 2. 每个兵种分成 1..maxGroupsPerUnit 组，各组随机取部署边缘上的一格与部署时刻
+    const int width = _field.width();
+    for (int u = 0; u < unitTypes; ++u) {
+        if (counts[u] == 0) continue;
+        const int groupCount = 1 + random.nextInt(std::min(std::max(1, options.maxGroupsPerUnit), counts[u]));
+        std::vector<int> sizes(groupCount, 1);
+        for (int extra = counts[u] - groupCount; extra > 0; --extra) {
+            ++sizes[random.nextInt(groupCount)];
+        }
+        for (int g = 0; g < groupCount; ++g) {
+            AttackPlanGroup group;
+            const int tile = edge[random.nextInt(static_cast<int>(edge.size()))];
+            group.unit = u;
+            group.count = sizes[g];
+            group.x = tile % width;
+            group.y = tile / width;
+            group.time = random.nextFloat(0.0f, options.maxDelay);
+            plan.groups.push_back(group);
+        }
+    }
+    return plan;
+}
+
+std::vector<SimDeployment> AttackPlanner::expand(const AttackPlan& plan, int trial,
+                                                 const AttackPlanOptions& options) const {
+    std::vector<SimDeployment> deployments;
+    SimRandom random(SimRandom::mix(SimRandom::mix(options.seed, static_cast<uint64_t>(plan.id)),
+                                    static_cast<uint64_t>(trial) + 1));
+    for (const auto& group : plan.groups) {
+        for (int i = 0; i < group.count; ++i) {
+            SimDeployment deployment;
+            deployment.unit = group.unit;
+            deployment.x = group.x + 0.5f;
+            deployment.y = group.y + 0.5f;
+            deployment.time = group.time;
+            if (trial >= 0) {
+                // 偏移后落入禁区时退回原部署点
+                const float x = deployment.x + random.nextFloat(-options.jitterTiles, options.jitterTiles);
+                const float y = deployment.y + random.nextFloat(-options.jitterTiles, options.jitterTiles);
+                if (_field.isDeployAllowed(static_cast<int>(std::floor(x)), static_cast<int>(std::floor(y)))) {
+                    deployment.x = x;
+                    deployment.y = y;
+                }
+                deployment.time = std::max(0.0f, deployment.time +
+                                           random.nextFloat(-options.jitterSeconds, options.jitterSeconds));
+            }
+            deployments.push_back(deployment);
+        }
+    }
+    return deployments;
+}
+
+void AttackPlanner::evaluate(std::vector<AttackPlan>& plans, int trials, const AttackPlanOptions& options) {
+    const int count = static_cast<int>(plans.size()) * trials;
+    std::vector<SimResult> results(count);
+
+    // 每场模拟只读 plans/_field，只写自己的结果槽位
+    auto job = [&](int begin, int end) {
+        HeadlessBattle battle(_rules);
+        for (int i = begin; i < end; ++i) {
+            const AttackPlan& plan = plans[i / trials];
+            const int trial = plan.trials + i % trials;
+            results[i] = battle.run(_field, expand(plan, trial, options), options.run);
+        }
+    };
+    JobSystem::getInstance()->parallelFor(count, kBattlesPerChunk, job);
+
+    // 按方案顺序汇总，与执行顺序无关
+    for (int i = 0; i < count; ++i) {
+        AttackPlan& plan = plans[i / trials];
+        const SimResult& result = results[i];
+        plan.totalStars += result.stars;
+        plan.totalDestruction += result.destruction;
+        if (result.stars >= 3) {
+            ++plan.threeStarCount;
+            plan.totalThreeStarTime += result.threeStarTime;
+        }
+    }
+    for (auto& plan : plans) plan.trials += trials;
+    _simulatedBattles += count;
+}
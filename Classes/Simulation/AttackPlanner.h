@@ -0,0 +1,75 @@
+#pragma once
+#ifndef __ATTACK_PLANNER_H__
+#define __ATTACK_PLANNER_H__
+
+#include "HeadlessBattle.h"
+#include <cstdint>
+#include <vector>
+
+// 一组部署：time 秒时在格子 (x, y) 放下 count 个同兵种士兵
+struct AttackPlanGroup {
+    int unit = 0;
+    int count = 0;
+    int x = 0;
+    int y = 0;
+    float time = 0.0f;
+};
+
+struct AttackPlan {
+    int id = 0;                       // 生成序号，决定每次试验的随机种子
+    std::vector<AttackPlanGroup> groups;
+    int trials = 0;
+    double totalStars = 0.0;
+    double totalDestruction = 0.0;
+    int threeStarCount = 0;
+    double totalThreeStarTime = 0.0;
+
+    double expectedStars() const { return trials ? totalStars / trials : 0.0; }
+    double expectedDestruction() const { return trials ? totalDestruction / trials : 0.0; }
+    double threeStarRate() const { return trials ? static_cast<double>(threeStarCount) / trials : 0.0; }
+    // 排序依据：期望星数优先，其次期望破坏度
+    double score() const { return expectedStars() * 1000.0 + expectedDestruction(); }
+};
+
+struct AttackPlanOptions {
+    int armyCapacity = 30;            // 可用人口
+    int candidates = 512;             // 初始随机方案数
+    int initialTrials = 4;            // 第一轮每个方案的模拟次数
+    int rounds = 3;                   // 逐轮淘汰：每轮保留前一半，下一轮模拟次数翻倍
+    int topCount = 5;                 // 返回的方案数
+    int maxGroupsPerUnit = 3;         // 每个兵种最多分几个部署点
+    float maxDelay = 8.0f;            // 部署时间窗（秒）
+    float jitterTiles = 1.0f;         // 每次试验给部署点加的随机偏移，模拟手动部署的误差
+    float jitterSeconds = 0.25f;
+    uint64_t seed = 1;
+    SimRunOptions run;
+};
+
+// 蒙特卡洛进攻规划：
+// 随机生成兵种组合（人口不超过 armyCapacity）、部署边缘上的部署点与部署时间，
+// 每个方案带随机扰动模拟多场战斗取平均；按逐轮淘汰提前放弃明显较差的方案，
+// 把模拟次数集中到靠前的方案上。各场模拟通过 JobSystem 并行，结果与线程数无关
+class AttackPlanner {
+public:
+    AttackPlanner(const SimRules& rules, const SimField& field);
+
+    std::vector<AttackPlan> plan(const AttackPlanOptions& options);
+
+    // 方案展开为逐个士兵的部署；trial 决定扰动，trial < 0 时不加扰动
+    std::vector<SimDeployment> expand(const AttackPlan& plan, int trial, const AttackPlanOptions& options) const;
+
+    uint64_t getSimulatedBattles() const { return _simulatedBattles; }
+    double getElapsedSeconds() const { return _elapsedSeconds; }
+
+private:
+    AttackPlan randomPlan(int id, const AttackPlanOptions& options) const;
+    // 对 plans 中每个方案再模拟 trials 次（试验序号从各方案已有的 trials 接着编号）
+    void evaluate(std::vector<AttackPlan>& plans, int trials, const AttackPlanOptions& options);
+
+    const SimRules& _rules;
+    const SimField& _field;
+    uint64_t _simulatedBattles = 0;
+    double _elapsedSeconds = 0.0;
+};
+
+#endif // __ATTACK_PLANNER_H__
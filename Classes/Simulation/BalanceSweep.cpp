@@ -0,0 +1,208 @@
+#include "BalanceSweep.h"
+#include "JobSystem/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace {
+// 每个分块连续模拟的场数：分块内复用同一个 HeadlessBattle 的工作数组
+const int kBattlesPerChunk = 4;
+
+// FNV-1a：种子只由缓存键的内容决定，布局与进攻的增删、换序不影响其余种子
+uint64_t hashKey(const std::string& key) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+}
+
+BalanceSweep::BalanceSweep(const SimRules& base, const std::vector<BalanceLayout>& layouts,
+                           const std::vector<SimAttack>& attacks)
+    : _base(base), _layouts(layouts), _attacks(attacks) {
+}
+
+bool BalanceSweep::applyParameter(SimRules& rules, const std::string& target, const std::string& stat, float value) {
+    const int unitIndex = rules.findUnit(target);
+    if (unitIndex >= 0) {
+        auto& unit = rules.units[unitIndex];
+        if (stat == "health") unit.health = static_cast<int>(std::lround(value));
+        else if (stat == "damage") unit.damage = static_cast<int>(std::lround(value));
+        else if (stat == "move_speed") unit.moveSpeed = value;
+        else if (stat == "attack_range") unit.attackRange = value;
+        else if (stat == "attack_delay") unit.attackDelay = value;
+        else return false;
+        return true;
+    }
+    const int buildingIndex = rules.findBuilding(target);
+    if (buildingIndex < 0 || !rules.buildings[buildingIndex].isDefense) return false;
+    auto& building = rules.buildings[buildingIndex];
+    if (stat == "attack_damage") building.attackDamage = static_cast<int>(std::lround(value));
+    else if (stat == "attack_interval") building.attackInterval = value;
+    else if (stat == "attack_range") building.attackRange = value;
+    else return false;
+    return true;
+}
+
+bool BalanceSweep::run(const BalanceSweepOptions& options, std::vector<BalanceRow>& rows, std::string* error) {
+    auto fail = [error](const std::string& message) {
+        if (error) *error = message;
+        return false;
+    };
+    const auto begin = std::chrono::steady_clock::now();
+    _simulatedBattles = 0;
+    rows.clear();
+
+    // 1. 展开参数网格：最后一个参数变化最快
+    size_t combos = 1;
+    for (const auto& parameter : options.parameters) {
+        if (parameter.values.empty()) return fail(parameter.target + "." + parameter.stat + " has no values");
+        SimRules probe = _base;
+        if (!applyParameter(probe, parameter.target, parameter.stat, parameter.values.front())) {
+            return fail("unknown parameter " + parameter.target + "." + parameter.stat);
+        }
+        combos *= parameter.values.size();
+    }
+    std::vector<SimRules> rulesets(combos, _base);
+    std::vector<std::vector<float>> comboValues(combos);
+    for (size_t c = 0; c < combos; ++c) {
+        size_t rest = c;
+        comboValues[c].resize(options.parameters.size());
+        for (size_t p = options.parameters.size(); p-- > 0;) {
+            const auto& parameter = options.parameters[p];
+            const float value = parameter.values[rest % parameter.values.size()];
+            rest /= parameter.values.size();
+            comboValues[c][p] = value;
+            applyParameter(rulesets[c], parameter.target, parameter.stat, value);
+        }
+    }
+
+    // 2. 战场与部署与参数无关，只准备一次；参数只改数值，不改建筑种类的下标
+    const int layoutCount = static_cast<int>(_layouts.size());
+    const int attackCount = static_cast<int>(_attacks.size());
+    const int trials = std::max(1, options.trials);
+    if (layoutCount == 0 || attackCount == 0) return fail("no layouts or attacks");
+    std::vector<SimField> fields(layoutCount);
+    for (int l = 0; l < layoutCount; ++l) {
+        std::string buildError;
+        if (!fields[l].build(_base, options.width, options.length, _layouts[l].pieces, &buildError)) {
+            return fail(_layouts[l].name + ": " + buildError);
+        }
+    }
+    std::vector<std::vector<SimDeployment>> deployments(static_cast<size_t>(layoutCount) * attackCount * trials);
+    for (int l = 0; l < layoutCount; ++l) {
+        for (int a = 0; a < attackCount; ++a) {
+            for (int t = 0; t < trials; ++t) {
+                auto& target = deployments[(static_cast<size_t>(l) * attackCount + a) * trials + t];
+                target = t == 0 ? _attacks[a].deployments
+                                : jitter(fields[l], _attacks[a], seedFor(l, a, t, options.seed), options);
+            }
+        }
+    }
+
+    // 3. 全部 (组合, 布局, 进攻, 试验) 展开成一个任务列表
+    const size_t perCombo = deployments.size();
+    const int count = static_cast<int>(combos * perCombo);
+    std::vector<SimResult> results(count);
+    auto job = [&](int jobBegin, int jobEnd) {
+        std::unique_ptr<HeadlessBattle> battle;
+        size_t battleCombo = combos;
+        for (int i = jobBegin; i < jobEnd; ++i) {
+            const size_t combo = i / perCombo;
+            const size_t battleIndex = i % perCombo;
+            if (combo != battleCombo) {
+                battle.reset(new HeadlessBattle(rulesets[combo]));
+                battleCombo = combo;
+            }
+            const int layout = static_cast<int>(battleIndex / (static_cast<size_t>(attackCount) * trials));
+            results[i] = battle->run(fields[layout], deployments[battleIndex], options.run);
+        }
+    };
+    JobSystem::getInstance()->parallelFor(count, kBattlesPerChunk, job);
+    _simulatedBattles = count;
+
+    // 4. 按 (组合, 布局) 汇总
+    for (size_t c = 0; c < combos; ++c) {
+        for (int l = 0; l < layoutCount; ++l) {
+            BalanceRow row;
+            row.values = comboValues[c];
+            row.layout = l;
+            const size_t first = c * perCombo + static_cast<size_t>(l) * attackCount * trials;
+            for (size_t i = first; i < first + static_cast<size_t>(attackCount) * trials; ++i) {
+                const SimResult& result = results[i];
+                ++row.battles;
+                if (result.stars > 0) ++row.wins;
+                if (result.stars >= 3) {
+                    ++row.threeStars;
+                    row.totalThreeStarTime += result.threeStarTime;
+                }
+                row.totalStars += result.stars;
+                row.totalDestruction += result.destruction;
+                row.totalUnitsLost += result.unitsLost;
+                row.totalHousingLost += result.housingLost;
+            }
+            rows.push_back(std::move(row));
+        }
+    }
+
+    _elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return true;
+}
+
+uint64_t BalanceSweep::seedFor(int layout, int attack, int trial, uint64_t base) {
+    const std::string key = _layouts[layout].name + "|" + _attacks[attack].name + "|" + std::to_string(trial);
+    auto found = _seeds.find(key);
+    if (found != _seeds.end()) return found->second;
+    const uint64_t seed = SimRandom::mix(base, hashKey(key));
+    _seeds.emplace(key, seed);
+    return seed;
+}
+
+std::vector<SimDeployment> BalanceSweep::jitter(const SimField& field, const SimAttack& attack, uint64_t seed,
+                                                const BalanceSweepOptions& options) const {
+    // 与 AttackPlanner::expand 相同的扰动：偏移后落入禁区时退回原部署点
+    std::vector<SimDeployment> deployments = attack.deployments;
+    SimRandom random(seed);
+    for (auto& deployment : deployments) {
+        const float x = deployment.x + random.nextFloat(-options.jitterTiles, options.jitterTiles);
+        const float y = deployment.y + random.nextFloat(-options.jitterTiles, options.jitterTiles);
+        if (field.isDeployAllowed(static_cast<int>(std::floor(x)), static_cast<int>(std::floor(y)))) {
+            deployment.x = x;
+            deployment.y = y;
+        }
+        deployment.time = std::max(0.0f, deployment.time + random.nextFloat(-options.jitterSeconds, options.jitterSeconds));
+    }
+    return deployments;
+}
+
+std::string BalanceSweep::toCsv(const std::vector<BalanceRow>& rows, const BalanceSweepOptions& options) const {
+    std::string csv;
+    for (const auto& parameter : options.parameters) csv += parameter.target + "." + parameter.stat + ",";
+    csv += "layout,battles,win_rate,three_star_rate,avg_stars,avg_destruction,avg_three_star_time,"
+           "avg_units_lost,avg_housing_lost\n";
+
+    char buffer[64];
+    for (const auto& row : rows) {
+        for (const float value : row.values) {
+            snprintf(buffer, sizeof(buffer), "%g,", value);
+            csv += buffer;
+        }
+        csv += _layouts[row.layout].name + ",";
+        const double battles = row.battles > 0 ? row.battles : 1;
+        snprintf(buffer, sizeof(buffer), "%d,%.4f,%.4f,%.4f,%.2f,", row.battles, row.wins / battles,
+                 row.threeStars / battles, row.totalStars / battles, row.totalDestruction / battles);
+        csv += buffer;
+        // 没有三星时用时留空
+        if (row.threeStars > 0) {
+            snprintf(buffer, sizeof(buffer), "%.2f", row.totalThreeStarTime / row.threeStars);
+            csv += buffer;
+        }
+        snprintf(buffer, sizeof(buffer), ",%.2f,%.2f\n", row.totalUnitsLost / battles, row.totalHousingLost / battles);
+        csv += buffer;
+    }
+    return csv;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef __BALANCE_SWEEP_H__
+#define __BALANCE_SWEEP_H__
+
+#include "HeadlessBattle.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 网格的一维：target 为兵种名（health / damage / move_speed / attack_range / attack_delay）
+// 或防御建筑类型（attack_damage / attack_interval / attack_range）
+struct BalanceParameter {
+    std::string target;
+    std::string stat;
+    std::vector<float> values;
+};
+
+struct BalanceLayout {
+    std::string name;
+    std::vector<LayoutPiece> pieces;
+};
+
+struct BalanceSweepOptions {
+    std::vector<BalanceParameter> parameters;
+    int trials = 1;                   // 每个 (布局, 进攻) 模拟几次；第 0 次按录制原样，其余加随机扰动
+    float jitterTiles = 0.5f;
+    float jitterSeconds = 0.25f;
+    uint64_t seed = 1;
+    int width = 30;
+    int length = 30;
+    SimRunOptions run;
+};
+
+// 一个参数组合在一个布局上的统计
+struct BalanceRow {
+    std::vector<float> values;        // 与 parameters 一一对应
+    int layout = 0;
+    int battles = 0;
+    int wins = 0;                     // 至少一星
+    int threeStars = 0;
+    int totalStars = 0;
+    int totalDestruction = 0;
+    double totalThreeStarTime = 0.0;
+    int totalUnitsLost = 0;
+    int totalHousingLost = 0;
+};
+
+// 数值平衡扫描：
+// 对参数网格的每个组合修改一份 SimRules，把进攻集合在每个布局上各模拟 trials 次，
+// 统计胜率、三星率、三星用时与兵力损失。所有组合共用同一组扰动种子（按 布局|进攻|试验 缓存），
+// 组合之间的差异只来自数值本身；全部战斗展开成一个任务列表交给 JobSystem，结果与线程数无关
+class BalanceSweep {
+public:
+    BalanceSweep(const SimRules& base, const std::vector<BalanceLayout>& layouts, const std::vector<SimAttack>& attacks);
+
+    // 参数名或目标不存在时返回 false
+    static bool applyParameter(SimRules& rules, const std::string& target, const std::string& stat, float value);
+
+    bool run(const BalanceSweepOptions& options, std::vector<BalanceRow>& rows, std::string* error = nullptr);
+    std::string toCsv(const std::vector<BalanceRow>& rows, const BalanceSweepOptions& options) const;
+
+    // 扰动种子缓存：run 之前载入上次的种子，run 之后取回（含本次新生成的）保存
+    void setSeeds(const std::map<std::string, uint64_t>& seeds) { _seeds = seeds; }
+    const std::map<std::string, uint64_t>& getSeeds() const { return _seeds; }
+
+    uint64_t getSimulatedBattles() const { return _simulatedBattles; }
+    double getElapsedSeconds() const { return _elapsedSeconds; }
+
+private:
+    uint64_t seedFor(int layout, int attack, int trial, uint64_t base);
+    std::vector<SimDeployment> jitter(const SimField& field, const SimAttack& attack, uint64_t seed,
+                                      const BalanceSweepOptions& options) const;
+
+    const SimRules& _base;
+    const std::vector<BalanceLayout>& _layouts;
+    const std::vector<SimAttack>& _attacks;
+    std::map<std::string, uint64_t> _seeds;
+    uint64_t _simulatedBattles = 0;
+    double _elapsedSeconds = 0.0;
+};
+
+#endif // __BALANCE_SWEEP_H__
@@ -0,0 +1,725 @@
+#include "HeadlessBattle.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace {
+
+const int kNeighborDirs[][2] = {
+    {1, 0}, {0, 1}, {-1, 0}, {0, -1}  // 与 PathRequestQueue 相同的 4 方向顺序
+};
+
+float distance(float ax, float ay, float bx, float by) {
+    const float dx = ax - bx;
+    const float dy = ay - by;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+} // namespace
+
+// ==================== 数值表 ====================
+
+int SimBuildingStats::healthAtLevel(int level) const {
+    // 与 Building::Upgrade 一致：先升级，再按新等级推算防御，血量为防御的 8 倍
+    int defense = base;
+    int health = healthFactor * base;
+    for (int current = 1; current < level; ++current) {
+        const int next = current + 1;
+        defense = 10 * ((defense * (next + 2) / (next + 1)) / 10);
+        health = 8 * defense;
+    }
+    return health;
+}
+
+SimRules SimRules::defaults() {
+    SimRules rules;
+
+    // 数值取自 BattleStats.h，与 TownHall 的兵种模板、建筑模板共用同一张表；
+    // 偏好与 Soldier 构造函数一致
+    for (const auto& stats : battle_stats::kUnits) {
+        SimUnitStats unit;
+        unit.name = stats.name;
+        unit.health = stats.health;
+        unit.damage = stats.damage;
+        unit.moveSpeed = stats.moveSpeed;
+        unit.attackRange = stats.attackRange;
+        unit.attackDelay = stats.attackDelay;
+        unit.housingSpace = stats.housingSpace;
+        rules.units.push_back(unit);
+    }
+    rules.units[rules.findUnit("Bomber")].preference = SimTargetPreference::Wall;
+    rules.units[rules.findUnit("Bomber")].suicideSplash = true;
+    rules.units[rules.findUnit("Giant")].preference = SimTargetPreference::Defense;
+
+    for (const auto& stats : battle_stats::kBuildings) {
+        SimBuildingStats building;
+        building.type = stats.name;
+        building.width = stats.width;
+        building.length = stats.length;
+        building.base = stats.base;
+        building.healthFactor = stats.healthFactor;
+        building.isTownHall = std::strcmp(stats.name, "TownHall") == 0;
+        building.isWall = std::strcmp(stats.name, "Wall") == 0;
+        if (stats.attackDamage > 0) {
+            building.isDefense = true;
+            building.attackInterval = stats.attackInterval;
+            building.attackDamage = stats.attackDamage;
+            building.attackRange = stats.attackRange;
+        }
+        rules.buildings.push_back(building);
+    }
+    return rules;
+}
+
+int SimRules::findUnit(const std::string& name) const {
+    for (int i = 0; i < static_cast<int>(units.size()); ++i) {
+        if (units[i].name == name) return i;
+    }
+    return -1;
+}
+
+int SimRules::findBuilding(const std::string& type) const {
+    for (int i = 0; i < static_cast<int>(buildings.size()); ++i) {
+        if (buildings[i].type == type) return i;
+    }
+    return -1;
+}
+
+// ==================== 随机数 ====================
+
+uint64_t SimRandom::mix(uint64_t a, uint64_t b) {
+    SimRandom random(a ^ (b * 0x9E3779B97F4A7C15ull + 0x632BE59BD9B4E019ull));
+    return random.next();
+}
+
+uint64_t SimRandom::next() {
+    uint64_t z = (_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+int SimRandom::nextInt(int bound) {
+    if (bound <= 1) return 0;
+    return static_cast<int>((next() >> 33) % static_cast<uint64_t>(bound));
+}
+
+float SimRandom::nextFloat(float lo, float hi) {
+    const float unit = static_cast<float>(next() >> 40) / static_cast<float>(1u << 24);
+    return lo + (hi - lo) * unit;
+}
+
+// ==================== 战场 ====================
+
+bool SimField::build(const SimRules& rules, int width, int length,
+                     const std::vector<LayoutPiece>& pieces, std::string* error) {
+    auto fail = [error](const std::string& message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    _buildings.clear();
+    _deployEdge.clear();
+    _countedBuildings = 0;
+    _owners.assign(width, length, kFree);
+    _noDeploy.assign(width, length);
+
+    for (const auto& piece : pieces) {
+        if (piece.type == "Obstacle") {
+            if (!inBounds(piece.x, piece.y)) return fail("obstacle out of bounds");
+            _owners.at(piece.x, piece.y) = kObstacle;
+            continue;
+        }
+        const int statsIndex = rules.findBuilding(piece.type);
+        if (statsIndex < 0) return fail("unknown building type " + piece.type);
+        const auto& stats = rules.buildings[statsIndex];
+        if (piece.x < 0 || piece.y < 0 || piece.x + stats.width > width || piece.y + stats.length > length) {
+            return fail(piece.type + " out of bounds");
+        }
+
+        SimBuilding building;
+        building.stats = statsIndex;
+        building.x = piece.x;
+        building.y = piece.y;
+        building.width = stats.width;
+        building.length = stats.length;
+        building.maxHealth = stats.healthAtLevel(std::max(1, piece.level));
+        const int index = static_cast<int>(_buildings.size());
+        for (int y = piece.y; y < piece.y + stats.length; ++y) {
+            for (int x = piece.x; x < piece.x + stats.width; ++x) {
+                if (_owners.at(x, y) != kFree) return fail(piece.type + " overlaps another piece");
+                _owners.at(x, y) = index;
+            }
+        }
+        // 与 MapManager::updateBuildingGrids 一致：建筑外一圈为禁区
+        const int mx = std::max(0, piece.x - 1);
+        const int my = std::max(0, piece.y - 1);
+        _noDeploy.setRect(mx, my, std::min(width, piece.x + stats.width + 1) - mx,
+                          std::min(length, piece.y + stats.length + 1) - my, true);
+        if (!stats.isWall) ++_countedBuildings;
+        _buildings.push_back(building);
+    }
+
+    for (int y = 0; y < length; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (!isDeployAllowed(x, y)) continue;
+            for (const auto& dir : kNeighborDirs) {
+                const int nx = x + dir[0], ny = y + dir[1];
+                if (inBounds(nx, ny) && _noDeploy.test(nx, ny)) {
+                    _deployEdge.push_back(y * width + x);
+                    break;
+                }
+            }
+        }
+    }
+    // 空地图没有禁区，整张地图都是部署边缘
+    if (_deployEdge.empty()) {
+        for (int y = 0; y < length; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (isDeployAllowed(x, y)) _deployEdge.push_back(y * width + x);
+            }
+        }
+    }
+    return true;
+}
+
+bool SimField::isDeployAllowed(int x, int y) const {
+    return inBounds(x, y) && !_noDeploy.test(x, y) && _owners.at(x, y) == kFree;
+}
+
+bool SimField::nearestDeployable(int x, int y, int& outX, int& outY) const {
+    const int maxRadius = std::max(width(), length());
+    for (int radius = 0; radius <= maxRadius; ++radius) {
+        for (int cy = y - radius; cy <= y + radius; ++cy) {
+            for (int cx = x - radius; cx <= x + radius; ++cx) {
+                // 只看这一圈的边上
+                if (std::abs(cx - x) != radius && std::abs(cy - y) != radius) continue;
+                if (isDeployAllowed(cx, cy)) {
+                    outX = cx;
+                    outY = cy;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// ==================== 影响区域 ====================
+
+void SimInfluence::reset(int width, int length, size_t buildings) {
+    firstRead.assign(width, length, kNever);
+    firstVisit.assign(width, length, kNever);
+    if (deployCells.width() == width && deployCells.length() == length) {
+        deployCells.reset();
+    } else {
+        deployCells.assign(width, length);
+    }
+    choices.clear();
+    destroyedAt.assign(buildings, kNever);
+}
+
+void SimInfluence::read(int x, int y, int tick) {
+    int& first = firstRead.at(x, y);
+    if (tick < first) first = tick;
+}
+
+void SimInfluence::readRect(int x, int y, int width, int length, int tick) {
+    for (int row = y; row < y + length; ++row) {
+        for (int column = x; column < x + width; ++column) read(column, row, tick);
+    }
+}
+
+bool SimInfluence::affectedBy(int building, const SimBuilding& from, const SimBuilding& to,
+                              const SimBuildingStats& stats) const {
+    const int width = firstRead.width(), length = firstRead.length();
+    // 存活到最后的建筑按最后一步计，未读过的格子（kNever）不算
+    const int until = std::min(destroyedAt[building], kNever - 1);
+
+    // 1. 部署：建筑外一圈为禁区，与存活无关
+    auto nearDeploy = [&](const SimBuilding& placed) {
+        const int x0 = std::max(0, placed.x - 1), y0 = std::max(0, placed.y - 1);
+        const int x1 = std::min(width, placed.x + placed.width + 1);
+        const int y1 = std::min(length, placed.y + placed.length + 1);
+        return deployCells.anyInRect(x0, y0, x1 - x0, y1 - y0);
+    };
+    if (nearDeploy(from) || nearDeploy(to)) return true;
+
+    // 2. 存活期间新旧占位上的格子被读过
+    auto readWhileAlive = [&](const SimBuilding& placed) {
+        for (int y = placed.y; y < placed.y + placed.length; ++y) {
+            for (int x = placed.x; x < placed.x + placed.width; ++x) {
+                if (firstRead.at(x, y) <= until) return true;
+            }
+        }
+        return false;
+    };
+    if (readWhileAlive(from) || readWhileAlive(to)) return true;
+
+    // 3. 存活期间某次选目标时，新旧左下角在候选范围内
+    for (const auto& choice : choices) {
+        if (choice.tick > until) break;
+        const bool preferred = choice.preference == SimTargetPreference::Wall ? stats.isWall
+                             : choice.preference == SimTargetPreference::Defense ? stats.isDefense : false;
+        if (preferred != choice.preferred || stats.isWall != choice.wall) continue;
+        if (distance(choice.x, choice.y, static_cast<float>(from.x), static_cast<float>(from.y)) <= choice.radius ||
+            distance(choice.x, choice.y, static_cast<float>(to.x), static_cast<float>(to.y)) <= choice.radius) {
+            return true;
+        }
+    }
+    if (!stats.isDefense) return false;
+
+    // 4. 原位置从未开火（否则占位已被读过）；新位置射程内（按格子对角线放宽）存活期间有士兵到过就可能开火
+    const float reach = stats.attackRange + 1.5f;
+    const int yMin = std::max(0, static_cast<int>(std::ceil(to.y - reach)));
+    const int yMax = std::min(length - 1, static_cast<int>(std::floor(to.y + reach)));
+    for (int y = yMin; y <= yMax; ++y) {
+        const float dy = static_cast<float>(y - to.y);
+        const float half = std::sqrt(std::max(0.0f, reach * reach - dy * dy));
+        const int xMin = std::max(0, static_cast<int>(std::ceil(to.x - half)));
+        const int xMax = std::min(width - 1, static_cast<int>(std::floor(to.x + half)));
+        for (int x = xMin; x <= xMax; ++x) {
+            if (firstVisit.at(x, y) <= until) return true;
+        }
+    }
+    return false;
+}
+
+// ==================== 模拟 ====================
+
+SimResult HeadlessBattle::run(const SimField& field, const std::vector<SimDeployment>& deployments,
+                              const SimRunOptions& options, SimInfluence* influence) {
+    SimResult result;
+    reset(field);
+    _influence = influence;
+    if (_influence) _influence->reset(field.width(), field.length(), field.buildings().size());
+
+    // 同一时刻的部署保持输入顺序
+    _order.resize(deployments.size());
+    for (size_t i = 0; i < _order.size(); ++i) _order[i] = static_cast<int>(i);
+    std::stable_sort(_order.begin(), _order.end(), [&deployments](int a, int b) {
+        return deployments[a].time < deployments[b].time;
+    });
+    if (_units.size() < deployments.size()) _units.resize(deployments.size());
+
+    const float dt = _rules.tickSeconds;
+    size_t nextDeploy = 0;
+    while (!_finished) {
+        // 与游戏内一致：部署发生在士兵动作之前，防御建筑最后结算
+        while (nextDeploy < _order.size() && deployments[_order[nextDeploy]].time <= _time) {
+            deploy(deployments[_order[nextDeploy++]], result);
+        }
+        for (size_t i = 0; i < _unitCount && !_finished; ++i) {
+            if (_units[i].state != UnitState::Dead) updateUnit(_units[i], dt, result);
+        }
+        if (!_finished) updateDefenses(dt, result);
+        if (_influence) {
+            for (size_t i = 0; i < _unitCount; ++i) {
+                const Unit& unit = _units[i];
+                if (unit.state == UnitState::Dead) continue;
+                const int x = static_cast<int>(std::floor(unit.x)), y = static_cast<int>(std::floor(unit.y));
+                if (field.inBounds(x, y) && _influence->firstVisit.at(x, y) == SimInfluence::kNever) {
+                    _influence->firstVisit.at(x, y) = _tick;
+                }
+            }
+        }
+        _time += dt;
+        ++_tick;
+
+        const bool allDeployed = nextDeploy == _order.size();
+        if (allDeployed && _liveUnits == 0) _finished = true;
+        if (_time >= _rules.timeLimit) _finished = true;
+        if (!_finished && allDeployed && options.stallSeconds > 0.0f && _time - _lastProgress >= options.stallSeconds) {
+            result.cutOff = true;
+            _finished = true;
+        }
+    }
+    result.duration = _time;
+    _influence = nullptr;
+    return result;
+}
+
+void HeadlessBattle::reset(const SimField& field) {
+    _field = &field;
+    _time = 0.0f;
+    _tick = 0;
+    _lastProgress = 0.0f;
+    _destroyedCounted = 0;
+    _liveUnits = 0;
+    _unitCount = 0;
+    _finished = field.countedBuildings() == 0;
+
+    _owners = field.owners();
+    const auto& buildings = field.buildings();
+    _health.resize(buildings.size());
+    _defenses.clear();
+    for (size_t i = 0; i < buildings.size(); ++i) {
+        _health[i] = buildings[i].maxHealth;
+        if (_rules.buildings[buildings[i].stats].isDefense) {
+            Defense defense;
+            defense.building = static_cast<int>(i);
+            _defenses.push_back(defense);
+        }
+    }
+
+    const size_t tiles = static_cast<size_t>(field.width()) * field.length();
+    if (_gCost.size() != tiles) {
+        _gCost.assign(tiles, 0.0f);
+        _parent.assign(tiles, -1);
+        _visited.assign(tiles, 0u);
+        _closed.assign(tiles, 0u);
+        _searchSerial = 0;
+    }
+}
+
+void HeadlessBattle::deploy(const SimDeployment& deployment, SimResult& result) {
+    const int cellX = static_cast<int>(std::floor(deployment.x));
+    const int cellY = static_cast<int>(std::floor(deployment.y));
+    if (_influence && _field->inBounds(cellX, cellY)) {
+        _influence->deployCells.set(cellX, cellY, true);
+    }
+    if (deployment.unit < 0 || deployment.unit >= static_cast<int>(_rules.units.size()) ||
+        !_field->isDeployAllowed(cellX, cellY)) {
+        ++result.rejected;
+        return;
+    }
+    Unit& unit = _units[_unitCount++];
+    unit.stats = deployment.unit;
+    unit.x = deployment.x;
+    unit.y = deployment.y;
+    unit.health = _rules.units[deployment.unit].health;
+    unit.target = -1;
+    unit.state = UnitState::Idle;
+    unit.attackTimer = 0.0f;
+    unit.path.clear();
+    unit.pathStep = 0;
+    ++_liveUnits;
+    ++result.deployed;
+    _lastProgress = _time;
+}
+
+void HeadlessBattle::chooseTarget(Unit& unit) {
+    // 与 SoldierInCombat::GetNextTarget 相同的比较：兵种偏好 → 非城墙 → 到建筑左下角的距离；
+    // 距离相同时取下标小的建筑
+    const auto& stats = _rules.units[unit.stats];
+    const auto& buildings = _field->buildings();
+    auto preferred = [&](int b) {
+        const auto& type = _rules.buildings[buildings[b].stats];
+        return stats.preference == SimTargetPreference::Wall ? type.isWall
+             : stats.preference == SimTargetPreference::Defense ? type.isDefense : false;
+    };
+    auto better = [&](int a, int b) {
+        if (stats.preference != SimTargetPreference::None) {
+            const bool aPreferred = preferred(a), bPreferred = preferred(b);
+            if (aPreferred != bPreferred) return aPreferred;
+        }
+        const bool aWall = _rules.buildings[buildings[a].stats].isWall;
+        const bool bWall = _rules.buildings[buildings[b].stats].isWall;
+        if (aWall != bWall) return bWall;
+        return distance(unit.x, unit.y, static_cast<float>(buildings[a].x), static_cast<float>(buildings[a].y)) <
+               distance(unit.x, unit.y, static_cast<float>(buildings[b].x), static_cast<float>(buildings[b].y));
+    };
+
+    int best = -1;
+    for (int b = 0; b < static_cast<int>(buildings.size()); ++b) {
+        if (_health[b] <= 0) continue;
+        if (best < 0 || better(b, best)) best = b;
+    }
+    unit.target = best;
+    if (_influence && best >= 0) {
+        const float radius = distance(unit.x, unit.y, static_cast<float>(buildings[best].x), static_cast<float>(buildings[best].y));
+        _influence->choices.push_back({ unit.x, unit.y, radius + 0.01f, _tick, stats.preference, preferred(best),
+                                        _rules.buildings[buildings[best].stats].isWall });
+    }
+}
+
+float HeadlessBattle::breakCost(int building, const SimUnitStats& stats) const {
+    // 与 PathCostProfile::BreakCost 一致：摧毁耗时换算成同等时间内可走的格数
+    const float dps = stats.attackDelay > 0.0f ? stats.damage / stats.attackDelay : static_cast<float>(stats.damage);
+    if (dps <= 0.0f) return -1.0f;
+    return _health[building] / dps * stats.moveSpeed;
+}
+
+bool HeadlessBattle::findPath(const Unit& unit, int goalX, int goalY, bool avoidBuildings) {
+    // 与 PathRequestQueue::FindPath 相同的 A*：4 方向、曼哈顿启发、进入射程即停止
+    const auto& stats = _rules.units[unit.stats];
+    const int width = _owners.width();
+    const int startX = static_cast<int>(std::floor(unit.x));
+    const int startY = static_cast<int>(std::floor(unit.y));
+    _pathBuffer.clear();
+    if (!_field->inBounds(startX, startY)) return false;
+
+    if (++_searchSerial == 0) {
+        std::fill(_visited.begin(), _visited.end(), 0u);
+        std::fill(_closed.begin(), _closed.end(), 0u);
+        _searchSerial = 1;
+    }
+    auto heuristic = [goalX, goalY](int x, int y) {
+        return static_cast<float>(std::abs(x - goalX) + std::abs(y - goalY));
+    };
+    _open.clear();
+    const int start = startY * width + startX;
+    _visited[start] = _searchSerial;
+    _gCost[start] = 0.0f;
+    _parent[start] = -1;
+    _open.push_back({ heuristic(startX, startY), 0.0f, start });
+    _examined.clear();
+    if (_influence) _examined.push_back(start);
+
+    while (!_open.empty()) {
+        std::pop_heap(_open.begin(), _open.end(), std::greater<>());
+        const OpenNode current = _open.back();
+        _open.pop_back();
+        const int cx = current.tile % width, cy = current.tile / width;
+
+        if (distance(static_cast<float>(cx), static_cast<float>(cy),
+                     static_cast<float>(goalX), static_cast<float>(goalY)) <= stats.attackRange) {
+            for (int tile = current.tile; tile != -1; tile = _parent[tile]) {
+                _pathBuffer.push_back(tile);
+            }
+            std::reverse(_pathBuffer.begin(), _pathBuffer.end());
+            // 搜索成功时路线取决于检查过的每一格；失败时只取决于挡路的格子：
+            // 往连通区域里添加建筑不会让它变得可达
+            if (_influence) {
+                for (const int tile : _examined) _influence->read(tile % width, tile / width, _tick);
+            }
+            return true;
+        }
+        if (_closed[current.tile] == _searchSerial) continue;
+        _closed[current.tile] = _searchSerial;
+
+        for (const auto& dir : kNeighborDirs) {
+            const int nx = cx + dir[0], ny = cy + dir[1];
+            if (!_field->inBounds(nx, ny)) continue;
+            const int neighbor = ny * width + nx;
+            if (_closed[neighbor] == _searchSerial) continue;
+
+            float g = current.g + 1.0f;
+            const int owner = _owners.at(nx, ny);
+            if (owner != SimField::kFree) {
+                if (avoidBuildings || owner == SimField::kObstacle) {
+                    // 挡路的格子无论搜索成败都会影响结果
+                    if (_influence) _influence->read(nx, ny, _tick);
+                    continue;
+                }
+                const float cost = breakCost(owner, stats);
+                if (cost < 0.0f) continue;
+                g += cost;
+            }
+            if (_influence) _examined.push_back(neighbor);
+            if (_visited[neighbor] != _searchSerial || g < _gCost[neighbor]) {
+                _visited[neighbor] = _searchSerial;
+                _gCost[neighbor] = g;
+                _parent[neighbor] = current.tile;
+                _open.push_back({ g + heuristic(nx, ny), g, neighbor });
+                std::push_heap(_open.begin(), _open.end(), std::greater<>());
+            }
+        }
+    }
+    return false;
+}
+
+void HeadlessBattle::planPath(Unit& unit) {
+    const auto& target = _field->buildings()[unit.target];
+    const int startX = static_cast<int>(std::floor(unit.x));
+    const int startY = static_cast<int>(std::floor(unit.y));
+
+    // 多格建筑按 下边→上边→右边→左边 的顺序取离起点最近的边缘格
+    int goalX = target.x, goalY = target.y;
+    if (target.width != 1 || target.length != 1) {
+        const int xMax = target.x + target.width - 1, yMax = target.y + target.length - 1;
+        float best = -1.0f;
+        auto consider = [&](int x, int y) {
+            const float d = distance(static_cast<float>(startX), static_cast<float>(startY),
+                                     static_cast<float>(x), static_cast<float>(y));
+            if (best < 0.0f || d < best) {
+                best = d;
+                goalX = x;
+                goalY = y;
+            }
+        };
+        for (int x = target.x; x <= xMax; ++x) consider(x, target.y);
+        for (int x = target.x; x <= xMax; ++x) consider(x, yMax);
+        for (int y = target.y + 1; y < yMax; ++y) consider(xMax, y);
+        for (int y = target.y + 1; y < yMax; ++y) consider(target.x, y);
+    }
+
+    // 存在不破坏建筑的路线时只走空地，否则允许按拆除代价穿过建筑
+    if (!findPath(unit, goalX, goalY, true)) findPath(unit, goalX, goalY, false);
+    unit.path.assign(_pathBuffer.begin(), _pathBuffer.end());
+    unit.pathStep = 1;
+
+    // 与 SoldierInCombat::RedirectPath 一致：路径被建筑挡住时改打挡路的建筑，
+    // 路径截断到能打到它的最早一点
+    const int width = _owners.width();
+    const float range = _rules.units[unit.stats].attackRange;
+    for (size_t i = 0; i < unit.path.size(); ++i) {
+        const int tile = unit.path[i];
+        const int owner = _owners.at(tile % width, tile / width);
+        if (owner == SimField::kFree) continue;
+        const float bx = static_cast<float>(tile % width), by = static_cast<float>(tile / width);
+        auto inRange = [&](size_t j) {
+            const int t = unit.path[j];
+            return distance(static_cast<float>(t % width), static_cast<float>(t / width), bx, by) <= range;
+        };
+        size_t keep = i;
+        while (keep > 0 && inRange(keep)) --keep;
+        if (!inRange(keep)) ++keep;
+        unit.path.resize(keep + 1);
+        if (owner >= 0) unit.target = owner;
+        break;
+    }
+    unit.state = UnitState::Moving;
+}
+
+void HeadlessBattle::updateUnit(Unit& unit, float dt, SimResult& result) {
+    const auto& stats = _rules.units[unit.stats];
+    if (unit.state == UnitState::Idle) {
+        chooseTarget(unit);
+        if (unit.target < 0) return;
+        planPath(unit);
+    }
+
+    if (unit.state == UnitState::Moving) {
+        float budget = stats.moveSpeed * dt;
+        const int width = _owners.width();
+        while (budget > 0.0f && unit.pathStep < unit.path.size()) {
+            const int tile = unit.path[unit.pathStep];
+            const float px = static_cast<float>(tile % width), py = static_cast<float>(tile / width);
+            const float remaining = distance(unit.x, unit.y, px, py);
+            if (remaining <= budget) {
+                unit.x = px;
+                unit.y = py;
+                budget -= remaining;
+                ++unit.pathStep;
+            } else {
+                unit.x += (px - unit.x) * budget / remaining;
+                unit.y += (py - unit.y) * budget / remaining;
+                budget = 0.0f;
+            }
+        }
+        if (unit.pathStep < unit.path.size()) return;
+
+        if (stats.suicideSplash) {
+            // 与 SoldierInCombat::DealSplashDamage 一致：所在格周围一圈，每座建筑只命中一次
+            const int cx = static_cast<int>(std::floor(unit.x)), cy = static_cast<int>(std::floor(unit.y));
+            int hits[9];
+            int hitCount = 0;
+            for (int y = cy - 1; y <= cy + 1 && !_finished; ++y) {
+                for (int x = cx - 1; x <= cx + 1 && !_finished; ++x) {
+                    if (!_field->inBounds(x, y)) continue;
+                    if (_influence) _influence->read(x, y, _tick);
+                    const int owner = _owners.at(x, y);
+                    if (owner < 0 || std::find(hits, hits + hitCount, owner) != hits + hitCount) continue;
+                    hits[hitCount++] = owner;
+                    const bool wall = _rules.buildings[_field->buildings()[owner].stats].isWall;
+                    damageBuilding(owner, wall ? stats.damage * _rules.wallDamageFactor : stats.damage, result);
+                }
+            }
+            killUnit(unit, result);
+            return;
+        }
+        unit.state = UnitState::Attacking;
+        unit.attackTimer = 0.0f;
+    }
+
+    if (unit.state == UnitState::Attacking) {
+        // 攻击动画时长计入攻击间隔：开始攻击后每 attackDelay 秒结算一次
+        unit.attackTimer += dt;
+        if (unit.attackTimer >= stats.attackDelay) {
+            unit.attackTimer -= stats.attackDelay;
+            damageBuilding(unit.target, stats.damage, result);
+        }
+    }
+}
+
+void HeadlessBattle::updateDefenses(float dt, SimResult& result) {
+    for (auto& defense : _defenses) {
+        if (_health[defense.building] <= 0) continue;
+        const auto& building = _field->buildings()[defense.building];
+        const auto& stats = _rules.buildings[building.stats];
+        defense.timer += dt;
+        if (defense.timer < stats.attackInterval) continue;
+        defense.timer -= stats.attackInterval;
+
+        // 与 AttackBuildingInCombat::SelectTarget 一致：沿用存活的目标，否则取射程内最近的士兵
+        if (defense.target < 0 || _units[defense.target].state == UnitState::Dead) {
+            defense.target = -1;
+            float nearest = 0.0f;
+            for (size_t i = 0; i < _unitCount; ++i) {
+                if (_units[i].state == UnitState::Dead) continue;
+                const float d = distance(static_cast<float>(building.x), static_cast<float>(building.y),
+                                         _units[i].x, _units[i].y);
+                if (defense.target < 0 || d < nearest) {
+                    defense.target = static_cast<int>(i);
+                    nearest = d;
+                }
+            }
+            if (defense.target >= 0 && nearest > stats.attackRange) defense.target = -1;
+        }
+        if (defense.target < 0) continue;
+        if (_influence) {
+            _influence->readRect(building.x, building.y, building.width, building.length, _tick);
+        }
+        Unit& unit = _units[defense.target];
+        unit.health -= stats.attackDamage;
+        if (unit.health <= 0) killUnit(unit, result);
+    }
+}
+
+bool HeadlessBattle::damageBuilding(int building, int damage, SimResult& result) {
+    if (building < 0 || _health[building] <= 0) return false;
+    _health[building] -= damage;
+    if (_health[building] > 0) return false;
+    _health[building] = 0;
+    destroyBuilding(building, result);
+    return true;
+}
+
+void HeadlessBattle::destroyBuilding(int building, SimResult& result) {
+    const auto& placed = _field->buildings()[building];
+    const auto& stats = _rules.buildings[placed.stats];
+    for (int y = placed.y; y < placed.y + placed.length; ++y) {
+        for (int x = placed.x; x < placed.x + placed.width; ++x) {
+            _owners.at(x, y) = SimField::kFree;
+        }
+    }
+    _lastProgress = _time;
+    if (_influence) _influence->destroyedAt[building] = _tick;
+
+    // 与 BuildingInCombat::Die 一致的星级：破坏度过半、全毁、摧毁大本营各一星
+    if (!stats.isWall) {
+        const int former = result.destruction;
+        ++_destroyedCounted;
+        result.destruction = 100 * _destroyedCounted / _field->countedBuildings();
+        if (former < 50 && result.destruction >= 50) ++result.stars;
+        if (former < 100 && result.destruction == 100) ++result.stars;
+    }
+    if (stats.isTownHall) {
+        ++result.stars;
+        result.townHallDestroyed = true;
+    }
+    if (result.stars >= 3 && result.threeStarTime < 0.0f) result.threeStarTime = _time;
+    if (result.destruction == 100) {
+        _finished = true;
+        return;
+    }
+
+    // 以它为目标的士兵重新选目标
+    for (size_t i = 0; i < _unitCount; ++i) {
+        Unit& unit = _units[i];
+        if (unit.state != UnitState::Dead && unit.target == building) {
+            unit.target = -1;
+            unit.state = UnitState::Idle;
+        }
+    }
+}
+
+void HeadlessBattle::killUnit(Unit& unit, SimResult& result) {
+    unit.state = UnitState::Dead;
+    unit.health = 0;
+    --_liveUnits;
+    ++result.unitsLost;
+    result.housingLost += _rules.units[unit.stats].housingSpace;
+}
@@ -0,0 +1,262 @@
+#pragma once
+#ifndef __HEADLESS_BATTLE_H__
+#define __HEADLESS_BATTLE_H__
+
+#include "MapManager/LayoutValidator.h"
+#include "MapManager/MapGrid.h"
+#include "TownHall/BattleStats.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 无渲染战斗模拟：
+// 不依赖 cocos 节点与 Action，按与 CombatManager 相同的固定步长推进相同的战斗规则
+// （士兵选目标偏好、A* 拆墙代价、防御建筑最近目标、炸弹人溅射、星级与破坏度），
+// 一场战斗只在一个线程内执行，多场战斗可以交给 JobSystem 并行。
+// 结果只取决于布局、部署与数值，与线程数无关
+
+// 士兵选目标时优先的建筑种类（对应 Soldier::building_preference_）
+enum class SimTargetPreference {
+    None,
+    Wall,       // 炸弹人
+    Defense     // 巨人
+};
+
+// 兵种数值，下标与 SoldierType 一致
+struct SimUnitStats {
+    std::string name;
+    int health = 0;
+    int damage = 0;
+    float moveSpeed = 1.0f;       // 格/秒
+    float attackRange = 1.0f;     // 格
+    float attackDelay = 1.0f;     // 两次攻击间隔（秒）
+    int housingSpace = 1;
+    SimTargetPreference preference = SimTargetPreference::None;
+    bool suicideSplash = false;   // 到达后对周围 3x3 的建筑各造成一次伤害并阵亡
+};
+
+// 建筑类型数值：1 级血量为 healthFactor * base，升级规则与 Building::Upgrade 一致
+struct SimBuildingStats {
+    std::string type;
+    int width = 1;
+    int length = 1;
+    int base = 10;
+    int healthFactor = 8;
+    bool isWall = false;
+    bool isTownHall = false;
+    bool isDefense = false;
+    float attackInterval = 1.0f;
+    int attackDamage = 0;
+    float attackRange = 0.0f;
+
+    int healthAtLevel(int level) const;
+};
+
+struct SimRules {
+    std::vector<SimUnitStats> units;
+    std::vector<SimBuildingStats> buildings;
+    float tickSeconds = battle_stats::kFixedTickDt;   // 固定步长，默认与 CombatManager 的 tick 相同
+    float timeLimit = 180.0f;     // 单场战斗时长上限（秒）
+    int wallDamageFactor = 40;    // 炸弹人对城墙的伤害倍数
+
+    // 默认数值，取自与 TownHall 兵种模板、建筑模板共用的 BattleStats.h
+    static SimRules defaults();
+    int findUnit(const std::string& name) const;
+    int findBuilding(const std::string& type) const;
+};
+
+// 可复现的随机数（splitmix64）：不同平台、不同标准库下序列一致
+class SimRandom {
+public:
+    explicit SimRandom(uint64_t seed) : _state(seed) {}
+    // 把多个整数合成一个种子，用于按 (方案, 试验) 派生互不相关的序列
+    static uint64_t mix(uint64_t a, uint64_t b);
+
+    uint64_t next();
+    int nextInt(int bound);                  // [0, bound)
+    float nextFloat(float lo, float hi);     // [lo, hi)
+
+private:
+    uint64_t _state;
+};
+
+struct SimBuilding {
+    int stats = -1;               // SimRules::buildings 下标
+    int x = 0;                    // 左下角格子
+    int y = 0;
+    int width = 1;
+    int length = 1;
+    int maxHealth = 0;
+};
+
+// 编译后的战场：建筑表、占位与部署许可，构建后只读，可被多个线程同时模拟
+// 部署规则与 MapManager 战斗地图一致：建筑及其外一圈禁止部署，障碍物不可部署
+class SimField {
+public:
+    bool build(const SimRules& rules, int width, int length,
+               const std::vector<LayoutPiece>& pieces, std::string* error = nullptr);
+
+    int width() const { return _owners.width(); }
+    int length() const { return _owners.length(); }
+    const std::vector<SimBuilding>& buildings() const { return _buildings; }
+    int countedBuildings() const { return _countedBuildings; }
+
+    bool inBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width() && y < length(); }
+    // -1 空地，-2 障碍物，其余为 buildings() 下标
+    int ownerAt(int x, int y) const { return _owners.at(x, y); }
+    const FlatGrid<int>& owners() const { return _owners; }
+    bool isDeployAllowed(int x, int y) const;
+    // 离 (x, y) 最近的可部署格（按切比雪夫距离逐圈查找，同一圈内先行后列），找不到返回 false
+    bool nearestDeployable(int x, int y, int& outX, int& outY) const;
+    // 可部署且与禁区相邻的格子下标（y * width + x），即贴近基地的部署边缘
+    const std::vector<int>& deployEdge() const { return _deployEdge; }
+
+    static constexpr int kFree = -1;
+    static constexpr int kObstacle = -2;
+
+private:
+    std::vector<SimBuilding> _buildings;
+    FlatGrid<int> _owners;
+    GridBitset _noDeploy;
+    std::vector<int> _deployEdge;
+    int _countedBuildings = 0;
+};
+
+// 一次部署：time 秒时在地图坐标 (x, y) 放下一个 unit 兵种的士兵
+struct SimDeployment {
+    int unit = 0;
+    float x = 0.0f;
+    float y = 0.0f;
+    float time = 0.0f;
+};
+
+// 一次录制或规划得到的进攻：对不同布局重放同一组部署
+struct SimAttack {
+    std::string name;
+    std::vector<SimDeployment> deployments;
+};
+
+struct SimRunOptions {
+    // 全部部署完毕后连续这么久没有摧毁建筑即提前结束（士兵被卡住或只剩城墙可打），<= 0 不启用
+    float stallSeconds = 20.0f;
+};
+
+struct SimResult {
+    int stars = 0;
+    int destruction = 0;          // 破坏度百分比（不计城墙）
+    bool townHallDestroyed = false;
+    float duration = 0.0f;        // 战斗结束时刻（秒）
+    float threeStarTime = -1.0f;  // 达成三星的时刻，未达成为 -1
+    int deployed = 0;
+    int rejected = 0;             // 落在禁区被拒绝的部署数
+    int unitsLost = 0;
+    int housingLost = 0;          // 阵亡士兵的人口合计
+    bool cutOff = false;          // 因 stallSeconds 提前结束
+};
+
+// 一场战斗实际依赖的区域：移动的建筑在存活期间与这些区域无关时，这场战斗的过程不变，可以沿用旧结果。
+// 时间以步数计；同一步内的先后不区分（按可能受影响处理）
+struct SimInfluence {
+    static constexpr int kNever = 0x7fffffff;
+
+    // 士兵选目标：与所选目标同一档（偏好、是否城墙都相同）、左下角到 (x, y) 不超过 radius 的
+    // 存活建筑都可能改变选择；更高一档的建筑此时必然已被摧毁，更低一档的不会被选中
+    struct Choice {
+        float x;
+        float y;
+        float radius;
+        int tick;
+        SimTargetPreference preference;
+        bool preferred;
+        bool wall;
+    };
+
+    FlatGrid<int> firstRead;      // 每格第一次影响结果的步数：寻路检查、溅射范围、开火的防御建筑占位
+    FlatGrid<int> firstVisit;     // 每格第一次有士兵停留的步数：防御建筑移到射程能覆盖这里的位置就可能开火
+    GridBitset deployCells;       // 部署点所在格：建筑移动会改变外圈禁区
+    std::vector<Choice> choices;
+    std::vector<int> destroyedAt; // 每座建筑被摧毁的步数，存活到最后为 kNever
+
+    void reset(int width, int length, size_t buildings);
+    void read(int x, int y, int tick);
+    void readRect(int x, int y, int width, int length, int tick);
+    // 第 building 座建筑从 from 移到 to（同尺寸）是否可能改变这场战斗
+    bool affectedBy(int building, const SimBuilding& from, const SimBuilding& to, const SimBuildingStats& stats) const;
+};
+
+class HeadlessBattle {
+public:
+    explicit HeadlessBattle(const SimRules& rules) : _rules(rules) {}
+
+    // 从 field 的初始状态开始模拟一场战斗；工作数组在多次 run 之间复用。
+    // influence 非空时记录这场战斗依赖的区域（会稍微变慢）
+    SimResult run(const SimField& field, const std::vector<SimDeployment>& deployments,
+                  const SimRunOptions& options = SimRunOptions(), SimInfluence* influence = nullptr);
+
+private:
+    enum class UnitState { Idle, Moving, Attacking, Dead };
+    struct Unit {
+        int stats = 0;
+        float x = 0.0f;
+        float y = 0.0f;
+        int health = 0;
+        int target = -1;
+        UnitState state = UnitState::Idle;
+        float attackTimer = 0.0f;
+        std::vector<int> path;    // 格子下标，起点→终点
+        size_t pathStep = 0;      // 正在走向的路径点
+    };
+    struct Defense {
+        int building = -1;
+        float timer = 0.0f;
+        int target = -1;          // 士兵下标
+    };
+    struct OpenNode {
+        float f;
+        float g;
+        int tile;
+        bool operator>(const OpenNode& other) const { return f > other.f; }
+    };
+
+    void reset(const SimField& field);
+    void deploy(const SimDeployment& deployment, SimResult& result);
+    void chooseTarget(Unit& unit);
+    void planPath(Unit& unit);
+    bool findPath(const Unit& unit, int goalX, int goalY, bool avoidBuildings);
+    void updateUnit(Unit& unit, float dt, SimResult& result);
+    void updateDefenses(float dt, SimResult& result);
+    // 返回建筑是否被摧毁
+    bool damageBuilding(int building, int damage, SimResult& result);
+    void destroyBuilding(int building, SimResult& result);
+    void killUnit(Unit& unit, SimResult& result);
+    float breakCost(int building, const SimUnitStats& stats) const;
+
+    const SimRules& _rules;
+    const SimField* _field = nullptr;
+    SimInfluence* _influence = nullptr;
+    float _time = 0.0f;
+    int _tick = 0;
+    float _lastProgress = 0.0f;
+    int _destroyedCounted = 0;
+    int _liveUnits = 0;
+    bool _finished = false;
+
+    FlatGrid<int> _owners;
+    std::vector<int> _health;
+    std::vector<Defense> _defenses;
+    std::vector<Unit> _units;
+    size_t _unitCount = 0;        // _units 中本场使用的前缀，其余为复用的空槽
+    std::vector<int> _order;      // 部署按时间排序后的下标
+
+    // A* 工作区：按格子下标平铺，用搜索序号标记状态
+    std::vector<float> _gCost;
+    std::vector<int> _parent;
+    std::vector<uint32_t> _visited;
+    std::vector<uint32_t> _closed;
+    std::vector<OpenNode> _open;
+    std::vector<int> _pathBuffer;
+    std::vector<int> _examined;   // 记录依赖区域时：本次搜索检查过的可通行格子
+    uint32_t _searchSerial = 0;
+};
+
+#endif // __HEADLESS_BATTLE_H__
@@ -0,0 +1,210 @@
+#include "LayoutOptimizer.h"
+#include "JobSystem/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+// 每个分块连续模拟的场数：分块内复用同一个 HeadlessBattle 的工作数组
+const int kBattlesPerChunk = 4;
+}
+
+LayoutOptimizer::LayoutOptimizer(const SimRules& rules, int width, int length, const std::vector<SimAttack>& attacks)
+    : _rules(rules), _width(width), _length(length), _attacks(attacks) {
+}
+
+std::vector<OptimizedLayout> LayoutOptimizer::optimize(const std::vector<LayoutPiece>& initial,
+                                                       const LayoutOptimizerOptions& options) {
+    const auto begin = std::chrono::steady_clock::now();
+    _candidates = 0;
+    _simulatedBattles = 0;
+    _reusedBattles = 0;
+
+    std::vector<OptimizedLayout> accepted;
+    _current = Layout();
+    _current.pieces = initial;
+    if (_attacks.empty() || !compile(_current)) return accepted;
+    simulateAll(_current, options);
+
+    auto record = [&](int iteration) {
+        OptimizedLayout layout;
+        layout.pieces = _current.pieces;
+        layout.totalDestruction = _current.totalDestruction;
+        layout.totalStars = _current.totalStars;
+        layout.attackCount = static_cast<int>(_attacks.size());
+        layout.iteration = iteration;
+        accepted.push_back(std::move(layout));
+    };
+    record(0);
+
+    const int attackCount = static_cast<int>(_attacks.size());
+    const int batchSize = std::max(1, options.batchSize);
+    std::vector<Layout> batch(batchSize);
+    std::vector<int> jobs;
+    for (int iteration = 1; iteration <= options.iterations; ++iteration) {
+        // 1. 串行生成候选：每个候选的随机序列只由 (seed, 轮次, 序号) 决定
+        int candidateCount = 0;
+        for (int i = 0; i < batchSize; ++i) {
+            SimRandom random(SimRandom::mix(options.seed, static_cast<uint64_t>(iteration) * batchSize + i));
+            if (mutate(_current, random, options, batch[candidateCount])) ++candidateCount;
+        }
+        _candidates += candidateCount;
+
+        // 2. 只模拟受移动影响的 (候选, 进攻)，其余沿用当前布局的结果
+        jobs.clear();
+        for (int c = 0; c < candidateCount; ++c) {
+            batch[c].results = _current.results;
+            for (int a = 0; a < attackCount; ++a) {
+                if (needsRerun(batch[c], a)) jobs.push_back(c * attackCount + a);
+            }
+        }
+        auto job = [&](int jobBegin, int jobEnd) {
+            HeadlessBattle battle(_rules);
+            for (int i = jobBegin; i < jobEnd; ++i) {
+                Layout& candidate = batch[jobs[i] / attackCount];
+                const int attack = jobs[i] % attackCount;
+                candidate.results[attack] = battle.run(candidate.field, candidate.deployments[attack], options.run);
+            }
+        };
+        JobSystem::getInstance()->parallelFor(static_cast<int>(jobs.size()), kBattlesPerChunk, job);
+        _simulatedBattles += jobs.size();
+        _reusedBattles += static_cast<uint64_t>(candidateCount) * attackCount - jobs.size();
+
+        // 3. 取本轮最好的候选；不比当前差就接受（允许在同分布局间移动，跳出平台）
+        int best = -1;
+        for (int c = 0; c < candidateCount; ++c) {
+            total(batch[c]);
+            if (best < 0 || better(batch[c], batch[best])) best = c;
+        }
+        if (best < 0 || better(_current, batch[best])) continue;
+
+        const bool improved = better(batch[best], _current);
+        Layout previous = std::move(_current);
+        std::vector<SimInfluence> previousInfluences = _influences;
+        _current = std::move(batch[best]);
+        batch[best] = Layout();
+        simulateAll(_current, options);
+        if (better(previous, _current)) {
+            // 增量评估漏判时以精确结果为准，退回原布局
+            _current = std::move(previous);
+            _influences = std::move(previousInfluences);
+            continue;
+        }
+        if (improved) record(iteration);
+    }
+
+    std::stable_sort(accepted.begin(), accepted.end(), [](const OptimizedLayout& a, const OptimizedLayout& b) {
+        if (a.totalDestruction != b.totalDestruction) return a.totalDestruction < b.totalDestruction;
+        if (a.totalStars != b.totalStars) return a.totalStars < b.totalStars;
+        return a.iteration > b.iteration;
+    });
+    if (accepted.size() > static_cast<size_t>(std::max(1, options.topCount))) accepted.resize(std::max(1, options.topCount));
+
+    _elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return accepted;
+}
+
+bool LayoutOptimizer::compile(Layout& layout) const {
+    // 与战斗地图的摆放规则一致：不越界、不重叠，并且至少留有一格可以部署士兵
+    if (!layout.field.build(_rules, _width, _length, layout.pieces) || layout.field.deployEdge().empty()) {
+        return false;
+    }
+    snapDeployments(layout);
+    return true;
+}
+
+bool LayoutOptimizer::mutate(const Layout& parent, SimRandom& random, const LayoutOptimizerOptions& options,
+                             Layout& out) const {
+    std::vector<int> movable;
+    for (int i = 0; i < static_cast<int>(parent.pieces.size()); ++i) {
+        const auto& piece = parent.pieces[i];
+        if (piece.type == "Obstacle") continue;
+        const int stats = _rules.findBuilding(piece.type);
+        if (stats < 0 || (_rules.buildings[stats].isWall && !options.moveWalls)) continue;
+        movable.push_back(i);
+    }
+    if (movable.empty()) return false;
+
+    for (int attempt = 0; attempt < std::max(1, options.mutationAttempts); ++attempt) {
+        out.pieces = parent.pieces;
+        const int moves = 1 + random.nextInt(std::min(std::max(1, options.maxMovedBuildings), static_cast<int>(movable.size())));
+        for (int m = 0; m < moves; ++m) {
+            LayoutPiece& piece = out.pieces[movable[random.nextInt(static_cast<int>(movable.size()))]];
+            const auto& stats = _rules.buildings[_rules.findBuilding(piece.type)];
+            if (random.nextFloat(0.0f, 1.0f) < options.relocateChance) {
+                piece.x = random.nextInt(_width - stats.width + 1);
+                piece.y = random.nextInt(_length - stats.length + 1);
+            } else {
+                const int shift = std::max(1, options.maxShift);
+                piece.x += random.nextInt(2 * shift + 1) - shift;
+                piece.y += random.nextInt(2 * shift + 1) - shift;
+            }
+        }
+        if (compile(out)) return true;
+    }
+    return false;
+}
+
+void LayoutOptimizer::snapDeployments(Layout& layout) const {
+    layout.deployments.resize(_attacks.size());
+    for (size_t a = 0; a < _attacks.size(); ++a) {
+        auto& deployments = layout.deployments[a];
+        deployments = _attacks[a].deployments;
+        for (auto& deployment : deployments) {
+            const int x = static_cast<int>(std::floor(deployment.x));
+            const int y = static_cast<int>(std::floor(deployment.y));
+            int nx = x, ny = y;
+            if (layout.field.isDeployAllowed(x, y) || !layout.field.nearestDeployable(x, y, nx, ny)) continue;
+            // 保留格内偏移
+            deployment.x += static_cast<float>(nx - x);
+            deployment.y += static_cast<float>(ny - y);
+        }
+    }
+}
+
+bool LayoutOptimizer::needsRerun(const Layout& candidate, int attack) const {
+    const auto& before = _current.deployments[attack];
+    const auto& after = candidate.deployments[attack];
+    for (size_t i = 0; i < before.size(); ++i) {
+        if (before[i].x != after[i].x || before[i].y != after[i].y) return true;
+    }
+
+    const auto& oldBuildings = _current.field.buildings();
+    const auto& newBuildings = candidate.field.buildings();
+    const SimInfluence& influence = _influences[attack];
+    for (size_t b = 0; b < oldBuildings.size(); ++b) {
+        if (oldBuildings[b].x == newBuildings[b].x && oldBuildings[b].y == newBuildings[b].y) continue;
+        if (influence.affectedBy(static_cast<int>(b), oldBuildings[b], newBuildings[b], _rules.buildings[oldBuildings[b].stats])) return true;
+    }
+    return false;
+}
+
+void LayoutOptimizer::simulateAll(Layout& layout, const LayoutOptimizerOptions& options) {
+    const int attackCount = static_cast<int>(_attacks.size());
+    layout.results.resize(attackCount);
+    _influences.resize(attackCount);
+    auto job = [&](int begin, int end) {
+        HeadlessBattle battle(_rules);
+        for (int a = begin; a < end; ++a) {
+            layout.results[a] = battle.run(layout.field, layout.deployments[a], options.run, &_influences[a]);
+        }
+    };
+    JobSystem::getInstance()->parallelFor(attackCount, kBattlesPerChunk, job);
+    _simulatedBattles += attackCount;
+    total(layout);
+}
+
+void LayoutOptimizer::total(Layout& layout) const {
+    layout.totalDestruction = 0;
+    layout.totalStars = 0;
+    for (const auto& result : layout.results) {
+        layout.totalDestruction += result.destruction;
+        layout.totalStars += result.stars;
+    }
+}
+
+bool LayoutOptimizer::better(const Layout& a, const Layout& b) {
+    // 平均破坏度优先，其次平均星数（进攻数相同，直接比总和）
+    if (a.totalDestruction != b.totalDestruction) return a.totalDestruction < b.totalDestruction;
+    return a.totalStars < b.totalStars;
+}
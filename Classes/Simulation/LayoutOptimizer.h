@@ -0,0 +1,85 @@
+#pragma once
+#ifndef __LAYOUT_OPTIMIZER_H__
+#define __LAYOUT_OPTIMIZER_H__
+
+#include "HeadlessBattle.h"
+#include <cstdint>
+#include <vector>
+
+struct OptimizedLayout {
+    std::vector<LayoutPiece> pieces;
+    int totalDestruction = 0;         // 全部进攻的破坏度之和
+    int totalStars = 0;
+    int attackCount = 0;
+    int iteration = 0;                // 第几轮被接受，0 为初始布局
+
+    double averageDestruction() const { return attackCount ? static_cast<double>(totalDestruction) / attackCount : 0.0; }
+    double averageStars() const { return attackCount ? static_cast<double>(totalStars) / attackCount : 0.0; }
+};
+
+struct LayoutOptimizerOptions {
+    int iterations = 200;             // 轮数：每轮从当前布局变异出 batchSize 个候选
+    int batchSize = 64;
+    int maxMovedBuildings = 2;        // 每个候选移动 1..maxMovedBuildings 座建筑
+    int maxShift = 3;                 // 平移的最大格数
+    float relocateChance = 0.2f;      // 改为随机搬到地图任意位置的概率
+    bool moveWalls = false;
+    int mutationAttempts = 20;        // 变异结果不合法（越界、重叠、无处部署）时的重试次数
+    int topCount = 3;                 // 返回的布局数
+    uint64_t seed = 1;
+    SimRunOptions run;
+};
+
+// 基地布局优化：
+// 爬山搜索——每轮随机移动少量建筑（不越界、不重叠、保留可部署区域，与战斗地图摆放规则一致），
+// 用固定的进攻集合对每个候选做无渲染模拟，接受平均破坏度不升高的最好候选。
+// 增量评估：当前布局的每场战斗记录了依赖区域（SimInfluence），候选只重新模拟
+// 被移动建筑新旧位置影响到的进攻，其余沿用当前结果；接受前整套重新模拟并以精确结果为准。
+// 候选的生成与模拟顺序无关，结果与线程数无关
+class LayoutOptimizer {
+public:
+    LayoutOptimizer(const SimRules& rules, int width, int length, const std::vector<SimAttack>& attacks);
+
+    // initial 不是合法布局或没有进攻时返回空；否则按平均破坏度从低到高返回
+    std::vector<OptimizedLayout> optimize(const std::vector<LayoutPiece>& initial,
+                                          const LayoutOptimizerOptions& options);
+
+    uint64_t getCandidates() const { return _candidates; }
+    uint64_t getSimulatedBattles() const { return _simulatedBattles; }
+    uint64_t getReusedBattles() const { return _reusedBattles; }
+    double getElapsedSeconds() const { return _elapsedSeconds; }
+
+private:
+    struct Layout {
+        std::vector<LayoutPiece> pieces;
+        SimField field;
+        std::vector<std::vector<SimDeployment>> deployments;  // 按本布局吸附到可部署格后的部署
+        std::vector<SimResult> results;
+        int totalDestruction = 0;
+        int totalStars = 0;
+    };
+
+    bool compile(Layout& layout) const;
+    bool mutate(const Layout& parent, SimRandom& random, const LayoutOptimizerOptions& options, Layout& out) const;
+    // 落在禁区的部署点移到最近的可部署格：玩家面对新布局也会就近部署，而不是放弃这些兵
+    void snapDeployments(Layout& layout) const;
+    bool needsRerun(const Layout& candidate, int attack) const;
+    // 精确模拟全部进攻并记录依赖区域，成为新的当前布局
+    void simulateAll(Layout& layout, const LayoutOptimizerOptions& options);
+    void total(Layout& layout) const;
+    static bool better(const Layout& a, const Layout& b);
+
+    const SimRules& _rules;
+    const int _width;
+    const int _length;
+    const std::vector<SimAttack>& _attacks;
+    std::vector<SimInfluence> _influences;     // 当前布局每场进攻的依赖区域
+    Layout _current;
+
+    uint64_t _candidates = 0;
+    uint64_t _simulatedBattles = 0;
+    uint64_t _reusedBattles = 0;
+    double _elapsedSeconds = 0.0;
+};
+
+#endif // __LAYOUT_OPTIMIZER_H__
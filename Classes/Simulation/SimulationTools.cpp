@@ -0,0 +1,427 @@
+#include "SimulationTools.h"
+#include "AttackPlanner.h"
+#include "BalanceSweep.h"
+#include "LayoutOptimizer.h"
+#include "JobSystem/JobSystem.h"
+#include "TownHall/TownHall.h"
+#include "UIManager/UIManager.h"
+#include "cocos2d.h"
+#include "json/document.h"
+#include "json/writer.h"
+#include "json/stringbuffer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+USING_NS_CC;
+
+SimRules SimulationTools::rulesFromGameTemplates() {
+    SimRules rules = SimRules::defaults();
+
+    for (const auto& tmpl : TownHall::GetSoldierTemplates()) {
+        const int index = rules.findUnit(tmpl.name_);
+        if (index < 0) continue;
+        auto& unit = rules.units[index];
+        if (tmpl.get_health_func_) unit.health = tmpl.get_health_func_();
+        if (tmpl.get_damage_func_) unit.damage = tmpl.get_damage_func_();
+        if (tmpl.get_move_speed_func_) unit.moveSpeed = tmpl.get_move_speed_func_();
+        if (tmpl.get_attack_range_func_) unit.attackRange = tmpl.get_attack_range_func_();
+        if (tmpl.get_attack_delay_func_) unit.attackDelay = tmpl.get_attack_delay_func_();
+        unit.housingSpace = tmpl.housing_space_;
+    }
+
+    for (const auto& tmpl : TownHall::GetAllBuildingTemplates()) {
+        const int index = rules.findBuilding(tmpl.name_);
+        if (index < 0) continue;
+        auto& building = rules.buildings[index];
+        building.width = tmpl.width_;
+        building.length = tmpl.length_;
+        // 只实例化防御建筑：其余模板的工厂函数会向 TownHall 登记资源建筑
+        if (!building.isDefense || !tmpl.createFunc) continue;
+        auto attack = dynamic_cast<AttackBuilding*>(tmpl.createFunc());
+        if (!attack || attack->GetDefense() <= 0) continue;
+        building.base = attack->GetDefense();
+        building.healthFactor = attack->GetHealth() / attack->GetDefense();
+        building.attackInterval = attack->attack_interval_;
+        building.attackDamage = attack->attack_damage_;
+        building.attackRange = attack->attack_range_;
+    }
+    return rules;
+}
+
+bool SimulationTools::loadLayoutFile(const std::string& file, std::vector<LayoutPiece>& pieces) {
+    std::string content = FileUtils::getInstance()->getStringFromFile(file);
+    if (content.empty()) {
+        CCLOG("SimulationTools: cannot read %s", file.c_str());
+        return false;
+    }
+    rapidjson::Document doc;
+    doc.Parse(content.c_str());
+    if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("map_layout")) {
+        CCLOG("SimulationTools: %s has no map_layout", file.c_str());
+        return false;
+    }
+    return LayoutValidator::parseLayout(doc["map_layout"], pieces);
+}
+
+bool SimulationTools::loadAttackSuite(const std::string& file, const SimRules& rules, std::vector<SimAttack>& attacks) {
+    std::string content = readFile(file);
+    if (content.empty()) {
+        CCLOG("SimulationTools: cannot read %s", file.c_str());
+        return false;
+    }
+    rapidjson::Document doc;
+    doc.Parse(content.c_str());
+    if (doc.HasParseError() || !doc.IsObject()) {
+        CCLOG("SimulationTools: %s is not a json object", file.c_str());
+        return false;
+    }
+
+    // 规划结果的坐标是格子，部署在格子中心
+    const bool plans = doc.HasMember("plans");
+    const char* key = plans ? "plans" : "attacks";
+    if (!doc.HasMember(key) || !doc[key].IsArray()) {
+        CCLOG("SimulationTools: %s has no %s", file.c_str(), key);
+        return false;
+    }
+    const float offset = plans ? 0.5f : 0.0f;
+    const auto& entries = doc[key];
+    for (rapidjson::SizeType i = 0; i < entries.Size(); i++) {
+        const auto& entry = entries[i];
+        if (!entry.IsObject() || !entry.HasMember("deployments") || !entry["deployments"].IsArray()) continue;
+        SimAttack attack;
+        attack.name = std::string(plans ? "plan " : "attack ") + std::to_string(i);
+        const auto& deployments = entry["deployments"];
+        for (rapidjson::SizeType j = 0; j < deployments.Size(); j++) {
+            const auto& d = deployments[j];
+            if (!d.IsObject() || !d.HasMember("unit") || !d["unit"].IsString() ||
+                !d.HasMember("x") || !d["x"].IsNumber() || !d.HasMember("y") || !d["y"].IsNumber()) continue;
+            const int unit = rules.findUnit(d["unit"].GetString());
+            if (unit < 0) continue;
+            SimDeployment deployment;
+            deployment.unit = unit;
+            deployment.x = d["x"].GetFloat() + offset;
+            deployment.y = d["y"].GetFloat() + offset;
+            deployment.time = d.HasMember("time") && d["time"].IsNumber() ? d["time"].GetFloat() : 0.0f;
+            const int count = d.HasMember("count") && d["count"].IsInt() ? d["count"].GetInt() : 1;
+            for (int c = 0; c < count; ++c) attack.deployments.push_back(deployment);
+        }
+        if (!attack.deployments.empty()) attacks.push_back(std::move(attack));
+    }
+    return !attacks.empty();
+}
+
+void SimulationTools::recordAttack(const std::vector<ReplayStep>& steps, int stars, int destruction) {
+    const char* suiteFile = std::getenv("TJ_RECORD_ATTACKS");
+    if (!suiteFile || steps.empty()) return;
+
+    // 追加到已有文件；文件不存在或损坏时重新开始
+    rapidjson::Document doc;
+    std::string content = FileUtils::getInstance()->getStringFromFile(
+        FileUtils::getInstance()->getWritablePath() + suiteFile);
+    if (!content.empty()) doc.Parse(content.c_str());
+    if (content.empty() || doc.HasParseError() || !doc.IsObject()) doc.SetObject();
+    auto& allocator = doc.GetAllocator();
+    if (!doc.HasMember("attacks") || !doc["attacks"].IsArray()) {
+        doc.RemoveMember("attacks");
+        doc.AddMember("attacks", rapidjson::Value(rapidjson::kArrayType), allocator);
+    }
+
+    rapidjson::Value attack(rapidjson::kObjectType);
+    attack.AddMember("stars", stars, allocator);
+    attack.AddMember("destruction", destruction, allocator);
+    rapidjson::Value deployments(rapidjson::kArrayType);
+    for (const auto& step : steps) {
+        rapidjson::Value deployment(rapidjson::kObjectType);
+        deployment.AddMember("unit", rapidjson::Value(step.troopName.c_str(), allocator), allocator);
+        deployment.AddMember("x", step.pos.x, allocator);
+        deployment.AddMember("y", step.pos.y, allocator);
+        deployment.AddMember("time", step.time, allocator);
+        deployments.PushBack(deployment, allocator);
+    }
+    attack.AddMember("deployments", deployments, allocator);
+    doc["attacks"].PushBack(attack, allocator);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+    writeFile(suiteFile, buffer.GetString());
+    CCLOG("SimulationTools: recorded attack #%u to %s", doc["attacks"].Size(), suiteFile);
+}
+
+void SimulationTools::startOfflineWorkers() {
+    int workers = JobSystem::workerCountFromEnvironment();
+    if (workers < 0) {
+        // 离线工具没有渲染线程要让路，调用线程之外的核全部用上
+        workers = std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    JobSystem::getInstance()->start(workers);
+}
+
+std::string SimulationTools::readFile(const std::string& file) {
+    auto fileUtils = FileUtils::getInstance();
+    std::string content = fileUtils->getStringFromFile(file);
+    if (content.empty()) content = fileUtils->getStringFromFile(fileUtils->getWritablePath() + file);
+    return content;
+}
+
+std::string SimulationTools::writeFile(const std::string& fileName, const std::string& content) {
+    std::string fullPath = FileUtils::getInstance()->getWritablePath() + fileName;
+    if (!FileUtils::getInstance()->writeStringToFile(content, fullPath)) {
+        CCLOG("SimulationTools: failed to write %s", fullPath.c_str());
+        return "";
+    }
+    return fullPath;
+}
+
+bool SimulationTools::runAttackPlannerFromEnvironment() {
+    const char* layoutFile = std::getenv("TJ_PLAN_ATTACK");
+    if (!layoutFile) return false;
+
+    AttackPlanOptions options;
+    if (const char* army = std::getenv("TJ_PLAN_ARMY")) {
+        options.armyCapacity = std::max(1, std::atoi(army));
+    }
+    if (const char* candidates = std::getenv("TJ_PLAN_CANDIDATES")) {
+        options.candidates = std::max(1, std::atoi(candidates));
+    }
+    if (const char* seed = std::getenv("TJ_PLAN_SEED")) {
+        options.seed = std::strtoull(seed, nullptr, 10);
+    }
+
+    std::vector<LayoutPiece> pieces;
+    SimRules rules = rulesFromGameTemplates();
+    SimField field;
+    std::string error;
+    if (!loadLayoutFile(layoutFile, pieces) ||
+        !field.build(rules, kBattleMapWidth, kBattleMapLength, pieces, &error)) {
+        CCLOG("AttackPlanner: invalid layout %s %s", layoutFile, error.c_str());
+        return true;
+    }
+
+    startOfflineWorkers();
+    AttackPlanner planner(rules, field);
+    const auto plans = planner.plan(options);
+    const double seconds = planner.getElapsedSeconds();
+
+    rapidjson::Document doc;
+    doc.SetObject();
+    auto& allocator = doc.GetAllocator();
+    doc.AddMember("layout", rapidjson::Value(layoutFile, allocator), allocator);
+    doc.AddMember("army_capacity", options.armyCapacity, allocator);
+    doc.AddMember("seed", static_cast<uint64_t>(options.seed), allocator);
+    doc.AddMember("workers", JobSystem::getInstance()->getWorkerCount(), allocator);
+    doc.AddMember("battles", static_cast<uint64_t>(planner.getSimulatedBattles()), allocator);
+    doc.AddMember("seconds", seconds, allocator);
+    doc.AddMember("battles_per_minute", seconds > 0.0 ? planner.getSimulatedBattles() * 60.0 / seconds : 0.0, allocator);
+
+    rapidjson::Value plansJson(rapidjson::kArrayType);
+    for (const auto& plan : plans) {
+        rapidjson::Value planJson(rapidjson::kObjectType);
+        planJson.AddMember("expected_stars", plan.expectedStars(), allocator);
+        planJson.AddMember("expected_destruction", plan.expectedDestruction(), allocator);
+        planJson.AddMember("three_star_rate", plan.threeStarRate(), allocator);
+        planJson.AddMember("trials", plan.trials, allocator);
+        rapidjson::Value groups(rapidjson::kArrayType);
+        for (const auto& group : plan.groups) {
+            rapidjson::Value groupJson(rapidjson::kObjectType);
+            groupJson.AddMember("unit", rapidjson::Value(rules.units[group.unit].name.c_str(), allocator), allocator);
+            groupJson.AddMember("count", group.count, allocator);
+            groupJson.AddMember("x", group.x, allocator);
+            groupJson.AddMember("y", group.y, allocator);
+            groupJson.AddMember("time", group.time, allocator);
+            groups.PushBack(groupJson, allocator);
+        }
+        planJson.AddMember("deployments", groups, allocator);
+        plansJson.PushBack(planJson, allocator);
+    }
+    doc.AddMember("plans", plansJson, allocator);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+    CCLOG("AttackPlanner: %llu battles in %.2fs", static_cast<unsigned long long>(planner.getSimulatedBattles()), seconds);
+    writeFile("attack_plans.json", buffer.GetString());
+    return true;
+}
+
+bool SimulationTools::runLayoutOptimizerFromEnvironment() {
+    const char* layoutFile = std::getenv("TJ_OPTIMIZE_LAYOUT");
+    if (!layoutFile) return false;
+    const char* attackFile = std::getenv("TJ_OPTIMIZE_ATTACKS");
+    if (!attackFile) attackFile = "attack_suite.json";
+
+    LayoutOptimizerOptions options;
+    if (const char* iterations = std::getenv("TJ_OPTIMIZE_ITERATIONS")) {
+        options.iterations = std::max(0, std::atoi(iterations));
+    }
+    if (const char* seed = std::getenv("TJ_OPTIMIZE_SEED")) {
+        options.seed = std::strtoull(seed, nullptr, 10);
+    }
+
+    std::vector<LayoutPiece> pieces;
+    std::vector<SimAttack> attacks;
+    SimRules rules = rulesFromGameTemplates();
+    SimField field;
+    std::string error;
+    if (!loadLayoutFile(layoutFile, pieces) ||
+        !field.build(rules, kBattleMapWidth, kBattleMapLength, pieces, &error)) {
+        CCLOG("LayoutOptimizer: invalid layout %s %s", layoutFile, error.c_str());
+        return true;
+    }
+    if (!loadAttackSuite(attackFile, rules, attacks)) {
+        CCLOG("LayoutOptimizer: no attacks in %s", attackFile);
+        return true;
+    }
+
+    startOfflineWorkers();
+    LayoutOptimizer optimizer(rules, kBattleMapWidth, kBattleMapLength, attacks);
+    const auto layouts = optimizer.optimize(pieces, options);
+    const double seconds = optimizer.getElapsedSeconds();
+
+    rapidjson::Document doc;
+    doc.SetObject();
+    auto& allocator = doc.GetAllocator();
+    doc.AddMember("layout", rapidjson::Value(layoutFile, allocator), allocator);
+    doc.AddMember("attacks", rapidjson::Value(attackFile, allocator), allocator);
+    doc.AddMember("attack_count", static_cast<int>(attacks.size()), allocator);
+    doc.AddMember("seed", static_cast<uint64_t>(options.seed), allocator);
+    doc.AddMember("workers", JobSystem::getInstance()->getWorkerCount(), allocator);
+    doc.AddMember("candidates", static_cast<uint64_t>(optimizer.getCandidates()), allocator);
+    doc.AddMember("battles", static_cast<uint64_t>(optimizer.getSimulatedBattles()), allocator);
+    doc.AddMember("reused_battles", static_cast<uint64_t>(optimizer.getReusedBattles()), allocator);
+    doc.AddMember("seconds", seconds, allocator);
+
+    rapidjson::Value layoutsJson(rapidjson::kArrayType);
+    for (const auto& layout : layouts) {
+        rapidjson::Value layoutJson(rapidjson::kObjectType);
+        layoutJson.AddMember("average_destruction", layout.averageDestruction(), allocator);
+        layoutJson.AddMember("average_stars", layout.averageStars(), allocator);
+        layoutJson.AddMember("iteration", layout.iteration, allocator);
+        // 与 battle_field*.json 相同的 map_layout 格式，可以直接替换关卡布局
+        rapidjson::Value buildings(rapidjson::kArrayType);
+        rapidjson::Value obstacles(rapidjson::kArrayType);
+        for (const auto& piece : layout.pieces) {
+            rapidjson::Value pieceJson(rapidjson::kObjectType);
+            if (piece.type != "Obstacle") {
+                pieceJson.AddMember("type", rapidjson::Value(piece.type.c_str(), allocator), allocator);
+            }
+            pieceJson.AddMember("x", piece.x, allocator);
+            pieceJson.AddMember("y", piece.y, allocator);
+            if (piece.type == "Obstacle") {
+                obstacles.PushBack(pieceJson, allocator);
+            } else {
+                pieceJson.AddMember("level", piece.level, allocator);
+                buildings.PushBack(pieceJson, allocator);
+            }
+        }
+        rapidjson::Value mapLayout(rapidjson::kObjectType);
+        mapLayout.AddMember("buildings", buildings, allocator);
+        mapLayout.AddMember("obstacles", obstacles, allocator);
+        layoutJson.AddMember("map_layout", mapLayout, allocator);
+        layoutsJson.PushBack(layoutJson, allocator);
+    }
+    doc.AddMember("layouts", layoutsJson, allocator);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+    CCLOG("LayoutOptimizer: %llu candidates, %llu battles (%llu reused) in %.2fs",
+          static_cast<unsigned long long>(optimizer.getCandidates()),
+          static_cast<unsigned long long>(optimizer.getSimulatedBattles()),
+          static_cast<unsigned long long>(optimizer.getReusedBattles()), seconds);
+    writeFile("optimized_layouts.json", buffer.GetString());
+    return true;
+}
+
+bool SimulationTools::runBalanceSweepFromEnvironment() {
+    const char* gridFile = std::getenv("TJ_BALANCE_SWEEP");
+    if (!gridFile) return false;
+
+    std::string content = readFile(gridFile);
+    rapidjson::Document grid;
+    if (!content.empty()) grid.Parse(content.c_str());
+    if (content.empty() || grid.HasParseError() || !grid.IsObject() ||
+        !grid.HasMember("layouts") || !grid["layouts"].IsArray() ||
+        !grid.HasMember("parameters") || !grid["parameters"].IsArray()) {
+        CCLOG("BalanceSweep: %s needs layouts and parameters", gridFile);
+        return true;
+    }
+
+    BalanceSweepOptions options;
+    options.width = kBattleMapWidth;
+    options.length = kBattleMapLength;
+    if (grid.HasMember("trials") && grid["trials"].IsInt()) options.trials = std::max(1, grid["trials"].GetInt());
+    if (grid.HasMember("seed") && grid["seed"].IsUint64()) options.seed = grid["seed"].GetUint64();
+    const auto& parametersJson = grid["parameters"];
+    for (rapidjson::SizeType i = 0; i < parametersJson.Size(); i++) {
+        const auto& p = parametersJson[i];
+        if (!p.IsObject() || !p.HasMember("target") || !p["target"].IsString() ||
+            !p.HasMember("stat") || !p["stat"].IsString() || !p.HasMember("values") || !p["values"].IsArray()) {
+            CCLOG("BalanceSweep: parameter %u needs target, stat and values", i);
+            return true;
+        }
+        BalanceParameter parameter;
+        parameter.target = p["target"].GetString();
+        parameter.stat = p["stat"].GetString();
+        for (const auto& value : p["values"].GetArray()) {
+            if (value.IsNumber()) parameter.values.push_back(value.GetFloat());
+        }
+        options.parameters.push_back(std::move(parameter));
+    }
+
+    SimRules rules = rulesFromGameTemplates();
+    std::vector<BalanceLayout> layouts;
+    for (const auto& layoutJson : grid["layouts"].GetArray()) {
+        if (!layoutJson.IsString()) continue;
+        BalanceLayout layout;
+        layout.name = layoutJson.GetString();
+        if (!loadLayoutFile(layout.name, layout.pieces)) return true;
+        layouts.push_back(std::move(layout));
+    }
+    std::vector<SimAttack> attacks;
+    const char* attackFile = grid.HasMember("attacks") && grid["attacks"].IsString()
+                           ? grid["attacks"].GetString() : "attack_suite.json";
+    if (!loadAttackSuite(attackFile, rules, attacks)) {
+        CCLOG("BalanceSweep: no attacks in %s", attackFile);
+        return true;
+    }
+
+    // 上次的扰动种子：同一个 布局|进攻|试验 沿用同一个种子
+    BalanceSweep sweep(rules, layouts, attacks);
+    const std::string seedFile = "balance_seeds.json";
+    std::map<std::string, uint64_t> seeds;
+    rapidjson::Document seedDoc;
+    std::string seedContent = FileUtils::getInstance()->getStringFromFile(FileUtils::getInstance()->getWritablePath() + seedFile);
+    if (!seedContent.empty()) seedDoc.Parse(seedContent.c_str());
+    if (!seedContent.empty() && !seedDoc.HasParseError() && seedDoc.IsObject()) {
+        for (auto it = seedDoc.MemberBegin(); it != seedDoc.MemberEnd(); ++it) {
+            if (it->value.IsUint64()) seeds[it->name.GetString()] = it->value.GetUint64();
+        }
+    }
+    sweep.setSeeds(seeds);
+
+    startOfflineWorkers();
+    std::vector<BalanceRow> rows;
+    std::string error;
+    if (!sweep.run(options, rows, &error)) {
+        CCLOG("BalanceSweep: %s", error.c_str());
+        return true;
+    }
+
+    rapidjson::Document seedOut;
+    seedOut.SetObject();
+    auto& allocator = seedOut.GetAllocator();
+    for (const auto& seed : sweep.getSeeds()) {
+        seedOut.AddMember(rapidjson::Value(seed.first.c_str(), allocator), rapidjson::Value(seed.second), allocator);
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    seedOut.Accept(writer);
+    writeFile(seedFile, buffer.GetString());
+
+    CCLOG("BalanceSweep: %zu rows, %llu battles in %.2fs", rows.size(),
+          static_cast<unsigned long long>(sweep.getSimulatedBattles()), sweep.getElapsedSeconds());
+    writeFile("balance_sweep.csv", sweep.toCsv(rows, options));
+    return true;
+}
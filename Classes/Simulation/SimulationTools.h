@@ -0,0 +1,61 @@
+#pragma once
+#ifndef __SIMULATION_TOOLS_H__
+#define __SIMULATION_TOOLS_H__
+
+#include "HeadlessBattle.h"
+#include <string>
+#include <vector>
+
+struct ReplayStep;
+
+// 离线模拟工具的入口：与压力测试模式相同，由环境变量启动，写出结果到可写目录后退出。
+// 这里负责读写文件和从游戏模板取数值，模拟本身在 HeadlessBattle / AttackPlanner 中完成
+class SimulationTools {
+public:
+    // 战斗地图尺寸（与 BattleScene 一致）
+    static constexpr int kBattleMapWidth = 30;
+    static constexpr int kBattleMapLength = 30;
+
+    // 以 SimRules::defaults 为底，兵种数值取自 TownHall::GetSoldierTemplates，
+    // 防御建筑的血量与攻击参数取自 TownHall::GetAllBuildingTemplates 创建的实例
+    static SimRules rulesFromGameTemplates();
+
+    // 读取 battle_field*.json 的 map_layout
+    static bool loadLayoutFile(const std::string& file, std::vector<LayoutPiece>& pieces);
+
+    // 读取进攻集合：录制文件（{"attacks":[{"deployments":[{unit,x,y,time}]}]}，x、y 为地图坐标）
+    // 或 attack_plans.json（{"plans":[{"deployments":[{unit,count,x,y,time}]}]}，x、y 为格子）；
+    // 先按资源路径查找，找不到再到可写目录查找，未知兵种的部署被跳过
+    static bool loadAttackSuite(const std::string& file, const SimRules& rules, std::vector<SimAttack>& attacks);
+
+    // 设置 TJ_RECORD_ATTACKS=attack_suite.json 时，把本场（非回放）的部署追加到可写目录下的这个文件，
+    // 作为布局优化的进攻集合
+    static void recordAttack(const std::vector<ReplayStep>& steps, int stars, int destruction);
+
+    // 离线工具按全部 CPU 核启动 JobSystem（TJ_JOB_THREADS 优先）
+    static void startOfflineWorkers();
+
+    // 进攻规划：TJ_PLAN_ATTACK=battle_field1.json 启动，可选 TJ_PLAN_ARMY（人口）、
+    // TJ_PLAN_CANDIDATES（候选方案数）、TJ_PLAN_SEED；写出 attack_plans.json。
+    // 未设置 TJ_PLAN_ATTACK 时返回 false
+    static bool runAttackPlannerFromEnvironment();
+
+    // 布局优化：TJ_OPTIMIZE_LAYOUT=battle_field1.json 与 TJ_OPTIMIZE_ATTACKS=attack_suite.json 启动，
+    // 可选 TJ_OPTIMIZE_ITERATIONS（轮数）、TJ_OPTIMIZE_SEED；写出 optimized_layouts.json。
+    // 未设置 TJ_OPTIMIZE_LAYOUT 时返回 false
+    static bool runLayoutOptimizerFromEnvironment();
+
+    // 数值平衡扫描：TJ_BALANCE_SWEEP=balance_grid.json 启动，网格文件格式：
+    // {"layouts":["battle_field1.json"], "attacks":"attack_suite.json", "trials":3, "seed":1,
+    //  "parameters":[{"target":"Barbarian","stat":"health","values":[40,50,60]}, ...]}
+    // 写出 balance_sweep.csv；扰动种子缓存在 balance_seeds.json，再次运行时沿用。
+    // 未设置 TJ_BALANCE_SWEEP 时返回 false
+    static bool runBalanceSweepFromEnvironment();
+
+private:
+    // 先按资源路径查找，找不到再到可写目录查找
+    static std::string readFile(const std::string& file);
+    static std::string writeFile(const std::string& fileName, const std::string& content);
+};
+
+#endif // __SIMULATION_TOOLS_H__
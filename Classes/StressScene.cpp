@@ -0,0 +1,327 @@
+#include "StressScene.h"
+#include "MapManager/MapManager.h"
+#include "TownHall/TownHall.h"
+#include "Combat/Combat.h"
+#include "Combat/CombatEntityPool.h"
+#include "Profiler/GameProfiler.h"
+#include "json/writer.h"
+#include "json/stringbuffer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_IOS
+#include <sys/resource.h>
+#endif
+
+using namespace cocos2d;
+
+namespace {
+const int kMapSize = 30;             // 与 BattleScene 的战斗地图尺寸一致
+const int kOuterWallInset = 3;       // 外圈城墙距地图边缘的格数（外侧留出部署区）
+const int kInnerWallInset = 9;       // 内圈城墙
+const int kWaveSize = 8;             // 每波部署的士兵数
+const float kWaveInterval = 0.1f;    // 波次间隔（秒）
+const int kTypeCount = static_cast<int>(SoldierType::kSoldierTypes);
+
+float percentile(std::vector<float> values, float q) {
+    if (values.empty()) return 0.0f;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(q * (values.size() - 1) + 0.5f);
+    return values[std::min(index, values.size() - 1)];
+}
+}
+
+bool StressConfig::fromEnvironment(StressConfig& config) {
+    const char* troops = std::getenv("TJ_STRESS_TROOPS");
+    if (!troops) return false;
+    config.troopsPerType = std::max(1, std::atoi(troops));
+    if (const char* seconds = std::getenv("TJ_STRESS_SECONDS")) {
+        config.maxSeconds = std::max(1.0f, static_cast<float>(std::atof(seconds)));
+    }
+    if (const char* gpu = std::getenv("TJ_STRESS_GPU")) {
+        config.useUnitRenderer = std::atoi(gpu) != 0;
+    }
+    config.exitWhenDone = true;
+    return true;
+}
+
+void StressScene::generateBaseLayout(int width, int length, rapidjson::Document& doc) {
+    doc.SetObject();
+    auto& allocator = doc.GetAllocator();
+    rapidjson::Value buildings(rapidjson::kArrayType);
+    std::vector<std::vector<bool>> occupied(width, std::vector<bool>(length, false));
+
+    auto addBuilding = [&](const std::string& type, int x, int y, int w, int l) {
+        for (int i = x; i < x + w; ++i) {
+            for (int j = y; j < y + l; ++j) occupied[i][j] = true;
+        }
+        rapidjson::Value b(rapidjson::kObjectType);
+        b.AddMember("type", rapidjson::Value(type.c_str(), allocator), allocator);
+        b.AddMember("x", x, allocator);
+        b.AddMember("y", y, allocator);
+        b.AddMember("level", 1, allocator);
+        buildings.PushBack(b, allocator);
+    };
+    auto isFree = [&](int x, int y, int w, int l, int lo, int hi) {
+        if (x < lo || y < lo || x + w - 1 > hi || y + l - 1 > hi) return false;
+        for (int i = x; i < x + w; ++i) {
+            for (int j = y; j < y + l; ++j) {
+                if (occupied[i][j]) return false;
+            }
+        }
+        return true;
+    };
+
+    auto templates = TownHall::GetAllBuildingTemplates();
+
+    // 1. 两圈闭合城墙
+    for (int inset : {kOuterWallInset, kInnerWallInset}) {
+        int lo = inset, hi = std::min(width, length) - 1 - inset;
+        for (int i = lo; i <= hi; ++i) {
+            addBuilding("Wall", i, lo, 1, 1);
+            addBuilding("Wall", i, hi, 1, 1);
+            if (i != lo && i != hi) {
+                addBuilding("Wall", lo, i, 1, 1);
+                addBuilding("Wall", hi, i, 1, 1);
+            }
+        }
+    }
+
+    // 2. 大本营放在中心，其余建筑类型轮流首次适配填满城墙内的空地，直到一整轮都放不下
+    int lo = kOuterWallInset + 1, hi = std::min(width, length) - 2 - kOuterWallInset;
+    std::vector<const TownHall::BuildingTemplate*> fillers;
+    for (const auto& t : templates) {
+        if (t.name_ == "TownHall") {
+            addBuilding(t.name_, (width - t.width_) / 2, (length - t.length_) / 2, t.width_, t.length_);
+        } else if (t.name_ != "Wall") {
+            fillers.push_back(&t);
+        }
+    }
+    size_t next = 0;
+    int failures = 0;
+    while (!fillers.empty() && failures < static_cast<int>(fillers.size())) {
+        const auto* t = fillers[next];
+        next = (next + 1) % fillers.size();
+        bool placed = false;
+        for (int y = lo; y <= hi && !placed; ++y) {
+            for (int x = lo; x <= hi && !placed; ++x) {
+                if (isFree(x, y, t->width_, t->length_, lo, hi)) {
+                    addBuilding(t->name_, x, y, t->width_, t->length_);
+                    placed = true;
+                }
+            }
+        }
+        failures = placed ? 0 : failures + 1;
+    }
+
+    doc.AddMember("buildings", buildings, allocator);
+    doc.AddMember("obstacles", rapidjson::Value(rapidjson::kArrayType), allocator);
+}
+
+StressScene* StressScene::createScene(const StressConfig& config) {
+    CCLOG("StressScene::createScene() troops per type: %d", config.troopsPerType);
+    PROFILE_SCOPE(ProfileZone::SceneBuild);
+    auto scene = StressScene::create();
+    if (!scene) return nullptr;
+    scene->setName("StressScene");
+    scene->_config = config;
+
+    auto map = MapManager::create(kMapSize, kMapSize, -1, TerrainType::Battle);
+    if (!map) return nullptr;
+    rapidjson::Document layout;
+    generateBaseLayout(kMapSize, kMapSize, layout);
+    map->loadFromJSONObject(layout);
+    CCLOG("StressScene: generated base with %d buildings", static_cast<int>(map->getAllBuildings().size()));
+    scene->addChild(map, 0);
+    scene->_map = map;
+
+    // 每个兵种一份模板，部署时复用；并按部署数量预热对象池
+    scene->_soldierTemplates.assign(kTypeCount, nullptr);
+    scene->_deployedPerType.assign(kTypeCount, 0);
+    for (const auto& tmpl : TownHall::GetInstance()->GetSoldierCategory()) {
+        int type = static_cast<int>(tmpl.type_);
+        if (type < 0 || type >= kTypeCount || scene->_soldierTemplates[type]) continue;
+        scene->_soldierTemplates[type] = tmpl.createFunc();
+        CombatEntityPool::GetInstance()->PrewarmSoldiers(tmpl, config.troopsPerType);
+    }
+
+    CombatManager::SetUseUnitRenderer(config.useUnitRenderer);
+    auto combatMgr = CombatManager::InitializeInstance(map);
+    if (!combatMgr) return nullptr;
+    scene->addChild(combatMgr);
+    // 战斗每帧推进一个固定 tick，同一配置每次的部署时机与战斗进程都相同，报告才能逐次对比
+    combatMgr->SetOneTickPerFrame(true);
+    combatMgr->StartCombat();
+    // 开战当帧先部署第一波，避免战斗因场上无兵而立即结束
+    scene->deployWave();
+
+    // 模拟耗时：一次 Scheduler::update（包含所有 Action 与 update 回调）
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    scene->_beforeUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_BEFORE_UPDATE,
+        [scene](EventCustom*) { scene->_tickBegin = std::chrono::steady_clock::now(); });
+    scene->_afterUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE,
+        [scene](EventCustom*) {
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - scene->_tickBegin).count();
+            if (!scene->_finished) scene->_tickMs.push_back(us / 1000.0f);
+        });
+
+    scene->scheduleUpdate();
+    return scene;
+}
+
+void StressScene::deployWave() {
+    auto combatMgr = CombatManager::GetInstance();
+    if (!combatMgr || !_map) return;
+
+    // 部署点脚本：沿四条边轮流取点，步长 7 格，跳过禁止部署的格子
+    auto nextDeployPos = [this]() -> Vec2 {
+        for (int attempt = 0; attempt < 4 * kMapSize; ++attempt) {
+            int k = _deployCursor++;
+            int t = (k / 4 * 7) % (kMapSize - 2) + 1;
+            int gx = 0, gy = 0;
+            switch (k % 4) {
+                case 0: gx = t; gy = 0; break;
+                case 1: gx = kMapSize - 1; gy = t; break;
+                case 2: gx = t; gy = kMapSize - 1; break;
+                default: gx = 0; gy = t; break;
+            }
+            if (_map->isDeployAllowedGrid(gx, gy)) {
+                return Vec2(gx + 0.5f, gy + 0.5f);
+            }
+        }
+        return Vec2(0.5f, 0.5f);
+    };
+
+    // 每波按兵种轮流部署，直到每个兵种都达到配置数量
+    int deployed = 0;
+    for (int round = 0; deployed < kWaveSize && round < kWaveSize; ++round) {
+        for (int type = 0; type < kTypeCount && deployed < kWaveSize; ++type) {
+            if (_deployedPerType[type] >= _config.troopsPerType || !_soldierTemplates[type]) continue;
+            combatMgr->SendSoldier(_soldierTemplates[type], nextDeployPos());
+            _deployedPerType[type]++;
+            deployed++;
+        }
+    }
+}
+
+void StressScene::update(float dt) {
+    if (_finished) return;
+    // 第一帧包含场景加载时间，不计入
+    if (_elapsed > 0.0f) {
+        _frameMs.push_back(dt * 1000.0f);
+    }
+
+    // 波次与时间上限按模拟时间计：与战斗一样每帧一个固定步长，不受真实帧间隔影响
+    _elapsed += CombatManager::kFixedTickDt;
+    _waveTimer += CombatManager::kFixedTickDt;
+    while (_waveTimer >= kWaveInterval) {
+        _waveTimer -= kWaveInterval;
+        deployWave();
+    }
+
+    if (!CombatManager::GetInstance()) {
+        finish("combat ended");
+    } else if (_elapsed >= _config.maxSeconds) {
+        finish("time limit");
+    }
+}
+
+void StressScene::finish(const std::string& reason) {
+    if (_finished) return;
+    _finished = true;
+    unscheduleUpdate();
+
+    auto path = writeReport(reason);
+
+    auto visibleSize = Director::getInstance()->getVisibleSize();
+    auto label = Label::createWithTTF(StringUtils::format("Stress test finished (%s)\nreport: %s",
+                                                          reason.c_str(), path.c_str()),
+                                      "fonts/arial.ttf", 12);
+    label->setPosition(Vec2(visibleSize.width / 2, visibleSize.height / 2));
+    addChild(label, 100);
+
+    if (_config.exitWhenDone) {
+        Director::getInstance()->end();
+    }
+}
+
+std::string StressScene::writeReport(const std::string& reason) const {
+    int totalDeployed = 0;
+    for (int n : _deployedPerType) totalDeployed += n;
+
+    rapidjson::Document doc;
+    doc.SetObject();
+    auto& allocator = doc.GetAllocator();
+    doc.AddMember("reason", rapidjson::Value(reason.c_str(), allocator), allocator);
+    doc.AddMember("troops_per_type", _config.troopsPerType, allocator);
+    doc.AddMember("troops_deployed", totalDeployed, allocator);
+    doc.AddMember("unit_renderer", _config.useUnitRenderer, allocator);
+    doc.AddMember("buildings", static_cast<int>(_map ? _map->getAllBuildings().size() : 0), allocator);
+    doc.AddMember("seconds", _elapsed, allocator);
+    doc.AddMember("frames", static_cast<int>(_frameMs.size()), allocator);
+    doc.AddMember("frame_ms_p50", percentile(_frameMs, 0.50f), allocator);
+    doc.AddMember("frame_ms_p90", percentile(_frameMs, 0.90f), allocator);
+    doc.AddMember("frame_ms_p99", percentile(_frameMs, 0.99f), allocator);
+    doc.AddMember("frame_ms_max", percentile(_frameMs, 1.0f), allocator);
+    doc.AddMember("tick_ms_p50", percentile(_tickMs, 0.50f), allocator);
+    doc.AddMember("tick_ms_p99", percentile(_tickMs, 0.99f), allocator);
+    doc.AddMember("tick_ms_max", percentile(_tickMs, 1.0f), allocator);
+    doc.AddMember("peak_memory_kb", static_cast<uint64_t>(getPeakMemoryKB()), allocator);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    CCLOG("StressScene report: %s", buffer.GetString());
+    std::string fullPath = FileUtils::getInstance()->getWritablePath() + "stress_report.json";
+    if (!FileUtils::getInstance()->writeStringToFile(buffer.GetString(), fullPath)) {
+        CCLOG("StressScene: failed to write %s", fullPath.c_str());
+        return "";
+    }
+    return fullPath;
+}
+
+size_t StressScene::getPeakMemoryKB() {
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_IOS
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;   // macOS 下单位为字节
+#else
+    // Linux / Android：/proc/self/status 中的 VmHWM
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return static_cast<size_t>(std::atol(line.c_str() + 6));
+        }
+    }
+    return 0;
+#endif
+}
+
+StressScene::~StressScene() {
+    for (auto soldier : _soldierTemplates) {
+        CC_SAFE_RELEASE(soldier);
+    }
+}
+
+void StressScene::onExit() {
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    if (_beforeUpdateListener) dispatcher->removeEventListener(_beforeUpdateListener);
+    if (_afterUpdateListener) dispatcher->removeEventListener(_afterUpdateListener);
+    _beforeUpdateListener = _afterUpdateListener = nullptr;
+    CombatManager::SetUseUnitRenderer(false);
+    Scene::onExit();
+}
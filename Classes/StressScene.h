@@ -0,0 +1,68 @@
+#pragma once
+#ifndef __STRESS_SCENE_H__
+#define __STRESS_SCENE_H__
+
+#include "cocos2d.h"
+#include "Soldier/Soldier.h"
+#include "json/document.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+// 前向声明
+class MapManager;
+
+// 压力测试配置
+struct StressConfig {
+    int troopsPerType = 50;          // 每个兵种部署的数量
+    float maxSeconds = 60.0f;        // 最长模拟时间（战斗先结束则提前出报告）
+    bool useUnitRenderer = false;    // 是否启用 AnimatedUnitRenderer 批量绘制
+    bool exitWhenDone = false;       // 出报告后退出程序（命令行/夜间任务模式）
+
+    // 从环境变量读取：TJ_STRESS_TROOPS / TJ_STRESS_SECONDS / TJ_STRESS_GPU
+    // 未设置 TJ_STRESS_TROOPS 时返回 false
+    static bool fromEnvironment(StressConfig& config);
+};
+
+// 确定性压力测试场景：
+// 生成铺满 30x30 战斗地图的基地（全部建筑类型 + 两圈完整城墙），
+// 按固定脚本从四条边分波部署每个兵种 N 个士兵；战斗与部署都按每帧一个固定步长推进，
+// 同一配置每次跑出相同的战斗。记录帧时间分位数、模拟耗时（每次 Scheduler::update）与峰值内存，结束时写出报告
+class StressScene : public cocos2d::Scene {
+public:
+    static StressScene* createScene(const StressConfig& config);
+
+    CREATE_FUNC(StressScene);
+
+    ~StressScene() override;
+
+    void update(float dt) override;
+    void onExit() override;
+
+    // 生成基地布局（JSON 格式与 battle_field*.json 的 map_layout 一致）
+    static void generateBaseLayout(int width, int length, rapidjson::Document& doc);
+
+private:
+    void deployWave();
+    void finish(const std::string& reason);
+    std::string writeReport(const std::string& reason) const;
+    static size_t getPeakMemoryKB();
+
+    StressConfig _config;
+    MapManager* _map = nullptr;
+    std::vector<Soldier*> _soldierTemplates;   // 下标为 SoldierType，持有引用
+    std::vector<int> _deployedPerType;
+    int _deployCursor = 0;           // 部署点脚本位置
+    float _elapsed = 0.0f;
+    float _waveTimer = 0.0f;
+    bool _finished = false;
+
+    // 统计
+    std::vector<float> _frameMs;
+    std::vector<float> _tickMs;
+    std::chrono::steady_clock::time_point _tickBegin;
+    cocos2d::EventListenerCustom* _beforeUpdateListener = nullptr;
+    cocos2d::EventListenerCustom* _afterUpdateListener = nullptr;
+};
+
+#endif // __STRESS_SCENE_H__
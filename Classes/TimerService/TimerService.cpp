@@ -0,0 +1,142 @@
+#include "TimerService/TimerService.h"
+#include "cocos2d.h"
+#include <algorithm>
+#include <cmath>
+
+USING_NS_CC;
+
+TimerService* TimerService::_instance = nullptr;
+
+namespace {
+// TimerId = (generation << 16) | (index + 1)，0 保留为无效 ID
+inline uint32_t indexOf(TimerService::TimerId id) { return (id & 0xFFFF) - 1; }
+inline uint16_t generationOf(TimerService::TimerId id) { return static_cast<uint16_t>(id >> 16); }
+}
+
+TimerService* TimerService::getInstance() {
+    if (!_instance) {
+        _instance = new (std::nothrow) TimerService();
+    }
+    return _instance;
+}
+
+TimerService::TimerService() {
+    _timers.reserve(64);
+}
+
+void TimerService::install() {
+    Director::getInstance()->getScheduler()->schedule(
+        [this](float dt) { tick(dt); }, this, 0.0f, false, "TimerServiceTick");
+}
+
+TimerService::TimerId TimerService::start(float duration, const std::function<void()>& onFire,
+                                          const void* owner, float repeatInterval) {
+    uint32_t index;
+    if (!_freeList.empty()) {
+        index = _freeList.back();
+        _freeList.pop_back();
+    } else {
+        if (_timers.size() >= 0xFFFF) {
+            CCLOG("TimerService: too many timers");
+            return kInvalidTimer;
+        }
+        index = static_cast<uint32_t>(_timers.size());
+        _timers.emplace_back();
+    }
+
+    auto& timer = _timers[index];
+    timer.active = true;
+    timer.owner = owner;
+    timer.duration = std::max(0.0f, duration);
+    timer.interval = std::max(0.0f, repeatInterval);
+    timer.deadline = _now + timer.duration;
+    timer.onFire = onFire;
+    insert(index);
+    _activeCount++;
+    return (static_cast<uint32_t>(timer.generation) << 16) | (index + 1);
+}
+
+void TimerService::insert(uint32_t index) {
+    auto& timer = _timers[index];
+    // 至少落在下一格，保证在当前帧的派发结束后才触发
+    auto tick = static_cast<uint64_t>(std::ceil(timer.deadline / kResolution));
+    timer.deadlineTick = std::max(tick, _currentTick + 1);
+    _slots[timer.deadlineTick % kSlotCount].push_back({ index, timer.generation });
+}
+
+void TimerService::release(uint32_t index) {
+    auto& timer = _timers[index];
+    timer.active = false;
+    timer.owner = nullptr;
+    timer.onFire = nullptr;
+    timer.generation++;         // 槽位中残留的旧条目因代数不符被跳过
+    _freeList.push_back(index);
+    _activeCount--;
+}
+
+const TimerService::Timer* TimerService::find(TimerId id) const {
+    if (id == kInvalidTimer) return nullptr;
+    uint32_t index = indexOf(id);
+    if (index >= _timers.size()) return nullptr;
+    const auto& timer = _timers[index];
+    return (timer.active && timer.generation == generationOf(id)) ? &timer : nullptr;
+}
+
+void TimerService::cancel(TimerId id) {
+    if (find(id)) release(indexOf(id));
+}
+
+void TimerService::cancelAll(const void* owner) {
+    if (!owner) return;
+    for (uint32_t i = 0; i < _timers.size(); ++i) {
+        if (_timers[i].active && _timers[i].owner == owner) release(i);
+    }
+}
+
+bool TimerService::isActive(TimerId id) const {
+    return find(id) != nullptr;
+}
+
+float TimerService::getRemaining(TimerId id) const {
+    auto timer = find(id);
+    return timer ? static_cast<float>(std::max(0.0, timer->deadline - _now)) : 0.0f;
+}
+
+float TimerService::getDuration(TimerId id) const {
+    auto timer = find(id);
+    return timer ? timer->duration : 0.0f;
+}
+
+void TimerService::tick(float dt) {
+    _now += dt;
+    auto targetTick = static_cast<uint64_t>(std::floor(_now / kResolution));
+
+    while (_currentTick < targetTick) {
+        _currentTick++;
+        auto& slot = _slots[_currentTick % kSlotCount];
+        if (slot.empty()) continue;
+
+        // 先取出本格全部条目：回调中可能新建/取消计时器
+        _firing.clear();
+        _firing.swap(slot);
+        for (const auto& entry : _firing) {
+            auto& timer = _timers[entry.index];
+            if (!timer.active || timer.generation != entry.generation) continue;
+            if (timer.deadlineTick != _currentTick) {
+                slot.push_back(entry);      // 下一圈才到期
+                continue;
+            }
+
+            // 回调可能触发 _timers 扩容，先拷贝回调
+            auto onFire = timer.onFire;
+            if (timer.interval > 0.0f) {
+                timer.deadline += timer.interval;
+                timer.duration = timer.interval;
+                insert(entry.index);
+            } else {
+                release(entry.index);
+            }
+            if (onFire) onFire();
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#ifndef __TIMER_SERVICE_H__
+#define __TIMER_SERVICE_H__
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 全局计时服务（哈希时间轮）：
+// - 统一持有建筑升级、训练、升级进度条等所有倒计时，每帧只推进一次
+// - 每帧开销只与本帧到期槽位中的计时器数量有关，与同时进行的计时器总数无关
+// - 剩余时间按需由截止时间计算，调用方不再每帧递减自己的计时变量
+class TimerService {
+public:
+    using TimerId = uint32_t;
+    static const TimerId kInvalidTimer = 0;
+
+    static TimerService* getInstance();
+
+    // 注册每帧推进，在 AppDelegate 创建 Director 之后调用一次
+    void install();
+
+    // duration 秒后调用 onFire；repeatInterval > 0 时按该间隔重复触发直到取消
+    // owner 用于对象析构时 cancelAll 批量取消
+    TimerId start(float duration, const std::function<void()>& onFire,
+                  const void* owner = nullptr, float repeatInterval = 0.0f);
+    void cancel(TimerId id);
+    void cancelAll(const void* owner);
+
+    bool isActive(TimerId id) const;
+    float getRemaining(TimerId id) const;   // 未激活时返回 0
+    float getDuration(TimerId id) const;
+
+    // 推进时间并触发到期计时器（install 后由 Scheduler 每帧调用）
+    void tick(float dt);
+
+    int getActiveCount() const { return _activeCount; }
+
+private:
+    TimerService();
+
+    static const int kSlotCount = 512;
+    static constexpr double kResolution = 0.1;   // 每格 0.1 秒，一圈 51.2 秒
+
+    struct Timer {
+        uint16_t generation = 0;
+        bool active = false;
+        const void* owner = nullptr;
+        double deadline = 0.0;
+        float duration = 0.0f;
+        float interval = 0.0f;
+        uint64_t deadlineTick = 0;
+        std::function<void()> onFire;
+    };
+
+    struct SlotEntry {
+        uint32_t index;
+        uint16_t generation;
+    };
+
+    static TimerService* _instance;
+
+    const Timer* find(TimerId id) const;
+    void insert(uint32_t index);
+    void release(uint32_t index);
+
+    double _now = 0.0;
+    uint64_t _currentTick = 0;
+    int _activeCount = 0;
+    std::vector<Timer> _timers;
+    std::vector<uint32_t> _freeList;
+    std::vector<SlotEntry> _slots[kSlotCount];
+    std::vector<SlotEntry> _firing;          // 复用的临时数组，避免每帧分配
+};
+
+#endif // __TIMER_SERVICE_H__
@@ -0,0 +1,79 @@
+//
+// BattleStats.h
+// 兵种与建筑的战斗数值表：TownHall 的士兵/建筑模板与离线模拟的 SimRules::defaults 共用这一份，
+// 调整数值只改这里，实战与无头模拟不会各自为政
+//
+
+#pragma once
+#ifndef __BATTLE_STATS_H__
+#define __BATTLE_STATS_H__
+
+#include <cstring>
+
+struct UnitBattleStats {
+    const char* name;
+    int health;
+    int damage;
+    float moveSpeed;
+    float attackRange;
+    float attackDelay;
+    int housingSpace;
+    int trainingCost;
+    int trainingTime;
+};
+
+// base 为建筑构造函数的基准数值；血量倍数与各建筑类的构造函数一致（防御建筑 6 倍，其余 8 倍）
+struct BuildingBattleStats {
+    const char* name;
+    int width;
+    int length;
+    int base;
+    int healthFactor;
+    // 防御建筑的攻击参数，其余建筑为 0
+    float attackInterval;
+    int attackDamage;
+    float attackRange;
+};
+
+namespace battle_stats {
+
+// 战斗固定步长（秒）：CombatManager 每个 tick 与离线模拟的默认步长共用，
+// 移动、攻击间隔与部署时机在两边按同样的粒度量化
+constexpr float kFixedTickDt = 1.0f / 60.0f;
+
+// 顺序与 SoldierType 一致
+constexpr UnitBattleStats kUnits[] = {
+    {"Barbarian", 50, 12, 1.0f, 1.0f, 1.0f, 1, 25, 20},
+    {"Archer", 25, 10, 1.5f, 3.5f, 1.0f, 1, 50, 25},
+    {"Bomber", 20, 10, 1.2f, 1.0f, 1.0f, 2, 1000, 60},
+    {"Giant", 500, 30, 0.6f, 1.0f, 2.0f, 5, 500, 120},
+};
+
+constexpr BuildingBattleStats kBuildings[] = {
+    {"TownHall", 4, 4, 20, 8, 0.0f, 0, 0.0f},
+    {"Gold Mine", 3, 3, 15, 8, 0.0f, 0, 0.0f},
+    {"Elixir Collector", 3, 3, 15, 8, 0.0f, 0, 0.0f},
+    {"Gold Storage", 3, 3, 15, 8, 0.0f, 0, 0.0f},
+    {"Elixir Storage", 3, 3, 15, 8, 0.0f, 0, 0.0f},
+    {"Barracks", 3, 3, 15, 8, 0.0f, 0, 0.0f},
+    {"Training Camp", 4, 4, 15, 8, 0.0f, 0, 0.0f},
+    {"Wall", 1, 1, 15, 8, 0.0f, 0, 0.0f},
+    {"Archer Tower", 2, 2, 10, 6, 0.8f, 7, 10.0f},
+    {"Cannon", 2, 2, 10, 6, 1.0f, 10, 9.0f},
+};
+
+inline const UnitBattleStats& unit(int type) {
+    return kUnits[type];
+}
+
+// 按名称查找，表中没有时返回 nullptr
+inline const BuildingBattleStats* findBuilding(const char* name) {
+    for (const auto& stats : kBuildings) {
+        if (std::strcmp(stats.name, name) == 0) return &stats;
+    }
+    return nullptr;
+}
+
+} // namespace battle_stats
+
+#endif // __BATTLE_STATS_H__
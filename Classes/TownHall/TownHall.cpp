@@ -4,20 +4,26 @@
 
 #include "TownHall.h"
 #include "UIManager/UIManager.h"
+#include "Profiler/GameProfiler.h"
+#include "BattleStats.h"
 #include <cmath>
 #include <fstream>
 #include <sstream>
 USING_NS_CC;
 
+// 兵种数值取自 BattleStats.h，与离线模拟共用
+static SoldierTemplate MakeSoldierTemplate(SoldierType type, const std::string& icon_path) {
+    const auto& stats = battle_stats::unit(static_cast<int>(type));
+    return SoldierTemplate(type, stats.name, icon_path,
+                           stats.health, stats.damage, stats.moveSpeed, stats.attackRange, stats.attackDelay,
+                           stats.housingSpace, stats.trainingCost, stats.trainingTime);
+}
+
 static std::vector<SoldierTemplate> soldier_templates = {
-    SoldierTemplate(SoldierType::kBarbarian, "Barbarian","others/Barbarian.png",
-                    50, 12, 1.0f, 1.0f, 1.0f, 1, 25, 20),
-    SoldierTemplate(SoldierType::kArcher, "Archer","others/Archer.png",
-                    25, 10, 1.5f, 3.5f, 1.0f, 1, 50, 25),
-    SoldierTemplate(SoldierType::kBomber, "Bomber","others/Bomber.png",
-                    20, 10, 1.2f, 1.0f, 1.0f, 2, 1000, 60),
-    SoldierTemplate(SoldierType::kGiant, "Giant","others/Giant.png",
-                    500, 30, 0.6f, 1.0f, 2.0f, 5, 500, 120)
+    MakeSoldierTemplate(SoldierType::kBarbarian, "others/Barbarian.png"),
+    MakeSoldierTemplate(SoldierType::kArcher, "others/Archer.png"),
+    MakeSoldierTemplate(SoldierType::kBomber, "others/Bomber.png"),
+    MakeSoldierTemplate(SoldierType::kGiant, "others/Giant.png")
 };
 
 // ==================== JSON数据读取函数 ====================
@@ -273,6 +279,7 @@ static bool LoadPlayerDataFromJSON(const std::string& file_path,
 
 bool TownHall::SavePlayerDataToJSON(const std::string& file_path,
     int gold, int elixir, int level) {
+    PROFILE_SCOPE(ProfileZone::SaveIO);
     // 参数验证
     if (file_path.empty()) {
         cocos2d::log("错误: JSON文件路径为空");
@@ -811,7 +818,7 @@ TownHall::~TownHall() {
     // 清空管理列表
     gold_storages_.clear();
     elixir_storages_.clear();
-    walls_.clear();
+    walls_.Clear();
 }
 
 void TownHall::Upgrade() {
@@ -1021,6 +1028,56 @@ void TownHall::UpdateArmyCapacityFromBarracks() {
         base_capacity, total_barracks_capacity, army_capacity_);
 }
 
+// ==================== 存档事务 ====================
+
+void TownHall::BeginSaveTransaction() {
+    save_transaction_depth_++;
+}
+
+void TownHall::CommitSaveTransaction() {
+    if (save_transaction_depth_ <= 0) {
+        cocos2d::log("警告：没有进行中的存档事务");
+        return;
+    }
+    if (--save_transaction_depth_ > 0 || (!gold_dirty_ && !elixir_dirty_)) {
+        return;
+    }
+
+    // 一次事务只写一次 UserDefault 与一次 JSON 字段
+    cocos2d::UserDefault* userDefault = cocos2d::UserDefault::getInstance();
+    if (gold_dirty_) userDefault->setIntegerForKey("player_gold", gold_);
+    if (elixir_dirty_) userDefault->setIntegerForKey("player_elixir", elixir_);
+    userDefault->setIntegerForKey("player_townhall_level", level_);
+    userDefault->flush();
+
+    std::string json_file_path = cocos2d::FileUtils::getInstance()->getWritablePath() + "player_save.json";
+    if (gold_dirty_ && !UpdatePlayerDataField(json_file_path, "gold", gold_)) {
+        cocos2d::log("警告：保存金币数据到JSON文件失败");
+    }
+    if (elixir_dirty_ && !UpdatePlayerDataField(json_file_path, "elixir", elixir_)) {
+        cocos2d::log("警告：保存圣水数据到JSON文件失败");
+    }
+    gold_dirty_ = false;
+    elixir_dirty_ = false;
+}
+
+void TownHall::PersistGold() {
+    gold_dirty_ = true;
+    if (save_transaction_depth_ == 0) {
+        // 不在事务中：立即写入
+        BeginSaveTransaction();
+        CommitSaveTransaction();
+    }
+}
+
+void TownHall::PersistElixir() {
+    elixir_dirty_ = true;
+    if (save_transaction_depth_ == 0) {
+        BeginSaveTransaction();
+        CommitSaveTransaction();
+    }
+}
+
 // ==================== 城墙管理 ====================
 
 void TownHall::AddWall(WallBuilding* wall) {
@@ -1029,6 +1086,12 @@ void TownHall::AddWall(WallBuilding* wall) {
         return;
     }
 
+    // 检查是否已存在
+    if (wall->GetSegmentStore() == &walls_) {
+        cocos2d::log("城墙 %s 已在管理列表中", wall->GetName().c_str());
+        return;
+    }
+
     // 检查是否已达到上限
     if (IsWallCapacityFull()) {
         cocos2d::log("已达到城墙上限 %d/%d，无法添加更多城墙",
@@ -1036,18 +1099,11 @@ void TownHall::AddWall(WallBuilding* wall) {
         return;
     }
 
-    // 检查是否已存在
-    auto it = std::find(walls_.begin(), walls_.end(), wall);
-    if (it == walls_.end()) {
-        walls_.push_back(wall);
-        cocos2d::log("添加城墙 %s，当前数量: %d/%d",
-            wall->GetName().c_str(),
-            GetCurrentWallCount(),
-            wall_capacity_);
-    }
-    else {
-        cocos2d::log("城墙 %s 已在管理列表中", wall->GetName().c_str());
-    }
+    walls_.Add(wall);
+    cocos2d::log("添加城墙 %s，当前数量: %d/%d",
+        wall->GetName().c_str(),
+        GetCurrentWallCount(),
+        wall_capacity_);
 }
 
 void TownHall::RemoveWall(WallBuilding* wall) {
@@ -1056,9 +1112,7 @@ void TownHall::RemoveWall(WallBuilding* wall) {
         return;
     }
 
-    auto it = std::find(walls_.begin(), walls_.end(), wall);
-    if (it != walls_.end()) {
-        walls_.erase(it);
+    if (walls_.Remove(wall)) {
         cocos2d::log("移除城墙 %s，剩余数量: %d",
             wall->GetName().c_str(),
             GetCurrentWallCount());
@@ -1069,7 +1123,17 @@ void TownHall::RemoveWall(WallBuilding* wall) {
 }
 
 int TownHall::GetCurrentWallCount() const {
-    return static_cast<int>(walls_.size());
+    return walls_.Size();
+}
+
+int TownHall::GetBuildingCapacityForLevel(const std::string& type, int town_hall_level) {
+    const int upgrades = std::max(0, town_hall_level - 1);
+    if (type == "TownHall") return 1;
+    if (type == "Gold Storage" || type == "Elixir Storage") return 2 + upgrades;
+    if (type == "Gold Mine" || type == "Elixir Collector") return 3 + upgrades;
+    if (type == "Barracks") return 1 + upgrades;
+    if (type == "Wall") return 10 + upgrades * 5;
+    return -1;
 }
 
 bool TownHall::IsWallCapacityFull() const {
@@ -1077,129 +1141,74 @@ bool TownHall::IsWallCapacityFull() const {
 }
 
 bool TownHall::HasDamagedWalls() const {
-    for (const auto* wall : walls_) {
-        if (wall && wall->IsActive() && wall->GetHealth() < wall->GetMaxHealth()) {
-            return true;
-        }
-    }
-    return false;
+    return walls_.HasDamaged();
 }
 
-int TownHall::UpgradeAllWalls() {
-    int upgraded_count = 0;
-
-    for (auto* wall : walls_) {
-        if (!wall || !wall->IsActive()) {
-            continue;
-        }
-
+int TownHall::UpgradeWalls(const std::vector<int>& indices) {
+    // 先在紧凑数组上选出预算内的城墙，再一次性扣费并保存
+    std::vector<int> selected;
+    int total_cost = walls_.SelectUpgrades(indices, gold_, selected);
+    if (selected.empty()) {
+        cocos2d::log("金币不足或没有可升级的城墙");
+        return 0;
+    }
 
-        // 计算升级成本
-        int upgrade_cost = wall->GetNextBuildCost();
+    BeginSaveTransaction();
+    SpendGold(total_cost);
+    walls_.StartUpgrades(selected);
+    CommitSaveTransaction();
 
-        // 检查资源是否足够
-        if (SpendGold(upgrade_cost)) {
-            wall->StartUpgrade(wall->GetNextBuildTime());
-            upgraded_count++;
-            cocos2d::log("开始升级城墙 %s，消耗金币: %d",
-                wall->GetName().c_str(), upgrade_cost);
-        }
-        else {
-            cocos2d::log("金币不足，无法升级城墙 %s",
-                wall->GetName().c_str());
-            break; // 资源不足，停止批量升级
-        }
+    cocos2d::log("批量升级完成，开始升级 %d 个城墙，总计消耗金币: %d",
+        static_cast<int>(selected.size()), total_cost);
+    return static_cast<int>(selected.size());
+}
 
-    }
+int TownHall::UpgradeAllWalls() {
+    std::vector<int> indices;
+    walls_.AllIndices(indices);
+    return UpgradeWalls(indices);
+}
 
-    cocos2d::log("批量升级完成，开始升级 %d 个城墙", upgraded_count);
-    return upgraded_count;
+int TownHall::UpgradeWallRun(const cocos2d::Vec2& from, const cocos2d::Vec2& to) {
+    std::vector<int> indices;
+    walls_.FindRun(from, to, indices);
+    return UpgradeWalls(indices);
 }
 
 int TownHall::RepairAllDamagedWalls() {
-    int repaired_count = 0;
-    int total_cost = 0;
-
-    for (auto* wall : walls_) {
-        if (!wall || !wall->IsActive()) {
-            continue;
-        }
-
-        // 检查是否需要修复
-        if (wall->GetHealth() < wall->GetMaxHealth()) {
-            // 计算修复成本
-            int repair_cost = (wall->GetMaxHealth() - wall->GetHealth()) / 20;
-
-            if (repair_cost <= 0) {
-                repair_cost = 1; // 至少1金币
-            }
-
-            // 检查金币是否足够
-            if (SpendGold(repair_cost)) {
-                wall->Repair();
-                repaired_count++;
-                total_cost += repair_cost;
-                cocos2d::log("修复城墙 %s，消耗金币: %d",
-                    wall->GetName().c_str(), repair_cost);
-            }
-            else {
-                cocos2d::log("金币不足，停止批量修复");
-                break; // 资源不足，停止批量修复
-            }
-        }
+    std::vector<int> indices;
+    std::vector<int> selected;
+    walls_.AllIndices(indices);
+    int total_cost = walls_.SelectRepairs(indices, gold_, selected);
+    if (selected.empty()) {
+        return 0;
     }
 
-    if (repaired_count > 0) {
-        cocos2d::log("批量修复完成，修复 %d 个城墙，总计消耗金币: %d",
-            repaired_count, total_cost);
-    }
+    BeginSaveTransaction();
+    SpendGold(total_cost);
+    walls_.Repair(selected);
+    CommitSaveTransaction();
 
-    return repaired_count;
+    cocos2d::log("批量修复完成，修复 %d 个城墙，总计消耗金币: %d",
+        static_cast<int>(selected.size()), total_cost);
+    return static_cast<int>(selected.size());
 }
 
 void TownHall::GetWallStats(int& active_count, int& damaged_count, int& upgrading_count) const {
-    active_count = 0;
-    damaged_count = 0;
-    upgrading_count = 0;
-
-    for (const auto* wall : walls_) {
-        if (!wall) {
-            continue;
-        }
-
-        if (wall->IsActive()) {
-            active_count++;
-
-            if (wall->GetHealth() < wall->GetMaxHealth()) {
-                damaged_count++;
-            }
-
-            if (wall->IsUpgrading()) {
-                upgrading_count++;
-            }
-        }
-    }
+    auto stats = walls_.GetStats();
+    active_count = stats.active;
+    damaged_count = stats.damaged;
+    upgrading_count = stats.upgrading;
 }
 
 void TownHall::ClearAllWalls() {
     int wall_count = GetCurrentWallCount();
-    walls_.clear();
+    walls_.Clear();
     cocos2d::log("清空所有 %d 个城墙", wall_count);
 }
 
 int TownHall::CountWallsByLevel(int min_level, int max_level) const {
-    int count = 0;
-
-    for (const auto* wall : walls_) {
-        if (wall && wall->IsActive()) {
-            int level = wall->GetLevel();
-            if (level >= min_level && level <= max_level) {
-                count++;
-            }
-        }
-    }
-
-    return count;
+    return walls_.CountByLevel(min_level, max_level);
 }
 // ==================== 军队人数更新 ====================
 
@@ -1273,18 +1282,8 @@ int TownHall::AddGold() {
     //更新大本营金币数量
     gold_ += actual_add;
     
-    // 使用UserDefault强制保存资源数据
-    cocos2d::UserDefault* userDefault = cocos2d::UserDefault::getInstance();
-    userDefault->setIntegerForKey("player_gold", gold_);
-    userDefault->setIntegerForKey("player_townhall_level", level_);
-    userDefault->flush(); // 立即写入磁盘
-    
-    // 保存更新后的金币数量到JSON文件
-    // 使用可写路径确保文件可以被正确更新
-    std::string json_file_path = cocos2d::FileUtils::getInstance()->getWritablePath() + "player_save.json";
-    if (!UpdatePlayerDataField(json_file_path, "gold", gold_)) {
-        cocos2d::log("警告：保存金币数据到JSON文件失败");
-    }
+    // 保存资源数据（处于存档事务中时延迟到提交时统一写入）
+    PersistGold();
 
     cocos2d::log("存入金币: %d", actual_add);
     return actual_add;
@@ -1320,18 +1319,8 @@ bool TownHall::SpendGold(int amount) {
     //更新大本营金币数量
     gold_ -= amount;
     
-    // 使用UserDefault强制保存资源数据
-    cocos2d::UserDefault* userDefault = cocos2d::UserDefault::getInstance();
-    userDefault->setIntegerForKey("player_gold", gold_);
-    userDefault->setIntegerForKey("player_townhall_level", level_);
-    userDefault->flush(); // 立即写入磁盘
-    
-    // 保存更新后的金币数量到JSON文件
-    // 使用可写路径确保文件可以被正确更新
-    std::string json_file_path = cocos2d::FileUtils::getInstance()->getWritablePath() + "player_save.json";
-    if (!UpdatePlayerDataField(json_file_path, "gold", gold_)) {
-        cocos2d::log("警告：保存金币数据到JSON文件失败");
-    }
+    // 保存资源数据（处于存档事务中时延迟到提交时统一写入）
+    PersistGold();
 
     cocos2d::log("消耗金币: %d，剩余: %d", amount, total_gold - amount);
     return true;
@@ -1345,18 +1334,8 @@ bool TownHall::AddGold(int amount) {
     //更新大本营金币数量
     gold_ += amount;
 
-    // 使用UserDefault强制保存资源数据
-    cocos2d::UserDefault* userDefault = cocos2d::UserDefault::getInstance();
-    userDefault->setIntegerForKey("player_gold", gold_);
-    userDefault->setIntegerForKey("player_townhall_level", level_);
-    userDefault->flush(); // 立即写入磁盘
-
-    // 保存更新后的金币数量到JSON文件
-    // 使用可写路径确保文件可以被正确更新
-    std::string json_file_path = cocos2d::FileUtils::getInstance()->getWritablePath() + "player_save.json";
-    if (!UpdatePlayerDataField(json_file_path, "gold", gold_)) {
-        cocos2d::log("警告：保存金币数据到JSON文件失败");
-    }
+    // 保存资源数据（处于存档事务中时延迟到提交时统一写入）
+    PersistGold();
 
     cocos2d::log("获取金币: %d", amount);
     return true;
@@ -1407,18 +1386,8 @@ int TownHall::AddElixir() {
     //更新大本营圣水数量
     elixir_ += actual_add;
     
-    // 使用UserDefault强制保存资源数据
-    cocos2d::UserDefault* userDefault = cocos2d::UserDefault::getInstance();
-    userDefault->setIntegerForKey("player_elixir", elixir_);
-    userDefault->setIntegerForKey("player_townhall_level", level_);
-    userDefault->flush(); // 立即写入磁盘
-    
-    // 保存更新后的圣水数量到JSON文件
-    // 使用可写路径确保文件可以被正确更新
-    std::string json_file_path = cocos2d::FileUtils::getInstance()->getWritablePath() + "player_save.json";
-    if (!UpdatePlayerDataField(json_file_path, "elixir", elixir_)) {
-        cocos2d::log("警告：保存圣水数据到JSON文件失败");
-    }
+    // 保存资源数据（处于存档事务中时延迟到提交时统一写入）
+    PersistElixir();
 
     cocos2d::log("存入圣水: %d", actual_add);
     return actual_add;
@@ -1453,18 +1422,8 @@ bool TownHall::SpendElixir(int amount) {
     //更新大本营圣水数量
     elixir_ -= amount;
     
-    // 使用UserDefault强制保存资源数据
-    cocos2d::UserDefault* userDefault = cocos2d::UserDefault::getInstance();
-    userDefault->setIntegerForKey("player_elixir", elixir_);
-    userDefault->setIntegerForKey("player_townhall_level", level_);
-    userDefault->flush(); // 立即写入磁盘
-    
-    // 保存更新后的圣水数量到JSON文件
-    // 使用可写路径确保文件可以被正确更新
-    std::string json_file_path = cocos2d::FileUtils::getInstance()->getWritablePath() + "player_save.json";
-    if (!UpdatePlayerDataField(json_file_path, "elixir", elixir_)) {
-        cocos2d::log("警告：保存圣水数据到JSON文件失败");
-    }
+    // 保存资源数据（处于存档事务中时延迟到提交时统一写入）
+    PersistElixir();
 
     cocos2d::log("消耗圣水: %d，剩余: %d", amount, total_elixir - amount);
     return true;
@@ -1478,18 +1437,8 @@ bool TownHall::AddElixir(int amount) {
     //更新大本营圣水数量
     elixir_ += amount;
 
-    // 使用UserDefault强制保存资源数据
-    cocos2d::UserDefault* userDefault = cocos2d::UserDefault::getInstance();
-    userDefault->setIntegerForKey("player_elixir", elixir_);
-    userDefault->setIntegerForKey("player_townhall_level", level_);
-    userDefault->flush(); // 立即写入磁盘
-
-    // 保存更新后的圣水数量到JSON文件
-    // 使用可写路径确保文件可以被正确更新
-    std::string json_file_path = cocos2d::FileUtils::getInstance()->getWritablePath() + "player_save.json";
-    if (!UpdatePlayerDataField(json_file_path, "elixir", elixir_)) {
-        cocos2d::log("警告：保存圣水数据到JSON文件失败");
-    }
+    // 保存资源数据（处于存档事务中时延迟到提交时统一写入）
+    PersistElixir();
 
     cocos2d::log("获取圣水: %d", amount);
     return true;
@@ -1654,28 +1603,31 @@ void TownHall::ShowInfo() const {
 
 std::vector<TownHall::BuildingTemplate> TownHall::GetAllBuildingTemplates() {
     std::vector<TownHall::BuildingTemplate> templates;
+    // 占地与战斗数值取自 BattleStats.h，与离线模拟共用
 
     // 大本营
+    auto town_hall = battle_stats::findBuilding("TownHall");
     templates.emplace_back(
         "TownHall",
         "buildings/TownHall1.png",
         200,  // 成本
-        4,    // 宽度
-        4,    // 长度
+        town_hall->width,    // 宽度
+        town_hall->length,    // 长度
         []() -> Building* {
             return TownHallTemplate::Create(1, {0, 0});
         }
     );
 
     // 金矿
+    auto gold_mine = battle_stats::findBuilding("Gold Mine");
     templates.emplace_back(
         "Gold Mine",
         "buildings/goldmine.png",
         150,  // 成本
-        3,    // 宽度
-        3,    // 长度
-        []() -> Building* {
-            auto temp = SourceBuilding::Create("Gold Mine", 15, { 0, 0 }, "buildings/goldmine.png", "Gold");
+        gold_mine->width,    // 宽度
+        gold_mine->length,    // 长度
+        [gold_mine]() -> Building* {
+            auto temp = SourceBuilding::Create("Gold Mine", gold_mine->base, { 0, 0 }, "buildings/goldmine.png", "Gold");
             if (!UIManager::getInstance()->isInBattleMode() && !UIManager::getInstance()->isInReplayMode())
                 TownHall::GetInstance()->AddGoldMine(temp);
             return temp;
@@ -1683,14 +1635,15 @@ std::vector<TownHall::BuildingTemplate> TownHall::GetAllBuildingTemplates() {
     );
 
     // 圣水收集器
+    auto elixir_collector = battle_stats::findBuilding("Elixir Collector");
     templates.emplace_back(
         "Elixir Collector",
         "buildings/elixirmine0.png",
         150,
-        3,
-        3,
-        []() -> Building* {
-            auto temp = SourceBuilding::Create("Elixir Collector", 15, { 0, 0 }, "buildings/elixirmine0.png", "Elixir");
+        elixir_collector->width,
+        elixir_collector->length,
+        [elixir_collector]() -> Building* {
+            auto temp = SourceBuilding::Create("Elixir Collector", elixir_collector->base, { 0, 0 }, "buildings/elixirmine0.png", "Elixir");
             if (!UIManager::getInstance()->isInBattleMode() && !UIManager::getInstance()->isInReplayMode())
                 TownHall::GetInstance()->AddElixirCollector(temp);
             return temp;
@@ -1698,94 +1651,103 @@ std::vector<TownHall::BuildingTemplate> TownHall::GetAllBuildingTemplates() {
     );
 
     // 金币储罐
+    auto gold_storage = battle_stats::findBuilding("Gold Storage");
     templates.emplace_back(
         "Gold Storage",
         "buildings/goldpool1.png",
         300,
-        3,
-        3,
-        []() -> Building* {
-            auto temp = ProductionBuilding::Create("Gold Storage", 15, { 0, 0 }, "buildings/goldpool1.png", "Gold Storage");
+        gold_storage->width,
+        gold_storage->length,
+        [gold_storage]() -> Building* {
+            auto temp = ProductionBuilding::Create("Gold Storage", gold_storage->base, { 0, 0 }, "buildings/goldpool1.png", "Gold Storage");
 			TownHall::GetInstance()->AddGoldStorage(temp);
             return temp;
         }
     );
 
     // 圣水储罐
+    auto elixir_storage = battle_stats::findBuilding("Elixir Storage");
     templates.emplace_back(
         "Elixir Storage",
         "buildings/elixirpool2.png",
         300,
-        3,
-        3,
-        []() -> Building* {
-            auto temp = ProductionBuilding::Create("Elixir Storage", 15, { 0, 0 }, "buildings/elixirpool2.png", "Elixir Storage");
+        elixir_storage->width,
+        elixir_storage->length,
+        [elixir_storage]() -> Building* {
+            auto temp = ProductionBuilding::Create("Elixir Storage", elixir_storage->base, { 0, 0 }, "buildings/elixirpool2.png", "Elixir Storage");
 			TownHall::GetInstance()->AddElixirStorage(temp);
             return temp;
         }
     );
 
     // 军营
+    auto barracks = battle_stats::findBuilding("Barracks");
     templates.emplace_back(
         "Barracks",
         "buildings/barrack.png",
         200,
-        3,
-        3,
-        []() -> Building* {
-			auto temp = TrainingBuilding::Create("Barracks", 15, { 0, 0 }, "buildings/barrack.png", 50, 2);
+        barracks->width,
+        barracks->length,
+        [barracks]() -> Building* {
+			auto temp = TrainingBuilding::Create("Barracks", barracks->base, { 0, 0 }, "buildings/barrack.png", 50, 2);
 			TownHall::GetInstance()->AddBarracks(temp);
             return temp;
         }
     );
 
     // 训练营
+    auto training_camp = battle_stats::findBuilding("Training Camp");
     templates.emplace_back(
         "Training Camp",
         "buildings/trainingcamp.png",
         500,
-        4,
-        4,
-        []() -> Building* {
+        training_camp->width,
+        training_camp->length,
+        [training_camp]() -> Building* {
             // 调用 TrainingBuilding 的 InitializeInstance 函数
-            return TrainingBuilding::Create("Training Camp", 15, { 0, 0 },
+            return TrainingBuilding::Create("Training Camp", training_camp->base, { 0, 0 },
                 "buildings/trainingcamp.png", 10, 20);
         }
     );
 
     // 城墙
+    auto wall = battle_stats::findBuilding("Wall");
     templates.emplace_back(
         "Wall",
         "buildings/wall1.png",
         100,  // 建造成本
-        1,    // 宽度
-        1,    // 长度
-        []() -> Building* {
-            return WallBuilding::Create("Wall", 15, { 0, 0 }, "buildings/wall1.png");
+        wall->width,    // 宽度
+        wall->length,    // 长度
+        [wall]() -> Building* {
+            return WallBuilding::Create("Wall", wall->base, { 0, 0 }, "buildings/wall1.png");
         }
     );
 
     // 箭塔
+    auto archer_tower = battle_stats::findBuilding("Archer Tower");
     templates.emplace_back(
         "Archer Tower",
         "buildings/archertower.png",
         350,
-        2,
-        2,
-        []() -> Building* {
-            return AttackBuilding::Create("Archer Tower", 10, { 0, 0 }, "buildings/archertower.png", 0.8, 7, 10);
+        archer_tower->width,
+        archer_tower->length,
+        [archer_tower]() -> Building* {
+            return AttackBuilding::Create("Archer Tower", archer_tower->base, { 0, 0 }, "buildings/archertower.png",
+                                         archer_tower->attackInterval, archer_tower->attackDamage, archer_tower->attackRange);
         }
     );
 
     // 加农炮
+    auto cannon = battle_stats::findBuilding("Cannon");
     templates.emplace_back(
         "Cannon",
         "buildings/cannon1.png",
         350,
-        2,
-        2,
-        []() -> Building* {
-            return AttackBuilding::Create("Cannon", 10, { 0, 0 }, "buildings/cannon1.png", 1.0, 10, 9);
+        cannon->width,
+        cannon->length,
+        [cannon]() -> Building* {
+            return AttackBuilding::Create("Cannon", cannon->base, { 0, 0 }, "buildings/cannon1.png",
+                                         cannon->attackInterval, cannon->attackDamage, cannon->attackRange);
         }
     );
     return templates;
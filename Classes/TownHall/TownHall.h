@@ -17,6 +17,7 @@
 #include "json/writer.h"
 #include "json/stringbuffer.h"
 #include "TownHallTemplate/TownHallTemplate.h"
+#include "TownHall/WallSegmentStore.h"
 
 /**
  * @brief 从JSON文件中读取玩家数据
@@ -72,7 +73,12 @@ protected:
 
     // ==================== 城墙管理相关属性 ====================
     int wall_capacity_;                        // 当前等级下可建造的最大城墙数量
-    std::vector<WallBuilding*> walls_;         // 管理的城墙列表
+    WallSegmentStore walls_;                   // 管理的城墙（紧凑数组存储）
+
+    // ==================== 存档事务相关属性 ====================
+    int save_transaction_depth_ = 0;           // 嵌套的存档事务层数
+    bool gold_dirty_ = false;                  // 事务中金币是否有未保存的修改
+    bool elixir_dirty_ = false;                // 事务中圣水是否有未保存的修改
 
     // ==================== 资源池管理相关属性 ====================
     std::vector<ProductionBuilding*> gold_storages_;           // 管理的金币池列表
@@ -87,6 +93,9 @@ protected:
     cocos2d::Label* level_label_;    // 显示大本营等级的文本标签
 
     // ==================== 内部辅助函数 ====================
+    void PersistGold();
+    void PersistElixir();
+    int UpgradeWalls(const std::vector<int>& indices);
     void UpdateArmyCapacityFromBarracks();
     int GetTotalArmyCapacityFromBarracks() const;
 
@@ -329,6 +338,15 @@ public:
      */
     int GetWallCapacity() const { return wall_capacity_; }
 
+    /**
+     * @brief 按大本营等级计算某类建筑的数量上限（不依赖单例状态，供布局校验使用）
+     * 公式与构造函数/Upgrade 中的容量增长保持一致（base = 1）。
+     * @param type 建筑类型名（与 BuildingTemplate::name_ 一致）
+     * @param town_hall_level 大本营等级
+     * @return 数量上限，-1 表示该类型不受限制
+     */
+    static int GetBuildingCapacityForLevel(const std::string& type, int town_hall_level);
+
     /**
      * @brief 检查是否可以添加更多城墙
      * @return true 表示已达到容量上限，无法添加更多城墙
@@ -348,6 +366,15 @@ public:
      */
     int UpgradeAllWalls();
 
+    /**
+     * @brief 批量升级一段连续城墙
+     * 升级与 from、to 同行或同列且位于两点之间的城墙，从 from 一端开始直到金币不足
+     * @param from 起点网格坐标
+     * @param to 终点网格坐标
+     * @return 成功开始升级的城墙数量
+     */
+    int UpgradeWallRun(const cocos2d::Vec2& from, const cocos2d::Vec2& to);
+
     /**
      * @brief 批量修复所有受损的城墙
      * 修复所有生命值不满的城墙
@@ -377,6 +404,24 @@ public:
      */
     int CountWallsByLevel(int min_level, int max_level) const;
 
+    /**
+     * @brief 获取城墙段存储（只读，用于统计与筛选）
+     */
+    const WallSegmentStore& GetWallStore() const { return walls_; }
+
+    // ==================== 存档事务 ====================
+
+    /**
+     * @brief 开始存档事务
+     * 事务期间资源变化只标记为待保存，最外层 CommitSaveTransaction 时统一写盘一次
+     */
+    void BeginSaveTransaction();
+
+    /**
+     * @brief 提交存档事务
+     */
+    void CommitSaveTransaction();
+
 
     // ==================== 资源与容量的 Get 接口 ====================
     /**
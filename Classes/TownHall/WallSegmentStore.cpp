@@ -0,0 +1,199 @@
+//
+// WallSegmentStore.cpp
+//
+
+#include "TownHall/WallSegmentStore.h"
+#include "Building/Building.h"
+#include <algorithm>
+#include <cmath>
+
+WallSegmentStore::~WallSegmentStore() {
+    Clear();
+}
+
+int WallSegmentStore::Add(WallBuilding* wall) {
+    if (wall->GetSegmentStore() == this) {
+        return wall->GetSegmentIndex();
+    }
+
+    int index = Size();
+    walls_.push_back(wall);
+    grid_x_.push_back(0);
+    grid_y_.push_back(0);
+    levels_.push_back(0);
+    health_.push_back(0);
+    max_health_.push_back(0);
+    next_cost_.push_back(0);
+    next_time_.push_back(0);
+    upgrading_.push_back(0);
+    wall->BindSegment(this, index);
+    Sync(index);
+    return index;
+}
+
+bool WallSegmentStore::Remove(WallBuilding* wall) {
+    if (!wall || wall->GetSegmentStore() != this) {
+        return false;
+    }
+
+    int index = wall->GetSegmentIndex();
+    int last = Size() - 1;
+    if (index != last) {
+        walls_[index] = walls_[last];
+        grid_x_[index] = grid_x_[last];
+        grid_y_[index] = grid_y_[last];
+        levels_[index] = levels_[last];
+        health_[index] = health_[last];
+        max_health_[index] = max_health_[last];
+        next_cost_[index] = next_cost_[last];
+        next_time_[index] = next_time_[last];
+        upgrading_[index] = upgrading_[last];
+        walls_[index]->BindSegment(this, index);
+    }
+
+    walls_.pop_back();
+    grid_x_.pop_back();
+    grid_y_.pop_back();
+    levels_.pop_back();
+    health_.pop_back();
+    max_health_.pop_back();
+    next_cost_.pop_back();
+    next_time_.pop_back();
+    upgrading_.pop_back();
+    wall->BindSegment(nullptr, -1);
+    return true;
+}
+
+void WallSegmentStore::Clear() {
+    for (auto* wall : walls_) {
+        wall->BindSegment(nullptr, -1);
+    }
+    walls_.clear();
+    grid_x_.clear();
+    grid_y_.clear();
+    levels_.clear();
+    health_.clear();
+    max_health_.clear();
+    next_cost_.clear();
+    next_time_.clear();
+    upgrading_.clear();
+}
+
+void WallSegmentStore::Sync(int index) {
+    if (index < 0 || index >= Size()) {
+        return;
+    }
+    const WallBuilding* wall = walls_[index];
+    const auto& pos = wall->GetMapPosition();
+    grid_x_[index] = static_cast<int>(std::lround(pos.x));
+    grid_y_[index] = static_cast<int>(std::lround(pos.y));
+    levels_[index] = wall->GetLevel();
+    health_[index] = wall->GetHealth();
+    max_health_[index] = wall->GetMaxHealth();
+    next_cost_[index] = wall->GetNextBuildCost();
+    next_time_[index] = wall->GetNextBuildTime();
+    upgrading_[index] = wall->IsUpgrading() ? 1 : 0;
+}
+
+WallSegmentStore::Stats WallSegmentStore::GetStats() const {
+    Stats stats;
+    for (int i = 0; i < Size(); ++i) {
+        if (health_[i] <= 0) {
+            continue;
+        }
+        stats.active++;
+        stats.damaged += health_[i] < max_health_[i];
+        stats.upgrading += upgrading_[i];
+    }
+    return stats;
+}
+
+bool WallSegmentStore::HasDamaged() const {
+    for (int i = 0; i < Size(); ++i) {
+        if (health_[i] > 0 && health_[i] < max_health_[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int WallSegmentStore::CountByLevel(int min_level, int max_level) const {
+    int count = 0;
+    for (int i = 0; i < Size(); ++i) {
+        count += health_[i] > 0 && levels_[i] >= min_level && levels_[i] <= max_level;
+    }
+    return count;
+}
+
+void WallSegmentStore::FindRun(const cocos2d::Vec2& from, const cocos2d::Vec2& to, std::vector<int>& indices) const {
+    indices.clear();
+    int x0 = static_cast<int>(std::lround(from.x)), y0 = static_cast<int>(std::lround(from.y));
+    int x1 = static_cast<int>(std::lround(to.x)), y1 = static_cast<int>(std::lround(to.y));
+    if (x0 != x1 && y0 != y1) {
+        return; // 只支持水平或竖直的一段
+    }
+
+    int min_x = std::min(x0, x1), max_x = std::max(x0, x1);
+    int min_y = std::min(y0, y1), max_y = std::max(y0, y1);
+    for (int i = 0; i < Size(); ++i) {
+        if (grid_x_[i] >= min_x && grid_x_[i] <= max_x && grid_y_[i] >= min_y && grid_y_[i] <= max_y) {
+            indices.push_back(i);
+        }
+    }
+    std::sort(indices.begin(), indices.end(), [&](int a, int b) {
+        return std::abs(grid_x_[a] - x0) + std::abs(grid_y_[a] - y0) <
+               std::abs(grid_x_[b] - x0) + std::abs(grid_y_[b] - y0);
+    });
+}
+
+void WallSegmentStore::AllIndices(std::vector<int>& indices) const {
+    indices.resize(walls_.size());
+    for (int i = 0; i < Size(); ++i) {
+        indices[i] = i;
+    }
+}
+
+int WallSegmentStore::SelectUpgrades(const std::vector<int>& indices, int budget, std::vector<int>& selected) const {
+    selected.clear();
+    int total = 0;
+    for (int i : indices) {
+        if (health_[i] <= 0 || upgrading_[i]) {
+            continue;
+        }
+        if (total + next_cost_[i] > budget) {
+            break;
+        }
+        total += next_cost_[i];
+        selected.push_back(i);
+    }
+    return total;
+}
+
+int WallSegmentStore::SelectRepairs(const std::vector<int>& indices, int budget, std::vector<int>& selected) const {
+    selected.clear();
+    int total = 0;
+    for (int i : indices) {
+        if (health_[i] <= 0 || health_[i] >= max_health_[i]) {
+            continue;
+        }
+        int cost = std::max(1, (max_health_[i] - health_[i]) / 20);
+        if (total + cost > budget) {
+            break;
+        }
+        total += cost;
+        selected.push_back(i);
+    }
+    return total;
+}
+
+void WallSegmentStore::StartUpgrades(const std::vector<int>& selected) {
+    for (int i : selected) {
+        walls_[i]->StartUpgrade(static_cast<float>(next_time_[i]));
+    }
+}
+
+void WallSegmentStore::Repair(const std::vector<int>& selected) {
+    for (int i : selected) {
+        walls_[i]->Repair();  // WallBuilding::Repair 回写 health_
+    }
+}
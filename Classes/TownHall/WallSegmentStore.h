@@ -0,0 +1,127 @@
+//
+// WallSegmentStore.h
+// 城墙段存储：以紧凑数组保存全部城墙的等级、血量、位置与升级状态，
+// 供大本营的批量城墙操作与统计使用
+//
+
+#pragma once
+#ifndef __WALL_SEGMENT_STORE_H__
+#define __WALL_SEGMENT_STORE_H__
+
+#include <vector>
+#include "cocos2d.h"
+
+class WallBuilding;
+
+/**
+ * @brief 城墙段存储
+ * 按列存储（每个属性一个连续数组），统计与筛选只扫描需要的列，
+ * 不再逐个访问城墙 Sprite。城墙状态变化（开始/完成升级、受伤、修复）时
+ * 由 WallBuilding 回写对应下标，数组与节点始终保持一致。
+ */
+class WallSegmentStore {
+public:
+    WallSegmentStore() = default;
+    ~WallSegmentStore();
+
+    WallSegmentStore(const WallSegmentStore&) = delete;
+    WallSegmentStore& operator=(const WallSegmentStore&) = delete;
+
+    /**
+     * @brief 统计结果
+     */
+    struct Stats {
+        int active = 0;       // 未被摧毁的城墙数
+        int damaged = 0;      // 生命值不满的城墙数
+        int upgrading = 0;    // 正在升级的城墙数
+    };
+
+    /**
+     * @brief 添加城墙
+     * @return 城墙所在下标，已存在时返回原下标
+     */
+    int Add(WallBuilding* wall);
+
+    /**
+     * @brief 移除城墙（与末尾交换后删除，其余城墙下标可能变化）
+     * @return true 表示城墙在存储中并已移除
+     */
+    bool Remove(WallBuilding* wall);
+
+    /**
+     * @brief 清空全部城墙
+     */
+    void Clear();
+
+    /**
+     * @brief 从城墙节点重新读取第 index 段的数据
+     */
+    void Sync(int index);
+
+    int Size() const { return static_cast<int>(walls_.size()); }
+    WallBuilding* GetWall(int index) const { return walls_[index]; }
+    int GetLevel(int index) const { return levels_[index]; }
+    bool IsUpgrading(int index) const { return upgrading_[index] != 0; }
+
+    /**
+     * @brief 统计活跃、受损与升级中的城墙数
+     */
+    Stats GetStats() const;
+
+    /**
+     * @brief 是否存在受损城墙
+     */
+    bool HasDamaged() const;
+
+    /**
+     * @brief 统计等级在 [min_level, max_level] 内的活跃城墙数
+     */
+    int CountByLevel(int min_level, int max_level) const;
+
+    /**
+     * @brief 查找一段连续城墙
+     * 收集与 from、to 位于同一行或同一列、且在两点之间（含端点）的城墙下标
+     * @param[out] indices 按到 from 的距离排序的下标
+     */
+    void FindRun(const cocos2d::Vec2& from, const cocos2d::Vec2& to, std::vector<int>& indices) const;
+
+    /**
+     * @brief 收集全部下标（用于对全部城墙执行批量操作）
+     */
+    void AllIndices(std::vector<int>& indices) const;
+
+    /**
+     * @brief 按顺序选出预算内可升级的城墙
+     * 跳过已摧毁或正在升级的城墙，遇到第一面付不起的城墙即停止
+     * @param indices 候选下标
+     * @param budget 可用金币
+     * @param[out] selected 选中的下标
+     * @return 选中城墙的总费用
+     */
+    int SelectUpgrades(const std::vector<int>& indices, int budget, std::vector<int>& selected) const;
+
+    /**
+     * @brief 按顺序选出预算内可修复的受损城墙（每面至少 1 金币），遇到付不起的即停止
+     * @return 选中城墙的总费用
+     */
+    int SelectRepairs(const std::vector<int>& indices, int budget, std::vector<int>& selected) const;
+
+    /**
+     * @brief 对选中的城墙开始升级 / 修复（数据由城墙回写）
+     */
+    void StartUpgrades(const std::vector<int>& selected);
+    void Repair(const std::vector<int>& selected);
+
+private:
+    std::vector<WallBuilding*> walls_;
+    std::vector<int> grid_x_;
+    std::vector<int> grid_y_;
+    std::vector<int> levels_;
+    std::vector<int> health_;
+    std::vector<int> max_health_;
+    std::vector<int> next_cost_;
+    std::vector<int> next_time_;
+    std::vector<unsigned char> upgrading_;
+};
+
+#endif // __WALL_SEGMENT_STORE_H__
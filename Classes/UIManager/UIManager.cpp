@@ -5,7 +5,8 @@
 #include <sstream>
 #include "MapManager/MapManager.h"      
 #include "Combat/Combat.h"        
-#include "MainScene.h"          
+#include "MainScene.h"
+#include "Profiler/GameProfiler.h"          
 
 USING_NS_CC;
 using namespace cocos2d::ui;
@@ -35,9 +36,18 @@ UIManager::UIManager()
     , _selectedBuilding(nullptr)
     , _goldLabel(nullptr)
     , _elixirLabel(nullptr)
-    , _loadingProgressBar(nullptr){ }
+    , _loadingProgressBar(nullptr){
+    // 战斗事件：只记录数值，HUD 在下一次 update 中统一刷新
+    EventBus::getInstance()->subscribe(GameEventType::DestructionChanged, &_battleHUD, [this](const GameEvent& e) {
+        updateDestructionPercent(e.destruction.stars, e.destruction.percent);
+    });
+}
 
 UIManager::~UIManager() {
+    EventBus::getInstance()->unsubscribeAll(this);
+    EventBus::getInstance()->unsubscribeAll(&_battleHUD);
+    TimerService::getInstance()->cancelAll(this);
+    unbindBattleHUD();
     closeAllPanels();
 }
 
@@ -50,7 +60,7 @@ bool UIManager::init(Scene* rootScene) {
     closeAllPanels();
 
     _rootScene = rootScene;
-    _callbacks.clear();
+    EventBus::getInstance()->unsubscribeAll(this);
     
     _visibleSize = Director::getInstance()->getVisibleSize();
     _visibleOrigin = Director::getInstance()->getVisibleOrigin();
@@ -227,13 +237,12 @@ void UIManager::showLoadingScreen() {
     AudioManager::getInstance()->playIntro();
     auto node = getPanel(UIPanelType::LoadingScreen);
     if (node) {
-        float* progress = new float(0.0f);
+        // 进度放在回调自己的状态里：面板提前销毁、回调被取消时不会泄漏
         // 每 0.05 秒更新一次
-        node->schedule([this, progress, node](float dt) {
-            *progress += 0.035f; 
-            this->updateLoadingProgress(*progress);            
-            if (*progress >= 1.0f) {
-                delete progress;
+        node->schedule([this, progress = 0.0f, node](float dt) mutable {
+            progress += 0.035f;
+            this->updateLoadingProgress(progress);
+            if (progress >= 1.0f) {
                 node->unschedule("fake_loading");
                 this->hideLoadingScreen(); // 100% 后自动进入游戏
             }
@@ -643,7 +652,7 @@ Node* UIManager::createShop() {
                     _pendingPlacementCost = templateCopy.cost_;
 
                     showToast("Drag to place " + templateCopy.name_);
-                    triggerUIEvent("OnEnterPlacementMode");
+                    triggerUIEvent(GameEventType::EnterPlacementMode);
                 }
             }
             else {
@@ -734,7 +743,9 @@ Node* UIManager::createMapSelection() {
         playMapSelectAnimation(0, [this]() {
             hidePanel(UIPanelType::MapSelection, true);
             showBattleLoading("Loading Battle Map 1...");
-            triggerUIEvent("OnBattleStart_Map1");
+            auto event = GameEvent::make(GameEventType::BattleStart);
+            event.level.levelId = 1;
+            triggerUIEvent(event);
             });
         });
     panel->addChild(node1, 2);
@@ -761,7 +772,9 @@ Node* UIManager::createMapSelection() {
         playMapSelectAnimation(1, [this]() {
             hidePanel(UIPanelType::MapSelection, true);
             showBattleLoading("Loading Battle Map 2...");
-            triggerUIEvent("OnBattleStart_Map2");
+            auto event = GameEvent::make(GameEventType::BattleStart);
+            event.level.levelId = 2;
+            triggerUIEvent(event);
             });
         });
     panel->addChild(node2, 2);
@@ -1232,16 +1245,26 @@ Node* UIManager::createBuildingUpgrade(Building* building) {
         upgradeBtn->addClickEventListener([this, upgradeCost, upgradeTime](Ref* sender) {
             hidePanel(UIPanelType::BuildingUpgrade, true);
 
+            // StartUpgrade 没有启动计时器（例如已在升级中）时不扣费，也不显示进度条
+            if (_selectedBuilding->IsUpgrading()) {
+                showToast("Already upgrading!");
+                return;
+            }
+            _selectedBuilding->StartUpgrade(upgradeTime);
+            if (!_selectedBuilding->IsUpgrading()) {
+                showToast("Upgrade failed!");
+                return;
+            }
+
             TownHall* townHall = TownHall::GetInstance();
             townHall->SpendElixir(upgradeCost);
             updateResourceDisplay(ResourceType::Elixir, townHall->GetElixir());
-            _selectedBuilding->StartUpgrade(upgradeTime);
 
             // 获取地图容器，使进度条跟随地图移动
             auto worldNode = _selectedBuilding->getParent();
             showUpgradeProgress(_selectedBuilding, (float)upgradeTime, (float)upgradeTime, worldNode);
             showToast("Upgrade started!");
-            triggerUIEvent("OnUpgradeStarted");
+            triggerUIEvent(GameEventType::UpgradeStarted);
             });
     }
     else {
@@ -1480,7 +1503,7 @@ Node* UIManager::createArmyTraining(Building* building) {
         saveArmyConfig();
         hidePanel(UIPanelType::ArmyTraining, true);
         showToast("Army configuration saved!");
-        triggerUIEvent("OnArmyConfigSaved");
+        triggerUIEvent(GameEventType::ArmyConfigSaved);
         });
     panel->addChild(trainBtn, 1);
 
@@ -1695,7 +1718,7 @@ Node* UIManager::createBattleHUD() {
     endBtn->setPosition(Vec2(70 * _scaleFactor, controlBarY + controlBarHeight / 2));
     endBtn->addClickEventListener([this](Ref* sender) {
         showConfirmDialog("End Battle", "Return to village?", [this]() {
-            triggerUIEvent("OnRequestEndBattle");
+            triggerUIEvent(GameEventType::RequestEndBattle);
             });
         }); 
     panel->addChild(endBtn, 2);
@@ -1734,9 +1757,83 @@ Node* UIManager::createBattleHUD() {
     timerLabel->setName("CountdownLabel");
     panel->addChild(timerLabel, 1);
 
+    bindBattleHUD(panel);
     return panel;
 }
 
+// 缓存战斗 HUD 控件（只在面板创建时按名字查找一次）
+void UIManager::bindBattleHUD(Node* panel) {
+    unbindBattleHUD();
+    if (!panel) return;
+
+    _battleHUD.panel = panel;
+    panel->retain();
+    _battleHUD.countdownLabel = panel->getChildByName<Label*>("CountdownLabel");
+    auto statusBar = panel->getChildByName("statusBar");
+    if (statusBar) {
+        _battleHUD.destroyLabel = statusBar->getChildByName<Label*>("destroyLabel");
+        for (int i = 0; i < 3; i++) {
+            _battleHUD.stars[i] = statusBar->getChildByName<DrawNode*>("star_" + std::to_string(i));
+        }
+    }
+
+    _battleHUD.troops.resize(_battleTroopNames.size());
+    for (size_t i = 0; i < _battleTroopNames.size(); i++) {
+        auto container = panel->getChildByName("troopBtn_" + std::to_string(i));
+        if (!container) continue;
+        auto& slot = _battleHUD.troops[i];
+        slot.countLabel = container->getChildByName<Label*>("countLabel");
+        slot.icon = container->getChildByName<Sprite*>("icon");
+        slot.selectBorder = container->getChildByName("selectBorder");
+        slot.shownCount = _battleTroopCounts[_battleTroopNames[i]];
+    }
+
+    // 创建时写入的初始值
+    _battleHUD.shownStars = 0;
+    _battleHUD.shownPercent = 0;
+}
+
+void UIManager::unbindBattleHUD() {
+    CC_SAFE_RELEASE(_battleHUD.panel);
+    _battleHUD = BattleHUDBinding();
+}
+
+// 面板被替换或移除后绑定失效，此时跳过刷新
+bool UIManager::isBattleHUDBound() const {
+    return _battleHUD.panel && getPanel(UIPanelType::BattleHUD) == _battleHUD.panel;
+}
+
+// 把本帧累积的战斗事件一次性写入控件
+void UIManager::flushBattleHUD() {
+    if (!isBattleHUDBound()) return;
+
+    if (_battleHUD.destructionDirty) {
+        _battleHUD.destructionDirty = false;
+
+        if (_battleHUD.destroyLabel && _battleHUD.pendingPercent != _battleHUD.shownPercent) {
+            _battleHUD.destroyLabel->setString(std::to_string(_battleHUD.pendingPercent) + "%");
+        }
+        _battleHUD.shownPercent = _battleHUD.pendingPercent;
+
+        if (_battleHUD.pendingStars != _battleHUD.shownStars) {
+            float starSize = 20 * _scaleFactor;
+            for (int i = 0; i < 3; i++) {
+                auto star = _battleHUD.stars[i];
+                if (!star) continue;
+                star->clear();
+                Color4F starColor = (i < _battleHUD.pendingStars) ? Color4F(1, 0.8f, 0, 1) : Color4F(0.3f, 0.3f, 0.3f, 1);
+                star->drawSolidCircle(Vec2::ZERO, starSize / 2, 0, 5, starColor);
+            }
+            _battleHUD.shownStars = _battleHUD.pendingStars;
+        }
+    }
+
+    if (_battleHUD.troopsDirty) {
+        _battleHUD.troopsDirty = false;
+        refreshBattleHUDTroops();
+    }
+}
+
 // 选中战斗士兵
 void UIManager::selectBattleTroop(int index, const std::string& troopName) {
     auto panel = getPanel(UIPanelType::BattleHUD);
@@ -1749,47 +1846,39 @@ void UIManager::selectBattleTroop(int index, const std::string& troopName) {
     }
 
     // 取消之前的选中状态
-    if (_selectedTroopIndex >= 0) {
-        auto prevContainer = panel->getChildByName("troopBtn_" + std::to_string(_selectedTroopIndex));
-        if (prevContainer) {
-            auto prevBorder = prevContainer->getChildByName("selectBorder");
-            if (prevBorder) prevBorder->setVisible(false);
-        }
-    }
+    setBattleTroopSelected(_selectedTroopIndex, false);
 
     // 设置新的选中状态
     _selectedTroopIndex = index;
     _selectedTroopName = troopName;
-
-    auto container = panel->getChildByName("troopBtn_" + std::to_string(index));
-    if (container) {
-        auto border = container->getChildByName("selectBorder");
-        if (border) border->setVisible(true);
-    }
+    setBattleTroopSelected(index, true);
 
     CCLOG("Selected troop: %s", troopName.c_str());
 }
 
 // 取消选中士兵
 void UIManager::deselectBattleTroop() {
-    if (_selectedTroopIndex >= 0) {
-        auto panel = getPanel(UIPanelType::BattleHUD);
-        if (panel) {
-            auto container = panel->getChildByName("troopBtn_" + std::to_string(_selectedTroopIndex));
-            if (container) {
-                auto border = container->getChildByName("selectBorder");
-                if (border) border->setVisible(false);
-            }
-        }
-    }
+    setBattleTroopSelected(_selectedTroopIndex, false);
     _selectedTroopIndex = -1;
     _selectedTroopName = "";
 }
 
-// 更新战斗中士兵数量
+// 切换士兵按钮选中边框
+void UIManager::setBattleTroopSelected(int index, bool selected) {
+    if (index < 0 || !isBattleHUDBound() || index >= static_cast<int>(_battleHUD.troops.size())) return;
+    auto border = _battleHUD.troops[index].selectBorder;
+    if (border) border->setVisible(selected);
+}
+
+// 更新战斗中士兵数量（控件在下一帧 update 中统一刷新）
 void UIManager::updateBattleTroopCount(const std::string& troopName, int newCount) {
     _battleTroopCounts[troopName] = newCount;
-    refreshBattleHUDTroops();
+
+    // 数量为0时立即取消选中，避免同一帧内继续部署
+    if (newCount <= 0 && troopName == _selectedTroopName) {
+        deselectBattleTroop();
+    }
+    _battleHUD.troopsDirty = true;
 }
 
 // 获取指定士兵的剩余数量
@@ -1800,60 +1889,39 @@ int UIManager::getBattleTroopCount(const std::string& troopName) const {
 
 // 刷新战斗HUD士兵显示
 void UIManager::refreshBattleHUDTroops() {
-    auto panel = getPanel(UIPanelType::BattleHUD);
-    if (!panel) return;
+    if (!isBattleHUDBound()) return;
 
-    for (size_t i = 0; i < _battleTroopNames.size(); i++) {
-        const std::string& troopName = _battleTroopNames[i];
-        int count = _battleTroopCounts[troopName];
+    size_t slotCount = std::min(_battleTroopNames.size(), _battleHUD.troops.size());
+    for (size_t i = 0; i < slotCount; i++) {
+        auto& slot = _battleHUD.troops[i];
+        int count = _battleTroopCounts[_battleTroopNames[i]];
+        if (count == slot.shownCount) continue;
+        slot.shownCount = count;
 
-        auto container = panel->getChildByName("troopBtn_" + std::to_string(i));
-        if (!container) continue;
-
-        auto countLabel = container->getChildByName<Label*>("countLabel");
-        auto icon = container->getChildByName<Sprite*>("icon");
-        auto selectBorder = container->getChildByName("selectBorder");
-
-        if (countLabel) {
-            countLabel->setString(std::to_string(count));
+        if (slot.countLabel) {
+            slot.countLabel->setString(std::to_string(count));
         }
 
-        // 数量为0时变灰并取消选中
+        // 数量为0时变灰并隐藏选中框
         if (count <= 0) {
-            if (icon) icon->setColor(Color3B(80, 80, 80));
-            if (selectBorder) selectBorder->setVisible(false);
+            if (slot.icon) slot.icon->setColor(Color3B(80, 80, 80));
+            if (slot.selectBorder) slot.selectBorder->setVisible(false);
             if (_selectedTroopIndex == (int)i) {
                 _selectedTroopIndex = -1;
                 _selectedTroopName = "";
             }
+        } else if (slot.icon) {
+            // 恢复战斗快照后数量可能重新变为正数
+            slot.icon->setColor(Color3B::WHITE);
         }
     }
 }
 
-// 更新摧毁百分比和星级
+// 更新摧毁百分比和星级（控件在下一帧 update 中统一刷新）
 void UIManager::updateDestructionPercent(int stars,int percent) {
-    auto panel = getPanel(UIPanelType::BattleHUD);
-    if (!panel) return;
-
-    auto statusBar = panel->getChildByName("statusBar");
-    if (!statusBar) return;
-
-    // 更新百分比
-    auto destroyLabel = statusBar->getChildByName<Label*>("destroyLabel");
-    if (destroyLabel) {
-        destroyLabel->setString(std::to_string(percent) + "%");
-    }
-
-    // 更新星级显示
-    float starSize = 20 * _scaleFactor;
-    for (int i = 0; i < 3; i++) {
-        auto star = statusBar->getChildByName<DrawNode*>("star_" + std::to_string(i));
-        if (star) {
-            star->clear();
-            Color4F starColor = (i < stars) ? Color4F(1, 0.8f, 0, 1) : Color4F(0.3f, 0.3f, 0.3f, 1);
-            star->drawSolidCircle(Vec2::ZERO, starSize / 2, 0, 5, starColor);
-        }
-    }
+    _battleHUD.pendingStars = stars;
+    _battleHUD.pendingPercent = percent;
+    _battleHUD.destructionDirty = true;
 }
 
 // ==================== 战斗模式 ====================
@@ -1868,6 +1936,7 @@ void UIManager::enterBattleMode(MapManager* battleMap) {
     _isBattleMode = true;
     _isReplayMode = false;
     _recordedSteps.clear();
+    _recordedChecksums = CombatChecksumLog();
     _currentBattleMap = battleMap;
     _selectedTroopIndex = -1;
     _selectedTroopName = "";
@@ -1903,6 +1972,33 @@ bool UIManager::areAllTroopsDeployed() const {
     return true;
 }
 
+BattleDeployState UIManager::captureDeployState() const {
+    BattleDeployState state;
+    state.nextReplayStep = _nextReplayStepIndex;
+    state.recordedSteps = _recordedSteps.size();
+    state.troopCounts = _battleTroopCounts;
+    return state;
+}
+
+void UIManager::restoreDeployState(const BattleDeployState& state) {
+    _nextReplayStepIndex = state.nextReplayStep;
+    if (_recordedSteps.size() > state.recordedSteps) {
+        _recordedSteps.resize(state.recordedSteps);
+    }
+    if (_isBattleMode) {
+        for (const auto& pair : state.troopCounts) {
+            updateBattleTroopCount(pair.first, pair.second);
+        }
+    }
+
+    // 剩余时间可能回到最后 30 秒之前
+    _battleHUD.shownSeconds = -1;
+    if (_battleHUD.timerWarning && _battleHUD.countdownLabel) {
+        _battleHUD.countdownLabel->setColor(Color3B::WHITE);
+    }
+    _battleHUD.timerWarning = false;
+}
+
 void UIManager::exitBattleMode() {
     if (!_isBattleMode) return;
 
@@ -1928,12 +2024,14 @@ void UIManager::exitBattleMode() {
 
 // ==================== 回放模式相关 ====================
 
-void UIManager::enterReplayMode(MapManager* battleMap, const std::vector<ReplayStep>& steps) {
+void UIManager::enterReplayMode(MapManager* battleMap, const std::vector<ReplayStep>& steps,
+                                const CombatChecksumLog& checksums) {
     CCLOG("UIManager::enterReplayMode called! Map: %p, Steps: %d", battleMap, (int)steps.size());
     _currentBattleMap = battleMap;
     _isBattleMode = false;
     _isReplayMode = true;
     _playbackSteps = steps;
+    _playbackChecksums = checksums;
     _replayTimer = 0.0f;
     _nextReplayStepIndex = 0;
 
@@ -1950,30 +2048,38 @@ void UIManager::exitReplayMode() {
     _currentBattleMap = nullptr;
     _recordedSteps.clear();
     _playbackSteps.clear();
+    _recordedChecksums = CombatChecksumLog();
+    _playbackChecksums = CombatChecksumLog();
+}
+
+void UIManager::recordChecksums(const CombatChecksumLog& checksums) {
+    if (_isReplayMode) return;
+    _recordedChecksums = checksums;
 }
 
 void UIManager::update(float dt) {
-    // 刷新倒计时（仅在战斗模式下）
-    if (_isBattleMode || _isReplayMode) {
-        auto hud = getPanel(UIPanelType::BattleHUD);
-        if (hud) {
-            auto timerLabel = dynamic_cast<Label*>(hud->getChildByName("CountdownLabel"));
-            if (timerLabel) {
-                auto combatMgr = CombatManager::GetInstance();
-                if (combatMgr) {
-                    float remaining = combatMgr->getRemainingTime();
-                    int minutes = static_cast<int>(remaining) / 60;
-                    int seconds = static_cast<int>(remaining) % 60;
-                    timerLabel->setString(StringUtils::format("%d:%02d", minutes, seconds));
-                    
-                    // 最后30秒变红
-                    if (remaining < 30.0f) {
-                        timerLabel->setColor(Color3B::RED);
-                    }
-                }
-            }
+    PROFILE_SCOPE(ProfileZone::UIUpdate);
+    // 刷新倒计时（仅在战斗模式下），只有显示的秒数变化时才重设文本
+    if (!(_isBattleMode || _isReplayMode) || !isBattleHUDBound()) return;
+
+    auto timerLabel = _battleHUD.countdownLabel;
+    auto combatMgr = CombatManager::GetInstance();
+    if (timerLabel && combatMgr) {
+        float remaining = combatMgr->getRemainingTime();
+        int totalSeconds = static_cast<int>(remaining);
+        if (totalSeconds != _battleHUD.shownSeconds) {
+            _battleHUD.shownSeconds = totalSeconds;
+            timerLabel->setString(StringUtils::format("%d:%02d", totalSeconds / 60, totalSeconds % 60));
+        }
+
+        // 最后30秒变红
+        if (!_battleHUD.timerWarning && remaining < 30.0f) {
+            _battleHUD.timerWarning = true;
+            timerLabel->setColor(Color3B::RED);
         }
     }
+
+    flushBattleHUD();
 }
 
 void UIManager::updateReplay() {
@@ -1984,10 +2090,15 @@ void UIManager::updateReplay() {
     if (!combatMgr) return;
     
     float currentCombatTime = combatMgr->getCombatTime();
+    int currentCombatTick = combatMgr->getCombatTick();
+    // 有 tick 的步骤按 tick 对齐，不受浮点时间累加误差影响
+    auto isStepDue = [&](const ReplayStep& step) {
+        return step.tick >= 0 ? currentCombatTick >= step.tick : currentCombatTime >= step.time;
+    };
 
     // 检查并执行回放步骤
     while (_nextReplayStepIndex < _playbackSteps.size() && 
-           currentCombatTime >= _playbackSteps[_nextReplayStepIndex].time) {
+           isStepDue(_playbackSteps[_nextReplayStepIndex])) {
         
         const auto& step = _playbackSteps[_nextReplayStepIndex];
         CCLOG("Replay attempt: step %d, troop: %s, time: %.2f (current: %.2f)", 
@@ -2103,6 +2214,7 @@ bool UIManager::deploySoldierAt(const cocos2d::Vec2& screenPos) {
     if (!_isReplayMode) {
         ReplayStep step;
         step.time = CombatManager::GetInstance()->getCombatTime();
+        step.tick = CombatManager::GetInstance()->getCombatTick();
         step.troopName = _selectedTroopName;
         step.pos = vecPos;
         _recordedSteps.push_back(step);
@@ -2174,7 +2286,7 @@ Node* UIManager::createReplayHUD() {
     exitBtn->setScale9Enabled(true);
     exitBtn->setPosition(Vec2(80 * _scaleFactor, 80 * _scaleFactor));
     exitBtn->addClickEventListener([this](Ref* sender) {
-        triggerUIEvent("OnRequestExitReplay");
+        triggerUIEvent(GameEventType::RequestExitReplay);
     });
     panel->addChild(exitBtn);
 
@@ -2301,6 +2413,7 @@ Node* UIManager::createBattleResult(int stars, int destroyPercent, bool isReplay
             _battleTroopCounts.clear();
             _battleTroopNames.clear();
             _recordedSteps.clear();
+            _recordedChecksums = CombatChecksumLog();
 
             // 返回主场景
             auto mainScene = MainScene::createScene();
@@ -2318,7 +2431,7 @@ Node* UIManager::createBattleResult(int stars, int destroyPercent, bool isReplay
     replayBtn->setPosition(Vec2(panelSize.width / 2 + 80 * _scaleFactor, 35 * _scaleFactor));
     replayBtn->addClickEventListener([this](Ref* sender) {
         // 发送 UI 事件，让外部处理回放请求
-        triggerUIEvent("OnRequestReplay");
+        triggerUIEvent(GameEventType::RequestReplay);
     });
     panel->addChild(replayBtn, 1);
 
@@ -2382,7 +2495,8 @@ Node* UIManager::createUpgradeProgressOverlay(Building* building, float totalTim
 }
 
 void UIManager::showUpgradeProgress(Building* building, float totalTime, float remainingTime, Node* parent) {
-    if (!building || !_rootScene) return;
+    // 完成计时器取建筑的剩余升级时间，建筑不在升级中时会立刻触发虚假的“升级完成”
+    if (!building || !_rootScene || !building->IsUpgrading()) return;
 
     // 移除已存在的进度条（防止重复）
     removeUpgradeProgress(building);
@@ -2405,94 +2519,82 @@ void UIManager::showUpgradeProgress(Building* building, float totalTime, float r
             buildingWorldPos.y + offset));
         _rootScene->addChild(overlay, static_cast<int>(UILayer::Tips)); // 使用 Tips 层，层级更高
     }
-    _upgradeProgressNodes[building] = overlay;
-
-    // 存储 totalTime（用于计算进度），removeUpgradeProgress 会 delete
-    overlay->setUserData(new float(totalTime));
+    auto& entry = _upgradeProgressNodes[building];
+    entry.node = overlay;
+    overlay->retain();
+    entry.timeLabel = overlay->getChildByName<Label*>("timeLabel");
+    entry.progressFill = overlay->getChildByName<LayerColor*>("progressFill");
+    entry.totalTime = totalTime;
 
-    // 启动更新定时器：每次读取 Building 的剩余时间（权威来源）
-    overlay->schedule([this, building](float dt) {
+    // 完成回调与建筑的升级计时器同一时刻到期（owner 为建筑，建筑析构时一并取消）
+    auto timers = TimerService::getInstance();
+    entry.completionTimer = timers->start(building->GetUpgradeRemainingTime(), [this, building]() {
         auto it = _upgradeProgressNodes.find(building);
-        if (it == _upgradeProgressNodes.end()) return;
-
-        Node* ov = it->second;
-        if (!ov) return;
-
-        // 从 building 获取剩余时间（请根据实际方法名替换）
-        float remaining = 0.0f;
-        remaining = building->GetUpgradeRemainingTime();
+        if (it != _upgradeProgressNodes.end()) {
+            applyUpgradeOverlay(it->second, 0.0f);
+        }
+        removeUpgradeProgress(building);
+        showToast("Upgrade complete!");
+        triggerUIEvent(GameEventType::UpgradeComplete);
+        }, building);
 
-        // 安全读取 totalTime
-        float totalTime = 0.0f;
-        float* totalPtr = static_cast<float*>(ov->getUserData());
-        if (totalPtr) totalTime = *totalPtr;
+    // 所有进度条共用一个刷新计时器，只在显示的秒数/像素宽度变化时写入控件
+    if (!timers->isActive(_upgradeRefreshTimer)) {
+        _upgradeRefreshTimer = timers->start(0.25f, [this]() { refreshUpgradeOverlays(); }, this, 0.25f);
+    }
+}
 
-        auto timeLabel = ov->getChildByName<Label*>("timeLabel");
-        auto progressFill = ov->getChildByName<LayerColor*>("progressFill");
+void UIManager::applyUpgradeOverlay(UpgradeOverlay& overlay, float remainingTime) {
+    int totalSeconds = static_cast<int>(remainingTime);
+    if (overlay.timeLabel && totalSeconds != overlay.shownSeconds) {
+        overlay.shownSeconds = totalSeconds;
+        overlay.timeLabel->setString(StringUtils::format("%02d:%02d", totalSeconds / 60, totalSeconds % 60));
+    }
 
-        if (remaining <= 0.0f) {
-            // 完成
-            if (timeLabel) timeLabel->setString("00:00");
-            if (progressFill && totalTime > 0.0f) {
-                progressFill->setContentSize(Size(ov->getContentSize().width, 15 * _scaleFactor));
-            }
-            removeUpgradeProgress(building);
-            showToast("Upgrade complete!");
-            triggerUIEvent("OnUpgradeComplete");
-            return;
+    if (overlay.progressFill && overlay.totalTime > 0.0f) {
+        float progress = std::clamp((overlay.totalTime - remainingTime) / overlay.totalTime, 0.0f, 1.0f);
+        int width = static_cast<int>(overlay.node->getContentSize().width * progress);
+        if (width != overlay.shownWidth) {
+            overlay.shownWidth = width;
+            overlay.progressFill->setContentSize(Size(static_cast<float>(width), 15 * _scaleFactor));
         }
+    }
+}
 
-        // 更新 UI
-        int minutes = static_cast<int>(remaining) / 60;
-        int seconds = static_cast<int>(remaining) % 60;
-        if (timeLabel) timeLabel->setString(StringUtils::format("%02d:%02d", minutes, seconds));
-
-        if (progressFill && totalTime > 0.0f) {
-            float progress = (totalTime - remaining) / totalTime;
-            progress = std::clamp(progress, 0.0f, 1.0f);
-            progressFill->setContentSize(Size(ov->getContentSize().width * progress, 15 * _scaleFactor));
+void UIManager::refreshUpgradeOverlays() {
+    auto timers = TimerService::getInstance();
+    for (auto it = _upgradeProgressNodes.begin(); it != _upgradeProgressNodes.end(); ) {
+        auto& overlay = it->second;
+        // 完成计时器失效说明建筑已销毁（例如切换场景），直接丢弃
+        if (!timers->isActive(overlay.completionTimer)) {
+            overlay.node->removeFromParent();
+            CC_SAFE_RELEASE(overlay.node);
+            it = _upgradeProgressNodes.erase(it);
+            continue;
         }
-        }, "upgradeTimer");
+        applyUpgradeOverlay(overlay, timers->getRemaining(overlay.completionTimer));
+        ++it;
+    }
+
+    if (_upgradeProgressNodes.empty()) {
+        timers->cancel(_upgradeRefreshTimer);
+        _upgradeRefreshTimer = TimerService::kInvalidTimer;
+    }
 }
 
 void UIManager::updateUpgradeProgress(Building* building, float remainingTime) {
     auto it = _upgradeProgressNodes.find(building);
-    if (it == _upgradeProgressNodes.end() || !it->second) return;
-
-    Node* ov = it->second;
-    auto timeLabel = ov->getChildByName<Label*>("timeLabel");
-    auto progressFill = ov->getChildByName<LayerColor*>("progressFill");
-
-    if (timeLabel) {
-        int minutes = static_cast<int>(remainingTime) / 60;
-        int seconds = static_cast<int>(remainingTime) % 60;
-        timeLabel->setString(StringUtils::format("%02d:%02d", minutes, seconds));
-    }
-
-    // 读取 totalTime 计算进度
-    float* totalTimePtr = static_cast<float*>(ov->getUserData());
-    if (progressFill && totalTimePtr && *totalTimePtr > 0.0f) {
-        float totalTime = *totalTimePtr;
-        float progress = (totalTime - remainingTime) / totalTime;
-        progress = std::clamp(progress, 0.0f, 1.0f);
-        progressFill->setContentSize(Size(ov->getContentSize().width * progress, 15 * _scaleFactor));
-    }
+    if (it == _upgradeProgressNodes.end()) return;
+    applyUpgradeOverlay(it->second, remainingTime);
 }
 
 void UIManager::removeUpgradeProgress(Building* building) {
     auto it = _upgradeProgressNodes.find(building);
     if (it == _upgradeProgressNodes.end()) return;
 
-    if (it->second) {
-        // 清理 userData（totalTime）
-        float* totalTimePtr = static_cast<float*>(it->second->getUserData());
-        if (totalTimePtr) {
-            delete totalTimePtr;
-            it->second->setUserData(nullptr);
-        }
-        it->second->unschedule("upgradeTimer");
-        it->second->removeFromParent();
-    }
+    TimerService::getInstance()->cancel(it->second.completionTimer);
+    it->second.node->removeFromParent();
+    CC_SAFE_RELEASE(it->second.node);
     _upgradeProgressNodes.erase(it);
 }
 
@@ -2762,15 +2864,16 @@ void UIManager::playHideAnimation(Node* panel, const std::function<void()>& call
 }
 
 // ==================== UI事件系统 ====================
-void UIManager::setUICallback(const std::string& eventName, const std::function<void()>& callback) {
-    _callbacks[eventName] = callback;
+void UIManager::setUICallback(GameEventType type, const EventBus::Handler& callback) {
+    EventBus::getInstance()->subscribe(type, this, callback);
 }
 
-void UIManager::triggerUIEvent(const std::string& eventName) {
-    auto it = _callbacks.find(eventName);
-    if (it != _callbacks.end() && it->second) {
-        it->second();
-    }
+void UIManager::triggerUIEvent(GameEventType type) {
+    EventBus::getInstance()->publish(type);
+}
+
+void UIManager::triggerUIEvent(const GameEvent& event) {
+    EventBus::getInstance()->publish(event);
 }
 
 // ==================== 屏幕适配工具 ====================
@@ -7,6 +7,9 @@
 #include <string>
 #include <map>
 #include <functional>
+#include "EventBus/EventBus.h"
+#include "TimerService/TimerService.h"
+#include "Combat/CombatChecksum.h"
 
 // 前向声明
 class Building;
@@ -67,10 +70,18 @@ enum class ResourceType {
 // 回放步骤结构体
 struct ReplayStep {
     float time;          // 战斗开始后的秒数
+    int tick = -1;       // 战斗开始后的 update 次数，回放按它对齐；-1 时退回按 time 对齐
     std::string troopName; 
     cocos2d::Vec2 pos;    // 地图坐标
 };
 
+// 战斗快照中与部署相关的 UI 状态
+struct BattleDeployState {
+    int nextReplayStep = 0;                  // 回放：下一条待执行的步骤
+    size_t recordedSteps = 0;                // 实战：已录制的部署条数
+    std::map<std::string, int> troopCounts;  // 实战：各兵种剩余数量
+};
+
 // 建筑类型枚举（用于判断BuildingOptions显示哪些按钮）
 enum class BuildingCategory {
     Normal,           // 普通建筑（信息/升级）
@@ -194,8 +205,10 @@ public:
     void playMapSelectAnimation(int mapIndex, const std::function<void()>& onComplete);
 
     // ========== UI事件系统 ==========
-    void setUICallback(const std::string& eventName, const std::function<void()>& callback);
-    void triggerUIEvent(const std::string& eventName);
+    // 场景通过它订阅 UI 请求事件（每次 init 时清空），事件经 EventBus 在下一次派发时执行
+    void setUICallback(GameEventType type, const EventBus::Handler& callback);
+    void triggerUIEvent(GameEventType type);
+    void triggerUIEvent(const GameEvent& event);
 
     // ========== 屏幕适配工具 ==========
     cocos2d::Size getVisibleSize() const;
@@ -213,7 +226,9 @@ public:
 
     // ========== 回放模式（新增）==========
     // 进入回放模式
-    void enterReplayMode(MapManager* battleMap, const std::vector<ReplayStep>& steps);
+    // checksums 为原战斗的状态检查点，回放时逐点比对
+    void enterReplayMode(MapManager* battleMap, const std::vector<ReplayStep>& steps,
+                         const CombatChecksumLog& checksums = CombatChecksumLog());
     // 退出回放模式
     void exitReplayMode();
     // 是否处于回放模式
@@ -228,10 +243,18 @@ public:
     int getCurrentLevelId() const { return _currentLevelId; }
     const std::vector<ReplayStep>& getRecordedSteps() const { return _recordedSteps; }
     const std::vector<ReplayStep>& getPlaybackSteps() const { return _playbackSteps; }
+    // 战斗结束时由 CombatManager 交来本场检查点（回放中忽略）
+    void recordChecksums(const CombatChecksumLog& checksums);
+    const CombatChecksumLog& getRecordedChecksums() const { return _recordedChecksums; }
+    const CombatChecksumLog& getPlaybackChecksums() const { return _playbackChecksums; }
     
     // 检查所有士兵是否已部署完毕
     bool areAllTroopsDeployed() const;
 
+    // 战斗快照用：保存/恢复部署进度，恢复后 HUD 在下一帧按新数值刷新
+    BattleDeployState captureDeployState() const;
+    void restoreDeployState(const BattleDeployState& state);
+
     // 结束战斗（由 Combat 调用，显示结算界面）
     void endBattle(int stars, int destroyPercent);
 
@@ -297,14 +320,24 @@ private:
     // 模态遮罩层缓存
     std::map<UIPanelType, cocos2d::LayerColor*> _modalLayers;
 
-    // UI事件回调映射
-    std::map<std::string, std::function<void()>> _callbacks;
-
     // 当前选中的建筑（用于BuildingOptions/Info/Upgrade）
     Building* _selectedBuilding;
 
-    // 升级进度覆盖层缓存（建筑指针 -> 进度条节点）
-    std::map<Building*, cocos2d::Node*> _upgradeProgressNodes;
+    // 升级进度覆盖层（缓存控件指针，由一个共享的刷新计时器批量更新）
+    struct UpgradeOverlay {
+        cocos2d::Node* node = nullptr;          // 持有引用
+        cocos2d::Label* timeLabel = nullptr;
+        cocos2d::LayerColor* progressFill = nullptr;
+        float totalTime = 0.0f;
+        int shownSeconds = -1;
+        int shownWidth = -1;
+        TimerService::TimerId completionTimer = TimerService::kInvalidTimer;
+    };
+    // 升级进度覆盖层缓存（建筑指针 -> 进度条）
+    std::map<Building*, UpgradeOverlay> _upgradeProgressNodes;
+    TimerService::TimerId _upgradeRefreshTimer = TimerService::kInvalidTimer;
+    void refreshUpgradeOverlays();
+    void applyUpgradeOverlay(UpgradeOverlay& overlay, float remainingTime);
 
     // 资源栏标签引用（用于快速更新）
     cocos2d::Label* _goldLabel;
@@ -331,6 +364,8 @@ private:
     int _nextReplayStepIndex = 0;
     std::vector<ReplayStep> _recordedSteps; // 录制容器
     std::vector<ReplayStep> _playbackSteps; // 回放容器
+    CombatChecksumLog _recordedChecksums;   // 录制时的状态检查点
+    CombatChecksumLog _playbackChecksums;   // 回放比对用的检查点
     int _currentLevelId = 0;                // 当前关卡ID
 
     // ========== 战斗模式相关（新增）==========
@@ -352,9 +387,42 @@ private:
     // 当前选中的士兵类型名称
     std::string _selectedTroopName;
 
+    // 战斗 HUD 控件绑定：面板创建时缓存控件指针，之后只在数值变化时写入控件，
+    // 避免每帧 getChildByName + 格式化字符串 + Label 重新排版
+    struct BattleHUDTroopSlot {
+        cocos2d::Label* countLabel = nullptr;
+        cocos2d::Sprite* icon = nullptr;
+        cocos2d::Node* selectBorder = nullptr;
+        int shownCount = -1;                   // 当前显示的数量，-1 表示未写入
+    };
+    struct BattleHUDBinding {
+        cocos2d::Node* panel = nullptr;        // 持有引用，保证缓存的子节点指针有效
+        cocos2d::Label* countdownLabel = nullptr;
+        cocos2d::Label* destroyLabel = nullptr;
+        cocos2d::DrawNode* stars[3] = {};
+        std::vector<BattleHUDTroopSlot> troops;  // 下标与 _battleTroopNames 一致
+
+        int shownSeconds = -1;
+        bool timerWarning = false;
+        int shownStars = -1;
+        int shownPercent = -1;
+
+        // 战斗事件写入的待刷新值，每帧 update 中统一刷新一次
+        int pendingStars = 0;
+        int pendingPercent = 0;
+        bool destructionDirty = false;
+        bool troopsDirty = false;
+    };
+    BattleHUDBinding _battleHUD;
+
     // 战斗 HUD 内部方法
     void selectBattleTroop(int index, const std::string& troopName);
+    void setBattleTroopSelected(int index, bool selected);
     void refreshBattleHUDTroops();
+    void bindBattleHUD(cocos2d::Node* panel);
+    void unbindBattleHUD();
+    bool isBattleHUDBound() const;
+    void flushBattleHUD();
 
     void playWhiteTransition(const std::function<void()>& onComplete);
 };
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# gen_soldier_anim_table.py
+# 离线读取 Resources/Soldiers/<Name>/anims.plist（TexturePacker 导出），
+# 生成 Classes/Combat/SoldierAnimationTable.h：
+#   兵种 x 动作 x 方向 -> [首帧下标, 帧数]，以及每帧在图集中的矩形。
+# 运行时由 SoldierAnimationDatabase 一次性读入扁平数组，按枚举下标访问。
+#
+# 用法（仓库根目录）：python3 tools/gen_soldier_anim_table.py
+
+import os
+import plistlib
+import re
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUTPUT = os.path.join(ROOT, "Classes", "Combat", "SoldierAnimationTable.h")
+
+# 顺序必须与 SoldierType / SoldierAction / Direction 枚举一致
+SOLDIERS = ["Barbarian", "Archer", "Bomber", "Giant"]
+ACTIONS = ["walk", "attack"]
+DIRECTIONS = ["up", "down", "left", "right"]
+FRAME_DELAY = 0.1
+
+RECT_RE = re.compile(r"\{\{(-?\d+),(-?\d+)\},\{(-?\d+),(-?\d+)\}\}")
+
+
+def load_frames(name):
+    path = os.path.join(ROOT, "Resources", "Soldiers", name, "anims.plist")
+    with open(path, "rb") as f:
+        plist = plistlib.load(f)
+    frames = {}
+    for key, info in plist["frames"].items():
+        if info.get("textureRotated", False):
+            raise SystemExit("%s: rotated frame %s is not supported" % (name, key))
+        m = RECT_RE.match(info["textureRect"].replace(" ", ""))
+        if not m:
+            raise SystemExit("%s: bad textureRect for %s" % (name, key))
+        frames[key] = tuple(int(v) for v in m.groups())
+    return frames
+
+
+def main():
+    rects = []
+    clips = []
+    for name in SOLDIERS:
+        frames = load_frames(name)
+        per_action = []
+        for action in ACTIONS:
+            per_dir = []
+            for direction in DIRECTIONS:
+                first = len(rects)
+                i = 1
+                while ("%s%s%s%d.png" % (name, action, direction, i)) in frames:
+                    rects.append(frames["%s%s%s%d.png" % (name, action, direction, i)])
+                    i += 1
+                per_dir.append((first, len(rects) - first))
+            per_action.append(per_dir)
+        clips.append(per_action)
+
+    out = []
+    out.append("// SoldierAnimationTable.h")
+    out.append("// 由 tools/gen_soldier_anim_table.py 根据 Resources/Soldiers/*/anims.plist 生成，请勿手动修改")
+    out.append("")
+    out.append("#ifndef PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATIONTABLE_H")
+    out.append("#define PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATIONTABLE_H")
+    out.append("")
+    out.append("namespace soldier_anim_table {")
+    out.append("")
+    out.append("struct FrameRect { float x, y, width, height; };")
+    out.append("struct Clip { int first_frame; int frame_count; };")
+    out.append("")
+    out.append("constexpr int kSoldierCount = %d;" % len(SOLDIERS))
+    out.append("constexpr int kActionCount = %d;" % len(ACTIONS))
+    out.append("constexpr int kDirectionCount = %d;" % len(DIRECTIONS))
+    out.append("constexpr float kFrameDelay = %.2ff;" % FRAME_DELAY)
+    out.append("")
+    out.append("// 兵种图集路径（下标与 SoldierType 一致）")
+    out.append("constexpr const char* kTexturePaths[kSoldierCount] = {")
+    for name in SOLDIERS:
+        out.append("        \"Soldiers/%s/anims.png\"," % name)
+    out.append("};")
+    out.append("")
+    out.append("// [兵种][动作][方向] -> 帧区间（方向顺序：up, down, left, right）")
+    out.append("constexpr Clip kClips[kSoldierCount][kActionCount][kDirectionCount] = {")
+    for name, per_action in zip(SOLDIERS, clips):
+        out.append("        { // %s" % name)
+        for action, per_dir in zip(ACTIONS, per_action):
+            cells = ", ".join("{%d, %d}" % c for c in per_dir)
+            out.append("                {%s}, // %s" % (cells, action))
+        out.append("        },")
+    out.append("};")
+    out.append("")
+    out.append("// 图集内的帧矩形（像素，左上角为原点）")
+    out.append("constexpr FrameRect kFrames[] = {")
+    for x, y, w, h in rects:
+        out.append("        {%d, %d, %d, %d}," % (x, y, w, h))
+    out.append("};")
+    out.append("")
+    out.append("} // namespace soldier_anim_table")
+    out.append("")
+    out.append("#endif //PROGRAMMING_PARADIGM_FINAL_PROJECT_SOLDIERANIMATIONTABLE_H")
+
+    with open(OUTPUT, "w", newline="\n") as f:
+        f.write("\n".join(out) + "\n")
+    print("wrote %s (%d frames)" % (OUTPUT, len(rects)))
+
+
+if __name__ == "__main__":
+    main()